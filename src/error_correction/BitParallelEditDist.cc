@@ -0,0 +1,182 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BitParallelEditDist.cc
+ *
+ * @brief Definitions file for BitParallelEditDist.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "BitParallelEditDist.h"
+
+//--------------- Constants ------------------------------------------
+
+#define BPED_BLOCK_SIZE 64
+#define BPED_NUM_CHARS  256
+
+//--------------- BitParallelEditDist class function definitions
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDist(const std::string& x,
+                                                    const std::string& y)
+{
+      // The distance is symmetric, the shortest string is taken as the
+      // pattern to reduce the number of blocks
+  const std::string& pattern=(x.size()<y.size() ? x : y);
+  const std::string& text=(x.size()<y.size() ? y : x);
+  if(pattern.empty())
+    return text.size();
+
+      // Obtain match vectors of the pattern
+  initPeq(BPED_NUM_CHARS,pattern.size());
+  for(unsigned int i=0;i<pattern.size();++i)
+    setPeqBit((unsigned char)pattern[i],i,pattern.size());
+
+      // Obtain symbols of the text
+  std::vector<unsigned int> textSymbols(text.size());
+  for(unsigned int j=0;j<text.size();++j)
+    textSymbols[j]=(unsigned char)text[j];
+
+  return calculateEditDistGivenPeq(textSymbols,pattern.size());
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDist(const std::vector<std::string>& x,
+                                                    const std::vector<std::string>& y)
+{
+  const std::vector<std::string>& pattern=(x.size()<y.size() ? x : y);
+  const std::vector<std::string>& text=(x.size()<y.size() ? y : x);
+  if(pattern.empty())
+    return text.size();
+
+      // Assign symbols to the words of the pattern
+  wordToSymbolMap.clear();
+  std::vector<unsigned int> patternSymbols(pattern.size());
+  for(unsigned int i=0;i<pattern.size();++i)
+  {
+    std::unordered_map<std::string,unsigned int>::const_iterator mapIter=wordToSymbolMap.find(pattern[i]);
+    if(mapIter==wordToSymbolMap.end())
+    {
+      unsigned int symbol=wordToSymbolMap.size();
+      wordToSymbolMap[pattern[i]]=symbol;
+      patternSymbols[i]=symbol;
+    }
+    else
+      patternSymbols[i]=mapIter->second;
+  }
+
+      // Obtain match vectors of the pattern, an additional symbol
+      // without matches is used for the words not in the pattern
+  unsigned int noMatchSymbol=wordToSymbolMap.size();
+  initPeq(noMatchSymbol+1,pattern.size());
+  for(unsigned int i=0;i<pattern.size();++i)
+    setPeqBit(patternSymbols[i],i,pattern.size());
+
+      // Obtain symbols of the text
+  std::vector<unsigned int> textSymbols(text.size());
+  for(unsigned int j=0;j<text.size();++j)
+  {
+    std::unordered_map<std::string,unsigned int>::const_iterator mapIter=wordToSymbolMap.find(text[j]);
+    if(mapIter==wordToSymbolMap.end())
+      textSymbols[j]=noMatchSymbol;
+    else
+      textSymbols[j]=mapIter->second;
+  }
+
+  return calculateEditDistGivenPeq(textSymbols,pattern.size());
+}
+
+//---------------------------------------
+unsigned int BitParallelEditDist::calculateEditDistGivenPeq(const std::vector<unsigned int>& textSymbols,
+                                                            unsigned int patternLength)
+{
+  const BitVector highBit=((BitVector)1)<<(BPED_BLOCK_SIZE-1);
+  unsigned int numBlocks=(patternLength+BPED_BLOCK_SIZE-1)/BPED_BLOCK_SIZE;
+
+      // The first column of the distance matrix is 0,1,...,m, so all
+      // vertical differences are positive
+  vp.assign(numBlocks,~(BitVector)0);
+  vn.assign(numBlocks,0);
+  const BitVector lastRowBit=((BitVector)1)<<((patternLength-1)%BPED_BLOCK_SIZE);
+  unsigned int dist=patternLength;
+
+  for(unsigned int j=0;j<textSymbols.size();++j)
+  {
+    const BitVector* eqVec=&peq[textSymbols[j]*numBlocks];
+
+        // The first row of the distance matrix is 0,1,...,n, so the
+        // horizontal difference entering the first block is positive
+    int hin=1;
+    for(unsigned int b=0;b<numBlocks;++b)
+    {
+      BitVector pv=vp[b];
+      BitVector mv=vn[b];
+      BitVector eq=eqVec[b];
+      BitVector xv=eq|mv;
+      if(hin<0)
+        eq|=1;
+      BitVector xh=(((eq&pv)+pv)^pv)|eq;
+      BitVector ph=mv|~(xh|pv);
+      BitVector mh=pv&xh;
+
+          // Obtain horizontal difference leaving the block, the one of
+          // the last block is taken at the last row of the pattern
+      BitVector outBit=(b+1==numBlocks ? lastRowBit : highBit);
+      int hout=0;
+      if(ph&outBit)
+        hout=1;
+      else if(mh&outBit)
+        hout=-1;
+
+          // Update vertical differences
+      ph<<=1;
+      mh<<=1;
+      if(hin<0)
+        mh|=1;
+      else if(hin>0)
+        ph|=1;
+      vp[b]=mh|~(xv|ph);
+      vn[b]=ph&xv;
+      hin=hout;
+    }
+    if(hin>0)
+      ++dist;
+    else if(hin<0)
+      --dist;
+  }
+  return dist;
+}
+
+//---------------------------------------
+void BitParallelEditDist::initPeq(unsigned int numSymbols,
+                                  unsigned int patternLength)
+{
+  unsigned int numBlocks=(patternLength+BPED_BLOCK_SIZE-1)/BPED_BLOCK_SIZE;
+  peq.assign(numSymbols*numBlocks,0);
+}
+
+//---------------------------------------
+void BitParallelEditDist::setPeqBit(unsigned int symbol,
+                                    unsigned int pos,
+                                    unsigned int patternLength)
+{
+  unsigned int numBlocks=(patternLength+BPED_BLOCK_SIZE-1)/BPED_BLOCK_SIZE;
+  peq[symbol*numBlocks+pos/BPED_BLOCK_SIZE]|=((BitVector)1)<<(pos%BPED_BLOCK_SIZE);
+}
@@ -0,0 +1,94 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file BitParallelEditDist.h
+ *
+ * @brief Defines the BitParallelEditDist class, which calculates the
+ * unit-cost edit distance by means of the bit-parallel algorithm of
+ * Myers, extended to patterns of arbitrary length as proposed by
+ * Hyyro.
+ */
+
+#ifndef _BitParallelEditDist_h
+#define _BitParallelEditDist_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- BitParallelEditDist class declaration
+
+/**
+ * @brief Calculates the Levenshtein distance (hits cost 0, insertions,
+ * deletions and substitutions cost 1) without filling the distance
+ * matrix. The columns of the matrix are encoded as bit vectors of
+ * vertical differences, which are processed in blocks of 64 rows, so
+ * the time cost is O(ceil(m/64)*n), where m is the length of the
+ * shortest sequence. Edit operations are not recovered, the classes
+ * derived from _editDist should be used when they are required.
+ */
+
+class BitParallelEditDist
+{
+ public:
+
+  unsigned int calculateEditDist(const std::string& x,
+                                 const std::string& y);
+      // Calculates the edit distance between the characters of x and
+      // y
+  unsigned int calculateEditDist(const std::vector<std::string>& x,
+                                 const std::vector<std::string>& y);
+      // Calculates the edit distance between the words of x and y
+
+ protected:
+
+  typedef unsigned long long BitVector;
+
+  std::vector<BitVector> peq;
+      // Match vectors of the pattern, stored in blocks of numBlocks
+      // bit vectors per symbol
+  std::vector<BitVector> vp;
+  std::vector<BitVector> vn;
+      // Positive and negative vertical differences of each block
+  std::unordered_map<std::string,unsigned int> wordToSymbolMap;
+      // Symbols assigned to the words of the pattern
+
+  unsigned int calculateEditDistGivenPeq(const std::vector<unsigned int>& textSymbols,
+                                         unsigned int patternLength);
+      // Calculates the edit distance given the match vectors of a
+      // pattern of length patternLength and the symbols of the text
+  void initPeq(unsigned int numSymbols,
+               unsigned int patternLength);
+  void setPeqBit(unsigned int symbol,
+                 unsigned int pos,
+                 unsigned int patternLength);
+};
+
+#endif
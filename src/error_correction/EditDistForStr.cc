@@ -42,7 +42,7 @@ Score EditDistForStr::calculateEditDistPrefix(const std::string& x,
 {
   std::vector<unsigned int> ops;
 
-  return calculateEditDistPrefixOps(x,y,ops,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,USE_PREF_DEL_OP,false,ops,verbose);
 }
 
 //---------------------------------------
@@ -51,7 +51,7 @@ Score EditDistForStr::calculateEditDistPrefixOps(const std::string& x,
                                                  std::vector<unsigned int>& ops,
                                                  int verbose)
 {
-  return calculateEditDistPrefixOpsAux(x,y,USE_PREF_DEL_OP,ops,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,USE_PREF_DEL_OP,true,ops,verbose);
 }
 
 //---------------------------------------
@@ -60,13 +60,14 @@ Score EditDistForStr::calculateEditDistPrefixOpsNoPrefDel(const std::string& x,
                                                           std::vector<unsigned int>& ops,
                                                           int verbose)
 {
-  return calculateEditDistPrefixOpsAux(x,y,DONT_USE_PREF_DEL_OP,ops,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,DONT_USE_PREF_DEL_OP,true,ops,verbose);
 }
 
 //---------------------------------------
 Score EditDistForStr::calculateEditDistPrefixOpsAux(const std::string& x,
                                                     const std::string& y,
                                                     bool usePrefDelOp,
+                                                    bool obtainOps,
                                                     std::vector<unsigned int>& ops,
                                                     int verbose)
 {
@@ -86,7 +87,8 @@ Score EditDistForStr::calculateEditDistPrefixOpsAux(const std::string& x,
     }
   }
       // Retrieve operations
-  obtainOperationsPref(x,y,dm,usePrefDelOp,x.size(),y.size(),ops);
+  if(obtainOps)
+    obtainOperationsPref(x,y,dm,usePrefDelOp,x.size(),y.size(),ops);
 
   if(verbose) printDistMatrix(x,y,dm,std::cerr);
   return dm[x.size()][y.size()];	
@@ -109,9 +109,11 @@ class EditDistForStr: public _editDist<std::string>
     Score calculateEditDistPrefixOpsAux(const std::string& x,
                                         const std::string& y,
                                         bool usePrefDelOp,
+                                        bool obtainOps,
                                         std::vector<unsigned int>& ops,
                                         int verbose);
-        // Auxiliary function for calculateEditDistPrefixOps()
+        // Auxiliary function for calculateEditDistPrefixOps(), the
+        // sequence of operations is only obtained if obtainOps is true
 
     inline Score insertionCost(char /*c*/)
       {
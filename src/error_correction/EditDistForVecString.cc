@@ -31,6 +31,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //---------------------------------------
 EditDistForVecString::EditDistForVecString(void):EditDistForVec<std::string>()
 {
+  errorModelVersion=0;
 }
 
 //---------------------------------------
@@ -60,7 +61,7 @@ Score EditDistForVecString::calculateEditDistPrefix(const std::vector<std::strin
   std::vector<unsigned int> opsWordLevel;
   std::vector<unsigned int> opsCharLevel;
   
-  return calculateEditDistPrefixOps(x,y,opsWordLevel,opsCharLevel,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,opsWordLevel,opsCharLevel,USE_PREF_DEL_OP,false,verbose);
 }
 
 //---------------------------------------
@@ -70,7 +71,7 @@ Score EditDistForVecString::calculateEditDistPrefixOps(const std::vector<std::st
                                                        std::vector<unsigned int>& opsCharLevel,    
                                                        int verbose)
 {
-  return calculateEditDistPrefixOpsAux(x,y,opsWordLevel,opsCharLevel,USE_PREF_DEL_OP,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,opsWordLevel,opsCharLevel,USE_PREF_DEL_OP,true,verbose);
 }
 
 //---------------------------------------
@@ -80,7 +81,7 @@ Score EditDistForVecString::calculateEditDistPrefixOpsNoPrefDel(const std::vecto
                                                                 std::vector<unsigned int>& opsCharLevel,                                                    
                                                                 int verbose)
 {
-  return calculateEditDistPrefixOpsAux(x,y,opsWordLevel,opsCharLevel,DONT_USE_PREF_DEL_OP,verbose);
+  return calculateEditDistPrefixOpsAux(x,y,opsWordLevel,opsCharLevel,DONT_USE_PREF_DEL_OP,true,verbose);
 }
 
 //---------------------------------------
@@ -89,6 +90,7 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
                                                           std::vector<unsigned int>& opsWordLevel,
                                                           std::vector<unsigned int>& opsCharLevel,
                                                           bool usePrefDelOp,
+                                                          bool obtainOps,
                                                           int verbose)
 {
   bool lastWordIsComplete=true;
@@ -132,6 +134,13 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
     }
   }
 
+      // If verbose, print distance matrix
+  if(verbose) printDistMatrix(xVec,yVec,dm,std::cerr);
+
+      // Operations are not retrieved if they were not requested
+  if(!obtainOps)
+    return dm[x.size()][y.size()];
+
       // Retrieve word level operations
   std::vector<Score> opCosts;
   obtainOperationsPref(xVec,yVec,dm,lastWordIsComplete,usePrefDelOp,x.size(),y.size(),opsWordLevel,opsCharLevel,opCosts);
@@ -141,11 +150,6 @@ Score EditDistForVecString::calculateEditDistPrefixOpsAux(const std::vector<std:
   std::vector<Score> opCostsPerType;
   obtainOpsAndOpCostsPerType(opsWordLevel,opCosts,opsPerType,opCostsPerType);
 
-      // Print verbose information
-
-      // If verbose, print distance matrix
-  if(verbose) printDistMatrix(xVec,yVec,dm,std::cerr);
-
       // If verbose, print operation costs per type
   if(verbose)
   {
@@ -201,6 +205,29 @@ void EditDistForVecString::incrEditDistPrefix(const std::string& xWord,
                            opIdVec);
 }
 
+//---------------------------------------
+void EditDistForVecString::incrEditDistPrefix(const std::string& xWord,
+                                              const std::vector<std::string>& incr_y,
+                                              const std::vector<Score> prevScoreVec,
+                                              SubstCostCache& substCostCache,
+                                              std::vector<Score>& newScoreVec,
+                                              std::vector<int>& opIdVec)
+{
+  if(substCostCache.errorModelVersion!=errorModelVersion ||
+     substCostCache.substCostMap.size()>=EDIT_DIST_MAX_CACHED_SUBST_COSTS)
+  {
+    substCostCache.substCostMap.clear();
+    substCostCache.errorModelVersion=errorModelVersion;
+  }
+
+  incrEditDistPrefixCached(xWord,
+                           incr_y,
+                           prevScoreVec,
+                           substCostCache.substCostMap,
+                           newScoreVec,
+                           opIdVec);
+}
+
 //---------------------------------------
 void EditDistForVecString::incrEditDistPrefixCached(const std::string& xWord,
                                                     const std::vector<std::string>& incr_y,
@@ -296,6 +323,9 @@ void EditDistForVecString::setErrorModel(Score _hitCost,
 
       // Set character-level costs
   editDistForStr.setErrorModel(hitCost,insCost,substCost,delCost);
+
+      // Cached substitution costs are no longer valid
+  ++errorModelVersion;
 }
 
 //---------------------------------------
@@ -479,8 +509,8 @@ Score EditDistForVecString::processMatrixCellPref(const std::vector<std::string>
 }
 
 //---------------------------------------
-Score EditDistForVecString::cachedPrefSubstCost(std::string xWord,
-                                                std::string yWord,
+Score EditDistForVecString::cachedPrefSubstCost(const std::string& xWord,
+                                                const std::string& yWord,
                                                 SubstCostMap& substCostMap)
 {
   std::string xWordAdapted=xWord+" pref";
@@ -496,8 +526,8 @@ Score EditDistForVecString::cachedPrefSubstCost(std::string xWord,
 }
 
 //---------------------------------------
-Score EditDistForVecString::cachedSubstCost(std::string xWord,
-                                            std::string yWord,
+Score EditDistForVecString::cachedSubstCost(const std::string& xWord,
+                                            const std::string& yWord,
                                             SubstCostMap& substCostMap)
 {
   SubstCostMap::const_iterator scmConstIter=substCostMap.find(std::make_pair(xWord,yWord));
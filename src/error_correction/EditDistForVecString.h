@@ -43,11 +43,20 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Constants ------------------------------------------
 
+#define EDIT_DIST_MAX_CACHED_SUBST_COSTS 1000000
 
 //--------------- Type definitions -----------------------------------
 
 typedef std::map<std::pair<std::string,std::string>,Score> SubstCostMap;
 
+struct SubstCostCache
+{
+  SubstCostMap substCostMap;
+  unsigned int errorModelVersion; // Version of the error model used
+                                  // to obtain the costs
+  SubstCostCache(void){errorModelVersion=0;}
+};
+
 //--------------- Classes --------------------------------------------
 
 
@@ -103,6 +112,19 @@ class EditDistForVecString: public EditDistForVec<std::string>
       // previous vector of costs and new partially calculated vector of
       // costs
 
+  void incrEditDistPrefix(const std::string& xWord,
+                          const std::vector<std::string>& incr_y,
+                          const std::vector<Score> prevScoreVec,
+                          SubstCostCache& substCostCache,
+                          std::vector<Score>& newScoreVec,
+                          std::vector<int>& opIdVec);
+      // The same as the previous function, but substitution costs are
+      // kept in substCostCache between calls, so they are only
+      // calculated once for each pair of words. The cache belongs to
+      // the caller, so the object can be shared by threads that use
+      // different caches. The cache is cleared when the error model
+      // changes
+
   void incrEditDistPrefixCached(const std::string& xWord,
                                 const std::vector<std::string>& incr_y,
                                 const std::vector<Score> prevScoreVec,
@@ -125,6 +147,9 @@ class EditDistForVecString: public EditDistForVec<std::string>
  protected:
 
   EditDistForStr editDistForStr;
+  unsigned int errorModelVersion;
+      // Increased each time the error model changes, so as to
+      // invalidate the substitution cost caches
   
   Score processMatrixCell(const std::vector<std::string>& x,
                           const std::vector<std::string>& y,
@@ -182,8 +207,8 @@ class EditDistForVecString: public EditDistForVec<std::string>
 #endif
     }
 
-  Score cachedSubstCost(std::string xWord,
-                        std::string yWord,
+  Score cachedSubstCost(const std::string& xWord,
+                        const std::string& yWord,
                         SubstCostMap& substCostMap);
   
   inline Score substitutionCost(const std::string& x,
@@ -203,8 +228,8 @@ class EditDistForVecString: public EditDistForVec<std::string>
 #endif
     }
 
-  Score cachedPrefSubstCost(std::string xWord,
-                            std::string yWord,
+  Score cachedPrefSubstCost(const std::string& xWord,
+                            const std::string& yWord,
                             SubstCostMap& substCostMap);
 
   inline Score prefSubstitutionCost(const std::string& x,
@@ -239,8 +264,10 @@ class EditDistForVecString: public EditDistForVec<std::string>
                                       std::vector<unsigned int>& opsWordLevel,
                                       std::vector<unsigned int>& opsCharLevel,
                                       bool usePrefDelOp,
+                                      bool obtainOps,
                                       int verbose=0);
-      // Auxiliary function for calculateEditDistPrefixOps
+      // Auxiliary function for calculateEditDistPrefixOps, the
+      // sequences of operations are only obtained if obtainOps is true
 };
 
 #endif
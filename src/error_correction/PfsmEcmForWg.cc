@@ -106,6 +106,27 @@ void PfsmEcmForWg::extendEsi(const std::vector<std::string>& prefixDiffVec,
     newEsi.opIdVec.push_back(opIdVec[i]);
 }
 
+//---------------------------------------
+void PfsmEcmForWg::extendEsi(const std::vector<std::string>& prefixDiffVec,
+                             const EcmScoreInfo& prevEsi,
+                             const std::string& word,
+                             EsiCache& esiCache,
+                             EcmScoreInfo& newEsi)
+{
+      // Extend score vector
+  std::vector<int> opIdVec;
+  editDistForVecStr.incrEditDistPrefix(word,
+                                       prefixDiffVec,
+                                       prevEsi.scrVec,
+                                       esiCache,
+                                       newEsi.scrVec,
+                                       opIdVec);
+
+      // Extend predecessor vector
+  for(unsigned int i=0;i<opIdVec.size();++i)
+    newEsi.opIdVec.push_back(opIdVec[i]);
+}
+
 //---------------------------------------
 std::vector<Score> PfsmEcmForWg::obtainScrVecFromEsi(const EcmScoreInfo& esi)
 {
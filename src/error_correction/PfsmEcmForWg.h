@@ -54,6 +54,9 @@ class PfsmEcmForWg: public PfsmEcm, public BaseEcmForWg<PfsmEcmForWgEsi>
  public:
 
   typedef BaseEcmForWg<PfsmEcmForWgEsi>::EcmScoreInfo EcmScoreInfo;
+  typedef SubstCostCache EsiCache;
+      // Data cached between calls to extendEsi(), it is owned by the
+      // callers so that the model can be shared between threads
 
   void correctStrGivenPrefWg(std::vector<std::string> uncorrStrVec,
                              std::vector<std::string> prefStrVec,
@@ -79,6 +82,13 @@ class PfsmEcmForWg: public PfsmEcm, public BaseEcmForWg<PfsmEcmForWgEsi>
                  const std::string& word,
                  EcmScoreInfo& newEsi);
       // Extends ecm score info
+  void extendEsi(const std::vector<std::string>& prefixDiffVec,
+                 const EcmScoreInfo& prevEsi,
+                 const std::string& word,
+                 EsiCache& esiCache,
+                 EcmScoreInfo& newEsi);
+      // The same as the previous function, but the substitution costs
+      // are cached in esiCache
 
       // Functions to extract data from a given esi
   std::vector<Score> obtainScrVecFromEsi(const EcmScoreInfo& esi);
@@ -0,0 +1,55 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgContainerDefs.h
+ *
+ * @brief Defines the format of word graph containers. A container is
+ * an append-only file composed of records, each one with a header
+ * (magic string, sentence id and size of the data) followed by a word
+ * graph in binary format. Records start at offsets multiple of
+ * WG_BINARY_ALIGNMENT, so the arrays of the word graphs can be used
+ * from a memory mapping of the file. The offsets of the records are
+ * stored in an index file (container name plus WGC_INDEX_SUFFIX) with
+ * one "<sentence id> <offset> <size>" line per record, which can be
+ * rebuilt by scanning the record headers.
+ */
+
+#ifndef _WgContainerDefs_h
+#define _WgContainerDefs_h
+
+//--------------- Include files --------------------------------------
+
+#include "WordGraph.h"
+
+//--------------- Constants ------------------------------------------
+
+#define WGC_RECORD_MAGIC      "thot_wgc_rec_v1"
+#define WGC_RECORD_MAGIC_SIZE 16
+#define WGC_INDEX_SUFFIX      ".idx"
+
+//--------------- typedefs -------------------------------------------
+
+struct WgContainerRecordHeader
+{
+  char magic[WGC_RECORD_MAGIC_SIZE];
+  unsigned long long sentId;
+  unsigned long long dataSize;
+};
+
+#endif
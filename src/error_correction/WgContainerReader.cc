@@ -0,0 +1,204 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgContainerReader.cc
+ *
+ * @brief Definitions file for WgContainerReader.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgContainerReader.h"
+#include <sys/stat.h>
+#include <sstream>
+
+//--------------- Static members
+
+WgContainerReader::SharedReaderMap WgContainerReader::sharedReaderMap;
+pthread_mutex_t WgContainerReader::sharedReaderMut=PTHREAD_MUTEX_INITIALIZER;
+
+//--------------- WgContainerReader class function definitions
+
+//---------------------------------------
+bool WgContainerReader::open(const char* fileName)
+{
+  close();
+
+      // Obtain modification time and size before mapping the file, so
+      // that later modifications are detected by isUpToDate()
+  struct stat statBuf;
+  if(stat(fileName,&statBuf)!=0 || mappedFile.open(fileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening word graph container "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  containerFileName=fileName;
+  mtime=statBuf.st_mtim.tv_sec;
+  mtimeNsec=statBuf.st_mtim.tv_nsec;
+  fileSize=statBuf.st_size;
+
+      // Obtain index
+  std::string indexFileName=containerFileName+WGC_INDEX_SUFFIX;
+  bool indexLoaded=false;
+  if(MappedFile::isNewerThan(indexFileName.c_str(),fileName))
+    indexLoaded=(loadIndex(indexFileName)==THOT_OK);
+  if(!indexLoaded && rebuildIndex()==THOT_ERROR)
+  {
+    close();
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool WgContainerReader::isOpen(void)const
+{
+  return mappedFile.isOpen();
+}
+
+//---------------------------------------
+bool WgContainerReader::isUpToDate(void)const
+{
+  struct stat statBuf;
+  if(!isOpen() || stat(containerFileName.c_str(),&statBuf)!=0)
+    return false;
+  return (statBuf.st_mtim.tv_sec==mtime &&
+          statBuf.st_mtim.tv_nsec==mtimeNsec &&
+          (unsigned long long)statBuf.st_size==fileSize);
+}
+
+//---------------------------------------
+void WgContainerReader::getSentIds(std::vector<unsigned int>& sentIds)const
+{
+  sentIds.clear();
+  std::map<unsigned int,std::pair<unsigned long long,unsigned long long> >::const_iterator indexIter;
+  for(indexIter=index.begin();indexIter!=index.end();++indexIter)
+    sentIds.push_back(indexIter->first);
+}
+
+//---------------------------------------
+bool WgContainerReader::sentIdExists(unsigned int sentId)const
+{
+  return index.find(sentId)!=index.end();
+}
+
+//---------------------------------------
+bool WgContainerReader::load(unsigned int sentId,
+                             WordGraph& wordGraph)const
+{
+  std::map<unsigned int,std::pair<unsigned long long,unsigned long long> >::const_iterator indexIter=index.find(sentId);
+  if(indexIter==index.end())
+  {
+    std::cerr<<"Error: word graph container "<<containerFileName<<" does not contain sentence "<<sentId<<std::endl;
+    return THOT_ERROR;
+  }
+
+  std::ostringstream nameS;
+  nameS<<containerFileName<<" (sentence "<<sentId<<")";
+  return wordGraph.loadBinaryBuffer(mappedFile.getData()+indexIter->second.first,
+                                    indexIter->second.second,
+                                    nameS.str().c_str());
+}
+
+//---------------------------------------
+void WgContainerReader::close(void)
+{
+  mappedFile.close();
+  containerFileName.clear();
+  index.clear();
+}
+
+//---------------------------------------
+std::shared_ptr<const WgContainerReader> WgContainerReader::obtainShared(const char* fileName)
+{
+  pthread_mutex_lock(&sharedReaderMut);
+  std::shared_ptr<const WgContainerReader>& readerPtr=sharedReaderMap[fileName];
+  if(!readerPtr || !readerPtr->isUpToDate())
+  {
+        // Open the container again, callers holding the previous
+        // reader keep using it until they release it
+    std::shared_ptr<WgContainerReader> newReaderPtr(new WgContainerReader);
+    if(newReaderPtr->open(fileName)==THOT_OK)
+      readerPtr=newReaderPtr;
+    else
+      readerPtr.reset();
+  }
+  std::shared_ptr<const WgContainerReader> result=readerPtr;
+  if(!result)
+    sharedReaderMap.erase(fileName);
+  pthread_mutex_unlock(&sharedReaderMut);
+  return result;
+}
+
+//---------------------------------------
+bool WgContainerReader::loadIndex(const std::string& indexFileName)
+{
+  AwkInputStream awk;
+  if(awk.open(indexFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+  index.clear();
+  while(awk.getln())
+  {
+    if(awk.NF!=3)
+      return THOT_ERROR;
+    unsigned int sentId=atoi(awk.dollar(1).c_str());
+    unsigned long long offset=strtoull(awk.dollar(2).c_str(),NULL,10);
+    unsigned long long size=strtoull(awk.dollar(3).c_str(),NULL,10);
+    if(offset%WG_BINARY_ALIGNMENT!=0 || offset>mappedFile.getSize() || size>mappedFile.getSize()-offset)
+      return THOT_ERROR;
+    index[sentId]=std::make_pair(offset,size);
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool WgContainerReader::rebuildIndex(void)
+{
+  index.clear();
+
+      // Scan record headers
+  const char* bufPtr=mappedFile.getData();
+  unsigned long long bufSize=mappedFile.getSize();
+  unsigned long long offset=0;
+  while(offset<bufSize)
+  {
+    if(bufSize-offset<sizeof(WgContainerRecordHeader))
+      break;
+    const WgContainerRecordHeader* headerPtr=(const WgContainerRecordHeader*)(bufPtr+offset);
+    if(strncmp(headerPtr->magic,WGC_RECORD_MAGIC,WGC_RECORD_MAGIC_SIZE)!=0)
+    {
+      std::cerr<<"Error: word graph container "<<containerFileName<<" is corrupted"<<std::endl;
+      return THOT_ERROR;
+    }
+    offset+=sizeof(WgContainerRecordHeader);
+    if(headerPtr->dataSize>bufSize-offset)
+      break;
+    index[headerPtr->sentId]=std::make_pair(offset,headerPtr->dataSize);
+    offset+=headerPtr->dataSize;
+    if(offset%WG_BINARY_ALIGNMENT!=0)
+      offset+=WG_BINARY_ALIGNMENT-offset%WG_BINARY_ALIGNMENT;
+  }
+
+      // A truncated last record is ignored, since it may be the result
+      // of an interrupted process
+  if(offset<bufSize)
+    std::cerr<<"Warning: last record of word graph container "<<containerFileName<<" is incomplete"<<std::endl;
+  return THOT_OK;
+}
@@ -0,0 +1,103 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgContainerReader.h
+ *
+ * @brief Defines the WgContainerReader class, which gives random
+ * access to the word graphs stored in a container file.
+ */
+
+#ifndef _WgContainerReader_h
+#define _WgContainerReader_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WgContainerDefs.h"
+#include <pthread.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <utility>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WgContainerReader class
+
+/**
+ * @brief Reads word graph containers (see WgContainerDefs.h). The
+ * container is memory mapped, and the word graphs are located by
+ * means of the index file. The index is rebuilt from the record
+ * headers if the index file does not exist or is older than the
+ * container. If a sentence id appears more than once, the last record
+ * is used.
+ */
+
+class WgContainerReader
+{
+ public:
+
+  bool open(const char* fileName);
+  bool isOpen(void)const;
+  bool isUpToDate(void)const;
+      // Returns true if the container file was not modified since it
+      // was opened
+  void getSentIds(std::vector<unsigned int>& sentIds)const;
+      // Returns the sentence ids stored in the container in
+      // increasing order
+  bool sentIdExists(unsigned int sentId)const;
+  bool load(unsigned int sentId,
+            WordGraph& wordGraph)const;
+      // Loads the word graph of the given sentence
+  void close(void);
+
+  static std::shared_ptr<const WgContainerReader> obtainShared(const char* fileName);
+      // Returns a reader for the given container that is shared by all
+      // the callers of the process, so the container is mapped and
+      // indexed only once. The container is opened again if it was
+      // modified. Readers remain valid while they are referenced, even
+      // if they are replaced. Returns an empty pointer on error
+
+ private:
+
+  MappedFile mappedFile;
+  std::string containerFileName;
+  long long mtime;
+  long mtimeNsec;
+  unsigned long long fileSize;
+  std::map<unsigned int,std::pair<unsigned long long,unsigned long long> > index;
+      // Offset and size of the word graph of each sentence
+
+  bool loadIndex(const std::string& indexFileName);
+  bool rebuildIndex(void);
+
+      // Readers shared by obtainShared()
+  typedef std::map<std::string,std::shared_ptr<const WgContainerReader> > SharedReaderMap;
+  static SharedReaderMap sharedReaderMap;
+  static pthread_mutex_t sharedReaderMut;
+};
+
+#endif
@@ -0,0 +1,245 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgContainerWriter.cc
+ *
+ * @brief Definitions file for WgContainerWriter.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgContainerWriter.h"
+#include <sstream>
+
+//--------------- WgContainerWriter class function definitions
+
+//---------------------------------------
+WgContainerWriter::WgContainerWriter(void)
+{
+  currOffset=0;
+  writerThreadRunning=false;
+  finishRequested=false;
+  writeError=false;
+  pthread_mutex_init(&queue_mut,NULL);
+  pthread_cond_init(&record_avail_cond,NULL);
+  pthread_cond_init(&space_avail_cond,NULL);
+}
+
+//---------------------------------------
+bool WgContainerWriter::open(const char* fileName)
+{
+  close();
+
+  outS.open(fileName,std::ios::binary|std::ios::trunc);
+  if(!outS)
+  {
+    std::cerr<<"Error while creating word graph container "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+  containerFileName=fileName;
+  currOffset=0;
+  index.clear();
+  finishRequested=false;
+  writeError=false;
+
+      // Start writer thread
+  if(pthread_create(&writerThread,NULL,writerThreadFunc,(void*)this)!=0)
+  {
+    std::cerr<<"Error while creating writer thread for word graph container "<<fileName<<std::endl;
+    outS.close();
+    return THOT_ERROR;
+  }
+  writerThreadRunning=true;
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool WgContainerWriter::isOpen(void)const
+{
+  return writerThreadRunning;
+}
+
+//---------------------------------------
+bool WgContainerWriter::addWordGraph(unsigned int sentId,
+                                     const WordGraph& wordGraph,
+                                     bool printOnlyUsefulStates/*=true*/)
+{
+  if(!writerThreadRunning)
+  {
+    std::cerr<<"Error: word graph container is not open"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Serialize word graph
+  std::ostringstream dataS;
+  if(wordGraph.printBinary(dataS,printOnlyUsefulStates)==THOT_ERROR)
+  {
+    std::cerr<<"Error while serializing word graph of sentence "<<sentId<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Queue record
+  pthread_mutex_lock(&queue_mut);
+  while(pendingRecords.size()>=WGC_MAX_PENDING_RECORDS && !writeError)
+    pthread_cond_wait(&space_avail_cond,&queue_mut);
+  bool error=writeError;
+  if(!error)
+  {
+    pendingRecords.push_back(std::make_pair(sentId,std::string()));
+    pendingRecords.back().second=dataS.str();
+    pthread_cond_signal(&record_avail_cond);
+  }
+  pthread_mutex_unlock(&queue_mut);
+
+  if(error)
+  {
+    std::cerr<<"Error while writing word graph container "<<containerFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+    return THOT_OK;
+}
+
+//---------------------------------------
+bool WgContainerWriter::close(void)
+{
+  if(!writerThreadRunning)
+    return THOT_OK;
+
+      // Wait until all records have been written
+  pthread_mutex_lock(&queue_mut);
+  finishRequested=true;
+  pthread_cond_signal(&record_avail_cond);
+  pthread_mutex_unlock(&queue_mut);
+  pthread_join(writerThread,NULL);
+  writerThreadRunning=false;
+
+  outS.close();
+  if(writeError || !outS)
+  {
+    std::cerr<<"Error while writing word graph container "<<containerFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return printIndex();
+}
+
+//---------------------------------------
+void* WgContainerWriter::writerThreadFunc(void* writerPtr)
+{
+  ((WgContainerWriter*) writerPtr)->writeRecords();
+  return NULL;
+}
+
+//---------------------------------------
+void WgContainerWriter::writeRecords(void)
+{
+  while(true)
+  {
+        // Wait for a record
+    pthread_mutex_lock(&queue_mut);
+    while(pendingRecords.empty() && !finishRequested)
+      pthread_cond_wait(&record_avail_cond,&queue_mut);
+    if(pendingRecords.empty())
+    {
+      pthread_mutex_unlock(&queue_mut);
+      break;
+    }
+    std::pair<unsigned int,std::string> record;
+    record.first=pendingRecords.front().first;
+    record.second.swap(pendingRecords.front().second);
+    pendingRecords.pop_front();
+    pthread_cond_signal(&space_avail_cond);
+    pthread_mutex_unlock(&queue_mut);
+
+        // Write record, the queue is not locked meanwhile
+    if(writeRecord(record.first,record.second)==THOT_ERROR)
+    {
+      pthread_mutex_lock(&queue_mut);
+      writeError=true;
+      pendingRecords.clear();
+      pthread_cond_broadcast(&space_avail_cond);
+      pthread_mutex_unlock(&queue_mut);
+      break;
+    }
+  }
+}
+
+//---------------------------------------
+bool WgContainerWriter::writeRecord(unsigned int sentId,
+                                    const std::string& data)
+{
+  WgContainerRecordHeader header;
+  memset(&header,0,sizeof(header));
+  strncpy(header.magic,WGC_RECORD_MAGIC,WGC_RECORD_MAGIC_SIZE);
+  header.sentId=sentId;
+  header.dataSize=data.size();
+
+  IndexEntry indexEntry;
+  indexEntry.sentId=sentId;
+  indexEntry.offset=currOffset+sizeof(header);
+  indexEntry.size=data.size();
+
+      // Write header and data, padding the data to keep the next
+      // record aligned
+  outS.write((const char*)&header,sizeof(header));
+  outS.write(data.data(),data.size());
+  currOffset+=sizeof(header)+data.size();
+  if(currOffset%WG_BINARY_ALIGNMENT!=0)
+  {
+    char padding[WG_BINARY_ALIGNMENT];
+    memset(padding,0,WG_BINARY_ALIGNMENT);
+    unsigned int paddingSize=WG_BINARY_ALIGNMENT-currOffset%WG_BINARY_ALIGNMENT;
+    outS.write(padding,paddingSize);
+    currOffset+=paddingSize;
+  }
+  if(!outS)
+    return THOT_ERROR;
+
+  index.push_back(indexEntry);
+  return THOT_OK;
+}
+
+//---------------------------------------
+bool WgContainerWriter::printIndex(void)
+{
+  std::string indexFileName=containerFileName+WGC_INDEX_SUFFIX;
+  std::ofstream indexS(indexFileName.c_str(),std::ios::trunc);
+  if(!indexS)
+  {
+    std::cerr<<"Error while printing word graph container index "<<indexFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  for(unsigned int i=0;i<index.size();++i)
+    indexS<<index[i].sentId<<" "<<index[i].offset<<" "<<index[i].size<<std::endl;
+  if(!indexS)
+  {
+    std::cerr<<"Error while printing word graph container index "<<indexFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+WgContainerWriter::~WgContainerWriter()
+{
+  close();
+  pthread_mutex_destroy(&queue_mut);
+  pthread_cond_destroy(&record_avail_cond);
+  pthread_cond_destroy(&space_avail_cond);
+}
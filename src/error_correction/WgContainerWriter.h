@@ -0,0 +1,115 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgContainerWriter.h
+ *
+ * @brief Defines the WgContainerWriter class, which stores the word
+ * graphs of a corpus in a single container file.
+ */
+
+#ifndef _WgContainerWriter_h
+#define _WgContainerWriter_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "WgContainerDefs.h"
+#include <pthread.h>
+#include <deque>
+#include <string>
+#include <vector>
+#include <fstream>
+
+//--------------- Constants ------------------------------------------
+
+#define WGC_MAX_PENDING_RECORDS 64
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WgContainerWriter class
+
+/**
+ * @brief Writes word graph containers (see WgContainerDefs.h). Word
+ * graphs are serialized by the caller and appended to the container
+ * by a background thread, so decoding is not blocked by file system
+ * operations. At most WGC_MAX_PENDING_RECORDS records wait to be
+ * written. The index file is written when the container is closed.
+ */
+
+class WgContainerWriter
+{
+ public:
+
+      // Constructor
+  WgContainerWriter(void);
+
+  bool open(const char* fileName);
+      // Creates the container, removing its previous content
+  bool isOpen(void)const;
+  bool addWordGraph(unsigned int sentId,
+                    const WordGraph& wordGraph,
+                    bool printOnlyUsefulStates=true);
+      // Queues the word graph of the given sentence, returns
+      // THOT_ERROR if a previous write failed
+  bool close(void);
+      // Waits until all queued records have been written and writes
+      // the index file
+
+      // Destructor
+  ~WgContainerWriter();
+
+ private:
+
+  struct IndexEntry
+  {
+    unsigned int sentId;
+    unsigned long long offset;
+    unsigned long long size;
+  };
+
+  std::string containerFileName;
+  std::ofstream outS;
+  unsigned long long currOffset;
+  std::vector<IndexEntry> index;
+
+      // Data shared with the writer thread
+  pthread_t writerThread;
+  bool writerThreadRunning;
+  std::deque<std::pair<unsigned int,std::string> > pendingRecords;
+  bool finishRequested;
+  bool writeError;
+  pthread_mutex_t queue_mut;
+  pthread_cond_t record_avail_cond;
+  pthread_cond_t space_avail_cond;
+
+  static void* writerThreadFunc(void* writerPtr);
+  void writeRecords(void);
+  bool writeRecord(unsigned int sentId,
+                   const std::string& data);
+  bool printIndex(void);
+
+      // Writers cannot be copied
+  WgContainerWriter(const WgContainerWriter&);
+  WgContainerWriter& operator=(const WgContainerWriter&);
+};
+
+#endif
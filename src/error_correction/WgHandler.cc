@@ -25,12 +25,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "WgHandler.h"
+#include <sys/stat.h>
 
 //--------------- WgHandler class function definitions
 
 //---------------------------------------
 WgHandler::WgHandler(void)
 {
+  pthread_mutex_init(&preprocWgMut,NULL);
 }
 
 //---------------------------------------
@@ -87,6 +89,103 @@ std::string WgHandler::pathAssociatedToSentence(const std::vector<std::string>&
   }
 }
 
+//---------------------------------------
+bool WgHandler::obtainPreprocWg(const std::string& wgPath,
+                                const std::vector<float>& weightVec,
+                                float wgp,
+                                float wgpp,
+                                WordGraph& wg,
+                                bool& completeHypReachable)const
+{
+  bool found=false;
+  PreprocWgKey key=obtainPreprocWgKey(wgPath,weightVec,wgp,wgpp);
+  pthread_mutex_lock(&preprocWgMut);
+  PreprocWgMap::const_iterator citer=preprocWgMap.find(key);
+  if(citer!=preprocWgMap.end())
+  {
+    wg=citer->second.first;
+    completeHypReachable=citer->second.second;
+    found=true;
+  }
+  pthread_mutex_unlock(&preprocWgMut);
+  return found;
+}
+
+//---------------------------------------
+void WgHandler::storePreprocWg(const std::string& wgPath,
+                               const std::vector<float>& weightVec,
+                               float wgp,
+                               float wgpp,
+                               const WordGraph& wg,
+                               bool completeHypReachable)
+{
+  PreprocWgKey key=obtainPreprocWgKey(wgPath,weightVec,wgp,wgpp);
+  pthread_mutex_lock(&preprocWgMut);
+  PreprocWgMap::iterator iter=preprocWgMap.find(key);
+  if(iter==preprocWgMap.end())
+  {
+        // Remove oldest word graph if necessary
+    if(preprocWgKeyQueue.size()>=WGH_MAX_PREPROC_WGS)
+    {
+      preprocWgMap.erase(preprocWgKeyQueue.front());
+      preprocWgKeyQueue.pop_front();
+    }
+    preprocWgKeyQueue.push_back(key);
+    iter=preprocWgMap.insert(std::make_pair(key,std::make_pair(WordGraph(),false))).first;
+  }
+  iter->second.first=wg;
+  iter->second.second=completeHypReachable;
+  pthread_mutex_unlock(&preprocWgMut);
+}
+
+//---------------------------------------
+WgHandler::PreprocWgKey WgHandler::obtainPreprocWgKey(const std::string& wgPath,
+                                                      const std::vector<float>& weightVec,
+                                                      float wgp,
+                                                      float wgpp)const
+{
+  PreprocWgKey key;
+  key.wgPath=wgPath;
+  key.weightVec=weightVec;
+  key.wgp=wgp;
+  key.wgpp=wgpp;
+
+      // The modification time of the file is included so that a word
+      // graph edited on disk is not served from the store
+  struct stat statBuf;
+  if(stat(wgPath.c_str(),&statBuf)==0)
+  {
+    key.mtime=statBuf.st_mtim.tv_sec;
+    key.mtimeNsec=statBuf.st_mtim.tv_nsec;
+  }
+  else
+  {
+    key.mtime=0;
+    key.mtimeNsec=0;
+  }
+  return key;
+}
+
+//---------------------------------------
+bool WgHandler::PreprocWgKey::operator<(const PreprocWgKey& right)const
+{
+  if(wgPath!=right.wgPath) return wgPath<right.wgPath;
+  if(mtime!=right.mtime) return mtime<right.mtime;
+  if(mtimeNsec!=right.mtimeNsec) return mtimeNsec<right.mtimeNsec;
+  if(weightVec!=right.weightVec) return weightVec<right.weightVec;
+  if(wgp!=right.wgp) return wgp<right.wgp;
+  return wgpp<right.wgpp;
+}
+
+//---------------------------------------
+void WgHandler::clearPreprocWgs(void)
+{
+  pthread_mutex_lock(&preprocWgMut);
+  preprocWgMap.clear();
+  preprocWgKeyQueue.clear();
+  pthread_mutex_unlock(&preprocWgMut);
+}
+
 //---------------------------------------
 bool WgHandler::empty(void)const
 {
@@ -135,9 +234,11 @@ void WgHandler::print(std::ostream &outS)const
 void WgHandler::clear(void)
 {
   sentToWgInfoMap.clear();
+  clearPreprocWgs();
 }
 
 //---------------------------------------
 WgHandler::~WgHandler()
 {
+  pthread_mutex_destroy(&preprocWgMut);
 }
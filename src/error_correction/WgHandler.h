@@ -34,9 +34,12 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <WordGraph.h>
 #include "AwkInputStream.h"
+#include <pthread.h>
+#include <deque>
 
 //--------------- Constants ------------------------------------------
 
+#define WGH_MAX_PREPROC_WGS 64
 
 //--------------- Classes --------------------------------------------
 
@@ -58,6 +61,28 @@ class WgHandler
   std::string pathAssociatedToSentence(const std::vector<std::string>& strVec,
                                        bool& found)const;
 
+      // Functions to share preprocessed word graphs (rescored, pruned
+      // and composed of useful states) between CAT sessions. Word
+      // graphs are identified by their path and modification time,
+      // the component weights and the pruning thresholds (score and
+      // posterior based). Cached search heuristics are copied together
+      // with the word graphs
+  bool obtainPreprocWg(const std::string& wgPath,
+                       const std::vector<float>& weightVec,
+                       float wgp,
+                       float wgpp,
+                       WordGraph& wg,
+                       bool& completeHypReachable)const;
+      // Returns false if the word graph is not stored
+  void storePreprocWg(const std::string& wgPath,
+                      const std::vector<float>& weightVec,
+                      float wgp,
+                      float wgpp,
+                      const WordGraph& wg,
+                      bool completeHypReachable);
+      // Stores a preprocessed word graph, the oldest one is removed if
+      // there are more than WGH_MAX_PREPROC_WGS
+
       // size related functions
   bool empty(void)const;
   size_t size(void)const;
@@ -79,6 +104,28 @@ class WgHandler
   typedef std::map<std::vector<std::string>,WgInfo> SentToWgInfoMap;
   
   SentToWgInfoMap sentToWgInfoMap;
+
+      // Preprocessed word graphs
+  struct PreprocWgKey
+  {
+    std::string wgPath;
+    long long mtime;
+    long mtimeNsec;
+    std::vector<float> weightVec;
+    float wgp;
+    float wgpp;
+    bool operator<(const PreprocWgKey& right)const;
+  };
+  typedef std::map<PreprocWgKey,std::pair<WordGraph,bool> > PreprocWgMap;
+  PreprocWgMap preprocWgMap;
+  std::deque<PreprocWgKey> preprocWgKeyQueue;
+  mutable pthread_mutex_t preprocWgMut;
+
+  PreprocWgKey obtainPreprocWgKey(const std::string& wgPath,
+                                  const std::vector<float>& weightVec,
+                                  float wgp,
+                                  float wgpp)const;
+  void clearPreprocWgs(void);
 };
 
 #endif
@@ -35,13 +35,19 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <ctimer.h>
 #include <StrProcUtils.h>
+#include <ThreadPool.h>
 #include <map>
 #include <set>
 #include <vector>
+#include <unordered_map>
 #include "BaseWgProcessorForAnlp.h"
 
 //--------------- Constants ------------------------------------------
 
+#define WGP_NUM_CORR_THREADS 4 // Number of threads of the pool used
+                                // to obtain corrections, the pool is
+                                // shared by the processors of all the
+                                // users
 
 //--------------- Functions ------------------------------------------
 
@@ -125,6 +131,18 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   std::vector<EcmScrInfoForArc> ecmScrInfoForArcVec;
       // Ecm score info for each arc
 
+  std::vector<WordGraphArcId> esiSrcArcVec;
+  std::vector<unsigned int> numSharedEsiVec;
+      // Arcs leaving the same state whose first words are equal share
+      // the ecm score info for such words. For each arc, esiSrcArcVec
+      // stores a previous arc from which the first numSharedEsiVec
+      // elements of the ecm score info are copied
+
+  typename ECM_FOR_WG::EsiCache esiCache;
+      // Data cached by the error correcting model while extending the
+      // ecm score info. It is kept here since the model is shared by
+      // the processors of all the users
+
   std::vector<Score> wgScoreForState;  // Best word-graph score for each
                                   // state
 
@@ -135,6 +153,18 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                                      // for each state
 
   StatesInvolvedInArcs statesInvolvedInArcs; // List of states involved in arcs
+
+  struct CorrTask
+  {
+    WgProcessorForAnlp<ECM_FOR_WG>* wgpPtr;
+    const std::vector<std::string>* prefixVecPtr;
+    const RejectedWordsSet* rejectedWordsPtr;
+    float score;
+    bool isSubState;
+    HypStateIndex hypStateIndex;
+    HypSubStateIdx hypSubStateIdx;
+    std::vector<std::string> correction;
+  };
   
   // Auxiliary functions
 
@@ -142,6 +172,9 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
   void initVars(unsigned int verbose=0);
   void genListOfStatesInvolvedInArcs(StatesInvolvedInArcs& stInvInArcs)const;
   void updateSizeOfVars(const std::vector<std::string>& validProcPrefixVec);
+  void initEsiSharingInfo(void);
+      // Builds a trie with the words of the arcs leaving each state to
+      // determine which ecm score info can be shared between arcs
   void initWgpInfoForArcs(unsigned int verbose=0);
   void initWgpInfoForInitState(unsigned int verbose=0);
   void initWgpInfoForArc(WordGraphArcId wgArcId,
@@ -165,7 +198,7 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                             unsigned int verbose=0);
       // Given a prefix and a pair of weights, obtains a list of the n
       // substates of the words-graph with best probability
-  bool wordSatisfiesRejWordConstraint(std::string word,
+  bool wordSatisfiesRejWordConstraint(const std::string& word,
                                       const RejectedWordsSet& rejectedWords);
   void updateWgpInfoForInitState(const std::vector<std::string>& prefixDiffVec,
                                  unsigned int verbose=0);
@@ -188,7 +221,25 @@ class WgProcessorForAnlp: public BaseWgProcessorForAnlp
                                           const NbestHypSubStates& nbestHypSubStates,
                                           unsigned int verbose=0);
       // Given a prefix and a list of n-best states, obtains a list of
-      // the n-best corrections
+      // the n-best distinct corrections. Hypothesis states and
+      // sub-states are processed in score order, by batches executed
+      // in the shared correction thread pool, until n distinct
+      // corrections are found
+  static ThreadPool& getCorrThreadPool(void);
+      // Returns the pool used to obtain corrections. A single pool of
+      // WGP_NUM_CORR_THREADS threads is shared by all the processors,
+      // so the number of threads does not grow with the number of
+      // users
+  static void obtainCorrForTask(void* taskData);
+      // Executes a CorrTask. Tasks only read the search variables of
+      // the processor and the error correcting model, so they may be
+      // run concurrently. Correcting a string with the ecm
+      // (correctStrGivenPrefWg()) only reads the edit cost parameters
+      // and keeps its intermediate results in local variables; the
+      // only cached data of the model (see esiCache) is owned by each
+      // processor. The model is only modified by operations that the
+      // decoder executes with exclusive access (such as training the
+      // model), never while corrections are being obtained
   std::vector<std::string> obtainBestUncorrPrefHypState(unsigned int procPrefPos,
                                                    HypStateIndex hypStateIndex,
                                                    std::vector<WordGraphArcId>& wgaidVec);
@@ -443,26 +494,27 @@ template<class ECM_FOR_WG>
 void WgProcessorForAnlp<ECM_FOR_WG>::initEcmScoreInfoForArc(WordGraphArcId wgArcId,
                                                             unsigned int /*verbose*//*=0*/)
 {
-      // Obtain arc from arc identifier
-  WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
-
-      // Obtain predecessor state index
-  HypStateIndex idx=wgArc.predStateIndex;
+      // Obtain predecessor state index and number of words of the arc
+  HypStateIndex idx=wg_ptr->getArcPredStateIndex(wgArcId);
+  unsigned int numWords=wg_ptr->getArcNumWords(wgArcId);
     
       // Init ecm score info for each word of the arc
-  EcmScoreInfo prevEsi=ecmScrInfoForState[idx];
+  const EcmScoreInfo* prevEsiPtr=&ecmScrInfoForState[idx];
 
       // Grow new esi for arc if necessary
-  while(ecmScrInfoForArcVec[wgArcId].size()<wgArc.words.size())
+  while(ecmScrInfoForArcVec[wgArcId].size()<numWords)
   {
     EcmScoreInfo esi;
     ecmScrInfoForArcVec[wgArcId].push_back(esi);
   }
-  for(unsigned int w=0;w<wgArc.words.size();++w)
+  for(unsigned int w=0;w<numWords;++w)
   {
-    ecmScrInfoForArcVec[wgArcId][w]=ecm_wg_ptr->constructEsi(prevEsi,
-                                                             wgArc.words[w]);
-    prevEsi=ecmScrInfoForArcVec[wgArcId][w];
+    if(w<numSharedEsiVec[wgArcId])
+      ecmScrInfoForArcVec[wgArcId][w]=ecmScrInfoForArcVec[esiSrcArcVec[wgArcId]][w];
+    else
+      ecmScrInfoForArcVec[wgArcId][w]=ecm_wg_ptr->constructEsi(*prevEsiPtr,
+                                                               wg_ptr->getArcWord(wgArcId,w));
+    prevEsiPtr=&ecmScrInfoForArcVec[wgArcId][w];
   }
 }
 
@@ -473,11 +525,18 @@ WgProcessorForAnlp<ECM_FOR_WG>::getValidProcPrefixVec(const std::vector<std::str
 {
   std::vector<std::string> result;
 
+      // The processed words are valid up to the first difference. The
+      // last word of a prefix is processed as an incomplete word unless
+      // it ends with a blank character, so it is only valid if it keeps
+      // its role in the new prefix
   for(unsigned int i=0;i<previousPrefixVec.size();++i)
   {
     if(i>=prefixVec.size()) break;
-    if(previousPrefixVec[i]==prefixVec[i])
-      result.push_back(previousPrefixVec[i]);
+    bool prevWordIsLast=(i==previousPrefixVec.size()-1);
+    bool wordIsLast=(i==prefixVec.size()-1);
+    if(previousPrefixVec[i]!=prefixVec[i] || prevWordIsLast!=wordIsLast)
+      break;
+    result.push_back(previousPrefixVec[i]);
   }
   return result;
 }
@@ -561,18 +620,18 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypStates(unsigned int n,
     if(!rejectedWords.empty())
     {
           // Obtain successors
-      std::vector<WordGraphArc> wgArcs;
-      wg_ptr->getArcsToSuccStates(hsIdx,wgArcs);
+      std::vector<WordGraphArcId> wgArcIds;
+      wg_ptr->getArcIdsToSuccStates(hsIdx,wgArcIds);
 
           // Find the best successor
       Score bestRestScoreForSucc=SMALL_SCORE;
-      for(unsigned int i=0;i<wgArcs.size();++i)
+      for(unsigned int i=0;i<wgArcIds.size();++i)
       {
             // Check that the constraint is satisfied
-        bool wordSatisfiesConstraint=wordSatisfiesRejWordConstraint(wgArcs[i].words[0],rejectedWords);
+        bool wordSatisfiesConstraint=wordSatisfiesRejWordConstraint(wg_ptr->getArcWord(wgArcIds[i],0),rejectedWords);
         if(wordSatisfiesConstraint)
         {
-          Score restScoreForArc=wgArcs[i].arcScore+restScores[wgArcs[i].succStateIndex];
+          Score restScoreForArc=wg_ptr->getArcScore(wgArcIds[i])+restScores[wg_ptr->getArcSuccStateIndex(wgArcIds[i])];
           if(bestRestScoreForSucc<restScoreForArc)
             bestRestScoreForSucc=restScoreForArc;
         }
@@ -619,25 +678,26 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypSubStates(unsigned int n,
     if(!wg_ptr->arcPruned(wgArcId))
     {
           // Insert sub-state in the n-best list
-          // Obtain arc from arc id.
-      WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
+          // Obtain arc data from arc id.
+      unsigned int numWords=wg_ptr->getArcNumWords(wgArcId);
+      HypStateIndex predStateIndex=wg_ptr->getArcPredStateIndex(wgArcId);
           // Iterate over the words of the arc
-      if(wgArc.words.size()>1)
+      if(numWords>1)
       {
-            // NOTE: the last word of the arc wgArc constitutes a sub-state
-            // equivalent to wgArc.succStateIndex state
+            // NOTE: the last word of the arc constitutes a sub-state
+            // equivalent to its successor state
         
             // Obtain wg score for predecessor state
-        Score wgScr=wgScoreForState[wgArc.predStateIndex];
+        Score wgScr=wgScoreForState[predStateIndex];
 
-        for(unsigned int w=0;w<wgArc.words.size()-1;++w)
+        for(unsigned int w=0;w<numWords-1;++w)
         {
               // Check that the sub-state satisfies the constraints
               // imposed by the set of rejected words
           bool subHypStateOk=true;
           if(!rejectedWords.empty())
           {
-            bool wordSatisfiesConstraint=wordSatisfiesRejWordConstraint(wgArc.words[w+1],rejectedWords);
+            bool wordSatisfiesConstraint=wordSatisfiesRejWordConstraint(wg_ptr->getArcWord(wgArcId,w+1),rejectedWords);
             if(!wordSatisfiesConstraint)
               subHypStateOk=false;
           }
@@ -649,7 +709,7 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypSubStates(unsigned int n,
                 // Obtain ecm score vector for w'th word of current arc
             std::vector<Score> ecmScrVec=ecm_wg_ptr->obtainScrVecFromEsi(ecmScrInfoForArcVec[wgArcId][w]);
                 // Calculate score of the sub-state
-            Score score=wgWeight*wgScr+ecmWeight*ecmScrVec.back()+(wgWeight*restScores[wgArc.predStateIndex]);
+            Score score=wgWeight*wgScr+ecmWeight*ecmScrVec.back()+(wgWeight*restScores[predStateIndex]);
             
                 // Create sub-state object
             HypSubStateIdx hssIdx;
@@ -673,7 +733,7 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestHypSubStates(unsigned int n,
 
 //---------------------------------------
 template<class ECM_FOR_WG>
-bool WgProcessorForAnlp<ECM_FOR_WG>::wordSatisfiesRejWordConstraint(std::string word,
+bool WgProcessorForAnlp<ECM_FOR_WG>::wordSatisfiesRejWordConstraint(const std::string& word,
                                                                     const RejectedWordsSet& rejectedWords)
 {
   RejectedWordsSet::const_iterator strSetIter;
@@ -744,30 +804,39 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateEcmScoreInfoForArc(const std::vector<
                                                               WordGraphArcId wgArcId,
                                                               unsigned int /*verbose*//*=0*/)
 {
-      // Obtain arc from arc identifier
-  WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
-
-      // Obtain predecessor state
-  HypStateIndex idx=wgArc.predStateIndex;
+      // Obtain predecessor state and number of words of the arc
+  HypStateIndex idx=wg_ptr->getArcPredStateIndex(wgArcId);
+  unsigned int numWords=wg_ptr->getArcNumWords(wgArcId);
 
       // Update ecm score info for each word of the arc
-  EcmScoreInfo prevEsi=ecmScrInfoForState[idx];
+  const EcmScoreInfo* prevEsiPtr=&ecmScrInfoForState[idx];
   
       // Grow new esi for arc if necessary
-  while(ecmScrInfoForArcVec[wgArcId].size()<wgArc.words.size())
+  while(ecmScrInfoForArcVec[wgArcId].size()<numWords)
   {
     EcmScoreInfo esi;
     ecmScrInfoForArcVec[wgArcId].push_back(esi);
   }
 
-  for(unsigned int w=0;w<wgArc.words.size();++w)
+  for(unsigned int w=0;w<numWords;++w)
   {
-        // Extend ecm score info
-    ecm_wg_ptr->extendEsi(prefixDiffVec,
-                          prevEsi,
-                          wgArc.words[w],
-                          ecmScrInfoForArcVec[wgArcId][w]);
-    prevEsi=ecmScrInfoForArcVec[wgArcId][w];
+    if(w<numSharedEsiVec[wgArcId])
+    {
+          // Copy ecm score info from an arc with the same predecessor
+          // state and words, which has already been updated given that
+          // the arcs are processed in order
+      ecmScrInfoForArcVec[wgArcId][w]=ecmScrInfoForArcVec[esiSrcArcVec[wgArcId]][w];
+    }
+    else
+    {
+          // Extend ecm score info
+      ecm_wg_ptr->extendEsi(prefixDiffVec,
+                            *prevEsiPtr,
+                            wg_ptr->getArcWord(wgArcId,w),
+                            esiCache,
+                            ecmScrInfoForArcVec[wgArcId][w]);
+    }
+    prevEsiPtr=&ecmScrInfoForArcVec[wgArcId][w];
   }
 }
 
@@ -803,12 +872,9 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateBestScoresForState(WordGraphArcId wgA
                                                               unsigned int prefDiffSize,
                                                               unsigned int /*verbose*//*=0*/)
 {
-      // Obtain arc from arc identifier
-  WordGraphArc wgArc=wg_ptr->wordGraphArcId2WordGraphArc(wgArcId);
-
       // Retrieve predecessor and successor states
-  HypStateIndex predIdx=wgArc.predStateIndex;
-  HypStateIndex succIdx=wgArc.succStateIndex;
+  HypStateIndex predIdx=wg_ptr->getArcPredStateIndex(wgArcId);
+  HypStateIndex succIdx=wg_ptr->getArcSuccStateIndex(wgArcId);
 
       // Check if ecmScrInfoForArcVec[wgArcId] is
       // empty. ecmScrInfoForArcVec[wgArcId] may be empty if wgArc has
@@ -822,7 +888,7 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateBestScoresForState(WordGraphArcId wgA
       
       // Obtain wg score for successor state from the wg score
       // vector of the predecessor state
-  Score wgScr=wgScoreForState[predIdx]+wgArc.arcScore;
+  Score wgScr=wgScoreForState[predIdx]+wg_ptr->getArcScore(wgArcId);
 
   // Update vector of best scores for state
 
@@ -876,42 +942,75 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestCorrections(std::vector<std::string>
                                                        const NbestHypSubStates& nbestHypSubStates,
                                                        unsigned int verbose/*=0*/)
 {
-      // Generate list with the n-best corrections given lists with
-      // n-best hypothesis states and n-best hypothesis sub-states
-  NbestCorrections nbestCorrections;
-  nbestCorrections.clear();
-
-      // Iterate over the n-best list of states
-  NbestHypStates::const_iterator nbestHypStatesIter;
-  for(nbestHypStatesIter=nbestHypStates.begin();nbestHypStatesIter!=nbestHypStates.end();++nbestHypStatesIter)
+      // Merge the n-best lists of states and sub-states by score
+      // (states go first in case of ties)
+  std::vector<CorrTask> corrTasks;
+  NbestHypStates::const_iterator nbestHypStatesIter=nbestHypStates.begin();
+  NbestHypSubStates::const_iterator nbestHypSubStatesIter=nbestHypSubStates.begin();
+  while(nbestHypStatesIter!=nbestHypStates.end() || nbestHypSubStatesIter!=nbestHypSubStates.end())
   {
-    HypStateIndex hypStateIndex=nbestHypStatesIter->second;
-    
-        // Obtain suffix
-    std::vector<std::string> correction=obtainCorrForHypState(prefixVec,hypStateIndex,rejectedWords,verbose);
-       
-        // Insert correction
-    nbestCorrections.insert(std::make_pair(nbestHypStatesIter->first,correction));
-        // Prune n-best corrections if necessary
-    if(nbestCorrections.size()>n)
-      removeLastFromNbestCorrs(nbestCorrections);
+    CorrTask corrTask;
+    corrTask.wgpPtr=this;
+    corrTask.prefixVecPtr=&prefixVec;
+    corrTask.rejectedWordsPtr=&rejectedWords;
+    if(nbestHypSubStatesIter==nbestHypSubStates.end() ||
+       (nbestHypStatesIter!=nbestHypStates.end() && nbestHypStatesIter->first>=nbestHypSubStatesIter->first))
+    {
+      corrTask.score=nbestHypStatesIter->first;
+      corrTask.isSubState=false;
+      corrTask.hypStateIndex=nbestHypStatesIter->second;
+      ++nbestHypStatesIter;
+    }
+    else
+    {
+      corrTask.score=nbestHypSubStatesIter->first;
+      corrTask.isSubState=true;
+      corrTask.hypSubStateIdx=nbestHypSubStatesIter->second;
+      ++nbestHypSubStatesIter;
+    }
+    corrTasks.push_back(corrTask);
   }
 
-      // Iterate over the n-best list of sub-states
-  NbestHypSubStates::const_iterator nbestHypSubStatesIter;
-  for(nbestHypSubStatesIter=nbestHypSubStates.begin();nbestHypSubStatesIter!=nbestHypSubStates.end();++nbestHypSubStatesIter)
+      // Obtain corrections by batches until n distinct corrections are
+      // found. Each batch contains as many tasks as corrections are
+      // still needed, so no work is wasted if there are no duplicates
+  NbestCorrections nbestCorrections;
+  std::set<std::vector<std::string> > distinctCorrs;
+  unsigned int nextTask=0;
+  while(distinctCorrs.size()<n && nextTask<corrTasks.size())
   {
-    HypSubStateIdx hypSubStateIdx=nbestHypSubStatesIter->second;
-    
-        // Obtain suffix
-    std::vector<std::string> correction=obtainCorrForHypSubState(prefixVec,hypSubStateIdx,verbose);
+    unsigned int batchEnd=nextTask+(n-distinctCorrs.size());
+    if(batchEnd>corrTasks.size())
+      batchEnd=corrTasks.size();
 
-        // Insert correction
-    nbestCorrections.insert(std::make_pair(nbestHypSubStatesIter->first,correction));
+        // Execute tasks (verbose output of different tasks would be
+        // mixed up if they were executed concurrently)
+    if(batchEnd-nextTask>1 && !verbose)
+    {
+      ThreadPool& corrThreadPool=getCorrThreadPool();
+      ThreadPool::TaskGroup taskGroup;
+      for(unsigned int i=nextTask;i<batchEnd;++i)
+        corrThreadPool.addTask(obtainCorrForTask,(void*)&corrTasks[i],taskGroup);
+      corrThreadPool.waitForTasks(taskGroup);
+    }
+    else
+    {
+      for(unsigned int i=nextTask;i<batchEnd;++i)
+      {
+        if(corrTasks[i].isSubState)
+          corrTasks[i].correction=obtainCorrForHypSubState(prefixVec,corrTasks[i].hypSubStateIdx,verbose);
+        else
+          corrTasks[i].correction=obtainCorrForHypState(prefixVec,corrTasks[i].hypStateIndex,rejectedWords,verbose);
+      }
+    }
 
-        // Prune n-best corrections if necessary
-    if(nbestCorrections.size()>n)
-      removeLastFromNbestCorrs(nbestCorrections);
+        // Insert distinct corrections in score order
+    for(unsigned int i=nextTask;i<batchEnd;++i)
+    {
+      if(distinctCorrs.insert(corrTasks[i].correction).second)
+        nbestCorrections.insert(std::make_pair(corrTasks[i].score,corrTasks[i].correction));
+    }
+    nextTask=batchEnd;
   }
 
       // Print corrections
@@ -935,6 +1034,28 @@ WgProcessorForAnlp<ECM_FOR_WG>::obtainNbestCorrections(std::vector<std::string>
   return nbestCorrections;
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+ThreadPool& WgProcessorForAnlp<ECM_FOR_WG>::getCorrThreadPool(void)
+{
+  static ThreadPool corrThreadPool(WGP_NUM_CORR_THREADS);
+  return corrThreadPool;
+}
+
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::obtainCorrForTask(void* taskData)
+{
+  CorrTask* corrTaskPtr=(CorrTask*) taskData;
+  if(corrTaskPtr->isSubState)
+    corrTaskPtr->correction=corrTaskPtr->wgpPtr->obtainCorrForHypSubState(*corrTaskPtr->prefixVecPtr,
+                                                                          corrTaskPtr->hypSubStateIdx);
+  else
+    corrTaskPtr->correction=corrTaskPtr->wgpPtr->obtainCorrForHypState(*corrTaskPtr->prefixVecPtr,
+                                                                       corrTaskPtr->hypStateIndex,
+                                                                       *corrTaskPtr->rejectedWordsPtr);
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 std::vector<std::string>
@@ -1269,6 +1390,8 @@ void WgProcessorForAnlp<ECM_FOR_WG>::clear(void)
   restScores.clear();
   ecmScrInfoForState.clear();
   ecmScrInfoForArcVec.clear();
+  esiSrcArcVec.clear();
+  numSharedEsiVec.clear();
   wgScoreForState.clear();
   bestScoresForState.clear();
   bestPredsForState.clear();
@@ -1287,9 +1410,10 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose/*=0*/)
       // Clear previous prefix vector
   previousPrefixVec.clear();
 
-      // Generate rest scores for word-graph
+      // Obtain rest scores for word-graph (they are cached in the
+      // word-graph for its current component weights)
   restScores.clear();
-  wg_ptr->calcRestScores(restScores);
+  wg_ptr->obtainRestScores(restScores);
 
       // Make room for the ecmScrInfoForState and the ecmScrInfoForArcVec
       // variables
@@ -1324,6 +1448,9 @@ void WgProcessorForAnlp<ECM_FOR_WG>::initVars(unsigned int verbose/*=0*/)
     bestPredsForState.insert(bestPredsForState.begin(),wg_ptr->numStates(),wgArcIdVec);
   }
 
+      // Determine which ecm score info can be shared between arcs
+  initEsiSharingInfo();
+
       // Init wgp info for hypothesis states and arcs
   if(wg_ptr!=NULL && ecm_wg_ptr!=NULL)
   {
@@ -1396,6 +1523,56 @@ void WgProcessorForAnlp<ECM_FOR_WG>::updateSizeOfVars(const std::vector<std::str
   }
 }
 
+//---------------------------------------
+template<class ECM_FOR_WG>
+void WgProcessorForAnlp<ECM_FOR_WG>::initEsiSharingInfo(void)
+{
+  esiSrcArcVec.clear();
+  numSharedEsiVec.clear();
+  if(wg_ptr==NULL)
+    return;
+  esiSrcArcVec.insert(esiSrcArcVec.begin(),wg_ptr->numArcs(),INVALID_ARCID);
+  numSharedEsiVec.insert(numSharedEsiVec.begin(),wg_ptr->numArcs(),0);
+
+      // Trie nodes are identified by integers, the nodes for the
+      // predecessor states of the arcs are identified by the state
+      // indices. Each child is indexed by its parent and word index,
+      // and stores its identifier and the first arc including it
+  std::unordered_map<unsigned long long,std::pair<unsigned int,WordGraphArcId> > trieChildren;
+  unsigned int numTrieNodes=wg_ptr->numStates();
+
+      // Iterate over the arcs of the word-graph
+  std::pair<WordGraphArcId,WordGraphArcId> arcIdxRange=wg_ptr->getArcIndexRange();
+  for(WordGraphArcId aIdx=arcIdxRange.first;aIdx<=arcIdxRange.second;++aIdx)
+  {
+    if(wg_ptr->arcPruned(aIdx))
+      continue;
+
+    unsigned int node=wg_ptr->getArcPredStateIndex(aIdx);
+    for(unsigned int w=0;w<wg_ptr->getArcNumWords(aIdx);++w)
+    {
+      unsigned long long key=(((unsigned long long)node)<<32) | (unsigned long long)wg_ptr->getArcWordIndex(aIdx,w);
+      std::unordered_map<unsigned long long,std::pair<unsigned int,WordGraphArcId> >::const_iterator childIter=trieChildren.find(key);
+      if(childIter==trieChildren.end())
+      {
+            // Add new node, the remaining words of the arc are not
+            // shared with previous arcs
+        node=numTrieNodes;
+        ++numTrieNodes;
+        trieChildren[key]=std::make_pair(node,aIdx);
+      }
+      else
+      {
+            // The first arc including the node shares the words of the
+            // current arc up to position w
+        node=childIter->second.first;
+        esiSrcArcVec[aIdx]=childIter->second.second;
+        numSharedEsiVec[aIdx]=w+1;
+      }
+    }
+  }
+}
+
 //---------------------------------------
 template<class ECM_FOR_WG>
 bool WgProcessorForAnlp<ECM_FOR_WG>::print(const char* filename)const
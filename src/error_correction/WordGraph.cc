@@ -25,12 +25,58 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "WordGraph.h"
+#include "WgContainerReader.h"
+#include "MathFuncs.h"
 
 //--------------- WordGraph class function definitions
 
 WordGraph::WordGraph(void)
 {
-  initialStateScore=0;
+  pthread_mutex_init(&adjacencyMut,NULL);
+  pthread_mutex_init(&heurCacheMut,NULL);
+  clear();
+}
+
+//---------------------------------------
+WordGraph::WordGraph(const WordGraph& wg)
+{
+  pthread_mutex_init(&adjacencyMut,NULL);
+  pthread_mutex_init(&heurCacheMut,NULL);
+  *this=wg;
+}
+
+//---------------------------------------
+WordGraph& WordGraph::operator=(const WordGraph& wg)
+{
+  if(this!=&wg)
+  {
+    arcPredStates=wg.arcPredStates;
+    arcSuccStates=wg.arcSuccStates;
+    arcScores=wg.arcScores;
+    arcWordBegin=wg.arcWordBegin;
+    arcWordIndices=wg.arcWordIndices;
+    arcsPruned=wg.arcsPruned;
+    vocab=wg.vocab;
+    vocabMap=wg.vocabMap;
+    numStatesVar=wg.numStatesVar;
+    finalStateSet=wg.finalStateSet;
+    initialStateScore=wg.initialStateScore;
+    compWeights=wg.compWeights;
+    scrCompsVec=wg.scrCompsVec;
+
+        // Adjacency is rebuilt when required
+    adjacencyOutdated=true;
+
+        // Search heuristics are copied together with the word graph
+    pthread_mutex_lock(&wg.heurCacheMut);
+    HeurCache heurCacheAux=wg.heurCache;
+    pthread_mutex_unlock(&wg.heurCacheMut);
+    pthread_mutex_lock(&heurCacheMut);
+    heurCache.swap(heurCacheAux);
+    pthread_mutex_unlock(&heurCacheMut);
+    arcScoresGivenByWeights=wg.arcScoresGivenByWeights;
+  }
+  return *this;
 }
 
 //---------------------------------------
@@ -39,15 +85,21 @@ void WordGraph::setCompWeights(const std::vector<std::pair<std::string,float> >&
       // Set new component weight vector
   compWeights=_compWeights;
 
+      // Discard cached heuristics if they were obtained for arc scores
+      // not given by the component weights
+  if(!arcScoresGivenByWeights)
+    invalidateHeurCache();
+
       // Re-score arcs
   rescoreArcsGivenWeights(compWeights);
+  arcScoresGivenByWeights=true;
 }
 
 //---------------------------------------
 void WordGraph::rescoreArcsGivenWeights(const std::vector<std::pair<std::string,float> >& _compWeights)
 {
       // Iterate over arcs
-  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
   {
         // Check if there is a component vector for wgArcId
     if(wgArcId<scrCompsVec.size())
@@ -57,9 +109,9 @@ void WordGraph::rescoreArcsGivenWeights(const std::vector<std::pair<std::string,
       if(scrCompsVec[wgArcId].size()==_compWeights.size())
       {
             // Re-score arc
-        wordGraphArcs[wgArcId].arcScore=0;
+        arcScores[wgArcId]=0;
         for(unsigned int i=0;i<_compWeights.size();++i)
-          wordGraphArcs[wgArcId].arcScore+=_compWeights[i].second * scrCompsVec[wgArcId][i];
+          arcScores[wgArcId]+=_compWeights[i].second * scrCompsVec[wgArcId][i];
       }
     }
   }
@@ -77,48 +129,64 @@ void WordGraph::addArc(HypStateIndex predStateIndex,
                        const std::vector<std::string>& words,
                        Score arcScore)
 {
-  WordGraphArc wordGraphArc;
-  WordGraphArcId wordGraphArcId;
-  
-      // Fill wordGraphArc data structure
-  wordGraphArc.predStateIndex=predStateIndex;
-  wordGraphArc.succStateIndex=succStateIndex;
-  wordGraphArc.arcScore=arcScore;
-  wordGraphArc.words=words;
+      // Obtain word indices
+  std::vector<WgWordIndex> wordIndices(words.size());
+  for(unsigned int i=0;i<words.size();++i)
+    wordIndices[i]=addWordToVocab(words[i]);
 
-      // Insert arc and retrieve index
-  wordGraphArcs.push_back(wordGraphArc);
-  wordGraphArcId=wordGraphArcs.size()-1;
+      // Add arc
+  addArcWordIndices(predStateIndex,
+                    succStateIndex,
+                    wordIndices.empty() ? NULL : &wordIndices[0],
+                    wordIndices.size(),
+                    arcScore);
+}
 
-      // Register arc as not selected for pruning
-  arcsPruned.push_back(false);
-  
-      // Add the new arc   
-  if(succStateIndex<wordGraphStates.size())
-  {
-        // Add arc to predecessor and succesor states
-    wordGraphStates[predStateIndex].arcsToSuccStates.push_back(wordGraphArcId);
-    wordGraphStates[succStateIndex].arcsToPredStates.push_back(wordGraphArcId);
-  }
+//---------------------------------------
+WgWordIndex WordGraph::addWordToVocab(const std::string& word)
+{
+  std::unordered_map<std::string,WgWordIndex>::const_iterator vocabIter=vocabMap.find(word);
+  if(vocabIter!=vocabMap.end())
+    return vocabIter->second;
   else
   {
-        // There were not any arcs to the successor state
-    WordGraphStateData wordGraphStateData;
+    WgWordIndex wordIndex=vocab.size();
+    vocab.push_back(word);
+    vocabMap[word]=wordIndex;
+    return wordIndex;
+  }
+}
 
-        // Add the required number of empty elements to wordGraphStates
-    while(succStateIndex>=wordGraphStates.size())
-      wordGraphStates.push_back(wordGraphStateData);
+//---------------------------------------
+void WordGraph::addArcWordIndices(HypStateIndex predStateIndex,
+                                  HypStateIndex succStateIndex,
+                                  const WgWordIndex* wordIndices,
+                                  unsigned int numWords,
+                                  Score arcScore)
+{
+      // Store arc data
+  arcPredStates.push_back(predStateIndex);
+  arcSuccStates.push_back(succStateIndex);
+  arcScores.push_back(arcScore);
+  arcWordIndices.insert(arcWordIndices.end(),wordIndices,wordIndices+numWords);
+  arcWordBegin.push_back(arcWordIndices.size());
 
-        // Add arc to succesor state
-    wordGraphStates[predStateIndex].arcsToSuccStates.push_back(wordGraphArcId);
+      // Register arc as not selected for pruning
+  arcsPruned.push_back(false);
 
-        // Add arc to predecessor state
-    wordGraphStates[succStateIndex].arcsToPredStates.push_back(wordGraphArcId);
-  }
+      // Update number of states
+  if(predStateIndex>=numStatesVar)
+    numStatesVar=predStateIndex+1;
+  if(succStateIndex>=numStatesVar)
+    numStatesVar=succStateIndex+1;
 
       // Add empty score vector
   std::vector<Score> emptyScrVec;
   scrCompsVec.push_back(emptyScrVec);
+
+  adjacencyOutdated=true;
+  arcScoresGivenByWeights=false;
+  invalidateHeurCache();
 }
 
 //---------------------------------------
@@ -133,7 +201,7 @@ void WordGraph::addArcWithScrComps(HypStateIndex predStateIndex,
 
       // Store components
   std::vector<Score> emptyScrVec;
-  while(scrCompsVec.size()!=wordGraphArcs.size())
+  while(scrCompsVec.size()!=arcScores.size())
   {
     scrCompsVec.push_back(emptyScrVec);
   }
@@ -149,6 +217,7 @@ void WordGraph::addFinalState(HypStateIndex finalStateIndex)
   if(finalStateSetIter==finalStateSet.end())
   {
     finalStateSet.insert(finalStateIndex);
+    invalidateHeurCache();
   }
 }
 
@@ -156,6 +225,7 @@ void WordGraph::addFinalState(HypStateIndex finalStateIndex)
 void WordGraph::setInitialStateScore(Score _initialStateScore)
 {
   initialStateScore=_initialStateScore;
+  invalidateHeurCache();
 }
 
 //---------------------------------------
@@ -167,51 +237,104 @@ Score WordGraph::getInitialStateScore(void)const
 //---------------------------------------
 std::pair<HypStateIndex,HypStateIndex> WordGraph::getHypStateIndexRange(void)const
 {
-  if(wordGraphStates.empty())
+  if(numStatesVar==0)
     return std::make_pair(INVALID_STATE,INVALID_STATE);
   else
-    return std::make_pair(INITIAL_STATE,wordGraphStates.size()-1);
+    return std::make_pair(INITIAL_STATE,numStatesVar-1);
 }
 
 //---------------------------------------
 std::pair<WordGraphArcId,WordGraphArcId> WordGraph::getArcIndexRange(void)const
 {
-  if(wordGraphArcs.empty())
+  if(arcScores.empty())
     return std::make_pair(INVALID_ARCID,INVALID_ARCID);  
   else
-    return std::make_pair(0,wordGraphArcs.size()-1);  
+    return std::make_pair(0,arcScores.size()-1);  
 }
 
 //---------------------------------------
 WordGraphStateData WordGraph::getWordGraphStateData(HypStateIndex hypStateIndex)const
 {  
-  if(hypStateIndex<wordGraphStates.size())
+  WordGraphStateData wordGraphStateData;
+  if(hypStateIndex<numStatesVar)
   {
-    return wordGraphStates[hypStateIndex];
-  }
-  else
-  {
-    WordGraphStateData wordGraphStateData;
-    return wordGraphStateData;
+    updateAdjacency();
+    wordGraphStateData.arcsToPredStates.assign(predArcIds.begin()+predArcBegin[hypStateIndex],
+                                               predArcIds.begin()+predArcBegin[hypStateIndex+1]);
+    wordGraphStateData.arcsToSuccStates.assign(succArcIds.begin()+succArcBegin[hypStateIndex],
+                                               succArcIds.begin()+succArcBegin[hypStateIndex+1]);
   }
+  return wordGraphStateData;
 }
 
 //---------------------------------------
 WordGraphArc WordGraph::wordGraphArcId2WordGraphArc(WordGraphArcId wordGraphArcId)const
 {
-  if(wordGraphArcId<wordGraphArcs.size())
+  WordGraphArc wordGraphArc;
+  if(wordGraphArcId<arcScores.size())
   {
-    return wordGraphArcs[wordGraphArcId];
+    wordGraphArc.predStateIndex=arcPredStates[wordGraphArcId];
+    wordGraphArc.succStateIndex=arcSuccStates[wordGraphArcId];
+    wordGraphArc.arcScore=arcScores[wordGraphArcId];
+    wordGraphArc.words.reserve(getArcNumWords(wordGraphArcId));
+    for(unsigned int i=arcWordBegin[wordGraphArcId];i<arcWordBegin[wordGraphArcId+1];++i)
+      wordGraphArc.words.push_back(vocab[arcWordIndices[i]]);
   }
   else
   {
-    WordGraphArc wordGraphArc;
     wordGraphArc.predStateIndex=INVALID_STATE;
     wordGraphArc.succStateIndex=INVALID_STATE;
     wordGraphArc.arcScore=0;
-    
-    return wordGraphArc;
   }
+  return wordGraphArc;
+}
+
+//---------------------------------------
+HypStateIndex WordGraph::getArcPredStateIndex(WordGraphArcId wordGraphArcId)const
+{
+  return arcPredStates[wordGraphArcId];
+}
+
+//---------------------------------------
+HypStateIndex WordGraph::getArcSuccStateIndex(WordGraphArcId wordGraphArcId)const
+{
+  return arcSuccStates[wordGraphArcId];
+}
+
+//---------------------------------------
+Score WordGraph::getArcScore(WordGraphArcId wordGraphArcId)const
+{
+  return arcScores[wordGraphArcId];
+}
+
+//---------------------------------------
+void WordGraph::getArcScoreComps(WordGraphArcId wordGraphArcId,
+                                 std::vector<Score>& scoreComps)const
+{
+  if(wordGraphArcId<scrCompsVec.size())
+    scoreComps=scrCompsVec[wordGraphArcId];
+  else
+    scoreComps.clear();
+}
+
+//---------------------------------------
+unsigned int WordGraph::getArcNumWords(WordGraphArcId wordGraphArcId)const
+{
+  return arcWordBegin[wordGraphArcId+1]-arcWordBegin[wordGraphArcId];
+}
+
+//---------------------------------------
+WgWordIndex WordGraph::getArcWordIndex(WordGraphArcId wordGraphArcId,
+                                       unsigned int w)const
+{
+  return arcWordIndices[arcWordBegin[wordGraphArcId]+w];
+}
+
+//---------------------------------------
+const std::string& WordGraph::getArcWord(WordGraphArcId wordGraphArcId,
+                                         unsigned int w)const
+{
+  return vocab[arcWordIndices[arcWordBegin[wordGraphArcId]+w]];
 }
 
 //---------------------------------------
@@ -233,16 +356,16 @@ void WordGraph::getArcsToPredStates(HypStateIndex hypStateIndex,
 void WordGraph::getArcIdsToPredStates(HypStateIndex hypStateIndex,
                                       std::vector<WordGraphArcId>& wgArcIds)const
 {
-  if(hypStateIndex<wordGraphStates.size())
+  if(hypStateIndex<numStatesVar)
   {
-    std::vector<WordGraphArcId>::const_iterator arcIdVecIter;
+    updateAdjacency();
 
     wgArcIds.clear();
         // Iterate over the arcs to predecessors
-    for(arcIdVecIter=wordGraphStates[hypStateIndex].arcsToPredStates.begin();arcIdVecIter!=wordGraphStates[hypStateIndex].arcsToPredStates.end();++arcIdVecIter)
+    for(unsigned int i=predArcBegin[hypStateIndex];i<predArcBegin[hypStateIndex+1];++i)
     {
-      if(!arcsPruned[*arcIdVecIter])
-        wgArcIds.push_back(*arcIdVecIter);
+      if(!arcsPruned[predArcIds[i]])
+        wgArcIds.push_back(predArcIds[i]);
     }
   }
   else
@@ -270,16 +393,16 @@ void WordGraph::getArcsToSuccStates(HypStateIndex hypStateIndex,
 void WordGraph::getArcIdsToSuccStates(HypStateIndex hypStateIndex,
                                       std::vector<WordGraphArcId>& wgArcIds)const
 {
-  if(hypStateIndex<wordGraphStates.size())
+  if(hypStateIndex<numStatesVar)
   {
-    std::vector<WordGraphArcId>::const_iterator arcIdVecIter;
+    updateAdjacency();
 
     wgArcIds.clear();
         // Iterate over the arcs to succesors
-    for(arcIdVecIter=wordGraphStates[hypStateIndex].arcsToSuccStates.begin();arcIdVecIter!=wordGraphStates[hypStateIndex].arcsToSuccStates.end();++arcIdVecIter)
+    for(unsigned int i=succArcBegin[hypStateIndex];i<succArcBegin[hypStateIndex+1];++i)
     {
-      if(!arcsPruned[*arcIdVecIter])
-        wgArcIds.push_back(*arcIdVecIter);
+      if(!arcsPruned[succArcIds[i]])
+        wgArcIds.push_back(succArcIds[i]);
     }
   }
   else
@@ -307,17 +430,39 @@ bool WordGraph::stateIsFinal(HypStateIndex hypStateIndex)const
     return true;
 }
 
+//---------------------------------------
+size_t WordGraph::getVocabSize(void)const
+{
+  return vocab.size();
+}
+
+//---------------------------------------
+const std::string& WordGraph::wordIndexToString(WgWordIndex wordIndex)const
+{
+  return vocab[wordIndex];
+}
+
+//---------------------------------------
+WgWordIndex WordGraph::stringToWordIndex(const std::string& word)const
+{
+  std::unordered_map<std::string,WgWordIndex>::const_iterator vocabIter=vocabMap.find(word);
+  if(vocabIter!=vocabMap.end())
+    return vocabIter->second;
+  else
+    return INVALID_WG_WORD_INDEX;
+}
+
 //---------------------------------------
 unsigned int WordGraph::getNumberOfPrunedAndNonPrunedArcs(void)const
 {
-  return wordGraphArcs.size();
+  return arcScores.size();
 }
 
 //---------------------------------------
 unsigned int WordGraph::getNumberOfNonPrunedArcs(void)const
 {
   unsigned int numArcsNotPruned=0;
-  for(unsigned int i=0;i<wordGraphArcs.size();++i)
+  for(unsigned int i=0;i<arcScores.size();++i)
   {
     if(!arcPruned(i))
       ++numArcsNotPruned;
@@ -334,6 +479,7 @@ float WordGraph::calculateDensity(unsigned int numRefSentWords)const
 //---------------------------------------
 unsigned int WordGraph::prune(float threshold)
 {
+  invalidateHeurCache();
   if(threshold==UNLIMITED_DENSITY)
   {
         // unlimited density, every arc is marked as not pruned
@@ -356,6 +502,180 @@ bool WordGraph::arcPruned(WordGraphArcId wordGraphArcId)const
   return arcsPruned[wordGraphArcId];
 }
 
+//---------------------------------------
+Score WordGraph::calcArcPosteriors(std::vector<Score>& arcLogPosteriors,
+                                   float scaleFactor/*=1.0*/)const
+{
+      // Obtain forward and backward log-probabilities
+  std::vector<Score> fwdLogProbs;
+  std::vector<Score> bwdLogProbs;
+  calcFwdBwdLogProbs(fwdLogProbs,bwdLogProbs,scaleFactor);
+
+  return calcArcPosteriorsGivenFwdBwd(fwdLogProbs,bwdLogProbs,scaleFactor,arcLogPosteriors);
+}
+
+//---------------------------------------
+Score WordGraph::calcArcPosteriorsGivenFwdBwd(const std::vector<Score>& fwdLogProbs,
+                                              const std::vector<Score>& bwdLogProbs,
+                                              float scaleFactor,
+                                              std::vector<Score>& arcLogPosteriors)const
+{
+      // Obtain log-probability of the complete paths
+  Score totalLogProb=SMALL_SCORE;
+  if(!empty())
+    totalLogProb=bwdLogProbs[INITIAL_STATE];
+
+      // Obtain arc posteriors
+  arcLogPosteriors.clear();
+  arcLogPosteriors.insert(arcLogPosteriors.begin(),arcScores.size(),SMALL_SCORE);
+  if(totalLogProb==SMALL_SCORE)
+    return totalLogProb;
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    Score fwdLogProb=fwdLogProbs[arcPredStates[wgArcId]];
+    Score bwdLogProb=bwdLogProbs[arcSuccStates[wgArcId]];
+    if(!arcPruned(wgArcId) && fwdLogProb!=SMALL_SCORE && bwdLogProb!=SMALL_SCORE)
+    {
+      Score logPosterior=fwdLogProb+scaleFactor*arcScores[wgArcId]+bwdLogProb-totalLogProb;
+      if(logPosterior>0) logPosterior=0;
+      arcLogPosteriors[wgArcId]=logPosterior;
+    }
+  }
+  return totalLogProb;
+}
+
+//---------------------------------------
+unsigned int WordGraph::pruneGivenPosteriors(float threshold,
+                                             float scaleFactor/*=1.0*/)
+{
+  if(empty() || threshold<=0)
+    return 0;
+  
+      // Obtain arc posteriors
+  std::vector<Score> arcLogPosteriors;
+  calcArcPosteriors(arcLogPosteriors,scaleFactor);
+
+      // Obtain best path scores to identify the arcs of the best path
+  std::vector<Score> restScores;
+  calcRestScores(restScores);
+  std::set<WordGraphArcId> emptyWgArcIdSet;
+  std::vector<Score> prevScores;
+  std::vector<WordGraphArc> bestPredArcForStateVec;
+  calcPrevScores(INITIAL_STATE,
+                 emptyWgArcIdSet,
+                 prevScores,
+                 bestPredArcForStateVec);
+  Score bestScore=restScores[INITIAL_STATE]+initialStateScore;
+
+      // Prune arcs
+  invalidateHeurCache();
+  Score logThreshold=log(threshold);
+  unsigned int numPrunedArcs=0;
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    if(!arcPruned(wgArcId) && arcLogPosteriors[wgArcId]<logThreshold)
+    {
+      Score bestScoreAssociatedToArc=prevScores[arcPredStates[wgArcId]]+arcScores[wgArcId]+restScores[arcSuccStates[wgArcId]];
+      if(bestScoreAssociatedToArc<bestScore-EPSILON*fabs(bestScore))
+      {
+        arcsPruned[wgArcId]=true;
+        ++numPrunedArcs;
+      }
+    }
+  }
+  return numPrunedArcs;
+}
+
+//---------------------------------------
+void WordGraph::calcArcWordConfidences(std::vector<std::vector<float> >& arcWordConfids,
+                                       std::vector<Score>& arcLogPosteriors,
+                                       float scaleFactor/*=1.0*/)const
+{
+      // Obtain forward log-probabilities and arc posteriors with a
+      // single forward-backward pass
+  std::vector<Score> fwdLogProbs;
+  std::vector<Score> bwdLogProbs;
+  calcFwdBwdLogProbs(fwdLogProbs,bwdLogProbs,scaleFactor);
+  calcArcPosteriorsGivenFwdBwd(fwdLogProbs,bwdLogProbs,scaleFactor,arcLogPosteriors);
+  
+      // Obtain expected number of words from the initial state to each
+      // state
+  std::vector<double> expectedPosVec(numStatesVar,0);
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    HypStateIndex predStateIndex=arcPredStates[wgArcId];
+    HypStateIndex succStateIndex=arcSuccStates[wgArcId];
+    if(!arcPruned(wgArcId) && fwdLogProbs[predStateIndex]!=SMALL_SCORE)
+    {
+      double weight=exp(fwdLogProbs[predStateIndex]+scaleFactor*arcScores[wgArcId]-fwdLogProbs[succStateIndex]);
+      expectedPosVec[succStateIndex]+=weight*(expectedPosVec[predStateIndex]+getArcNumWords(wgArcId));
+    }
+  }
+
+      // Group word occurrences by word, each one given by its
+      // expected position and the posterior of its arc
+  std::vector<std::vector<std::pair<double,double> > > occurrencesForWord(vocab.size());
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    if(arcLogPosteriors[wgArcId]!=SMALL_SCORE)
+    {
+      double posterior=exp(arcLogPosteriors[wgArcId]);
+      for(unsigned int w=0;w<getArcNumWords(wgArcId);++w)
+      {
+        double pos=expectedPosVec[arcPredStates[wgArcId]]+w;
+        occurrencesForWord[getArcWordIndex(wgArcId,w)].push_back(std::make_pair(pos,posterior));
+      }
+    }
+  }
+
+      // Sort occurrences by position and obtain accumulated posteriors
+  std::vector<std::vector<double> > accumPosteriorsForWord(vocab.size());
+  for(unsigned int i=0;i<occurrencesForWord.size();++i)
+  {
+    std::sort(occurrencesForWord[i].begin(),occurrencesForWord[i].end());
+    double accumPosterior=0;
+    for(unsigned int j=0;j<occurrencesForWord[i].size();++j)
+    {
+      accumPosterior+=occurrencesForWord[i][j].second;
+      accumPosteriorsForWord[i].push_back(accumPosterior);
+    }
+  }
+
+      // Obtain confidences
+  arcWordConfids.clear();
+  arcWordConfids.resize(arcScores.size());
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    if(arcLogPosteriors[wgArcId]!=SMALL_SCORE)
+    {
+      for(unsigned int w=0;w<getArcNumWords(wgArcId);++w)
+      {
+        WgWordIndex wordIndex=getArcWordIndex(wgArcId,w);
+        const std::vector<std::pair<double,double> >& occurrences=occurrencesForWord[wordIndex];
+        double pos=expectedPosVec[arcPredStates[wgArcId]]+w;
+        
+            // Sum posteriors of the occurrences in the
+            // [pos-WG_CONFID_POS_TOLERANCE,pos+WG_CONFID_POS_TOLERANCE]
+            // range
+        std::vector<std::pair<double,double> >::const_iterator firstIter=
+          std::lower_bound(occurrences.begin(),occurrences.end(),std::make_pair(pos-WG_CONFID_POS_TOLERANCE,0.0));
+        std::vector<std::pair<double,double> >::const_iterator lastIter=
+          std::upper_bound(occurrences.begin(),occurrences.end(),std::make_pair(pos+WG_CONFID_POS_TOLERANCE,2.0));
+        double confid=0;
+        if(lastIter!=occurrences.begin())
+        {
+          confid=accumPosteriorsForWord[wordIndex][lastIter-occurrences.begin()-1];
+          if(firstIter!=occurrences.begin())
+            confid-=accumPosteriorsForWord[wordIndex][firstIter-occurrences.begin()-1];
+        }
+        if(confid>1) confid=1;
+        if(confid<0) confid=0;
+        arcWordConfids[wgArcId].push_back(confid);
+      }
+    }
+  }
+}
+
 //---------------------------------------
 void WordGraph::obtainNbestList(unsigned int len,
                                 std::vector<std::pair<Score,std::string> >& nblist,
@@ -364,7 +684,7 @@ void WordGraph::obtainNbestList(unsigned int len,
                                 int verbosity/*=false*/)
 {
       // Check if word-graph is empty
-  if(wordGraphArcs.empty())
+  if(arcScores.empty())
   {
         // clear nblist and scoreCompsVec output variables
     nblist.clear();
@@ -391,6 +711,159 @@ void WordGraph::obtainNbestList(unsigned int len,
   }
 }
 
+//---------------------------------------
+void WordGraph::obtainNbestHyps(unsigned int len,
+                                std::vector<std::pair<Score,NbSearchHyp> >& nbestHyps,
+                                std::vector<std::vector<Score> >& scoreCompsVec)const
+{
+  nbestHyps.clear();
+  scoreCompsVec.clear();
+  if(arcScores.empty())
+    return;
+
+      // Initialize search information
+  KbestSearchInfo ksi;
+  ksi.derivsForState.resize(numStatesVar);
+  ksi.candsForState.resize(numStatesVar);
+  ksi.candsInitialized.resize(numStatesVar,false);
+
+  for(unsigned int k=0;k<len;++k)
+  {
+        // Obtain k'th best path from the initial state
+    if(!obtainKthBestDeriv(INITIAL_STATE,k,ksi))
+      break;
+
+        // Retrieve arcs of the path
+    NbSearchHyp hyp;
+    HypStateIndex idx=INITIAL_STATE;
+    unsigned int rank=k;
+    while(ksi.derivsForState[idx][rank].arcId!=INVALID_ARCID)
+    {
+      const KbestDeriv& deriv=ksi.derivsForState[idx][rank];
+      hyp.push_back(deriv.arcId);
+      idx=arcSuccStates[deriv.arcId];
+      rank=deriv.succRank;
+    }
+
+        // Obtain score and score components following the order of the
+        // arcs
+    Score score=initialStateScore;
+    std::vector<Score> scoreComps;
+    for(unsigned int i=0;i<hyp.size();++i)
+    {
+      score+=arcScores[hyp[i]];
+      if(hyp[i]<scrCompsVec.size())
+      {
+        if(i==0)
+          scoreComps=scrCompsVec[hyp[i]];
+        else
+        {
+          for(unsigned int j=0;j<scoreComps.size();++j)
+            scoreComps[j]+=scrCompsVec[hyp[i]][j];
+        }
+      }
+    }
+    nbestHyps.push_back(std::make_pair(score,hyp));
+    if(!scoreComps.empty())
+      scoreCompsVec.push_back(scoreComps);
+  }
+}
+
+//---------------------------------------
+bool WordGraph::kbestDerivLess(const KbestDeriv& d1,
+                               const KbestDeriv& d2)
+{
+      // Ties are broken in favour of the arcs with lower identifiers
+  if(d1.score!=d2.score)
+    return d1.score<d2.score;
+  else
+  {
+    if(d1.arcId!=d2.arcId)
+      return d1.arcId>d2.arcId;
+    else
+      return d1.succRank>d2.succRank;
+  }
+}
+
+//---------------------------------------
+void WordGraph::initKbestCands(HypStateIndex hypStateIndex,
+                               KbestSearchInfo& ksi)const
+{
+  ksi.candsInitialized[hypStateIndex]=true;
+
+      // Paths end when a final state is reached. The initial state is
+      // always expanded, as it is done in obtainNbestList()
+  if(hypStateIndex!=INITIAL_STATE && stateIsFinal(hypStateIndex))
+  {
+    KbestDeriv deriv;
+    deriv.score=0;
+    deriv.arcId=INVALID_ARCID;
+    deriv.succRank=0;
+    ksi.candsForState[hypStateIndex].push_back(deriv);
+    return;
+  }
+
+      // Add the best path through each arc
+  std::vector<WordGraphArcId> wgArcIds;
+  getArcIdsToSuccStates(hypStateIndex,wgArcIds);
+  for(unsigned int i=0;i<wgArcIds.size();++i)
+  {
+    if(!arcPruned(wgArcIds[i]))
+    {
+      HypStateIndex succIdx=arcSuccStates[wgArcIds[i]];
+      if(obtainKthBestDeriv(succIdx,0,ksi))
+      {
+        KbestDeriv deriv;
+        deriv.score=arcScores[wgArcIds[i]]+ksi.derivsForState[succIdx][0].score;
+        deriv.arcId=wgArcIds[i];
+        deriv.succRank=0;
+        ksi.candsForState[hypStateIndex].push_back(deriv);
+      }
+    }
+  }
+  std::make_heap(ksi.candsForState[hypStateIndex].begin(),ksi.candsForState[hypStateIndex].end(),kbestDerivLess);
+}
+
+//---------------------------------------
+bool WordGraph::obtainKthBestDeriv(HypStateIndex hypStateIndex,
+                                   unsigned int k,
+                                   KbestSearchInfo& ksi)const
+{
+  if(!ksi.candsInitialized[hypStateIndex])
+    initKbestCands(hypStateIndex,ksi);
+
+  while(ksi.derivsForState[hypStateIndex].size()<=k)
+  {
+        // Add the successor of the last path obtained for the state,
+        // which uses the next path of the same successor state
+    if(!ksi.derivsForState[hypStateIndex].empty())
+    {
+      KbestDeriv lastDeriv=ksi.derivsForState[hypStateIndex].back();
+      if(lastDeriv.arcId!=INVALID_ARCID)
+      {
+        HypStateIndex succIdx=arcSuccStates[lastDeriv.arcId];
+        if(obtainKthBestDeriv(succIdx,lastDeriv.succRank+1,ksi))
+        {
+          KbestDeriv deriv;
+          deriv.score=arcScores[lastDeriv.arcId]+ksi.derivsForState[succIdx][lastDeriv.succRank+1].score;
+          deriv.arcId=lastDeriv.arcId;
+          deriv.succRank=lastDeriv.succRank+1;
+          ksi.candsForState[hypStateIndex].push_back(deriv);
+          std::push_heap(ksi.candsForState[hypStateIndex].begin(),ksi.candsForState[hypStateIndex].end(),kbestDerivLess);
+        }
+      }
+    }
+
+        // Move the best candidate to the list of paths
+    if(ksi.candsForState[hypStateIndex].empty())
+      return false;
+    std::pop_heap(ksi.candsForState[hypStateIndex].begin(),ksi.candsForState[hypStateIndex].end(),kbestDerivLess);
+    ksi.derivsForState[hypStateIndex].push_back(ksi.candsForState[hypStateIndex].back());
+    ksi.candsForState[hypStateIndex].pop_back();
+  }
+  return true;
+}
+
 //---------------------------------------
 NbSearchHighLevelHyp WordGraph::hypToHighLevelHyp(const NbSearchHyp& hyp)
 {
@@ -404,11 +877,25 @@ NbSearchHighLevelHyp WordGraph::hypToHighLevelHyp(const NbSearchHyp& hyp)
 
 //---------------------------------------
 void WordGraph::obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState)
+{
+  pthread_mutex_lock(&heurCacheMut);
+  HeurCacheEntry& heurCacheEntry=getHeurCacheEntry();
+  if(!heurCacheEntry.nbSearchHeurCalculated)
+  {
+    calcNbSearchHeurInfo(heurCacheEntry.nbSearchHeur);
+    heurCacheEntry.nbSearchHeurCalculated=true;
+  }
+  heurForEachState=heurCacheEntry.nbSearchHeur;
+  pthread_mutex_unlock(&heurCacheMut);
+}
+
+//---------------------------------------
+void WordGraph::calcNbSearchHeurInfo(std::vector<Score>& heurForEachState)const
 {
       // Clear vector
   heurForEachState.clear();
       // Initialize costs
-  heurForEachState.insert(heurForEachState.begin(),wordGraphStates.size(),SMALL_SCORE);
+  heurForEachState.insert(heurForEachState.begin(),numStatesVar,SMALL_SCORE);
       // Set zero cost for final states
   FinalStateSet::const_iterator iter;
   for(iter=finalStateSet.begin();iter!=finalStateSet.end();++iter)
@@ -416,17 +903,16 @@ void WordGraph::obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState)
       
       // Explore arcs in reverse order
       // WARNING: arcs must be topologically ordered
-  if(!wordGraphArcs.empty())
+  if(!arcScores.empty())
   {
-    for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+    for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
     {
-      WordGraphArcId reverseWgArcId=wordGraphArcs.size()-wgArcId-1;
+      WordGraphArcId reverseWgArcId=arcScores.size()-wgArcId-1;
       if(!arcPruned(reverseWgArcId))
       {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(reverseWgArcId);
-        Score scr=wgArc.arcScore+heurForEachState[wgArc.succStateIndex];
-        if(heurForEachState[wgArc.predStateIndex]<scr)
-          heurForEachState[wgArc.predStateIndex]=scr;
+        Score scr=arcScores[reverseWgArcId]+heurForEachState[arcSuccStates[reverseWgArcId]];
+        if(heurForEachState[arcPredStates[reverseWgArcId]]<scr)
+          heurForEachState[arcPredStates[reverseWgArcId]]=scr;
       }
     }
   }
@@ -483,8 +969,7 @@ void WordGraph::nbSearch(unsigned int len,
           lastHypStateIndex=INITIAL_STATE;
         else
         {
-          WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second.back());
-          lastHypStateIndex=wgArc.succStateIndex;
+          lastHypStateIndex=arcSuccStates[scrHypPair.second.back()];
         }
         
             // Subtract heuristic
@@ -517,13 +1002,12 @@ void WordGraph::nbSearch(unsigned int len,
           {
             if(!arcPruned(wgArcIds[i]))
             {
-              WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcIds[i]);
               std::pair<Score,NbSearchHyp> newScrHypPair;
               newScrHypPair=scrHypPair;
                   // Obtain new score
-              newScrHypPair.first+=wgArc.arcScore;
+              newScrHypPair.first+=arcScores[wgArcIds[i]];
                   // Add heuristic
-              newScrHypPair.first+=heurForEachState[wgArc.succStateIndex];   
+              newScrHypPair.first+=heurForEachState[arcSuccStates[wgArcIds[i]]];   
                   // Add new arc
               newScrHypPair.second.push_back(wgArcIds[i]);
                   // Push into vector
@@ -531,7 +1015,7 @@ void WordGraph::nbSearch(unsigned int len,
 
               if(verbosity>=1)
               {
-                std::cerr<<"  Adding extension, score contribution: "<<wgArc.arcScore<<" ; successor state: "<<wgArc.succStateIndex<<std::endl;
+                std::cerr<<"  Adding extension, score contribution: "<<arcScores[wgArcIds[i]]<<" ; successor state: "<<arcSuccStates[wgArcIds[i]]<<std::endl;
               }
             }
           }
@@ -584,8 +1068,7 @@ void WordGraph::nbSearch(unsigned int len,
       std::cerr<<scrHypPair.first<<" ||| "<<translation<<" |||";
       for(unsigned int j=0;j<scrHypPair.second.size();++j)
       {
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(scrHypPair.second[j]);
-        HypStateIndex hidx=wgArc.succStateIndex;
+        HypStateIndex hidx=arcSuccStates[scrHypPair.second[j]];
         std::cerr<<" "<<hidx;
       }
       std::cerr<<std::endl;
@@ -599,8 +1082,7 @@ bool WordGraph::hypIsComplete(const NbSearchHyp& nbSearchHyp)
   if(nbSearchHyp.empty()) return false;
   else
   {
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(nbSearchHyp.back());
-    HypStateIndex hidx=wgArc.succStateIndex;
+    HypStateIndex hidx=arcSuccStates[nbSearchHyp.back()];
     if(stateIsFinal(hidx))
       return true;
     else
@@ -616,16 +1098,16 @@ std::string WordGraph::stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
   for(unsigned int i=0;i<nbSearchHyp.size();++i)
   {
     WordGraphArcId wgArcId=nbSearchHyp[i];
-    WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcId);
+    unsigned int numWords=getArcNumWords(wgArcId);
 
         // Add words to str
     if(i!=0)
       str=str+" ";
     
-    for(unsigned int k=0;k<wgArc.words.size();++k)
+    for(unsigned int k=0;k<numWords;++k)
     {
-      str=str+wgArc.words[k];
-      if(k!=wgArc.words.size()-1)
+      str=str+getArcWord(wgArcId,k);
+      if(k!=numWords-1)
         str=str+" ";
     }
 
@@ -655,17 +1137,19 @@ void WordGraph::obtainWgComposedOfUsefulStates(void)
     obtainUsefulStates(stateIsUsefulVec,remappedStates);
 
         // Save current arc information
-    WordGraphArcs wordGraphArcsAux=wordGraphArcs;
+    std::vector<HypStateIndex> arcPredStatesAux=arcPredStates;
+    std::vector<HypStateIndex> arcSuccStatesAux=arcSuccStates;
+    std::vector<Score> arcScoresAux=arcScores;
+    std::vector<unsigned int> arcWordBeginAux=arcWordBegin;
+    std::vector<WgWordIndex> arcWordIndicesAux=arcWordIndices;
     FinalStateSet finalStateSetAux=finalStateSet;
     std::vector<bool> arcsPrunedAux=arcsPruned;
     std::vector<std::vector<Score> > scrCompsVecAux=scrCompsVec;
+    bool arcScoresGivenByWeightsAux=arcScoresGivenByWeights;
     
-        // Clear information subject to change
-    wordGraphArcs.clear();
-    arcsPruned.clear();
-    wordGraphStates.clear();
+        // Clear information subject to change (the vocabulary is kept)
+    clearArcs();
     finalStateSet.clear();
-    scrCompsVec.clear();
 
         // Regenerate final states
     FinalStateSet::iterator iter;
@@ -680,36 +1164,35 @@ void WordGraph::obtainWgComposedOfUsefulStates(void)
       }
     }
         // Regenerate arcs (states are regenerated implicitly)
-    for(unsigned int arcid=0;arcid<wordGraphArcsAux.size();++arcid)
+    for(unsigned int arcid=0;arcid<arcScoresAux.size();++arcid)
     {
           // Check if arc is not pruned
       if(!arcsPrunedAux[arcid])
       {
-            // Obtain wordgraph arc information
-        WordGraphArc wgArc=wordGraphArcsAux[arcid];
-        std::vector<Score> scrVec=scrCompsVecAux[arcid];
-        
             // Check if arc connects two useful states
-        if(stateIsUsefulVec[wgArc.predStateIndex] && stateIsUsefulVec[wgArc.succStateIndex])
+        if(stateIsUsefulVec[arcPredStatesAux[arcid]] && stateIsUsefulVec[arcSuccStatesAux[arcid]])
         {
               // Obtain remapped indices
           std::map<HypStateIndex,HypStateIndex>::iterator iter;
 
-          iter=remappedStates.find(wgArc.predStateIndex);
+          iter=remappedStates.find(arcPredStatesAux[arcid]);
           HypStateIndex newPredStateIndex=iter->second;
       
-          iter=remappedStates.find(wgArc.succStateIndex);
+          iter=remappedStates.find(arcSuccStatesAux[arcid]);
           HypStateIndex newSuccStateIndex=iter->second;
 
               // Insert arc
-          addArcWithScrComps(newPredStateIndex,
-                             newSuccStateIndex,
-                             wgArc.words,
-                             wgArc.arcScore,
-                             scrVec);
+          unsigned int numWords=arcWordBeginAux[arcid+1]-arcWordBeginAux[arcid];
+          addArcWordIndices(newPredStateIndex,
+                            newSuccStateIndex,
+                            numWords==0 ? NULL : &arcWordIndicesAux[arcWordBeginAux[arcid]],
+                            numWords,
+                            arcScoresAux[arcid]);
+          scrCompsVec.back()=scrCompsVecAux[arcid];
         }
       }
     }
+    arcScoresGivenByWeights=arcScoresGivenByWeightsAux;
   }
 }
 
@@ -717,16 +1200,16 @@ void WordGraph::obtainWgComposedOfUsefulStates(void)
 void WordGraph::orderArcsTopol(void)
 {
       // Define auxiliary variables
-  WordGraphArcs wordGraphArcsAux;
+  std::vector<WordGraphArcId> newToOldArcId;
 
   std::vector<bool> arcAdded;
-  arcAdded.insert(arcAdded.begin(),wordGraphArcs.size(),false);
+  arcAdded.insert(arcAdded.begin(),arcScores.size(),false);
   
   std::vector<bool> stateClosed;
-  stateClosed.insert(stateClosed.begin(),wordGraphStates.size(),false);
+  stateClosed.insert(stateClosed.begin(),numStatesVar,false);
   
       // Repeat until all arcs has been reintroduced
-  while(wordGraphArcsAux.size()<wordGraphArcs.size())
+  while(newToOldArcId.size()<arcScores.size())
   {
     unsigned int atLeastOneArcAdded=false;
 
@@ -737,19 +1220,15 @@ void WordGraph::orderArcsTopol(void)
           // Check if arc has already been added
       if(!arcAdded[wgArcId])
       {
-            // Obtain arc info
-        WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcId);
-
             // Obtain predecessors of predecessor node
         std::vector<WordGraphArcId> wgArcIds;
-        getArcIdsToPredStates(wgArc.predStateIndex,wgArcIds);
+        getArcIdsToPredStates(arcPredStates[wgArcId],wgArcIds);
 
             // Check if all precessor states are closed
         bool allPredStatesClosed=true;
         for(unsigned int i=0;i<wgArcIds.size();++i)
         {
-          WordGraphArc wgArcAux=wordGraphArcId2WordGraphArc(wgArcIds[i]);
-          if(!stateClosed[wgArcAux.predStateIndex])
+          if(!stateClosed[arcPredStates[wgArcIds[i]]])
           {
             allPredStatesClosed=false;
             break;
@@ -772,11 +1251,11 @@ void WordGraph::orderArcsTopol(void)
               // Update atLeastOneArcAdded flag
           atLeastOneArcAdded=true;
               // Add arc
-          wordGraphArcsAux.push_back(wgArc);
+          newToOldArcId.push_back(wgArcId);
               // Mark arc as added
           arcAdded[wgArcId]=true;
               // Close state
-          stateClosed[wgArc.predStateIndex]=true;
+          stateClosed[arcPredStates[wgArcId]]=true;
         }
       }
     }
@@ -790,12 +1269,41 @@ void WordGraph::orderArcsTopol(void)
     }
   }
       // Check if new arc ordering has been successfully obtained
-  if(wordGraphArcsAux.size()==wordGraphArcs.size())
+  if(newToOldArcId.size()==arcScores.size())
   {
-        // Replace wordGraphArcs with wordGraphArcsAux
-    wordGraphArcs=wordGraphArcsAux;
+        // Reorder arcs
+    permuteArcs(newToOldArcId);
   }
+}
 
+//---------------------------------------
+void WordGraph::permuteArcs(const std::vector<WordGraphArcId>& newToOldArcId)
+{
+      // Save current arc information
+  std::vector<HypStateIndex> arcPredStatesAux=arcPredStates;
+  std::vector<HypStateIndex> arcSuccStatesAux=arcSuccStates;
+  std::vector<Score> arcScoresAux=arcScores;
+  std::vector<unsigned int> arcWordBeginAux=arcWordBegin;
+  std::vector<WgWordIndex> arcWordIndicesAux=arcWordIndices;
+  std::vector<bool> arcsPrunedAux=arcsPruned;
+  std::vector<std::vector<Score> > scrCompsVecAux=scrCompsVec;
+  bool arcScoresGivenByWeightsAux=arcScoresGivenByWeights;
+
+      // Insert arcs following the new order
+  clearArcs();
+  for(unsigned int i=0;i<newToOldArcId.size();++i)
+  {
+    WordGraphArcId oldArcId=newToOldArcId[i];
+    unsigned int numWords=arcWordBeginAux[oldArcId+1]-arcWordBeginAux[oldArcId];
+    addArcWordIndices(arcPredStatesAux[oldArcId],
+                      arcSuccStatesAux[oldArcId],
+                      numWords==0 ? NULL : &arcWordIndicesAux[arcWordBeginAux[oldArcId]],
+                      numWords,
+                      arcScoresAux[oldArcId]);
+    arcsPruned.back()=arcsPrunedAux[oldArcId];
+    scrCompsVec.back()=scrCompsVecAux[oldArcId];
+  }
+  arcScoresGivenByWeights=arcScoresGivenByWeightsAux;
 }
 
 //---------------------------------------
@@ -840,11 +1348,11 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex,
 
         // Make room for vectors
     prevScores.clear();
-    prevScores.insert(prevScores.begin(),wordGraphStates.size()-INITIAL_STATE,SMALL_SCORE);
+    prevScores.insert(prevScores.begin(),numStatesVar-INITIAL_STATE,SMALL_SCORE);
 
     WordGraphArc wgArc;
     bestPredArcForStateVec.clear();
-    bestPredArcForStateVec.insert(bestPredArcForStateVec.begin(),wordGraphStates.size()-INITIAL_STATE,wgArc);
+    bestPredArcForStateVec.insert(bestPredArcForStateVec.begin(),numStatesVar-INITIAL_STATE,wgArc);
 
         // Set previous score for the initial state
     if(hypStateIndex==INITIAL_STATE)
@@ -854,7 +1362,7 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex,
 
         // Initialize boolean vector of accessible states
     std::vector<bool> accessibleStateVec;
-    accessibleStateVec.insert(accessibleStateVec.begin(),wordGraphStates.size()-INITIAL_STATE,false);
+    accessibleStateVec.insert(accessibleStateVec.begin(),numStatesVar-INITIAL_STATE,false);
     accessibleStateVec[hypStateIndex]=true;
   
         // Iteration over the arcs (arcs are assumed to be topologically
@@ -866,10 +1374,11 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex,
           // Check if arc has not been pruned
       if(!arcPruned(wgArcId))
       {
-        WordGraphArc wordGraphArc=wordGraphArcId2WordGraphArc(wgArcId);
+        HypStateIndex predStateIndex=arcPredStates[wgArcId];
+        HypStateIndex succStateIndex=arcSuccStates[wgArcId];
 
-            // Check if wordGraphArc.predStateIndex is accessible
-        if(accessibleStateVec[wordGraphArc.predStateIndex])
+            // Check if predStateIndex is accessible
+        if(accessibleStateVec[predStateIndex])
         {
               // Determine score of arc
           Score arcScore=0;
@@ -879,10 +1388,10 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex,
               arcScore+=altCompWeights[i]*scrCompsVec[wgArcId][i];
           }
           else
-            arcScore=wordGraphArc.arcScore;
+            arcScore=arcScores[wgArcId];
         
               // Update score
-          Score score=arcScore+prevScores[wordGraphArc.predStateIndex];
+          Score score=arcScore+prevScores[predStateIndex];
           if(!excludedArcs.empty())
           {
                 // If predecessor state is the initial state, check that the
@@ -894,20 +1403,20 @@ void WordGraph::calcPrevScoresWeights(HypStateIndex hypStateIndex,
           }
         
           if(score<SMALL_SCORE) score=SMALL_SCORE;
-          if(score>prevScores[wordGraphArc.succStateIndex])
+          if(score>prevScores[succStateIndex])
           {
-            prevScores[wordGraphArc.succStateIndex]=score;
-            bestPredArcForStateVec[wordGraphArc.succStateIndex]=wordGraphArc;
+            prevScores[succStateIndex]=score;
+            bestPredArcForStateVec[succStateIndex]=wordGraphArcId2WordGraphArc(wgArcId);
           }
               // Update accessibleStateVec vector
-          accessibleStateVec[wordGraphArc.succStateIndex]=true;
+          accessibleStateVec[succStateIndex]=true;
         }
         else
         {
-              // If wordGraphArc.succStateIndex is not accessible, assign
+              // If succStateIndex is not accessible, assign
               // SMALL_SCORE to it
-          if(!accessibleStateVec[wordGraphArc.succStateIndex])
-            prevScores[wordGraphArc.succStateIndex]=SMALL_SCORE;
+          if(!accessibleStateVec[succStateIndex])
+            prevScores[succStateIndex]=SMALL_SCORE;
         }
       }
     }
@@ -944,7 +1453,7 @@ void WordGraph::calcRestScores(std::vector<Score>& restScores)const
 {
       // Make room for vector
   restScores.clear();
-  restScores.insert(restScores.begin(),wordGraphStates.size(),SMALL_SCORE);
+  restScores.insert(restScores.begin(),numStatesVar,SMALL_SCORE);
   
       // Update rest scores for final states
   FinalStateSet::const_iterator finalStateSetIter;  
@@ -955,22 +1464,84 @@ void WordGraph::calcRestScores(std::vector<Score>& restScores)const
   
       // Reverse iteration over the arcs (arcs are assumed to be
       // topologically ordered)
-  for(unsigned int i=0;i<wordGraphArcs.size();++i)
+  for(unsigned int i=0;i<arcScores.size();++i)
   {
-    unsigned int r=wordGraphArcs.size()-i-1;
+    unsigned int r=arcScores.size()-i-1;
         // Check if arc has not been pruned
     if(!arcPruned(r))
     {
-      WordGraphArc wordGraphArc=wordGraphArcs[r];
-    
-      Score score=wordGraphArc.arcScore+restScores[wordGraphArc.succStateIndex];
+      Score score=arcScores[r]+restScores[arcSuccStates[r]];
       if(score<SMALL_SCORE) score=SMALL_SCORE;
-      if(score>restScores[wordGraphArc.predStateIndex])
-        restScores[wordGraphArc.predStateIndex]=score;
+      if(score>restScores[arcPredStates[r]])
+        restScores[arcPredStates[r]]=score;
     }
   }  
 }
 
+//---------------------------------------
+void WordGraph::obtainRestScores(std::vector<Score>& restScores)const
+{
+  pthread_mutex_lock(&heurCacheMut);
+  HeurCacheEntry& heurCacheEntry=getHeurCacheEntry();
+  if(!heurCacheEntry.restScoresCalculated)
+  {
+    calcRestScores(heurCacheEntry.restScores);
+    heurCacheEntry.restScoresCalculated=true;
+  }
+  restScores=heurCacheEntry.restScores;
+  pthread_mutex_unlock(&heurCacheMut);
+}
+
+//---------------------------------------
+void WordGraph::calcFwdBwdLogProbs(std::vector<Score>& fwdLogProbs,
+                                   std::vector<Score>& bwdLogProbs,
+                                   float scaleFactor/*=1.0*/)const
+{
+      // Make room for vectors
+  fwdLogProbs.clear();
+  fwdLogProbs.insert(fwdLogProbs.begin(),numStatesVar,SMALL_SCORE);
+  bwdLogProbs.clear();
+  bwdLogProbs.insert(bwdLogProbs.begin(),numStatesVar,SMALL_SCORE);
+  if(empty())
+    return;
+
+      // Initialize forward and backward log-probabilities
+  fwdLogProbs[INITIAL_STATE]=0;
+  FinalStateSet::const_iterator finalStateSetIter;  
+  for(finalStateSetIter=finalStateSet.begin();finalStateSetIter!=finalStateSet.end();++finalStateSetIter)
+    bwdLogProbs[*finalStateSetIter]=0;
+
+      // Direct iteration over the arcs (arcs are assumed to be
+      // topologically ordered)
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+  {
+    if(!arcPruned(wgArcId) && fwdLogProbs[arcPredStates[wgArcId]]!=SMALL_SCORE)
+    {
+      Score score=fwdLogProbs[arcPredStates[wgArcId]]+scaleFactor*arcScores[wgArcId];
+      Score& succLogProb=fwdLogProbs[arcSuccStates[wgArcId]];
+      if(succLogProb==SMALL_SCORE)
+        succLogProb=score;
+      else
+        succLogProb=MathFuncs::lns_sumlog(succLogProb,score);
+    }
+  }
+
+      // Reverse iteration over the arcs
+  for(unsigned int i=0;i<arcScores.size();++i)
+  {
+    unsigned int r=arcScores.size()-i-1;
+    if(!arcPruned(r) && bwdLogProbs[arcSuccStates[r]]!=SMALL_SCORE)
+    {
+      Score score=scaleFactor*arcScores[r]+bwdLogProbs[arcSuccStates[r]];
+      Score& predLogProb=bwdLogProbs[arcPredStates[r]];
+      if(predLogProb==SMALL_SCORE)
+        predLogProb=score;
+      else
+        predLogProb=MathFuncs::lns_sumlog(predLogProb,score);
+    }
+  }
+}
+
 //---------------------------------------
 Score WordGraph::bestPathFromFinalStateToIdx(HypStateIndex hypStateIndex,
                                              const std::set<WordGraphArcId>& excludedArcs,
@@ -1087,19 +1658,17 @@ unsigned int WordGraph::pruneArcsToPredStates(float threshold)
   unsigned int numPrunedArcs=0;
   
       // Explore nodes
-  for(HypStateIndex hidx=0;hidx<wordGraphStates.size();++hidx)  
+  updateAdjacency();
+  for(HypStateIndex hidx=0;hidx<numStatesVar;++hidx)  
   {
-    std::vector<std::pair<Score,WordGraphArcId> > scoreArcIdVec;
-    
         // Iterate over the arcs to predecessors
-    std::vector<WordGraphArcId>::iterator arcIdVecIter;
-    for(arcIdVecIter=wordGraphStates[hidx].arcsToPredStates.begin();arcIdVecIter!=wordGraphStates[hidx].arcsToPredStates.end();++arcIdVecIter)
+    for(unsigned int i=predArcBegin[hidx];i<predArcBegin[hidx+1];++i)
     {
           // Extract relevant arc information
-      WordGraphArcId wordGraphArcId=*arcIdVecIter;
-      HypStateIndex predStateIndex=wordGraphArcs[wordGraphArcId].predStateIndex;
-      HypStateIndex succStateIndex=wordGraphArcs[wordGraphArcId].succStateIndex;
-      Score arcScore=wordGraphArcs[wordGraphArcId].arcScore;
+      WordGraphArcId wordGraphArcId=predArcIds[i];
+      HypStateIndex predStateIndex=arcPredStates[wordGraphArcId];
+      HypStateIndex succStateIndex=arcSuccStates[wordGraphArcId];
+      Score arcScore=arcScores[wordGraphArcId];
       Score bestScoreAssociatedToArc=prevScores[predStateIndex]+arcScore+restScores[succStateIndex];
       // std::cerr<<predStateIndex<<" -> "<<succStateIndex<<" , "<<prevScores[predStateIndex]<<" ";
       // std::cerr<<arcScore<<" "<<restScores[succStateIndex]<<" , "<<bestScoreAssociatedToArc<<" , "<<bestHypScore<<" "<<bestHypScore+logThreshold<<std::endl;
@@ -1145,19 +1714,18 @@ void WordGraph::obtainStatesReachableFromInit(std::vector<bool>& stateReachableF
 {
       // Initialize stateReachableFromInitVec variable
   stateReachableFromInitVec.clear();
-  for(unsigned int i=0;i<wordGraphStates.size();++i)
+  for(unsigned int i=0;i<numStatesVar;++i)
     stateReachableFromInitVec.push_back(false);
   if(INITIAL_STATE<stateReachableFromInitVec.size())
     stateReachableFromInitVec[INITIAL_STATE]=true;
       // Direct iteration over the arcs (arcs are assumed to be
       // topologically ordered)
-  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
   {
     if(!arcPruned(wgArcId))
     {
-      WordGraphArc wgArc=wordGraphArcId2WordGraphArc(wgArcId);
-      if(stateReachableFromInitVec[wgArc.predStateIndex])
-        stateReachableFromInitVec[wgArc.succStateIndex]=true;
+      if(stateReachableFromInitVec[arcPredStates[wgArcId]])
+        stateReachableFromInitVec[arcSuccStates[wgArcId]]=true;
     }
   }
 }
@@ -1168,7 +1736,7 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
 {  
       // Initialize vector
   stateIsUsefulVec.clear();
-  for(unsigned int i=0;i<wordGraphStates.size();++i)
+  for(unsigned int i=0;i<numStatesVar;++i)
     stateIsUsefulVec.push_back(false);
 
       // Set vector values for final states
@@ -1202,14 +1770,13 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
   
       // Reverse iteration over the arcs (arcs are assumed to be
       // topologically ordered)
-  for(WordGraphArcId wgArcId=0;wgArcId<wordGraphArcs.size();++wgArcId)
+  for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
   {
-    WordGraphArcId reverseWgArcId=wordGraphArcs.size()-wgArcId-1;
+    WordGraphArcId reverseWgArcId=arcScores.size()-wgArcId-1;
     if(!arcPruned(reverseWgArcId))
     {
-      WordGraphArc wgArc=wordGraphArcId2WordGraphArc(reverseWgArcId);
-      if(stateReachableFromInitVec[wgArc.predStateIndex] && stateIsUsefulVec[wgArc.succStateIndex])
-        stateIsUsefulVec[wgArc.predStateIndex]=true;
+      if(stateReachableFromInitVec[arcPredStates[reverseWgArcId]] && stateIsUsefulVec[arcSuccStates[reverseWgArcId]])
+        stateIsUsefulVec[arcPredStates[reverseWgArcId]]=true;
     }
   }
 
@@ -1235,6 +1802,15 @@ void WordGraph::obtainUsefulStates(std::vector<bool>& stateIsUsefulVec,
 //---------------------------------------
 bool WordGraph::load(const char * filename)
 {
+      // Check if the file is in binary format
+  std::ifstream inS(filename,std::ios::binary);
+  if(inS)
+  {
+    char magic[WG_BINARY_MAGIC_SIZE];
+    if(inS.read(magic,WG_BINARY_MAGIC_SIZE) && strncmp(magic,WG_BINARY_MAGIC,WG_BINARY_MAGIC_SIZE)==0)
+      return loadBinary(filename);
+  }
+
   AwkInputStream awk;
   
   if(awk.open(filename)==THOT_ERROR)
@@ -1380,19 +1956,17 @@ void WordGraph::print(std::ostream &outS,
     obtainUsefulStates(stateIsUsefulVec,remappedStates);
   
       // Print arcs
-  for(unsigned int i=0;i<wordGraphArcs.size();++i)
+  for(unsigned int i=0;i<arcScores.size();++i)
   {
         // Print arc if it is useful and has not been pruned
     bool arcIsUseful=false;
     if(printOnlyUsefulStates)
-      arcIsUseful=stateIsUsefulVec[wordGraphArcs[i].predStateIndex] && stateIsUsefulVec[wordGraphArcs[i].succStateIndex];
+      arcIsUseful=stateIsUsefulVec[arcPredStates[i]] && stateIsUsefulVec[arcSuccStates[i]];
     
     if( (!printOnlyUsefulStates || arcIsUseful) && !arcsPruned[i])
     {
-      WordGraphArc wordGraphArc=wordGraphArcs[i];
-
           //Print indices
-      outS<<wordGraphArc.predStateIndex<<" "<<wordGraphArc.succStateIndex<<" "<<wordGraphArc.arcScore<<" ";
+      outS<<arcPredStates[i]<<" "<<arcSuccStates[i]<<" "<<arcScores[i]<<" ";
 
       if(!scrCompsVec[i].empty())
       {
@@ -1405,42 +1979,420 @@ void WordGraph::print(std::ostream &outS,
         outS<<"||| ";
       }
       
-      for(unsigned int i=0;i<wordGraphArc.words.size();++i)
+      for(unsigned int j=arcWordBegin[i];j<arcWordBegin[i+1];++j)
       {
-        outS<<wordGraphArc.words[i];
-        if(i<wordGraphArc.words.size()-1) outS<<" ";
+        outS<<vocab[arcWordIndices[j]];
+        if(j<arcWordBegin[i+1]-1) outS<<" ";
       }
       outS<<std::endl;
     }
   }
 }
 
+//---------------------------------------
+void WordGraph::writePadding(std::ostream& outS,
+                             size_t& written)
+{
+  while(written%WG_BINARY_ALIGNMENT!=0)
+  {
+    outS.put('\0');
+    ++written;
+  }
+}
+
+//---------------------------------------
+void WordGraph::writeBinaryArray(std::ostream& outS,
+                                 const void* arrayPtr,
+                                 size_t arraySize,
+                                 size_t& written)
+{
+  if(arraySize>0)
+    outS.write((const char*)arrayPtr,arraySize);
+  written+=arraySize;
+  writePadding(outS,written);
+}
+
+//---------------------------------------
+bool WordGraph::printBinary(const char* filename,
+                            bool printOnlyUsefulStates/*=false*/)const
+{
+  std::ofstream outS(filename,std::ios::binary|std::ios::trunc);
+  if(!outS)
+  {
+    std::cerr<<"Error while printing word graph to file "<<filename<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(printBinary(outS,printOnlyUsefulStates)==THOT_ERROR)
+  {
+    std::cerr<<"Error while printing word graph to file "<<filename<<std::endl;
+    return THOT_ERROR;
+  }
+  else
+    return THOT_OK;
+}
+
+//---------------------------------------
+bool WordGraph::printBinary(std::ostream &outS,
+                            bool printOnlyUsefulStates/*=false*/)const
+{
+      // Obtain useful states
+  std::vector<bool> stateIsUsefulVec;
+  std::map<HypStateIndex,HypStateIndex> remappedStates;
+  if(printOnlyUsefulStates)
+    obtainUsefulStates(stateIsUsefulVec,remappedStates);
+
+      // Obtain final states that have not been pruned
+  std::vector<HypStateIndex> finalStates;
+  for(FinalStateSet::const_iterator finalStateSetIter=finalStateSet.begin();finalStateSetIter!=finalStateSet.end();++finalStateSetIter)
+  {
+    if(!finalStatePruned(*finalStateSetIter))
+      finalStates.push_back(*finalStateSetIter);
+  }
+
+      // Obtain arcs to be printed
+  std::vector<HypStateIndex> predStates;
+  std::vector<HypStateIndex> succStates;
+  std::vector<Score> scores;
+  std::vector<unsigned int> wordBegin(1,0);
+  std::vector<WgWordIndex> wordIndices;
+  std::vector<unsigned int> scrCompBegin(1,0);
+  std::vector<Score> scrComps;
+  for(unsigned int i=0;i<arcScores.size();++i)
+  {
+    bool arcIsUseful=false;
+    if(printOnlyUsefulStates)
+      arcIsUseful=stateIsUsefulVec[arcPredStates[i]] && stateIsUsefulVec[arcSuccStates[i]];
+
+    if( (!printOnlyUsefulStates || arcIsUseful) && !arcsPruned[i])
+    {
+      predStates.push_back(arcPredStates[i]);
+      succStates.push_back(arcSuccStates[i]);
+      scores.push_back(arcScores[i]);
+      wordIndices.insert(wordIndices.end(),arcWordIndices.begin()+arcWordBegin[i],arcWordIndices.begin()+arcWordBegin[i+1]);
+      wordBegin.push_back(wordIndices.size());
+      scrComps.insert(scrComps.end(),scrCompsVec[i].begin(),scrCompsVec[i].end());
+      scrCompBegin.push_back(scrComps.size());
+    }
+  }
+
+      // Obtain vocabulary and component names as character arrays
+  std::vector<unsigned int> vocabBegin(1,0);
+  std::string vocabChars;
+  for(unsigned int i=0;i<vocab.size();++i)
+  {
+    vocabChars+=vocab[i];
+    vocabBegin.push_back(vocabChars.size());
+  }
+  std::vector<float> weights;
+  std::vector<unsigned int> compNameBegin(1,0);
+  std::string compNameChars;
+  for(unsigned int i=0;i<compWeights.size();++i)
+  {
+    weights.push_back(compWeights[i].second);
+    compNameChars+=compWeights[i].first;
+    compNameBegin.push_back(compNameChars.size());
+  }
+
+      // The format is composed of a magic string, the number of
+      // elements of each array, the initial state score and the
+      // arrays. Every item starts at an aligned offset
+  char magic[WG_BINARY_MAGIC_SIZE];
+  memset(magic,0,WG_BINARY_MAGIC_SIZE);
+  strncpy(magic,WG_BINARY_MAGIC,WG_BINARY_MAGIC_SIZE);
+  unsigned long long sizes[WG_BINARY_NUM_SIZES]={numStatesVar,finalStates.size(),scores.size(),
+                                                 wordIndices.size(),vocab.size(),vocabChars.size(),
+                                                 weights.size(),compNameChars.size(),scrComps.size()};
+  size_t written=0;
+  writeBinaryArray(outS,magic,WG_BINARY_MAGIC_SIZE,written);
+  writeBinaryArray(outS,sizes,sizeof(sizes),written);
+  writeBinaryArray(outS,&initialStateScore,sizeof(Score),written);
+  writeBinaryArray(outS,finalStates.data(),finalStates.size()*sizeof(HypStateIndex),written);
+  writeBinaryArray(outS,predStates.data(),predStates.size()*sizeof(HypStateIndex),written);
+  writeBinaryArray(outS,succStates.data(),succStates.size()*sizeof(HypStateIndex),written);
+  writeBinaryArray(outS,scores.data(),scores.size()*sizeof(Score),written);
+  writeBinaryArray(outS,wordBegin.data(),wordBegin.size()*sizeof(unsigned int),written);
+  writeBinaryArray(outS,wordIndices.data(),wordIndices.size()*sizeof(WgWordIndex),written);
+  writeBinaryArray(outS,vocabBegin.data(),vocabBegin.size()*sizeof(unsigned int),written);
+  writeBinaryArray(outS,vocabChars.data(),vocabChars.size(),written);
+  writeBinaryArray(outS,weights.data(),weights.size()*sizeof(float),written);
+  writeBinaryArray(outS,compNameBegin.data(),compNameBegin.size()*sizeof(unsigned int),written);
+  writeBinaryArray(outS,compNameChars.data(),compNameChars.size(),written);
+  writeBinaryArray(outS,scrCompBegin.data(),scrCompBegin.size()*sizeof(unsigned int),written);
+  writeBinaryArray(outS,scrComps.data(),scrComps.size()*sizeof(Score),written);
+
+  if(!outS)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//---------------------------------------
+const char* WordGraph::getBinaryArray(const char* bufPtr,
+                                      size_t bufSize,
+                                      size_t& offset,
+                                      unsigned long long numElems,
+                                      size_t elemSize)
+{
+  if(offset>bufSize || numElems>(bufSize-offset)/elemSize)
+    return NULL;
+  const char* arrayPtr=bufPtr+offset;
+  offset+=numElems*elemSize;
+  if(offset%WG_BINARY_ALIGNMENT!=0)
+    offset+=WG_BINARY_ALIGNMENT-offset%WG_BINARY_ALIGNMENT;
+  return arrayPtr;
+}
+
+//---------------------------------------
+bool WordGraph::offsetsAreValid(const unsigned int* beginPtr,
+                                unsigned long long numElems,
+                                unsigned long long arraySize)
+{
+  if(beginPtr[0]!=0 || beginPtr[numElems]!=arraySize)
+    return false;
+  for(unsigned long long i=0;i<numElems;++i)
+  {
+    if(beginPtr[i]>beginPtr[i+1])
+      return false;
+  }
+  return true;
+}
+
+//---------------------------------------
+bool WordGraph::loadBinary(const char * filename)
+{
+      // Map file
+  MappedFile mappedFile;
+  if(mappedFile.open(filename)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening word graph file: "<<filename<<"\n";
+    return THOT_ERROR;
+  }
+  std::cerr<<"Reading binary word graph from file: "<<filename<<"\n";
+
+  return loadBinaryBuffer(mappedFile.getData(),mappedFile.getSize(),filename);
+}
+
+//---------------------------------------
+bool WordGraph::loadFromContainer(const char* containerFileName,
+                                  unsigned int sentId)
+{
+      // The container is opened and indexed once, and reused by
+      // subsequent calls
+  std::shared_ptr<const WgContainerReader> wgContainerReaderPtr=WgContainerReader::obtainShared(containerFileName);
+  if(!wgContainerReaderPtr)
+    return THOT_ERROR;
+  std::cerr<<"Reading word graph of sentence "<<sentId<<" from container: "<<containerFileName<<"\n";
+
+  return wgContainerReaderPtr->load(sentId,*this);
+}
+
+//---------------------------------------
+bool WordGraph::loadBinaryBuffer(const char* bufPtr,
+                                 size_t bufSize,
+                                 const char* name)
+{
+      // Obtain arrays
+  size_t offset=0;
+  const char* magic=getBinaryArray(bufPtr,bufSize,offset,WG_BINARY_MAGIC_SIZE,1);
+  const unsigned long long* sizes=(const unsigned long long*)getBinaryArray(bufPtr,bufSize,offset,WG_BINARY_NUM_SIZES,sizeof(unsigned long long));
+  if(magic==NULL || sizes==NULL || strncmp(magic,WG_BINARY_MAGIC,WG_BINARY_MAGIC_SIZE)!=0)
+  {
+    std::cerr<<"Error: "<<name<<" is not a binary word graph file"<<std::endl;
+    return THOT_ERROR;
+  }
+  unsigned long long numStates=sizes[0];
+  unsigned long long numFinalStates=sizes[1];
+  unsigned long long numArcs=sizes[2];
+  unsigned long long numWords=sizes[3];
+  unsigned long long vocabSize=sizes[4];
+  unsigned long long vocabCharsSize=sizes[5];
+  unsigned long long numCompWeights=sizes[6];
+  unsigned long long compNameCharsSize=sizes[7];
+  unsigned long long numScrComps=sizes[8];
+
+  const Score* initialStateScorePtr=(const Score*)getBinaryArray(bufPtr,bufSize,offset,1,sizeof(Score));
+  const HypStateIndex* finalStates=(const HypStateIndex*)getBinaryArray(bufPtr,bufSize,offset,numFinalStates,sizeof(HypStateIndex));
+  const HypStateIndex* predStates=(const HypStateIndex*)getBinaryArray(bufPtr,bufSize,offset,numArcs,sizeof(HypStateIndex));
+  const HypStateIndex* succStates=(const HypStateIndex*)getBinaryArray(bufPtr,bufSize,offset,numArcs,sizeof(HypStateIndex));
+  const Score* scores=(const Score*)getBinaryArray(bufPtr,bufSize,offset,numArcs,sizeof(Score));
+  const unsigned int* wordBegin=(const unsigned int*)getBinaryArray(bufPtr,bufSize,offset,numArcs+1,sizeof(unsigned int));
+  const WgWordIndex* wordIndices=(const WgWordIndex*)getBinaryArray(bufPtr,bufSize,offset,numWords,sizeof(WgWordIndex));
+  const unsigned int* vocabBegin=(const unsigned int*)getBinaryArray(bufPtr,bufSize,offset,vocabSize+1,sizeof(unsigned int));
+  const char* vocabChars=getBinaryArray(bufPtr,bufSize,offset,vocabCharsSize,1);
+  const float* weights=(const float*)getBinaryArray(bufPtr,bufSize,offset,numCompWeights,sizeof(float));
+  const unsigned int* compNameBegin=(const unsigned int*)getBinaryArray(bufPtr,bufSize,offset,numCompWeights+1,sizeof(unsigned int));
+  const char* compNameChars=getBinaryArray(bufPtr,bufSize,offset,compNameCharsSize,1);
+  const unsigned int* scrCompBegin=(const unsigned int*)getBinaryArray(bufPtr,bufSize,offset,numArcs+1,sizeof(unsigned int));
+  const Score* scrComps=(const Score*)getBinaryArray(bufPtr,bufSize,offset,numScrComps,sizeof(Score));
+
+      // Check consistency of the arrays
+  bool ok=(initialStateScorePtr && finalStates && predStates && succStates && scores &&
+           wordBegin && wordIndices && vocabBegin && vocabChars && weights &&
+           compNameBegin && compNameChars && scrCompBegin && scrComps);
+  ok=ok && offsetsAreValid(wordBegin,numArcs,numWords);
+  ok=ok && offsetsAreValid(vocabBegin,vocabSize,vocabCharsSize);
+  ok=ok && offsetsAreValid(compNameBegin,numCompWeights,compNameCharsSize);
+  ok=ok && offsetsAreValid(scrCompBegin,numArcs,numScrComps);
+  for(unsigned long long i=0;ok && i<numFinalStates;++i)
+    ok=(finalStates[i]<numStates);
+  for(unsigned long long i=0;ok && i<numArcs;++i)
+    ok=(predStates[i]<numStates && succStates[i]<numStates);
+  for(unsigned long long i=0;ok && i<numWords;++i)
+    ok=(wordIndices[i]<vocabSize);
+  if(!ok)
+  {
+    std::cerr<<"Error: binary word graph file "<<name<<" is corrupted"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Clear word graph
+  clear();
+
+      // Set word graph data
+  initialStateScore=*initialStateScorePtr;
+  finalStateSet.insert(finalStates,finalStates+numFinalStates);
+  arcPredStates.assign(predStates,predStates+numArcs);
+  arcSuccStates.assign(succStates,succStates+numArcs);
+  arcScores.assign(scores,scores+numArcs);
+  arcWordBegin.assign(wordBegin,wordBegin+numArcs+1);
+  arcWordIndices.assign(wordIndices,wordIndices+numWords);
+  arcsPruned.assign(numArcs,false);
+  numStatesVar=numStates;
+  vocab.reserve(vocabSize);
+  for(unsigned long long i=0;i<vocabSize;++i)
+  {
+    vocab.push_back(std::string(vocabChars+vocabBegin[i],vocabBegin[i+1]-vocabBegin[i]));
+    vocabMap[vocab.back()]=i;
+  }
+  for(unsigned long long i=0;i<numCompWeights;++i)
+  {
+    std::string compName(compNameChars+compNameBegin[i],compNameBegin[i+1]-compNameBegin[i]);
+    compWeights.push_back(std::make_pair(compName,weights[i]));
+  }
+  scrCompsVec.resize(numArcs);
+  for(unsigned long long i=0;i<numArcs;++i)
+    scrCompsVec[i].assign(scrComps+scrCompBegin[i],scrComps+scrCompBegin[i+1]);
+
+  return THOT_OK;
+}
+
+//---------------------------------------
+void WordGraph::updateAdjacency(void)const
+{
+      // The flag is checked again after locking the mutex, since
+      // another thread may have rebuilt the adjacency in the
+      // meantime. The acquire load pairs with the release store
+      // below, so the adjacency vectors are visible once the flag is
+      // seen as false
+  if(!adjacencyOutdated.load(std::memory_order_acquire))
+    return;
+
+  pthread_mutex_lock(&adjacencyMut);
+  if(adjacencyOutdated.load(std::memory_order_relaxed))
+  {
+        // Count arcs of each state
+    succArcBegin.assign(numStatesVar+1,0);
+    predArcBegin.assign(numStatesVar+1,0);
+    for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+    {
+      ++succArcBegin[arcPredStates[wgArcId]+1];
+      ++predArcBegin[arcSuccStates[wgArcId]+1];
+    }
+    for(HypStateIndex idx=0;idx<numStatesVar;++idx)
+    {
+      succArcBegin[idx+1]+=succArcBegin[idx];
+      predArcBegin[idx+1]+=predArcBegin[idx];
+    }
+
+        // Fill arc identifiers, the arcs of each state are kept in
+        // increasing order
+    std::vector<unsigned int> succPos(succArcBegin.begin(),succArcBegin.end()-1);
+    std::vector<unsigned int> predPos(predArcBegin.begin(),predArcBegin.end()-1);
+    succArcIds.resize(arcScores.size());
+    predArcIds.resize(arcScores.size());
+    for(WordGraphArcId wgArcId=0;wgArcId<arcScores.size();++wgArcId)
+    {
+      succArcIds[succPos[arcPredStates[wgArcId]]++]=wgArcId;
+      predArcIds[predPos[arcSuccStates[wgArcId]]++]=wgArcId;
+    }
+    adjacencyOutdated.store(false,std::memory_order_release);
+  }
+  pthread_mutex_unlock(&adjacencyMut);
+}
+
+//---------------------------------------
+void WordGraph::invalidateHeurCache(void)
+{
+      // The word graph cannot be modified while other threads access
+      // it, so the mutex is not required
+  if(!heurCache.empty())
+    heurCache.clear();
+}
+
+//---------------------------------------
+WordGraph::HeurCacheEntry& WordGraph::getHeurCacheEntry(void)const
+{
+      // Obtain key given by the component weights
+  std::vector<float> weightVec(compWeights.size());
+  for(unsigned int i=0;i<compWeights.size();++i)
+    weightVec[i]=compWeights[i].second;
+
+      // Keep the size of the cache bounded
+  if(heurCache.size()>=WG_MAX_CACHED_WEIGHT_VECS && heurCache.find(weightVec)==heurCache.end())
+    heurCache.clear();
+
+  return heurCache[weightVec];
+}
+
 //---------------------------------------
 bool WordGraph::empty(void)const
 {
-  return wordGraphArcs.empty();
+  return arcScores.empty();
 }
 
 //---------------------------------------
 size_t WordGraph::numArcs(void)const
 {
-  return wordGraphArcs.size();  
+  return arcScores.size();  
 }
 
 //---------------------------------------
 size_t WordGraph::numStates(void)const
 {
-  return wordGraphStates.size();  
+  return numStatesVar;  
 }
 
 //---------------------------------------
-void WordGraph::clear(void)
+void WordGraph::clearArcs(void)
 {
-  wordGraphArcs.clear();
+  arcPredStates.clear();
+  arcSuccStates.clear();
+  arcScores.clear();
+  arcWordBegin.assign(1,0);
+  arcWordIndices.clear();
   arcsPruned.clear();
-  wordGraphStates.clear();
+  scrCompsVec.clear();
+  numStatesVar=0;
+  adjacencyOutdated=true;
+  arcScoresGivenByWeights=false;
+  invalidateHeurCache();
+}
+
+//---------------------------------------
+void WordGraph::clear(void)
+{
+  clearArcs();
+  vocab.clear();
+  vocabMap.clear();
   finalStateSet.clear();
   initialStateScore=0;
-  scrCompsVec.clear();
   compWeights.clear();
 }
+
+//---------------------------------------
+WordGraph::~WordGraph()
+{
+  pthread_mutex_destroy(&adjacencyMut);
+  pthread_mutex_destroy(&heurCacheMut);
+}
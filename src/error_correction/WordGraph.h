@@ -40,14 +40,20 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <map>
 #include "ErrorDefs.h"
 #include "AwkInputStream.h"
+#include "MappedFile.h"
 #include "WordGraphArc.h"
 #include "WordGraphArcId.h"
 #include "WordGraphStateData.h"
+#include "WgWordIndex.h"
 #include "NbSearchHighLevelHyp.h"
 #include "NbSearchHyp.h"
 #include "NbSearchStack.h"
 #include <algorithm>
+#include <unordered_map>
 #include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <atomic>
 
 //--------------- Constants ------------------------------------------
 
@@ -58,6 +64,13 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define DISABLE_WORDGRAPH    2
 #define SMALL_SCORE          -999999999
 #define NBEST_MAX_STACK_SIZE 10000
+#define INVALID_WG_WORD_INDEX UINT_MAX
+#define WG_BINARY_MAGIC      "thot_wg_bin_v1"
+#define WG_BINARY_MAGIC_SIZE 16
+#define WG_BINARY_NUM_SIZES  9
+#define WG_BINARY_ALIGNMENT  8
+#define WG_CONFID_POS_TOLERANCE 1.0
+#define WG_MAX_CACHED_WEIGHT_VECS 8
 
 //--------------- Classes --------------------------------------------
 
@@ -66,6 +79,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 /**
  * @brief The WordGraph class implements a word graph for being
  * used in stack decoding.
+ *
+ * The arcs are stored in parallel arrays indexed by arc identifier,
+ * and their words are interned in a vocabulary owned by the word
+ * graph. The arcs leaving and reaching each state are kept in
+ * compressed sparse row (CSR) form, which is rebuilt on demand after
+ * the word graph is modified. Word graphs can be printed and loaded
+ * both in text and in a binary format, binary files are mapped in
+ * memory and their arrays are copied without parsing.
  */
 
 class WordGraph
@@ -77,6 +98,10 @@ class WordGraph
       // Constructor
   WordGraph(void);
 
+      // Copy constructor and assignment operator
+  WordGraph(const WordGraph& wg);
+  WordGraph& operator=(const WordGraph& wg);
+
       // Set weights for the components
   void setCompWeights(const std::vector<std::pair<std::string,float> >& _compWeights);
       // The setCompWeights() function revise all those arc scores for
@@ -114,6 +139,23 @@ class WordGraph
       // should be called first
   WordGraphStateData getWordGraphStateData(HypStateIndex hypStateIndex)const;
   WordGraphArc wordGraphArcId2WordGraphArc(WordGraphArcId wordGraphArcId)const;
+      // Builds a WordGraphArc object for the given identifier, the
+      // functions given below give access to the arc data without
+      // copying it
+  HypStateIndex getArcPredStateIndex(WordGraphArcId wordGraphArcId)const;
+  HypStateIndex getArcSuccStateIndex(WordGraphArcId wordGraphArcId)const;
+  Score getArcScore(WordGraphArcId wordGraphArcId)const;
+  void getArcScoreComps(WordGraphArcId wordGraphArcId,
+                        std::vector<Score>& scoreComps)const;
+      // Returns the score components of the arc (empty if they were
+      // not given)
+  unsigned int getArcNumWords(WordGraphArcId wordGraphArcId)const;
+  WgWordIndex getArcWordIndex(WordGraphArcId wordGraphArcId,
+                              unsigned int w)const;
+  const std::string& getArcWord(WordGraphArcId wordGraphArcId,
+                                unsigned int w)const;
+      // Return the w'th word of the arc, no range checking is
+      // performed
   void getArcsToPredStates(HypStateIndex hypStateIndex,
                            std::vector<WordGraphArc>& wgArcs)const;
   void getArcIdsToPredStates(HypStateIndex hypStateIndex,
@@ -125,6 +167,13 @@ class WordGraph
   FinalStateSet getFinalStateSet(void)const;
   bool stateIsFinal(HypStateIndex hypStateIndex)const;
 
+      // Functions to access the vocabulary of the word graph
+  size_t getVocabSize(void)const;
+  const std::string& wordIndexToString(WgWordIndex wordIndex)const;
+  WgWordIndex stringToWordIndex(const std::string& word)const;
+      // Returns INVALID_WG_WORD_INDEX if word is not contained in the
+      // vocabulary
+
       // Functions to calculate previous and rest scores for
       // each state
   void calcPrevScores(HypStateIndex idx,
@@ -141,6 +190,19 @@ class WordGraph
       // score component weights can be given
   void calcRestScores(std::vector<Score>& restScores)const;
       // Calculate rest scores from each node
+  void obtainRestScores(std::vector<Score>& restScores)const;
+      // The same as calcRestScores(), but the rest scores are cached
+      // for the current component weights until the arcs, states or
+      // pruning of the word graph are modified
+  void calcFwdBwdLogProbs(std::vector<Score>& fwdLogProbs,
+                          std::vector<Score>& bwdLogProbs,
+                          float scaleFactor=1.0)const;
+      // The same as calcPrevScores() and calcRestScores() starting
+      // from the initial state, but in the sum semiring: the
+      // forward (backward) log-probability of a state is the
+      // log-sum of the scores of all the paths from the initial state
+      // to it (from it to a final state). Arc scores are multiplied by
+      // scaleFactor. Pruned arcs are ignored
   
       // IMPORTANT NOTE: these functions work correctly if and only if
       // whenever an arc is added with the addArc() function, the
@@ -186,12 +248,45 @@ class WordGraph
   bool arcPruned(WordGraphArcId wordGraphArcId)const;
       // Return true if a given arc was pruned
 
+      // Functions related to arc posteriors
+  Score calcArcPosteriors(std::vector<Score>& arcLogPosteriors,
+                          float scaleFactor=1.0)const;
+      // Obtains the log-posterior probability of each arc, i.e. the
+      // normalized log-sum of the scores of the complete paths
+      // traversing the arc. Pruned arcs receive SMALL_SCORE. Returns
+      // the log-sum of the scores of all complete paths
+  unsigned int pruneGivenPosteriors(float threshold,
+                                    float scaleFactor=1.0);
+      // Prunes the arcs whose posterior probability is lower than
+      // threshold. The arcs of the best path are never pruned. Returns
+      // the number of arcs pruned by the call
+  void calcArcWordConfidences(std::vector<std::vector<float> >& arcWordConfids,
+                              std::vector<Score>& arcLogPosteriors,
+                              float scaleFactor=1.0)const;
+      // Obtains the confidence of each word of each arc as the sum of
+      // the posteriors of the arcs containing the same word at an
+      // expected target position not further than
+      // WG_CONFID_POS_TOLERANCE ([Ueffing et al. 2003] "Confidence
+      // measures for statistical machine translation"). Pruned arcs
+      // receive an empty vector. The arc posteriors used to obtain
+      // the confidences are returned in arcLogPosteriors
+
       // Function to obtain n-best list
   void obtainNbestList(unsigned int len,
                        std::vector<std::pair<Score,std::string> >& nblist,
                        std::vector<NbSearchHighLevelHyp>& highLevelHypList,
                        std::vector<std::vector<Score> >& scoreCompsVec,
                        int verbosity=false);
+  void obtainNbestHyps(unsigned int len,
+                       std::vector<std::pair<Score,NbSearchHyp> >& nbestHyps,
+                       std::vector<std::vector<Score> >& scoreCompsVec)const;
+      // Obtains the len best paths from the initial state to a final
+      // state by means of the lazy k-best algorithm proposed in [Huang
+      // and Chiang 2005] ("Better k-best parsing"). Paths are given as
+      // sequences of arc identifiers together with their unweighted
+      // score components, so no strings are built. Unlike
+      // obtainNbestList(), the search is exact and the object is not
+      // modified
   
       // Function to obtain a wordgraph composed of useful states
       // (if wordgraph has been pruned, this function obtains a pruned
@@ -204,6 +299,18 @@ class WordGraph
 
       // Functions to load word graphs
   bool load(const char * filename);
+      // Loads a word graph in text or binary format
+  bool loadBinary(const char * filename);
+  bool loadBinaryBuffer(const char* bufPtr,
+                        size_t bufSize,
+                        const char* name);
+      // Loads a word graph in binary format stored in memory, name is
+      // only used in error messages
+  bool loadFromContainer(const char* containerFileName,
+                         unsigned int sentId);
+      // Loads the word graph of the given sentence from a word graph
+      // container (see WgContainerWriter class). The container is
+      // opened and indexed by the first call only
 
       // Functions to print word graphs
       //
@@ -215,6 +322,13 @@ class WordGraph
              bool printOnlyUsefulStates=false)const;
   void print(std::ostream &outS,
              bool printOnlyUsefulStates=false)const;
+  bool printBinary(const char* filename,
+                   bool printOnlyUsefulStates=false)const;
+  bool printBinary(std::ostream &outS,
+                   bool printOnlyUsefulStates=false)const;
+      // Prints the word graph in binary format. Pruned arcs are not
+      // printed, and the printOnlyUsefulStates flag works as in the
+      // print() function
   
       // size related functions
   bool empty(void)const;
@@ -224,18 +338,103 @@ class WordGraph
       // clear() function
   void clear(void);
 
+      // Destructor
+  ~WordGraph();
+
  protected:
-  typedef std::vector<WordGraphArc> WordGraphArcs;
-  typedef std::vector<WordGraphStateData> WordGraphStates;
-    
-  WordGraphArcs wordGraphArcs;
+
+      // Arc data, indexed by arc identifier
+  std::vector<HypStateIndex> arcPredStates;
+  std::vector<HypStateIndex> arcSuccStates;
+  std::vector<Score> arcScores;
+  std::vector<unsigned int> arcWordBegin;
+      // The words of the i'th arc are stored in the
+      // [arcWordBegin[i],arcWordBegin[i+1]) range of arcWordIndices
+  std::vector<WgWordIndex> arcWordIndices;
   std::vector<bool> arcsPruned;
-  WordGraphStates wordGraphStates;
+
+      // Vocabulary
+  std::vector<std::string> vocab;
+  std::unordered_map<std::string,WgWordIndex> vocabMap;
+
+  HypStateIndex numStatesVar;
   FinalStateSet finalStateSet;
   Score initialStateScore;
   std::vector<std::pair<std::string,float> > compWeights;
   std::vector<std::vector<Score> > scrCompsVec;
 
+      // CSR adjacency, the identifiers of the arcs leaving the i'th
+      // state are stored in the [succArcBegin[i],succArcBegin[i+1])
+      // range of succArcIds (the same applies to the arcs reaching
+      // it). Pruned arcs are also included
+  mutable std::vector<unsigned int> succArcBegin;
+  mutable std::vector<WordGraphArcId> succArcIds;
+  mutable std::vector<unsigned int> predArcBegin;
+  mutable std::vector<WordGraphArcId> predArcIds;
+  mutable std::atomic<bool> adjacencyOutdated;
+  mutable pthread_mutex_t adjacencyMut;
+
+      // Cache of search heuristics for each vector of component
+      // weights. Entries computed before setting the component
+      // weights are discarded when the arcs are rescored
+  struct HeurCacheEntry
+  {
+    bool restScoresCalculated;
+    std::vector<Score> restScores;
+    bool nbSearchHeurCalculated;
+    std::vector<Score> nbSearchHeur;
+    HeurCacheEntry(void):restScoresCalculated(false),nbSearchHeurCalculated(false){}
+  };
+  typedef std::map<std::vector<float>,HeurCacheEntry> HeurCache;
+  mutable HeurCache heurCache;
+  mutable pthread_mutex_t heurCacheMut;
+  bool arcScoresGivenByWeights;
+
+      // Functions to maintain arcs and adjacency
+  WgWordIndex addWordToVocab(const std::string& word);
+  void addArcWordIndices(HypStateIndex predStateIndex,
+                         HypStateIndex succStateIndex,
+                         const WgWordIndex* wordIndices,
+                         unsigned int numWords,
+                         Score arcScore);
+  void clearArcs(void);
+  void updateAdjacency(void)const;
+      // Rebuilds CSR adjacency if it is outdated. Modifications of the
+      // word graph should not be simultaneous with calls to const
+      // member functions
+  void invalidateHeurCache(void);
+  HeurCacheEntry& getHeurCacheEntry(void)const;
+      // Returns the cache entry for the current component weights,
+      // heurCacheMut must be locked
+  void permuteArcs(const std::vector<WordGraphArcId>& newToOldArcId);
+
+      // Auxiliary function for arc posteriors
+  Score calcArcPosteriorsGivenFwdBwd(const std::vector<Score>& fwdLogProbs,
+                                     const std::vector<Score>& bwdLogProbs,
+                                     float scaleFactor,
+                                     std::vector<Score>& arcLogPosteriors)const;
+      // Obtains the arc posteriors from already computed forward and
+      // backward log-probabilities
+
+      // Auxiliary functions for binary files
+  static void writePadding(std::ostream& outS,
+                           size_t& written);
+  static void writeBinaryArray(std::ostream& outS,
+                               const void* arrayPtr,
+                               size_t arraySize,
+                               size_t& written);
+  static const char* getBinaryArray(const char* bufPtr,
+                                    size_t bufSize,
+                                    size_t& offset,
+                                    unsigned long long numElems,
+                                    size_t elemSize);
+      // Returns a pointer to an array of the mapped file and moves
+      // offset to the next aligned position. Returns NULL if the
+      // array exceeds the file size
+  static bool offsetsAreValid(const unsigned int* beginPtr,
+                              unsigned long long numElems,
+                              unsigned long long arraySize);
+
       // Auxiliary functions for pruning
   unsigned int pruneArcsToPredStates(float threshold);
   bool finalStatePruned(HypStateIndex hypStateIndex)const;
@@ -244,6 +443,7 @@ class WordGraph
   void rescoreArcsGivenWeights(const std::vector<std::pair<std::string,float> >& _compWeights);
   bool checkIfAltWeightsAppliable(const std::vector<float>& altCompWeights)const;
   void obtainNbSearchHeurInfo(std::vector<Score>& heurForEachState);
+  void calcNbSearchHeurInfo(std::vector<Score>& heurForEachState)const;
   NbSearchHighLevelHyp hypToHighLevelHyp(const NbSearchHyp& hyp);
   void nbSearch(unsigned int len,
                 const std::vector<Score>& heurForEachState,
@@ -252,6 +452,35 @@ class WordGraph
                 std::vector<std::vector<Score> >& scoreCompsVec,
                 int verbosity=false);
   bool hypIsComplete(const NbSearchHyp& nbSearchHyp);
+
+      // Data structures and functions for the lazy k-best search
+  struct KbestDeriv
+  {
+    Score score;
+    WordGraphArcId arcId;
+        // First arc of the path, INVALID_ARCID if the path ends at the
+        // state
+    unsigned int succRank;
+        // Rank of the remaining path among those of the successor state
+  };
+  struct KbestSearchInfo
+  {
+    std::vector<std::vector<KbestDeriv> > derivsForState;
+        // Best paths from each state to a final state found so far,
+        // sorted by decreasing score
+    std::vector<std::vector<KbestDeriv> > candsForState;
+        // Heaps of candidate paths of each state
+    std::vector<bool> candsInitialized;
+  };
+  static bool kbestDerivLess(const KbestDeriv& d1,
+                             const KbestDeriv& d2);
+  void initKbestCands(HypStateIndex hypStateIndex,
+                      KbestSearchInfo& ksi)const;
+  bool obtainKthBestDeriv(HypStateIndex hypStateIndex,
+                          unsigned int k,
+                          KbestSearchInfo& ksi)const;
+      // Makes sure that the k'th best path of the state (starting from
+      // zero) has been obtained, returns false if it does not exist
   std::string stringAssociatedToHyp(const NbSearchHyp& nbSearchHyp,
                                     std::vector<Score>& scoreComps);
   Score bestPathFromFinalStateToIdxAux(HypStateIndex hypStateIndex,
@@ -0,0 +1,300 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_wg_nblists.cc
+ *
+ * @brief Obtains the n-best lists of a set of word graphs. The word
+ * graphs are processed in parallel, and the n-best lists are obtained
+ * by means of the lazy k-best algorithm implemented by the WordGraph
+ * class. The n-best list files have the format generated by the
+ * thot_wg_proc tool.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include <options.h>
+#include <ctimer.h>
+#include <ErrorDefs.h>
+#include <AwkInputStream.h>
+#include <ThreadPool.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "WordGraph.h"
+
+//--------------- Constants ------------------------------------------
+
+#define DEFAULT_NBLIST_LEN 100
+
+//--------------- Type definitions -----------------------------------
+
+struct NbListTask
+{
+  std::string wgFileName;
+  std::string outPrefix;
+  int ret;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int obtainTasks(std::vector<NbListTask>& tasks);
+void nbListTask(void* taskData);
+int printNbList(const WordGraph& wordGraph,
+                const std::vector<std::pair<Score,NbSearchHyp> >& nbestHyps,
+                const std::vector<std::vector<Score> >& scoreCompsVec,
+                std::string nbListFile);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+void version(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string listFileName;
+unsigned int nbListLen;
+unsigned int numThreads;
+bool pruneWg;
+float pruningThreshold;
+bool verbose;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+        // Obtain word graphs to be processed
+    std::vector<NbListTask> tasks;
+    if(obtainTasks(tasks)==THOT_ERROR)
+      return THOT_ERROR;
+
+        // Process word graphs
+    double elapsed_ant,elapsed,ucpu,scpu;
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    ThreadPool pool(numThreads);
+    for(unsigned int i=0;i<tasks.size();++i)
+      pool.addTask(nbListTask,(void*)&tasks[i]);
+    pool.waitForTasks();
+    ctimer(&elapsed,&ucpu,&scpu);
+
+        // Check results
+    int ret=THOT_OK;
+    for(unsigned int i=0;i<tasks.size();++i)
+    {
+      if(tasks[i].ret==THOT_ERROR)
+      {
+        std::cerr<<"Error while processing word graph "<<tasks[i].wgFileName<<std::endl;
+        ret=THOT_ERROR;
+      }
+    }
+    if(verbose)
+      std::cerr<<tasks.size()<<" word graphs processed, processing time: "<<elapsed-elapsed_ant<<" seconds"<<std::endl;
+    return ret;
+  }
+  else return THOT_ERROR;
+}
+
+//---------------
+int obtainTasks(std::vector<NbListTask>& tasks)
+{
+  AwkInputStream awk;
+  if(awk.open(listFileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<listFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  while(awk.getln())
+  {
+    if(awk.NF==0)
+      continue;
+    if(awk.NF!=2)
+    {
+      std::cerr<<"Error: line "<<awk.FNR<<" of file "<<listFileName<<" does not contain a word graph file and an output prefix"<<std::endl;
+      return THOT_ERROR;
+    }
+    NbListTask task;
+    task.wgFileName=awk.dollar(1);
+    task.outPrefix=awk.dollar(2);
+    task.ret=THOT_OK;
+    tasks.push_back(task);
+  }
+  return THOT_OK;
+}
+
+//---------------
+void nbListTask(void* taskData)
+{
+  NbListTask* taskPtr=(NbListTask*) taskData;
+
+      // Load word graph
+  WordGraph wordGraph;
+  if(wordGraph.load(taskPtr->wgFileName.c_str())==THOT_ERROR)
+  {
+    taskPtr->ret=THOT_ERROR;
+    return;
+  }
+  if(pruneWg)
+    wordGraph.prune(pruningThreshold);
+
+      // Obtain n-best list
+  std::vector<std::pair<Score,NbSearchHyp> > nbestHyps;
+  std::vector<std::vector<Score> > scoreCompsVec;
+  wordGraph.obtainNbestHyps(nbListLen,nbestHyps,scoreCompsVec);
+
+      // Print n-best list
+  std::string nbListFile=taskPtr->outPrefix;
+  if(pruneWg)
+    nbListFile=nbListFile+".nbl_pruned";
+  else
+    nbListFile=nbListFile+".nbl";
+  taskPtr->ret=printNbList(wordGraph,nbestHyps,scoreCompsVec,nbListFile);
+}
+
+//---------------
+int printNbList(const WordGraph& wordGraph,
+                const std::vector<std::pair<Score,NbSearchHyp> >& nbestHyps,
+                const std::vector<std::vector<Score> >& scoreCompsVec,
+                std::string nbListFile)
+{
+  std::ofstream outS;
+  outS.open(nbListFile.c_str(),std::ios::trunc);
+  if(!outS)
+  {
+    std::cerr<<"Error while printing n-best list file "<<nbListFile<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Print component weights as header if they were given
+  std::vector<std::pair<std::string,float> > compWeights;
+  wordGraph.getCompWeights(compWeights);
+  if(!compWeights.empty())
+  {
+    outS<<"# ";
+    for(unsigned int i=0;i<compWeights.size();++i)
+    {
+      outS<<compWeights[i].first<<" "<<compWeights[i].second;
+      if(i!=compWeights.size()-1) outS<<" , ";
+    }
+    outS<<std::endl;
+  }
+
+      // Iterate over n-best list elements
+  for(unsigned int i=0;i<nbestHyps.size();++i)
+  {
+    const NbSearchHyp& hyp=nbestHyps[i].second;
+    outS<<nbestHyps[i].first<<" |||";
+
+        // Print score components if given
+    if(i<scoreCompsVec.size())
+    {
+      for(unsigned int j=0;j<scoreCompsVec[i].size();++j)
+        outS<<" "<<scoreCompsVec[i][j];
+      outS<<" |||";
+    }
+
+        // Print hypothesis information
+    for(unsigned int j=0;j<hyp.size();++j)
+      outS<<" "<<wordGraph.getArcPredStateIndex(hyp[j])<<"->"<<wordGraph.getArcSuccStateIndex(hyp[j]);
+    outS<<" |||";
+
+        // Print translation
+    for(unsigned int j=0;j<hyp.size();++j)
+    {
+      for(unsigned int k=0;k<wordGraph.getArcNumWords(hyp[j]);++k)
+        outS<<" "<<wordGraph.getArcWord(hyp[j],k);
+    }
+    outS<<std::endl;
+  }
+  return THOT_OK;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+  if(argc==1 || readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Take the file with the list of word graphs */
+  err=readSTLstring(argc,argv,"-l",&listFileName);
+  if(err==-1)
+  {
+    std::cerr<<"Error: -l parameter not given!"<<std::endl;
+    printUsage();
+    return THOT_ERROR;
+  }
+
+      /* Take the length of the n-best lists */
+  int val;
+  nbListLen=DEFAULT_NBLIST_LEN;
+  if(readInt(argc,argv,"-n",&val)!=-1)
+    nbListLen=(val>0 ? val : 1);
+
+      /* Take the number of threads */
+  numThreads=1;
+  if(readInt(argc,argv,"-pr",&val)!=-1)
+    numThreads=(val>0 ? val : 1);
+
+      /* Take the pruning threshold */
+  pruneWg=(readFloat(argc,argv,"-wgp",&pruningThreshold)!=-1);
+
+  verbose=(readOption(argc,argv,"-v")!=-1);
+
+  return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+  std::cerr<<"Usage: thot_wg_nblists     -l <string> [-n <int>] [-pr <int>]\n";
+  std::cerr<<"                           [-wgp <float>] [-v] [--help] [--version]\n\n";
+  std::cerr<<"-l <string>                File with one line per word graph, containing\n";
+  std::cerr<<"                           the name of the word graph file and the prefix\n";
+  std::cerr<<"                           of the n-best list file separated by blanks.\n";
+  std::cerr<<"                           The n-best list of each word graph is printed\n";
+  std::cerr<<"                           to <prefix>.nbl (<prefix>.nbl_pruned if -wgp is\n";
+  std::cerr<<"                           given) in the format used by thot_wg_proc.\n";
+  std::cerr<<"-n <int>                   Length of the n-best lists ("<<DEFAULT_NBLIST_LEN<<" by default).\n";
+  std::cerr<<"-pr <int>                  Number of word graphs processed in parallel\n";
+  std::cerr<<"                           (1 by default).\n";
+  std::cerr<<"-wgp <float>               Prune the word graphs using the given threshold\n";
+  std::cerr<<"                           before obtaining the n-best lists.\n";
+  std::cerr<<"-v                         Verbose mode.\n";
+  std::cerr<<"--help                     Display this help and exit.\n";
+  std::cerr<<"--version                  Output version information and exit.\n";
+}
+
+//---------------
+void version(void)
+{
+  std::cerr<<"thot_wg_nblists is part of the thot package "<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
@@ -43,6 +43,9 @@ int printNbList(const std::vector<std::pair<std::string,float> >& compWeights,
                 const std::vector<std::vector<Score> >& scoreCompsVec,
                 const std::vector<NbSearchHighLevelHyp>& highLevelHypList,
                 std::string nbListFile);
+int printArcConfidences(const WordGraph& wordGraph,
+                        float scaleFactor,
+                        std::string outFile);
 int process_bp_par(const WordGraph& wordGraph,
                    thot_wg_proc_pars pars);
 int handleParameters(int argc,
@@ -92,7 +95,10 @@ int processParameters(thot_wg_proc_pars pars)
   WordGraph wordGraph;
 
       // Load word-graph
-  ret=wordGraph.load(pars.w_str.c_str());
+  if(pars.s_given)
+    ret=wordGraph.loadFromContainer(pars.w_str.c_str(),pars.sentId);
+  else
+    ret=wordGraph.load(pars.w_str.c_str());
   if(ret==THOT_ERROR) return THOT_ERROR;
   
   if(pars.wgp_given)
@@ -125,6 +131,33 @@ int processParameters(thot_wg_proc_pars pars)
     if(ret==THOT_ERROR) return THOT_ERROR;
   }
 
+  if(pars.pp_given)
+  {
+        // Prune word-graph given arc posteriors
+    WordGraph wgAux=wordGraph;
+    unsigned int numPrunedAndNotPrunedArcs=wgAux.getNumberOfPrunedAndNonPrunedArcs();
+    std::cerr<<"Pruning word-graph given arc posteriors..."<<std::endl;
+    unsigned int numPrunedArcs=wgAux.pruneGivenPosteriors(pars.posteriorThreshold,pars.scaleFactor);
+    std::cerr<<"Initial number of arcs: "<<numPrunedAndNotPrunedArcs<<std::endl;
+    std::cerr.precision(3);
+    std::cerr<<numPrunedArcs<<" arcs were pruned ("<<100*((float)numPrunedArcs/numPrunedAndNotPrunedArcs)<<" %)"<<std::endl;
+
+        // Print word-graph
+    std::string wgOutFile=pars.o_str;
+    wgOutFile=wgOutFile+".wgpp";
+    ret=wgAux.print(wgOutFile.c_str());
+    if(ret==THOT_ERROR) return THOT_ERROR;
+  }
+
+  if(pars.c_given)
+  {
+        // Print arc posteriors and word confidences
+    std::string confOutFile=pars.o_str;
+    confOutFile=confOutFile+".wg_confid";
+    ret=printArcConfidences(wordGraph,pars.scaleFactor,confOutFile);
+    if(ret==THOT_ERROR) return THOT_ERROR;
+  }
+
   if(pars.bp_given)
   {
         // Obtain best-path from hypStateIndex
@@ -290,6 +323,43 @@ int printNbList(const std::vector<std::pair<std::string,float> >& compWeights,
   }
 }
 
+//---------------
+int printArcConfidences(const WordGraph& wordGraph,
+                        float scaleFactor,
+                        std::string outFile)
+{
+  std::ofstream outS;
+  outS.open(outFile.c_str(),std::ios::out);
+  if(!outS)
+  {
+    std::cerr<<"Error while printing arc confidences to file."<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Obtain arc posteriors and word confidences
+  std::vector<Score> arcLogPosteriors;
+  std::vector<std::vector<float> > arcWordConfids;
+  wordGraph.calcArcWordConfidences(arcWordConfids,arcLogPosteriors,scaleFactor);
+
+      // Print one line per arc with the format "<pred> <succ>
+      // <posterior> ||| <word1> <confid1> ... <wordn> <confidn>"
+  for(WordGraphArcId wgArcId=0;wgArcId<arcLogPosteriors.size();++wgArcId)
+  {
+    if(wordGraph.arcPruned(wgArcId))
+      continue;
+    outS<<wordGraph.getArcPredStateIndex(wgArcId)<<" "<<wordGraph.getArcSuccStateIndex(wgArcId)<<" ";
+    if(arcLogPosteriors[wgArcId]==SMALL_SCORE)
+      outS<<0;
+    else
+      outS<<exp(arcLogPosteriors[wgArcId]);
+    outS<<" |||";
+    for(unsigned int w=0;w<arcWordConfids[wgArcId].size();++w)
+      outS<<" "<<wordGraph.getArcWord(wgArcId,w)<<" "<<arcWordConfids[wgArcId][w];
+    outS<<std::endl;
+  }
+  return THOT_OK;
+}
+
 //---------------
 int process_bp_par(const WordGraph& wordGraph,
                    thot_wg_proc_pars pars)
@@ -410,6 +480,23 @@ int takeParameters(int argc,
       }
     }
 
+        // -s parameter
+    if(argv_stl[i]=="-s" && !matched)
+    {
+      pars.s_given=true;
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -s parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.sentId=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -wgp parameter
     if(argv_stl[i]=="-wgp" && !matched)
     {
@@ -427,6 +514,46 @@ int takeParameters(int argc,
       }
     }
 
+        // -pp parameter
+    if(argv_stl[i]=="-pp" && !matched)
+    {
+      pars.pp_given=true;
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -pp parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.posteriorThreshold=atof(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -sf parameter
+    if(argv_stl[i]=="-sf" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -sf parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.scaleFactor=atof(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
+        // -c parameter
+    if(argv_stl[i]=="-c" && !matched)
+    {
+      pars.c_given=true;
+      ++matched;
+    }
+
         // -bp parameter
     if(argv_stl[i]=="-bp" && !matched)
     {
@@ -555,9 +682,21 @@ void printParameters(thot_wg_proc_pars pars)
 {
   std::cerr<<"File with word-graph: "<<pars.w_str<<std::endl;
 
+  if(pars.s_given)
+    std::cerr<<"-s: "<<pars.sentId<<std::endl;
+
   if(pars.wgp_given)
     std::cerr<<"-wgp: "<<pars.pruningThreshold<<std::endl;
 
+  if(pars.pp_given)
+    std::cerr<<"-pp: "<<pars.posteriorThreshold<<std::endl;
+
+  if(pars.pp_given || pars.c_given)
+    std::cerr<<"-sf: "<<pars.scaleFactor<<std::endl;
+
+  if(pars.c_given)
+    std::cerr<<"-c"<<std::endl;
+
   if(pars.bp_given)
   {
     std::cerr<<"-bp: "<<pars.hypStateIndex;
@@ -578,12 +717,16 @@ void printParameters(thot_wg_proc_pars pars)
 //---------------
 void printUsage(void)
 {
-  std::cerr<<"Usage: thot_wg_proc        -w <string>\n";
+  std::cerr<<"Usage: thot_wg_proc        -w <string> [-s <int>]\n";
   std::cerr<<"                           [-bp <int> [<float1> ... <floatn>] ]\n";
   std::cerr<<"                           [-wgp <float>] [-n <int> [-y] ] [-u] [-t]\n";
+  std::cerr<<"                           [-pp <float>] [-c] [-sf <float>]\n";
   std::cerr<<"                           -o <string>\n";
   std::cerr<<"                           [-v|-v1] [--help] [--version]\n\n";
   std::cerr<<"-w <string>                File with word-graph to be loaded.\n";
+  std::cerr<<"-s <int>                   Load the word-graph of sentence <int> from the\n";
+  std::cerr<<"                           word-graph container given with -w (see -wgc\n";
+  std::cerr<<"                           option of thot_ms_dec).\n";
   std::cerr<<"-bp <int> [<float1> ... <floatn>]\n";
   std::cerr<<"                           Obtain best-path from state <int> to a final\n";
   std::cerr<<"                           state. Optionally, a float vector containing the\n";
@@ -595,6 +738,13 @@ void printUsage(void)
   std::cerr<<"                           If not given, the number of arcs is not\n";
   std::cerr<<"                           restricted.\n";
   std::cerr<<"                           NOTE: arcs must be topologically ordered.\n";
+  std::cerr<<"-pp <float>                Prune arcs whose posterior probability is lower\n";
+  std::cerr<<"                           than <float>. Arcs of the best path are kept.\n";
+  std::cerr<<"                           NOTE: arcs must be topologically ordered.\n";
+  std::cerr<<"-c                         Print posterior probability of each arc and\n";
+  std::cerr<<"                           confidence of each of its words.\n";
+  std::cerr<<"-sf <float>                Scale factor applied to arc scores when computing\n";
+  std::cerr<<"                           posteriors (1 by default).\n";
   std::cerr<<"-n <int>                   Print n-best list of length <int>.\n";
   std::cerr<<"                           NOTE: -n and -wgp options can be combined\n";
   std::cerr<<"-y                         Incorporate hypothesis information when printing\n";
@@ -35,8 +35,14 @@ struct thot_wg_proc_pars
 {
   bool w_given;
   std::string w_str;
+  bool s_given;
+  unsigned int sentId;
   bool wgp_given;
   float pruningThreshold;
+  bool pp_given;
+  float posteriorThreshold;
+  float scaleFactor;
+  bool c_given;
   bool bp_given;
   unsigned int hypStateIndex;
   std::vector<float> compWeights;
@@ -57,7 +63,11 @@ struct thot_wg_proc_pars
   void default_values(void)
     {
       w_given=false;
+      s_given=false;
       wgp_given=false;
+      pp_given=false;
+      scaleFactor=1.0;
+      c_given=false;
       bp_given=false;
       n_given=false;
       u_given=false;
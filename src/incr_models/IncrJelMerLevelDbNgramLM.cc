@@ -112,6 +112,8 @@ bool IncrJelMerLevelDbNgramLM::loadNgramTable(const char *fileName)
 //------------------------------
 bool IncrJelMerLevelDbNgramLM::print(const char *fileName)
 {
+  static_cast<LevelDbNgramTable*>(tablePtr)->printCacheStats(std::cerr);
+
   std::string fileNameStl = fileName;
   if(ngramTableFileNameLoaded == fileNameStl)
   {
@@ -129,6 +131,18 @@ bool IncrJelMerLevelDbNgramLM::print(const char *fileName)
   }
 }
 
+//------------------------------
+const LevelDbConfig& IncrJelMerLevelDbNgramLM::getLevelDbConfig(void)const
+{
+  return static_cast<LevelDbNgramTable*>(tablePtr)->getConfig();
+}
+
+//------------------------------
+bool IncrJelMerLevelDbNgramLM::setLevelDbConfig(const LevelDbConfig& config)
+{
+  return static_cast<LevelDbNgramTable*>(tablePtr)->setConfig(config);
+}
+
 //------------------------------
 void IncrJelMerLevelDbNgramLM::clear(void)
 {
@@ -136,6 +150,18 @@ void IncrJelMerLevelDbNgramLM::clear(void)
   ngramTableFileNameLoaded.clear();
 }
 
+//------------------------------
+void IncrJelMerLevelDbNgramLM::infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                                                       unsigned int maxSuffixLen,
+                                                       const WordIndex& t,
+                                                       std::vector<im_pair<Count, Count> >& infVec)
+{
+      // Build the keys of every order from a single encoding of the
+      // n-gram
+  LevelDbNgramTable* levelDbNgramTablePtr = static_cast<LevelDbNgramTable*>(tablePtr);
+  levelDbNgramTablePtr->infSrcTrgForSrcSuffixes(s, maxSuffixLen, t, infVec);
+}
+
 //------------------------------
 IncrJelMerLevelDbNgramLM::~IncrJelMerLevelDbNgramLM()
 {
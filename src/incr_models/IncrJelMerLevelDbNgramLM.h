@@ -80,11 +80,25 @@ class IncrJelMerLevelDbNgramLM: public _incrJelMerNgramLM<Count,Count>
             // Functions to load and print the model (including model weights)
         bool load(const char *fileName);
         bool print(const char *fileName);
+            // Also reports the hit rate of the cache of the n-gram
+            // table to the standard error
+
+            // Functions to tune the access to the n-gram database
+        const LevelDbConfig& getLevelDbConfig(void)const;
+        bool setLevelDbConfig(const LevelDbConfig& config);
 
         void clear(void);
 
             // Destructor
         ~IncrJelMerLevelDbNgramLM();
+
+    protected:
+
+            // Function to obtain the counts required to interpolate models
+        void infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                                     unsigned int maxSuffixLen,
+                                     const WordIndex& t,
+                                     std::vector<im_pair<Count, Count> >& infVec);
 };
 
 //---------------
@@ -29,9 +29,17 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Function definitions
 
-extern "C" BaseNgramLM<std::vector<WordIndex> >* create(const char* /*str*/)
+extern "C" BaseNgramLM<std::vector<WordIndex> >* create(const char* str)
 {
-    return new IncrJelMerLevelDbNgramLM;
+    IncrJelMerLevelDbNgramLM* incrJelMerLevelDbNgramLMPtr = new IncrJelMerLevelDbNgramLM;
+
+        // Initialization parameters such as "-ldb-cache-mb 512" tune
+        // the access to the LevelDB database (see LevelDbConfig.h)
+    LevelDbConfig config = incrJelMerLevelDbNgramLMPtr->getLevelDbConfig();
+    if(config.parseInitPars(str) == THOT_OK)
+        incrJelMerLevelDbNgramLMPtr->setLevelDbConfig(config);
+
+    return incrJelMerLevelDbNgramLMPtr;
 }
 
 //---------------
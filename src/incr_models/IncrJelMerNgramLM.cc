@@ -25,11 +25,215 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "IncrJelMerNgramLM.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sstream>
 
 //--------------- Classes --------------------------------------------
 
+//------------------------------
+bool IncrJelMerNgramLM::modelReadsAreThreadSafe(void)
+{
+      // Queries only look up the vocabulary and the n-gram tries
+      // (including the read-only ones), none of them is modified
+  return true;
+}
+
+//------------------------------
+bool IncrJelMerNgramLM::load(const char *fileName)
+{
+  if(useMappedImage)
+    return loadUsingMappedImage(fileName);
+
+  bool retval=_incrJelMerNgramLM<Count,Count>::load(fileName);
+  if(retval==THOT_OK && freezeOnLoad)
+    freeze();
+  return retval;
+}
+
+//------------------------------
+void IncrJelMerNgramLM::freeze(void)
+{
+  vecx_x_incr_cptable<WordIndex,Count,Count>* cptablePtr=static_cast<vecx_x_incr_cptable<WordIndex,Count,Count>*>(this->tablePtr);
+  cptablePtr->freeze();
+}
+
+//------------------------------
+void IncrJelMerNgramLM::setFreezeOnLoad(bool b)
+{
+  freezeOnLoad=b;
+}
+
+//------------------------------
+void IncrJelMerNgramLM::setUseMappedImage(bool b)
+{
+  useMappedImage=b;
+}
+
+//------------------------------
+bool IncrJelMerNgramLM::loadUsingMappedImage(const char *fileName)
+{
+  std::string tableFileName=getNgramTableFileName(fileName);
+  std::string imageFileName=tableFileName+INCR_JEL_MER_NGRAM_LM_IMAGE_EXT;
+  std::string vocabFileName=tableFileName+INCR_JEL_MER_NGRAM_LM_IMAGE_VOCAB_EXT;
+
+  if(!MappedFile::isNewerThan(imageFileName.c_str(),tableFileName.c_str()) ||
+     !MappedFile::isNewerThan(vocabFileName.c_str(),tableFileName.c_str()))
+  {
+        // Load model from its files and create the image
+    this->tablePtr->clear();
+    mappedImage.close();
+    if(_incrJelMerNgramLM<Count,Count>::load(fileName)==THOT_ERROR)
+      return THOT_ERROR;
+    if(printImage(imageFileName,vocabFileName)==THOT_ERROR)
+    {
+      std::cerr<<"Warning: image of n-gram table could not be created in "<<imageFileName<<", the table is kept in private memory"<<std::endl;
+      return THOT_OK;
+    }
+  }
+  else
+  {
+    if(loadWeights(fileName)==THOT_ERROR)
+      return THOT_ERROR;
+  }
+
+      // The process that created the image also uses the mapping, so
+      // its private copy of the table is released
+  return attachImage(tableFileName,imageFileName,vocabFileName);
+}
+
+//------------------------------
+bool IncrJelMerNgramLM::printImage(const std::string& imageFileName,
+                                   const std::string& vocabFileName)
+{
+      // Files are written with temporary names and then renamed, so
+      // processes loading the model concurrently never see partial
+      // files
+  std::ostringstream tmpSuffix;
+  tmpSuffix<<".tmp"<<getpid();
+  std::string tmpVocabFileName=vocabFileName+tmpSuffix.str();
+  std::string tmpImageFileName=imageFileName+tmpSuffix.str();
+
+  if(printVocab(tmpVocabFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+  std::ofstream outF(tmpImageFileName.c_str(),std::ios::out|std::ios::binary);
+  if(!outF)
+  {
+    std::cerr<<"Error while creating file "<<tmpImageFileName<<std::endl;
+    remove(tmpVocabFileName.c_str());
+    return THOT_ERROR;
+  }
+
+  ImageHeader header;
+  memset(&header,0,sizeof(ImageHeader));
+  strncpy(header.magic,INCR_JEL_MER_NGRAM_LM_IMAGE_MAGIC,sizeof(header.magic)-1);
+  header.ngramOrder=ngramOrder;
+  header.wordIndexSize=sizeof(WordIndex);
+  header.countSize=sizeof(Count);
+  outF.write((const char*)&header,sizeof(ImageHeader));
+
+  vecx_x_incr_cptable<WordIndex,Count,Count>* cptablePtr=static_cast<vecx_x_incr_cptable<WordIndex,Count,Count>*>(this->tablePtr);
+  bool ret=cptablePtr->writeFrozen(outF);
+  outF.close();
+  if(ret==THOT_ERROR || !outF)
+  {
+    std::cerr<<"Error while writing file "<<tmpImageFileName<<std::endl;
+    remove(tmpVocabFileName.c_str());
+    remove(tmpImageFileName.c_str());
+    return THOT_ERROR;
+  }
+
+  if(rename(tmpVocabFileName.c_str(),vocabFileName.c_str())!=0 ||
+     rename(tmpImageFileName.c_str(),imageFileName.c_str())!=0)
+  {
+    std::cerr<<"Error while renaming file "<<tmpImageFileName<<std::endl;
+    remove(tmpVocabFileName.c_str());
+    remove(tmpImageFileName.c_str());
+    return THOT_ERROR;
+  }
+
+  std::cerr<<"Image of n-gram table written to "<<imageFileName<<std::endl;
+  return THOT_OK;
+}
+
+//------------------------------
+bool IncrJelMerNgramLM::attachImage(const std::string& tableFileName,
+                                    const std::string& imageFileName,
+                                    const std::string& vocabFileName)
+{
+  this->tablePtr->clear();
+  mappedImage.close();
+
+  if(loadVocab(vocabFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+  if(mappedImage.open(imageFileName.c_str())==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Check header
+  ImageHeader header;
+  if(mappedImage.getSize()<sizeof(ImageHeader))
+  {
+    std::cerr<<"Error: "<<imageFileName<<" is not a valid n-gram table image"<<std::endl;
+    mappedImage.close();
+    return THOT_ERROR;
+  }
+  memcpy(&header,mappedImage.getData(),sizeof(ImageHeader));
+  if(strncmp(header.magic,INCR_JEL_MER_NGRAM_LM_IMAGE_MAGIC,sizeof(header.magic))!=0 ||
+     header.wordIndexSize!=sizeof(WordIndex) || header.countSize!=sizeof(Count))
+  {
+    std::cerr<<"Error: "<<imageFileName<<" is not a valid n-gram table image"<<std::endl;
+    mappedImage.close();
+    return THOT_ERROR;
+  }
+
+      // Attach the tries stored in the image
+  vecx_x_incr_cptable<WordIndex,Count,Count>* cptablePtr=static_cast<vecx_x_incr_cptable<WordIndex,Count,Count>*>(this->tablePtr);
+  size_t offset=sizeof(ImageHeader);
+  if(cptablePtr->attachFrozen(mappedImage.getData(),mappedImage.getSize(),offset)==THOT_ERROR)
+  {
+    std::cerr<<"Error: n-gram table image "<<imageFileName<<" is truncated"<<std::endl;
+    mappedImage.close();
+    return THOT_ERROR;
+  }
+  ngramOrder=header.ngramOrder;
+  this->modelFileName=tableFileName;
+
+  std::cerr<<"Mapped n-gram table image "<<imageFileName<<std::endl;
+  return THOT_OK;
+}
+
+//------------------------------
+std::string IncrJelMerNgramLM::getNgramTableFileName(const char *fileName)
+{
+  std::string mainFileName;
+  if(fileIsDescriptor(fileName,mainFileName))
+  {
+    std::string descFileName=fileName;
+    return absolutizeModelFileName(descFileName,mainFileName);
+  }
+  else
+    return fileName;
+}
+
+//------------------------------
+void IncrJelMerNgramLM::infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                                                unsigned int maxSuffixLen,
+                                                const WordIndex& t,
+                                                std::vector<im_pair<Count,Count> >& infVec)
+{
+      // Walk the trie-based table directly, without building the
+      // suffix vectors
+  vecx_x_incr_cptable<WordIndex,Count,Count>* cptablePtr=static_cast<vecx_x_incr_cptable<WordIndex,Count,Count>*>(this->tablePtr);
+  cptablePtr->infSrcTrgForSrcSuffixes(s,maxSuffixLen,t,infVec);
+}
+
 //------------------------------
 IncrJelMerNgramLM::~IncrJelMerNgramLM()
 {
-  
+      // Remove references to the mapped image before unmapping it
+  if(this->tablePtr!=NULL)
+    this->tablePtr->clear();
 }
@@ -33,9 +33,15 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include "_incrJelMerNgramLM.h"
+#include "MappedFile.h"
+#include <fstream>
 
 //--------------- Constants ------------------------------------------
 
+#define INCR_JEL_MER_NGRAM_LM_IMAGE_EXT       ".frz"
+#define INCR_JEL_MER_NGRAM_LM_IMAGE_VOCAB_EXT ".frz_vcb"
+#define INCR_JEL_MER_NGRAM_LM_IMAGE_MAGIC     "thot_frz_lm_v1"
+
 
 //--------------- typedefs -------------------------------------------
 
@@ -59,13 +65,65 @@ class IncrJelMerNgramLM: public _incrJelMerNgramLM<Count,Count>
     {
           // Set new pointer to table
       this->tablePtr=new vecx_x_incr_cptable<WordIndex,Count,Count>;
+      freezeOnLoad=false;
+      useMappedImage=false;
     }
 
+      // Thread safety related functions
+  bool modelReadsAreThreadSafe(void);
+
+      // Load function
+  bool load(const char *fileName);
+
+      // Functions to manage the compact read-only representation of
+      // the n-gram table
+  void freeze(void);
+      // Stores the n-grams in contiguous sorted arrays. Subsequent
+      // updates are kept in a small mutable table that is periodically
+      // merged into the read-only one
+  void setFreezeOnLoad(bool b);
+      // If set, the table is frozen after loading the model
+  void setUseMappedImage(bool b);
+      // If set, load() maps into memory an image of the frozen n-gram
+      // table stored next to the table file, so all the processes
+      // loading the model share a single copy of it. The image is
+      // created when it does not exist or is older than the table
+      // file. Updates are kept in the mutable table, which is not
+      // merged into the mapped n-grams, so they remain shared
+
 
       // Destructor
   ~IncrJelMerNgramLM();
    
  protected:
+
+  bool freezeOnLoad;
+  bool useMappedImage;
+  MappedFile mappedImage;
+
+  struct ImageHeader
+  {
+    char magic[16];
+    unsigned int ngramOrder;
+    unsigned int wordIndexSize;
+    unsigned int countSize;
+    unsigned int reserved;
+  };
+
+      // Functions related to n-gram table images
+  bool loadUsingMappedImage(const char *fileName);
+  bool printImage(const std::string& imageFileName,
+                  const std::string& vocabFileName);
+  bool attachImage(const std::string& tableFileName,
+                   const std::string& imageFileName,
+                   const std::string& vocabFileName);
+  std::string getNgramTableFileName(const char *fileName);
+
+      // Function to obtain the counts required to interpolate models
+  void infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                               unsigned int maxSuffixLen,
+                               const WordIndex& t,
+                               std::vector<im_pair<Count,Count> >& infVec);
 };
 
 //---------------
@@ -25,13 +25,30 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- Include files --------------------------------------
 
 #include "IncrJelMerNgramLM.h"
+#include "StrProcUtils.h"
 #include <string>
 
 //--------------- Function definitions
 
-extern "C" BaseNgramLM<std::vector<WordIndex> >* create(const char* /*str*/)
+extern "C" BaseNgramLM<std::vector<WordIndex> >* create(const char* str)
 {
-  return new IncrJelMerNgramLM;
+  IncrJelMerNgramLM* incrJelMerNgramLMPtr=new IncrJelMerNgramLM;
+
+      // The "-freeze" initialization parameter makes the model store
+      // its n-gram table in a compact read-only representation after
+      // loading it. The "-mmap" initialization parameter makes the
+      // model use a memory-mapped image of its frozen n-gram table,
+      // which is shared by all the processes loading the same model
+  std::vector<std::string> initParsVec=StrProcUtils::stringToStringVector(str);
+  for(unsigned int i=0;i<initParsVec.size();++i)
+  {
+    if(initParsVec[i]=="-freeze")
+      incrJelMerNgramLMPtr->setFreezeOnLoad(true);
+    else if(initParsVec[i]=="-mmap")
+      incrJelMerNgramLMPtr->setUseMappedImage(true);
+  }
+  
+  return incrJelMerNgramLMPtr;
 }
 
 //---------------
@@ -31,12 +31,12 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //-------------------------
 LevelDbNgramTable::LevelDbNgramTable(void)
 {
-    options.create_if_missing = true;
-    options.max_open_files = 4000;
-    options.filter_policy = leveldb::NewBloomFilterPolicy(48);  // Use index store in memory to reduce number of disk operations
-    options.block_cache = leveldb::NewLRUCache(100 * 1048576);  // 100 MB for cache
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
     db = NULL;
     dbName = "";
+    bulkLoaderPtr = NULL;
     // Key for null info - use the maximum allowed value as the key
     std::vector<WordIndex> null_vec;
     for (unsigned int i = 0; i < WORD_INDEX_MODULO_BYTES; i++)
@@ -117,15 +117,22 @@ bool LevelDbNgramTable::retrieveData(const std::string key, float &count)const
     std::string value_str;
     count = 0;
 
-    leveldb::Status result = db->Get(leveldb::ReadOptions(), key, &value_str);  // Read stored src value
+    bool found;
+    if(valueCache.lookup(key, count, found))
+        return found;
+
+    leveldb::Status result = db->Get(readOptions, key, &value_str);  // Read stored src value
 
     if (result.ok())
     {
         count = atof(value_str.c_str());
+        valueCache.insert(key, count, true);
         return true;
     }
     else
     {
+        if(result.IsNotFound())
+            valueCache.insert(key, count, false);
         return false;
     }
 }
@@ -149,6 +156,9 @@ bool LevelDbNgramTable::retrieveData(const std::vector<WordIndex>& phrase, float
 //-------------------------
 bool LevelDbNgramTable::storeData(const std::string key, float count)
 {
+    if(bulkLoaderPtr != NULL)
+        return (bulkLoaderPtr->add(key, count) == THOT_OK);
+
     std::stringstream ss;
     ss << count;
     std::string count_str = ss.str();
@@ -157,8 +167,16 @@ bool LevelDbNgramTable::storeData(const std::string key, float count)
     batch.Put(key, count_str);
     leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
 
-    if(!s.ok())
+    if(s.ok())
+    {
+        // Cache the count as it is read from its text representation
+        valueCache.insert(key, atof(count_str.c_str()), true);
+    }
+    else
+    {
+        valueCache.erase(key);
         std::cerr << "Storing data status: " << s.ToString() << std::endl;
+    }
 
     return s.ok();
 }
@@ -208,6 +226,7 @@ bool LevelDbNgramTable::drop()
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     leveldb::Status status = leveldb::DestroyDB(dbName, options);
 
@@ -233,6 +252,7 @@ bool LevelDbNgramTable::load(const char *fileName)
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     dbName = levelDbPath;
     leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
@@ -256,6 +276,88 @@ bool LevelDbNgramTable::load(const char *fileName)
     }
 }
 
+//-------------------------
+bool LevelDbNgramTable::startBulkLoad(std::string tmpDir)
+{
+    if(db == NULL)
+        return THOT_ERROR;
+
+    delete bulkLoaderPtr;
+    bulkLoaderPtr = NULL;
+
+    // Reopen database using a large write buffer, so sorted entries
+    // are flushed into few non-overlapping table files
+    options.write_buffer_size = LDB_BULK_WRITE_BUFFER_SIZE;
+    if(load(dbName.c_str()) != THOT_OK)
+        return THOT_ERROR;
+
+    bulkLoaderPtr = new LevelDbBulkLoader(db, false, false, tmpDir);
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbNgramTable::endBulkLoad(void)
+{
+    if(bulkLoaderPtr == NULL)
+        return THOT_ERROR;
+
+    int ret = bulkLoaderPtr->finish();
+    std::cerr << "Bulk loaded " << bulkLoaderPtr->getNumKeys() << " keys" << std::endl;
+    delete bulkLoaderPtr;
+    bulkLoaderPtr = NULL;
+
+    // Restore default write buffer size
+    options.write_buffer_size = leveldb::Options().write_buffer_size;
+    if(load(dbName.c_str()) != THOT_OK)
+        return THOT_ERROR;
+
+    return ret;
+}
+
+//-------------------------
+bool LevelDbNgramTable::setConfig(const LevelDbConfig& _config)
+{
+    if(bulkLoaderPtr != NULL)
+    {
+        std::cerr << "Error: the LevelDB configuration cannot be changed during a bulk load" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // The database uses the filter policy and the block cache of the
+    // current options, so it is closed before they are released
+    bool dbWasOpen = (db != NULL);
+    if(db != NULL)
+    {
+        delete db;
+        db = NULL;
+    }
+
+    config.releaseOptions(options);
+    config = _config;
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
+    valueCache.clear();
+
+    if(dbWasOpen)
+        return load(dbName.c_str());
+    else
+        return THOT_OK;
+}
+
+//-------------------------
+const LevelDbConfig& LevelDbNgramTable::getConfig(void)const
+{
+    return config;
+}
+
+//-------------------------
+void LevelDbNgramTable::printCacheStats(std::ostream& outS)const
+{
+    valueCache.printStats("LevelDB n-gram table", outS);
+}
+
 //-------------------------
 std::vector<WordIndex> LevelDbNgramTable::getSrcTrg(const std::vector<WordIndex>& s,
                                                const WordIndex& t)const
@@ -409,6 +511,48 @@ Count LevelDbNgramTable::getSrcTrgInfo(const std::vector<WordIndex>& s,
     return getInfo(getSrcTrg(s, t), found);
 }
 
+//-------------------------
+void LevelDbNgramTable::infSrcTrgForSrcSuffixes(const std::vector<WordIndex>& s,
+                                                unsigned int maxSuffixLen,
+                                                const WordIndex& t,
+                                                std::vector<im_pair<Count, Count> >& infVec)
+{
+    // Encode the n-gram (s, t) only once, the keys of its suffixes are
+    // built from substrings of the encoded n-gram
+    std::string stKey = vectorToKey(getSrcTrg(s, t));
+    size_t n = s.size();
+
+    infVec.resize(maxSuffixLen + 1);
+    for(unsigned int k = 0; k <= maxSuffixLen; k++)
+    {
+        size_t suffixOffset = 1 + WORD_INDEX_MODULO_BYTES * (n - k);
+        float count;
+
+        // Retrieve count of s_k
+        if (k == 0)
+        {
+            infVec[k].first = srcInfoNull;
+        }
+        else
+        {
+            std::string srcKey(1, (char) (k + 1));
+            srcKey.append(stKey, suffixOffset, WORD_INDEX_MODULO_BYTES * k);
+            infVec[k].first = retrieveData(srcKey, count) ? Count(count) : Count();
+        }
+
+        // Retrieve count of (s_k, t) (not required for unseen s_k,
+        // since its probability is zero)
+        infVec[k].second = Count();
+        if ((float) infVec[k].first > 0)
+        {
+            std::string srcTrgKey(1, (char) (k + 2));
+            srcTrgKey.append(stKey, suffixOffset, std::string::npos);
+            if (retrieveData(srcTrgKey, count))
+                infVec[k].second = Count(count);
+        }
+    }
+}
+
 //-------------------------
 Prob LevelDbNgramTable::pTrgGivenSrc(const std::vector<WordIndex>& s,
                                      const WordIndex& t)
@@ -516,7 +660,7 @@ bool LevelDbNgramTable::getEntriesForSource(const std::vector<WordIndex>& s,
     leveldb::Slice end = end_str;
 
     // Iterate over the defined key range and populate valid results
-    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    leveldb::Iterator* it = db->NewIterator(readOptions);
     
     trgtn.clear();  // Make sure that structure does not keep old values
     
@@ -663,20 +807,22 @@ void LevelDbNgramTable::clear(void)
 //-------------------------
 LevelDbNgramTable::~LevelDbNgramTable(void)
 {
+    delete bulkLoaderPtr;
+
     if(db != NULL)
         delete db;
 
-    if(options.filter_policy != NULL)
-        delete options.filter_policy;
-
-    if(options.block_cache != NULL)
-        delete options.block_cache;
+    config.releaseOptions(options);
 }
 
 //-------------------------
 LevelDbNgramTable::const_iterator LevelDbNgramTable::begin(void)const
 {
-    leveldb::Iterator *local_iter = db->NewIterator(leveldb::ReadOptions());
+    // Full scans do not fill the block cache, so they do not evict
+    // the blocks used by the lookups
+    leveldb::ReadOptions scanOptions = readOptions;
+    scanOptions.fill_cache = false;
+    leveldb::Iterator *local_iter = db->NewIterator(scanOptions);
     local_iter->SeekToFirst();
 
     // Skip item, if it stores nullInfo, to be compatible with other implementations
@@ -42,6 +42,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <sstream>
 
 #include "BaseIncrCondProbTable.h"
+#include "LevelDbBulkLoader.h"
+#include "LevelDbConfig.h"
+#include "LevelDbValueCache.h"
 #include "ErrorDefs.h"
 #include "MathDefs.h"
 
@@ -62,8 +65,12 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
 {
         leveldb::DB* db;
         leveldb::Options options;
+        leveldb::ReadOptions readOptions;
+        LevelDbConfig config;
+        mutable LevelDbValueCache<float> valueCache;
         std::string dbName;
         std::string dbNullKey;
+        LevelDbBulkLoader* bulkLoaderPtr;
 
             // Converters
         std::string vectorToString(const std::vector<WordIndex>& vec)const;
@@ -99,6 +106,24 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
         bool load(const char *fileName);
         //bool load(std::string fileName);
 
+            // Bulk load functions. Between both calls, the stored
+            // entries are buffered, sorted by key and written in large
+            // batches when endBulkLoad() is called. The value of an
+            // entry stored more than once is the last one, and it
+            // replaces the value already stored in the database, as
+            // storeData() does outside bulk mode. Count increments
+            // read the stored value, so they do not see the buffered
+            // ones and should not be used during a bulk load
+        bool startBulkLoad(std::string tmpDir);
+        bool endBulkLoad(void);
+
+            // Functions to tune database access. The new configuration
+            // reopens the database if it was already loaded. It cannot
+            // be changed during a bulk load
+        bool setConfig(const LevelDbConfig& _config);
+        const LevelDbConfig& getConfig(void)const;
+        void printCacheStats(std::ostream& outS)const;
+
           // Basic functions
           // TODO Ordering by n-gram value
 
@@ -116,6 +141,13 @@ class LevelDbNgramTable: public BaseIncrCondProbTable<std::vector<WordIndex>, Wo
                                       bool& found);
         Count getSrcInfo(const std::vector<WordIndex>& s, bool& found);
         Count getSrcTrgInfo(const std::vector<WordIndex>& s, const WordIndex& t, bool& found);
+        void infSrcTrgForSrcSuffixes(const std::vector<WordIndex>& s,
+                                     unsigned int maxSuffixLen,
+                                     const WordIndex& t,
+                                     std::vector<im_pair<Count, Count> >& infVec);
+            // Obtains the counts of the entries (s_k,t), where s_k is
+            // the suffix of s of length k, for k=0...maxSuffixLen. The
+            // counts of each entry are stored in infVec[k]
         Prob pTrgGivenSrc(const std::vector<WordIndex>& s, const WordIndex& t);
         LgProb logpTrgGivenSrc(const std::vector<WordIndex>& s, const WordIndex& t);
         Prob pSrcGivenTrg(const std::vector<WordIndex>& s, const WordIndex& t);
@@ -0,0 +1,335 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordCompletionIndex.cc
+ *
+ * @brief Definitions file for WordCompletionIndex.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WordCompletionIndex.h"
+#include <algorithm>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- BetterWordCmp class
+
+/**
+ * @brief Function object used to sort word identifiers by decreasing
+ * count and alphabetical order.
+ */
+
+class BetterWordCmp
+{
+ public:
+  BetterWordCmp(const std::vector<std::string>& _words,
+                const std::vector<Count>& _wordCounts):words(_words),wordCounts(_wordCounts)
+  {
+  }
+
+  bool operator()(unsigned int wordId1,unsigned int wordId2)const
+  {
+    if((float)wordCounts[wordId1]!=(float)wordCounts[wordId2])
+      return (float)wordCounts[wordId1]>(float)wordCounts[wordId2];
+    else
+      return words[wordId1]<words[wordId2];
+  }
+
+ private:
+  const std::vector<std::string>& words;
+  const std::vector<Count>& wordCounts;
+};
+
+//--------------- WordCompletionIndex class functions
+//
+
+//---------------------------------------
+WordCompletionIndex::WordCompletionIndex(unsigned int _maxCompletions)
+{
+  maxCompletions=(_maxCompletions==0 ? 1 : _maxCompletions);
+  clear();
+}
+
+//---------------------------------------
+void WordCompletionIndex::setMaxCompletions(unsigned int _maxCompletions)
+{
+  if(_maxCompletions==0)
+    _maxCompletions=1;
+  if(_maxCompletions==maxCompletions)
+    return;
+
+      // Rebuild lists of best completions
+  maxCompletions=_maxCompletions;
+  nodeBest.assign(nodeLabel.size()*maxCompletions,WCI_NULL_WORD);
+  for(unsigned int wordId=0;wordId<words.size();++wordId)
+  {
+    unsigned int node=0;
+    updateBest(node,wordId);
+    for(unsigned int i=0;i<words[wordId].size();++i)
+    {
+      node=findChild(node,words[wordId][i]);
+      updateBest(node,wordId);
+    }
+  }
+}
+
+//---------------------------------------
+unsigned int WordCompletionIndex::getMaxCompletions(void)const
+{
+  return maxCompletions;
+}
+
+//---------------------------------------
+void WordCompletionIndex::addWord(const std::string& word,
+                                  Count c)
+{
+  if(word.empty())
+    return;
+
+      // Obtain path of the word, adding the nodes that do not exist
+  std::vector<unsigned int> path;
+  unsigned int node=0;
+  path.push_back(node);
+  for(unsigned int i=0;i<word.size();++i)
+  {
+    unsigned int child=findChild(node,word[i]);
+    if(child==WCI_NULL_NODE)
+      child=addChild(node,word[i]);
+    node=child;
+    path.push_back(node);
+  }
+
+      // Update count of the word
+  unsigned int wordId=nodeWord[node];
+  if(wordId==WCI_NULL_WORD)
+  {
+    wordId=words.size();
+    words.push_back(word);
+    wordCounts.push_back(0);
+    nodeWord[node]=wordId;
+  }
+  wordCounts[wordId]+=c;
+
+      // Update best completions of the prefixes of the word
+  for(unsigned int i=0;i<path.size();++i)
+    updateBest(path[i],wordId);
+}
+
+//---------------------------------------
+Count WordCompletionIndex::getCount(const std::string& word)const
+{
+  unsigned int node=findNode(word);
+  if(node==WCI_NULL_NODE || nodeWord[node]==WCI_NULL_WORD)
+    return 0;
+  else
+    return wordCounts[nodeWord[node]];
+}
+
+//---------------------------------------
+bool WordCompletionIndex::getBestCompletion(const std::string& prefix,
+                                            std::pair<Count,std::string>& completion)const
+{
+  unsigned int node=findNode(prefix);
+  if(node==WCI_NULL_NODE || nodeBest[node*maxCompletions]==WCI_NULL_WORD)
+    return false;
+
+  unsigned int wordId=nodeBest[node*maxCompletions];
+  completion.first=wordCounts[wordId];
+  completion.second=words[wordId].substr(prefix.size());
+  return true;
+}
+
+//---------------------------------------
+void WordCompletionIndex::getBestCompletions(const std::string& prefix,
+                                             CompletionList& completions)const
+{
+  completions.clear();
+  unsigned int node=findNode(prefix);
+  if(node==WCI_NULL_NODE)
+    return;
+
+  std::vector<unsigned int> wordIds;
+  for(unsigned int i=0;i<maxCompletions && nodeBest[node*maxCompletions+i]!=WCI_NULL_WORD;++i)
+    wordIds.push_back(nodeBest[node*maxCompletions+i]);
+  wordIdsToCompletions(prefix,wordIds,completions);
+}
+
+//---------------------------------------
+void WordCompletionIndex::getAllCompletions(const std::string& prefix,
+                                            CompletionList& completions)const
+{
+  completions.clear();
+  unsigned int node=findNode(prefix);
+  if(node==WCI_NULL_NODE)
+    return;
+
+  std::vector<unsigned int> wordIds;
+  collectWords(node,wordIds);
+  std::sort(wordIds.begin(),wordIds.end(),BetterWordCmp(words,wordCounts));
+  wordIdsToCompletions(prefix,wordIds,completions);
+}
+
+//---------------------------------------
+size_t WordCompletionIndex::numWords(void)const
+{
+  return words.size();
+}
+
+//---------------------------------------
+size_t WordCompletionIndex::numNodes(void)const
+{
+  return nodeLabel.size();
+}
+
+//---------------------------------------
+size_t WordCompletionIndex::byteSize(void)const
+{
+  size_t size=nodeLabel.capacity()*sizeof(char);
+  size+=nodeFirstChild.capacity()*sizeof(unsigned int);
+  size+=nodeNextSibling.capacity()*sizeof(unsigned int);
+  size+=nodeWord.capacity()*sizeof(unsigned int);
+  size+=nodeBest.capacity()*sizeof(unsigned int);
+  size+=rootChildren.capacity()*sizeof(unsigned int);
+  size+=wordCounts.capacity()*sizeof(Count);
+  size+=words.capacity()*sizeof(std::string);
+  for(unsigned int i=0;i<words.size();++i)
+    size+=words[i].capacity();
+  return size;
+}
+
+//---------------------------------------
+void WordCompletionIndex::clear(void)
+{
+  nodeLabel.clear();
+  nodeFirstChild.clear();
+  nodeNextSibling.clear();
+  nodeWord.clear();
+  nodeBest.clear();
+  rootChildren.assign(256,WCI_NULL_NODE);
+  words.clear();
+  wordCounts.clear();
+
+      // Add root node
+  nodeLabel.push_back(0);
+  nodeFirstChild.push_back(WCI_NULL_NODE);
+  nodeNextSibling.push_back(WCI_NULL_NODE);
+  nodeWord.push_back(WCI_NULL_WORD);
+  nodeBest.resize(maxCompletions,WCI_NULL_WORD);
+}
+
+//---------------------------------------
+unsigned int WordCompletionIndex::findNode(const std::string& prefix)const
+{
+  unsigned int node=0;
+  for(unsigned int i=0;i<prefix.size() && node!=WCI_NULL_NODE;++i)
+    node=findChild(node,prefix[i]);
+  return node;
+}
+
+//---------------------------------------
+unsigned int WordCompletionIndex::findChild(unsigned int node,
+                                            char c)const
+{
+  if(node==0)
+    return rootChildren[(unsigned char)c];
+
+  unsigned int child=nodeFirstChild[node];
+  while(child!=WCI_NULL_NODE && nodeLabel[child]!=c)
+    child=nodeNextSibling[child];
+  return child;
+}
+
+//---------------------------------------
+unsigned int WordCompletionIndex::addChild(unsigned int node,
+                                           char c)
+{
+  unsigned int child=nodeLabel.size();
+  nodeLabel.push_back(c);
+  nodeFirstChild.push_back(WCI_NULL_NODE);
+  nodeNextSibling.push_back(nodeFirstChild[node]);
+  nodeWord.push_back(WCI_NULL_WORD);
+  nodeBest.resize(nodeBest.size()+maxCompletions,WCI_NULL_WORD);
+  nodeFirstChild[node]=child;
+  if(node==0)
+    rootChildren[(unsigned char)c]=child;
+  return child;
+}
+
+//---------------------------------------
+bool WordCompletionIndex::betterWord(unsigned int wordId1,
+                                     unsigned int wordId2)const
+{
+  return BetterWordCmp(words,wordCounts)(wordId1,wordId2);
+}
+
+//---------------------------------------
+void WordCompletionIndex::updateBest(unsigned int node,
+                                     unsigned int wordId)
+{
+  unsigned int* best=&nodeBest[node*maxCompletions];
+
+      // Obtain position of the word in the list
+  unsigned int pos=0;
+  while(pos<maxCompletions && best[pos]!=WCI_NULL_WORD && best[pos]!=wordId)
+    ++pos;
+  if(pos==maxCompletions)
+  {
+        // The list is full and does not contain the word, replace the
+        // last entry if the word is better
+    if(!betterWord(wordId,best[maxCompletions-1]))
+      return;
+    pos=maxCompletions-1;
+  }
+  best[pos]=wordId;
+
+      // Counts never decrease, so the word can only move towards the
+      // beginning of the list
+  while(pos>0 && betterWord(best[pos],best[pos-1]))
+  {
+    std::swap(best[pos],best[pos-1]);
+    --pos;
+  }
+}
+
+//---------------------------------------
+void WordCompletionIndex::collectWords(unsigned int node,
+                                       std::vector<unsigned int>& wordIds)const
+{
+  std::vector<unsigned int> nodeStack;
+  nodeStack.push_back(node);
+  while(!nodeStack.empty())
+  {
+    unsigned int n=nodeStack.back();
+    nodeStack.pop_back();
+    if(nodeWord[n]!=WCI_NULL_WORD)
+      wordIds.push_back(nodeWord[n]);
+    for(unsigned int child=nodeFirstChild[n];child!=WCI_NULL_NODE;child=nodeNextSibling[child])
+      nodeStack.push_back(child);
+  }
+}
+
+//---------------------------------------
+void WordCompletionIndex::wordIdsToCompletions(const std::string& prefix,
+                                               const std::vector<unsigned int>& wordIds,
+                                               CompletionList& completions)const
+{
+  for(unsigned int i=0;i<wordIds.size();++i)
+    completions.push_back(std::make_pair(wordCounts[wordIds[i]],words[wordIds[i]].substr(prefix.size())));
+}
@@ -0,0 +1,136 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WordCompletionIndex.h
+ *
+ * @brief Declares the WordCompletionIndex class, a character trie
+ * that stores the best completions of each prefix.
+ */
+
+#ifndef _WordCompletionIndex_h
+#define _WordCompletionIndex_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <string>
+#include <vector>
+#include <utility>
+#include "Count.h"
+
+//--------------- Constants ------------------------------------------
+
+#define WCI_DEFAULT_MAX_COMPLETIONS 10
+#define WCI_NULL_NODE               ((unsigned int)-1)
+#define WCI_NULL_WORD               ((unsigned int)-1)
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WordCompletionIndex class
+
+/**
+ * @brief Character trie stored in parallel arrays. Each node keeps the
+ * identifiers of the words with the highest counts among those
+ * starting with the prefix represented by the node, so the best
+ * completions of a prefix are obtained in time proportional to its
+ * length. Word counts can only grow, which allows the lists of best
+ * completions to be updated incrementally when a word is added.
+ */
+
+class WordCompletionIndex
+{
+ public:
+
+  typedef std::vector<std::pair<Count,std::string> > CompletionList;
+
+      // Constructor
+  WordCompletionIndex(unsigned int _maxCompletions=WCI_DEFAULT_MAX_COMPLETIONS);
+
+  void setMaxCompletions(unsigned int _maxCompletions);
+      // Sets the number of completions stored for each prefix,
+      // rebuilding the lists of the existing nodes
+  unsigned int getMaxCompletions(void)const;
+
+  void addWord(const std::string& word,
+               Count c=1);
+      // Increases the count of word by c, c must not be negative
+  Count getCount(const std::string& word)const;
+
+  bool getBestCompletion(const std::string& prefix,
+                         std::pair<Count,std::string>& completion)const;
+      // Obtains the word with highest count starting with prefix,
+      // returns false if there is no such word. Completions are given
+      // as the suffixes to be appended to prefix
+  void getBestCompletions(const std::string& prefix,
+                          CompletionList& completions)const;
+      // Obtains up to getMaxCompletions() words starting with prefix,
+      // sorted by decreasing count. Ties are broken by alphabetical
+      // order
+  void getAllCompletions(const std::string& prefix,
+                         CompletionList& completions)const;
+      // Obtains all the words starting with prefix, sorted as in
+      // getBestCompletions(). The cost of this function grows with
+      // the number of completions
+
+  size_t numWords(void)const;
+  size_t numNodes(void)const;
+  size_t byteSize(void)const;
+      // Memory used by the index, in bytes
+  void clear(void);
+
+ protected:
+
+      // Node arrays, node 0 is the root
+  std::vector<char> nodeLabel;
+  std::vector<unsigned int> nodeFirstChild;
+  std::vector<unsigned int> nodeNextSibling;
+  std::vector<unsigned int> nodeWord;
+      // Identifier of the word ending at each node
+  std::vector<unsigned int> nodeBest;
+      // Best completions of each node, stored in blocks of
+      // maxCompletions identifiers padded with WCI_NULL_WORD
+  std::vector<unsigned int> rootChildren;
+      // Children of the root indexed by character
+
+      // Word arrays
+  std::vector<std::string> words;
+  std::vector<Count> wordCounts;
+
+  unsigned int maxCompletions;
+
+  unsigned int findNode(const std::string& prefix)const;
+  unsigned int findChild(unsigned int node,
+                         char c)const;
+  unsigned int addChild(unsigned int node,
+                        char c);
+  bool betterWord(unsigned int wordId1,
+                  unsigned int wordId2)const;
+  void updateBest(unsigned int node,
+                  unsigned int wordId);
+  void collectWords(unsigned int node,
+                    std::vector<unsigned int>& wordIds)const;
+  void wordIdsToCompletions(const std::string& prefix,
+                            const std::vector<unsigned int>& wordIds,
+                            CompletionList& completions)const;
+};
+
+#endif
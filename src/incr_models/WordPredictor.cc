@@ -137,89 +137,57 @@ void WordPredictor::addSentence(std::vector<std::string> strVec)
 //---------------------------------------
 void WordPredictor::addSentenceAux(std::vector<std::string> strVec)
 {
-  std::vector<char> vecChar;
-  std::string chain;
-  Count *cPtr;
-
   for(unsigned int i=0;i<strVec.size();++i)
-  {
-    chain=strVec[i];
-    vecChar.clear();
-    for(unsigned int j=0;j<chain.size();++j)
-    {
-      vecChar.push_back(chain[j]);
-    }
-    cPtr=charTrie.find(vecChar);
-    if(cPtr==NULL)
-    {
-      charTrie.insert(vecChar,1);
-    }
-    else
-    {
-      *cPtr=*cPtr+(Count)1;
-    }
-  }
+    completionIndex.addWord(strVec[i]);
 }
 
 //---------------------------------------
 void WordPredictor::getSuffixList(std::string input,
                                   SuffixList &out)
 {
-  Trie<char,Count>* triePtr;
-  std::vector<char> charVec;
-  
+  NbestSuffixList completions;
+
   out.clear();
-  for(unsigned int i=0;i<input.size();++i)
-    charVec.push_back(input[i]);
-  triePtr=charTrie.getState(charVec);
-  if(triePtr!=NULL)
+  completionIndex.getAllCompletions(input,completions);
+      // Completions are sorted by decreasing count, so the suffix kept
+      // for each count is the first one in alphabetical order
+  for(int i=completions.size()-1;i>=0;--i)
   {
-    Trie<char,Count>::const_iterator trieIter;
-    std::string suff;
-    unsigned int i;
-    
-    for(trieIter=triePtr->begin();trieIter!=triePtr->end();++trieIter)
-    {
-      suff="";
-      if((double)trieIter->second>(double)0)
-      {
-        if(input.size()>0 && trieIter->first[0]!=input[input.size()-1]) break;
-            // This checking is done to detect whether the iterator
-            // finish the iteration over the words that starts with the
-            // prefix input
-
-        for(i=1;i<trieIter->first.size();++i)
-        {
-          suff.push_back(trieIter->first[i]);
-        }
-        out[trieIter->second]=suff;
-      }
-    }
+    if((double)completions[i].first>(double)0)
+      out[completions[i].first]=completions[i].second;
   }
 }
 
+//---------------------------------------
+void WordPredictor::getNbestSuffixList(std::string input,
+                                       NbestSuffixList &out)
+{
+  completionIndex.getBestCompletions(input,out);
+}
+
+//---------------------------------------
+void WordPredictor::setMaxNbestSuffixes(unsigned int n)
+{
+  completionIndex.setMaxCompletions(n);
+}
+
 //---------------------------------------
 std::pair<Count,std::string> WordPredictor::getBestSuffix(std::string input)
 {
   std::pair<Count,std::string> pcs;
-  SuffixList suffixList; 
-  SuffixList::iterator suffListIter;
-    
-  pcs.first=0;
-  pcs.second="";
-
-  getSuffixList(input,suffixList);
 
-  suffListIter=suffixList.begin();
-  if(suffListIter!=suffixList.end()) pcs=*suffListIter;
-  
+  if(!completionIndex.getBestCompletion(input,pcs))
+  {
+    pcs.first=0;
+    pcs.second="";
+  }
   return pcs;
 }
   
 //---------------------------------------
 void WordPredictor::clear(void)
 {
-  charTrie.clear();
+  completionIndex.clear();
   numSentsToRetain=1;
   strVecVec.clear();
 }
@@ -41,7 +41,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "Count.h"
 #include "ErrorDefs.h"
 #include "AwkInputStream.h"
-#include "Trie.h"
+#include "WordCompletionIndex.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -52,7 +52,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 /**
  * @brief the WordPredictor class tries to predict the ending of
- * incomplete words, and is intended to be used in a CAT scenario
+ * incomplete words, and is intended to be used in a CAT scenario. The
+ * best suffixes of each prefix are kept in a completion index, so
+ * predictions are obtained in time proportional to the length of the
+ * typed prefix
  */
 
 class WordPredictor
@@ -60,6 +63,7 @@ class WordPredictor
  public:
 
   typedef std::map<Count,std::string,std::greater<Count> > SuffixList;
+  typedef WordCompletionIndex::CompletionList NbestSuffixList;
     
       // Constructor
   WordPredictor();
@@ -73,6 +77,13 @@ class WordPredictor
       // Get set of possible suffixes for a string
   void getSuffixList(std::string input,SuffixList &out);
 
+      // Get the suffixes with highest count for a string, sorted by
+      // decreasing count
+  void getNbestSuffixList(std::string input,NbestSuffixList &out);
+
+      // Set maximum number of suffixes returned by getNbestSuffixList
+  void setMaxNbestSuffixes(unsigned int n);
+
       // Get the suffix with highest count for given string
   std::pair<Count,std::string> getBestSuffix(std::string input);
   
@@ -83,7 +94,7 @@ class WordPredictor
   
  protected:
   
-  Trie<char,Count> charTrie;
+  WordCompletionIndex completionIndex;
   unsigned int numSentsToRetain;
   std::vector<std::vector<std::string> > strVecVec;
   
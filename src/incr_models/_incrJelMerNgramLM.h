@@ -91,24 +91,72 @@ class _incrJelMerNgramLM: public _incrNgramLM<SRC_INFO,SRCTRG_INFO>
   ~_incrJelMerNgramLM();
    
  protected:
+
+      // Information of a corpus required to obtain its perplexity for
+      // different weights without querying the n-gram table. For
+      // each n-gram, the maximum-likelihood estimations of the
+      // interpolated orders and the indices of their weights are
+      // stored
+  struct InterpCorpusCache
+  {
+    std::vector<bool> emptyLineVec;
+    std::vector<unsigned int> lineEndVec;
+        // End of the n-grams of each line
+    std::vector<unsigned int> ngramEndVec;
+        // End of the interpolation terms of each n-gram
+    std::vector<unsigned int> weightIdxVec;
+    std::vector<Prob> mlVec;
+    Prob zeroGramProb;
+    unsigned int numWords;
+  };
+  
   std::vector<double> weights;
   unsigned int numBucketsPerOrder;
   double sizeOfBucket;
 
       // Downhill-simplex related functions
-  int new_dhs_eval(const char *corpusFileName,
+  int new_dhs_eval(const InterpCorpusCache& corpusCache,
                    FILE* tmp_file,
                    double* x,
                    double& obj_func);
 
+      // Functions related to corpus caches
+  int obtainInterpCorpusCache(const char *corpusFileName,
+                              InterpCorpusCache& corpusCache);
+  void addNgramToInterpCorpusCache(const std::vector<WordIndex>& s,
+                                   const WordIndex& t,
+                                   InterpCorpusCache& corpusCache);
+  double perplexityGivenInterpCorpusCache(const InterpCorpusCache& corpusCache);
+      // Obtains the same perplexity as the perplexity() function using
+      // the current weights
+
       // Weights related functions
   double getJelMerWeight(const std::vector<WordIndex>& s,
                          const WordIndex& t);
+  double getJelMerWeightGivenCount(unsigned int ctxLen,
+                                   double c);
+      // Returns the weight for contexts of length ctxLen and count c
+  unsigned int getJelMerWeightIdxGivenCount(unsigned int ctxLen,
+                                            double c);
+      // Returns the index in the weights vector of the weight for
+      // contexts of length ctxLen and count c
   virtual double freqOfNgram(const std::vector<WordIndex>& s);
 
-      // Recursive function to interpolate models
-  Prob pTrgGivenSrcRec(const std::vector<WordIndex>& s,
-                       const WordIndex& t);
+      // Functions to obtain the counts required to interpolate models
+  void infSrcTrgForInterp(const std::vector<WordIndex>& s,
+                          const WordIndex& t,
+                          std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec);
+      // Obtains the information of the n-grams interpolated to
+      // obtain p(t|s), from the lowest to the highest order
+  virtual void infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                                       unsigned int maxSuffixLen,
+                                       const WordIndex& t,
+                                       std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec);
+      // Obtains the information of the n-grams (s_k,t), where s_k is
+      // the suffix of s of length k, for k=0...maxSuffixLen. The
+      // default implementation performs separate table queries for
+      // each suffix, derived classes can redefine it to take
+      // advantage of the table structure
 };
 
 //--------------- Template function definitions
@@ -117,52 +165,70 @@ class _incrJelMerNgramLM: public _incrNgramLM<SRC_INFO,SRCTRG_INFO>
 template<class SRC_INFO,class SRCTRG_INFO>
 Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<WordIndex>& s,
                                                             const WordIndex& t)
+{
+      // Obtain the counts for every order
+  std::vector<im_pair<SRC_INFO,SRCTRG_INFO> > infVec;
+  infSrcTrgForInterp(s,t,infVec);
+
+      // Calculate interpolated probability, starting from the
+      // zerogram probability
+  Prob p=(double)1.0/(double)this->getVocabSize();
+  for(unsigned int k=0;k<infVec.size();++k)
+  {
+    float c_s=(float)infVec[k].first.get_c_s();
+    Prob ml=0;
+    if(c_s!=0)
+      ml=(float)infVec[k].second.get_c_st()/c_s;
+    double weight=getJelMerWeightGivenCount(k,(double)infVec[k].first);
+    p=weight * (double) ml + (1-weight) * (double) p;
+  }
+  return p;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::infSrcTrgForInterp(const std::vector<WordIndex>& s,
+                                                                  const WordIndex& t,
+                                                                  std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec)
 {
       // Remove extra BOS symbols
   bool found;
-  std::vector<WordIndex> aux_s;
+  unsigned int ctxLen=s.size();
   if(s.size()>=2)
   {
+    WordIndex bosId=this->getBosId(found);
     unsigned int i=0;
-    while(i<s.size() && s[i]==this->getBosId(found))
+    while(i<s.size() && s[i]==bosId)
     {
       ++i;
     }
     if(i>0) --i;
-    for(;i<s.size();++i)
-      aux_s.push_back(s[i]);
+    ctxLen=s.size()-i;
   }
-  else aux_s=s;
 
-      // Calculate interpolated probability
-  Prob p=pTrgGivenSrcRec(aux_s,t);
-  return p;
+      // Obtain the counts for every order
+  infSrcTrgForCtxSuffixes(s,ctxLen,t,infVec);
 }
 
 //---------------
 template<class SRC_INFO,class SRCTRG_INFO>
-Prob _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::pTrgGivenSrcRec(const std::vector<WordIndex>& s,
-                                                               const WordIndex& t)
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::infSrcTrgForCtxSuffixes(const std::vector<WordIndex>& s,
+                                                                       unsigned int maxSuffixLen,
+                                                                       const WordIndex& t,
+                                                                       std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec)
 {
-  if(s.size()==0)
-  {
-    double weight=getJelMerWeight(s,t);
-    double zerogramprob=(double)1.0/(double)this->getVocabSize();
-
-    return (weight * (double) this->tablePtr->pTrgGivenSrc(s,t))+((1-weight) * zerogramprob);  
-  }
-  else
+  std::vector<WordIndex> suffix;
+  infVec.resize(maxSuffixLen+1);
+  for(unsigned int k=0;k<=maxSuffixLen;++k)
   {
-    std::vector<WordIndex> s_shifted;
-    if(s.size()>1)
+    bool found;
+    suffix.assign(s.end()-k,s.end());
+    infVec[k]=this->tablePtr->infSrcTrg(suffix,t,found);
+    if(!found)
     {
-      for(unsigned int i=1;i<s.size();++i)
-      {
-        s_shifted.push_back(s[i]);
-      }
+      SRCTRG_INFO srcTrgInfoNull;
+      infVec[k].second=srcTrgInfoNull;
     }
-    double weight=getJelMerWeight(s,t);
-    return weight * (double) this->tablePtr->pTrgGivenSrc(s,t)+ (1-weight) * (double) pTrgGivenSrcRec(s_shifted,t);
   }
 }
 
@@ -179,12 +245,24 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
   double* x=(double*) malloc(ndim*sizeof(double));
   double y;
 
+      // Obtain the information required to evaluate the perplexity
+      // of the corpus for different weights
+  InterpCorpusCache corpusCache;
+  if(obtainInterpCorpusCache(corpusFileName,corpusCache)==THOT_ERROR)
+  {
+    free(start);
+    free(x);
+    return THOT_ERROR;
+  }
+  
       // Create temporary file
   FILE* tmp_file=tmpfile();
   
   if(tmp_file==0)
   {
     std::cerr<<"Error updating of Jelinek Mercer's language model weights, tmp file could not be created"<<std::endl;
+    free(start);
+    free(x);
     return THOT_ERROR;
   }
     
@@ -211,7 +289,7 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
         break;
       case DSO_EVAL_FUNC: // A new function evaluation is requested by downhill simplex
         double perp;
-        int retEval=new_dhs_eval(corpusFileName,tmp_file,x,perp);
+        int retEval=new_dhs_eval(corpusCache,tmp_file,x,perp);
         if(retEval==THOT_ERROR)
         {
           end=true;
@@ -254,17 +332,13 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::updateModelWeights(const char *cor
 
 //---------------
 template<class SRC_INFO,class SRCTRG_INFO>
-int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFileName,
+int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const InterpCorpusCache& corpusCache,
                                                            FILE* tmp_file,
                                                            double* x,
                                                            double& obj_func)
 {
-  unsigned int numOfSentences;
-  unsigned int numWords;
-  LgProb totalLogProb;
   bool weightsArePositive=true;
   bool weightsAreBelowOne=true;
-  int retVal;
   
       // Fix weights to be evaluated
   for(unsigned int i=0;i<weights.size();++i)
@@ -276,12 +350,11 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFil
   if(weightsArePositive && weightsAreBelowOne)
   {
         // Obtain perplexity
-    retVal=this->perplexity(corpusFileName,numOfSentences,numWords,totalLogProb,obj_func);
+    obj_func=perplexityGivenInterpCorpusCache(corpusCache);
   }
   else
   {
     obj_func=DBL_MAX;
-    retVal=THOT_OK;
   }
       // Print result to tmp file
   fprintf(tmp_file,"%g\n",obj_func);
@@ -290,7 +363,103 @@ int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::new_dhs_eval(const char *corpusFil
       // indicator is set at the start of the stream
   rewind(tmp_file);
 
-  return retVal;
+  return THOT_OK;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::obtainInterpCorpusCache(const char *corpusFileName,
+                                                                      InterpCorpusCache& corpusCache)
+{
+  AwkInputStream awk;
+  bool found;
+  WordIndex eosId=this->getEosId(found);
+
+  if(awk.open(corpusFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  corpusCache.zeroGramProb=(double)1.0/(double)this->getVocabSize();
+  corpusCache.numWords=0;
+  while(awk.getln())
+  {
+        // Process the n-grams of the sentence in the same way as the
+        // getSentenceLog10Prob() function
+    if(awk.NF>=1)
+    {
+      corpusCache.numWords+=awk.NF;
+      std::vector<WordIndex> state;
+      this->getStateForBeginOfSentence(state);
+      for(unsigned int i=1;i<=awk.NF;++i)
+      {
+        WordIndex w=this->stringToWordIndex(awk.dollar(i));
+        addNgramToInterpCorpusCache(state,w,corpusCache);
+        this->addNextWordToState(w,state);
+      }
+      addNgramToInterpCorpusCache(state,eosId,corpusCache);
+    }
+    corpusCache.emptyLineVec.push_back(awk.NF==0);
+    corpusCache.lineEndVec.push_back(corpusCache.ngramEndVec.size());
+  }
+  return THOT_OK;
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+void _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::addNgramToInterpCorpusCache(const std::vector<WordIndex>& s,
+                                                                           const WordIndex& t,
+                                                                           InterpCorpusCache& corpusCache)
+{
+  std::vector<im_pair<SRC_INFO,SRCTRG_INFO> > infVec;
+  infSrcTrgForInterp(s,t,infVec);
+  for(unsigned int k=0;k<infVec.size();++k)
+  {
+    float c_s=(float)infVec[k].first.get_c_s();
+    Prob ml=0;
+    if(c_s!=0)
+      ml=(float)infVec[k].second.get_c_st()/c_s;
+    corpusCache.mlVec.push_back(ml);
+    corpusCache.weightIdxVec.push_back(getJelMerWeightIdxGivenCount(k,(double)infVec[k].first));
+  }
+  corpusCache.ngramEndVec.push_back(corpusCache.mlVec.size());
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::perplexityGivenInterpCorpusCache(const InterpCorpusCache& corpusCache)
+{
+  LgProb logp=0;
+  LgProb totalLogProb=0;
+  unsigned int ngramIdx=0;
+  unsigned int termIdx=0;
+  unsigned int numLines=corpusCache.lineEndVec.size();
+
+      // The arithmetic operations follow those executed by the
+      // perplexity() function
+  for(unsigned int n=0;n<numLines;++n)
+  {
+    if(!corpusCache.emptyLineVec[n])
+    {
+      LgProb total_lp=0;
+      for(;ngramIdx<corpusCache.lineEndVec[n];++ngramIdx)
+      {
+            // Interpolate the orders of the n-gram
+        Prob p=corpusCache.zeroGramProb;
+        for(;termIdx<corpusCache.ngramEndVec[ngramIdx];++termIdx)
+        {
+          double weight=weights[corpusCache.weightIdxVec[termIdx]];
+          p=weight * (double) corpusCache.mlVec[termIdx] + (1-weight) * (double) p;
+        }
+        LgProb lp=log((double)p);
+        total_lp=total_lp+lp;
+      }
+      logp=total_lp*((double)1/M_LN10);
+    }
+    totalLogProb+=logp;
+  }
+  return exp(-((double)totalLogProb/(corpusCache.numWords+numLines))*M_LN10);
 }
 
 //---------------
@@ -303,16 +472,38 @@ double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeight(const std::vect
     return weights[s.size()];
   }
   else
+  {
+    return getJelMerWeightGivenCount(s.size(),freqOfNgram(s));
+  }
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+double _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeightGivenCount(unsigned int ctxLen,
+                                                                           double c)
+{
+  return weights[getJelMerWeightIdxGivenCount(ctxLen,c)];
+}
+
+//---------------
+template<class SRC_INFO,class SRCTRG_INFO>
+unsigned int _incrJelMerNgramLM<SRC_INFO,SRCTRG_INFO>::getJelMerWeightIdxGivenCount(unsigned int ctxLen,
+                                                                                    double c)
+{
+  if(numBucketsPerOrder==1)
+  {
+    return ctxLen;
+  }
+  else
   {
         // Init variables
-    unsigned int order=s.size()+1;
-    double c=freqOfNgram(s);
+    unsigned int order=ctxLen+1;
     unsigned int bucketIdx=(unsigned int) trunc(c/sizeOfBucket);
     if(bucketIdx>numBucketsPerOrder-1)
       bucketIdx=numBucketsPerOrder-1;
     
-        // Return weight
-    return weights[((order-1)*numBucketsPerOrder)+bucketIdx];
+        // Return weight index
+    return ((order-1)*numBucketsPerOrder)+bucketIdx;
   }
 }
 
@@ -0,0 +1,264 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_lm.cc
+ *
+ * @brief Measures the query speed (in n-gram queries per second) of
+ * the language model class given in the master.ini file, using the
+ * n-grams contained in a test corpus.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LM_Defs.h"
+  // NOTE: this file should be included first, since it defines the
+  // _FILE_OFFSET_BITS constant. This constant has to be defined
+  // before including any STL header files to avoid conflicts.
+
+#include "BaseNgramLM.h"
+#include "WordIndex.h"
+#include "DynClassFileHandler.h"
+#include "SimpleDynClassLoader.h"
+#include "AwkInputStream.h"
+#include "ctimer.h"
+#include "options.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+
+//--------------- Constants ------------------------------------------
+
+#define DEFAULT_NUM_REPETITIONS 10
+
+//--------------- Function Declarations ------------------------------
+
+int init_lm(int verbosity);
+void release_lm(int verbosity);
+int obtainQueries(void);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Type definitions -----------------------------------
+
+
+//--------------- Global variables -----------------------------------
+
+std::string lmFileName;
+std::string corpusFileName;
+unsigned int order;
+unsigned int numReps;
+SimpleDynClassLoader<BaseNgramLM<std::vector<WordIndex> > > baseNgramLMDynClassLoader;
+BaseNgramLM<std::vector<WordIndex> >* lm;
+std::vector<std::vector<WordIndex> > histVec;
+std::vector<WordIndex> wordVec;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  double elapsed_ant,elapsed,ucpu,scpu;
+
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+    if(init_lm(true)==THOT_ERROR)
+      return THOT_ERROR;
+
+        // Load language model
+    if(lm->load(lmFileName.c_str())==THOT_ERROR)
+    {
+      std::cerr<<"Error while loading language model"<<std::endl;
+      release_lm(true);
+      return THOT_ERROR;
+    }
+    lm->setNgramOrder(order);
+
+        // Obtain the n-gram queries contained in the corpus
+    if(obtainQueries()==THOT_ERROR)
+    {
+      release_lm(true);
+      return THOT_ERROR;
+    }
+    std::cerr<<"Number of n-gram queries: "<<wordVec.size()<<std::endl;
+
+        // Execute queries
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    double total_logp=0;
+    for(unsigned int r=0;r<numReps;++r)
+    {
+      total_logp=0;
+      for(unsigned int i=0;i<wordVec.size();++i)
+        total_logp+=(double)lm->getNgramLgProb(wordVec[i],histVec[i]);
+    }
+    ctimer(&elapsed,&ucpu,&scpu);
+    double total_time=elapsed-elapsed_ant;
+    double numQueries=(double)wordVec.size()*numReps;
+
+        // Print results
+    std::cout<<"* Number of queries: "<<numQueries<<" ("<<numReps<<" repetitions)"<<std::endl;
+    std::cout<<"* Total log10 prob: "<<total_logp/M_LN10<<std::endl;
+    std::cout<<"* Retrieving time: "<<total_time<<std::endl;
+    std::cout<<"* Queries per second: "<<(total_time>0 ? numQueries/total_time : 0)<<std::endl;
+
+    release_lm(true);
+
+    return THOT_OK;
+  }
+  else return THOT_ERROR;
+}
+
+//---------------
+int obtainQueries(void)
+{
+  AwkInputStream awk;
+  if(awk.open(corpusFileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  bool found;
+  WordIndex bosId=lm->getBosId(found);
+  WordIndex eosId=lm->getEosId(found);
+  while(awk.getln())
+  {
+        // Obtain sentence, including end of sentence symbol
+    std::vector<WordIndex> sent;
+    for(unsigned int i=1;i<=awk.NF;++i)
+      sent.push_back(lm->stringToWordIndex(awk.dollar(i)));
+    sent.push_back(eosId);
+
+        // Obtain history for each word, using begin of sentence
+        // symbols as padding
+    std::vector<WordIndex> hist;
+    for(unsigned int i=1;i<order;++i)
+      hist.push_back(bosId);
+    for(unsigned int i=0;i<sent.size();++i)
+    {
+      histVec.push_back(hist);
+      wordVec.push_back(sent[i]);
+      if(!hist.empty())
+      {
+        hist.erase(hist.begin());
+        hist.push_back(sent[i]);
+      }
+    }
+  }
+  return THOT_OK;
+}
+
+//---------------
+int init_lm(int verbosity)
+{
+      // Initialize dynamic class file handler
+  DynClassFileHandler dynClassFileHandler;
+  if(dynClassFileHandler.load(THOT_MASTER_INI_PATH,verbosity)==THOT_ERROR)
+  {
+    std::cerr<<"Error while loading ini file"<<std::endl;
+    return THOT_ERROR;
+  }
+      // Define variables to obtain base class infomation
+  std::string baseClassName;
+  std::string soFileName;
+  std::string initPars;
+
+      ////////// Obtain info for BaseNgramLM class
+  baseClassName="BaseNgramLM";
+  if(dynClassFileHandler.getInfoForBaseClass(baseClassName,soFileName,initPars)==THOT_ERROR)
+  {
+    std::cerr<<"Error: ini file does not contain information about "<<baseClassName<<" class"<<std::endl;
+    std::cerr<<"Please check content of master.ini file or execute \"thot_handle_ini_files -r\" to reset it"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Load class derived from BaseNgramLM dynamically
+  if(!baseNgramLMDynClassLoader.open_module(soFileName,verbosity))
+  {
+    std::cerr<<"Error: so file ("<<soFileName<<") could not be opened"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  lm=baseNgramLMDynClassLoader.make_obj(initPars);
+  if(lm==NULL)
+  {
+    std::cerr<<"Error: BaseNgramLM pointer could not be instantiated"<<std::endl;
+    baseNgramLMDynClassLoader.close_module();
+
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//---------------
+void release_lm(int verbosity)
+{
+  delete lm;
+  baseNgramLMDynClassLoader.close_module(verbosity);
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+      /* Take the corpus file name */
+ err=readSTLstring(argc,argv, "-c", &corpusFileName);
+ if(err==-1 || argc<2)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take the language model file name */
+ err=readSTLstring(argc,argv, "-lm", &lmFileName);
+ if(err==-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+      /* Take order of the n-grams */
+ err=readUnsignedInt(argc,argv, "-n", &order);
+ if(err==-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take number of repetitions */
+ err=readUnsignedInt(argc,argv, "-r", &numReps);
+ if(err==-1 || numReps==0)
+ {
+   numReps=DEFAULT_NUM_REPETITIONS;
+ }
+
+ return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+ printf("Usage: thot_bench_lm -c <string> -lm <string> -n <int> [-r <int>]\n");
+ printf("-c <string>          Corpus file to be processed.\n\n");
+ printf("-lm <string>         Language model file name.\n\n");
+ printf("-n <int>             Order of the n-grams.\n\n");
+ printf("-r <int>             Number of times the n-gram queries are executed\n");
+ printf("                     (%d by default).\n\n",DEFAULT_NUM_REPETITIONS);
+}
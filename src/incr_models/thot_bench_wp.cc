@@ -0,0 +1,250 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_wp.cc
+ *
+ * @brief Measures the latency per keystroke of the word predictor
+ * used in the CAT scenario, simulating a user that types the words
+ * of a test corpus character by character.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WordPredictor.h"
+#include "AwkInputStream.h"
+#include "ctimer.h"
+#include "options.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define DEFAULT_NUM_REPETITIONS 10
+
+//--------------- Function Declarations ------------------------------
+
+int obtainWords(void);
+double benchNbestLookup(unsigned int& numKeystrokes,
+                        unsigned int& numSavedKeystrokes,
+                        size_t& numSuffixes);
+double benchExhaustiveLookup(size_t& numSuffixes);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+
+//--------------- Type definitions -----------------------------------
+
+
+//--------------- Global variables -----------------------------------
+
+std::string wpFileName;
+std::string corpusFileName;
+unsigned int numReps;
+unsigned int maxSuffixes;
+bool exhaustive;
+WordPredictor wordPredictor;
+std::vector<std::string> wordVec;
+
+//--------------- Function Definitions -------------------------------
+
+//---------------
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+        // Load word predictor
+    double elapsed_ant,elapsed,ucpu,scpu;
+    ctimer(&elapsed_ant,&ucpu,&scpu);
+    wordPredictor.setMaxNbestSuffixes(maxSuffixes);
+    if(wordPredictor.load(wpFileName.c_str())==THOT_ERROR)
+    {
+      std::cerr<<"Error while loading word predictor"<<std::endl;
+      return THOT_ERROR;
+    }
+    ctimer(&elapsed,&ucpu,&scpu);
+    std::cerr<<"Loading time: "<<elapsed-elapsed_ant<<std::endl;
+
+        // Obtain the words typed by the user
+    if(obtainWords()==THOT_ERROR)
+      return THOT_ERROR;
+    std::cerr<<"Number of words: "<<wordVec.size()<<std::endl;
+
+        // Simulate keystrokes using the best suffixes
+    unsigned int numKeystrokes;
+    unsigned int numSavedKeystrokes;
+    size_t numSuffixes;
+    double total_time=benchNbestLookup(numKeystrokes,numSavedKeystrokes,numSuffixes);
+    double numQueries=(double)numKeystrokes*numReps;
+
+        // Print results
+    std::cout<<"* Number of keystrokes: "<<numKeystrokes<<" ("<<numReps<<" repetitions)"<<std::endl;
+    std::cout<<"* Keystrokes saved by the best suffix: "<<numSavedKeystrokes;
+    if(numKeystrokes>0)
+      std::cout<<" ("<<100.0*numSavedKeystrokes/numKeystrokes<<"%)";
+    std::cout<<std::endl;
+    std::cout<<"* N-best lookup ("<<maxSuffixes<<" suffixes) retrieved suffixes: "<<numSuffixes<<std::endl;
+    std::cout<<"* N-best lookup time: "<<total_time<<std::endl;
+    std::cout<<"* N-best lookup latency per keystroke (us): "<<(numQueries>0 ? 1e6*total_time/numQueries : 0)<<std::endl;
+
+    if(exhaustive)
+    {
+      total_time=benchExhaustiveLookup(numSuffixes);
+      std::cout<<"* Exhaustive lookup retrieved suffixes: "<<numSuffixes<<std::endl;
+      std::cout<<"* Exhaustive lookup time: "<<total_time<<std::endl;
+      std::cout<<"* Exhaustive lookup latency per keystroke (us): "<<(numQueries>0 ? 1e6*total_time/numQueries : 0)<<std::endl;
+    }
+
+    return THOT_OK;
+  }
+  else return THOT_ERROR;
+}
+
+//---------------
+int obtainWords(void)
+{
+  AwkInputStream awk;
+  if(awk.open(corpusFileName.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  while(awk.getln())
+  {
+    for(unsigned int i=1;i<=awk.NF;++i)
+      wordVec.push_back(awk.dollar(i));
+  }
+  return THOT_OK;
+}
+
+//---------------
+double benchNbestLookup(unsigned int& numKeystrokes,
+                        unsigned int& numSavedKeystrokes,
+                        size_t& numSuffixes)
+{
+  double elapsed_ant,elapsed,ucpu,scpu;
+  WordPredictor::NbestSuffixList suffixList;
+
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int r=0;r<numReps;++r)
+  {
+    numKeystrokes=0;
+    numSavedKeystrokes=0;
+    numSuffixes=0;
+    for(unsigned int i=0;i<wordVec.size();++i)
+    {
+          // The user types the characters of the word until the best
+          // suffix completes it
+      bool completed=false;
+      for(unsigned int j=1;j<=wordVec[i].size();++j)
+      {
+        std::string prefix=wordVec[i].substr(0,j);
+        wordPredictor.getNbestSuffixList(prefix,suffixList);
+        numSuffixes+=suffixList.size();
+        ++numKeystrokes;
+        if(!completed && !suffixList.empty() && prefix+suffixList[0].second==wordVec[i])
+        {
+          numSavedKeystrokes+=wordVec[i].size()-j;
+          completed=true;
+        }
+      }
+    }
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+
+  return elapsed-elapsed_ant;
+}
+
+//---------------
+double benchExhaustiveLookup(size_t& numSuffixes)
+{
+  double elapsed_ant,elapsed,ucpu,scpu;
+  WordPredictor::SuffixList suffixList;
+
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  for(unsigned int r=0;r<numReps;++r)
+  {
+    numSuffixes=0;
+    for(unsigned int i=0;i<wordVec.size();++i)
+    {
+      for(unsigned int j=1;j<=wordVec[i].size();++j)
+      {
+        wordPredictor.getSuffixList(wordVec[i].substr(0,j),suffixList);
+        numSuffixes+=suffixList.size();
+      }
+    }
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+
+  return elapsed-elapsed_ant;
+}
+
+//---------------
+int TakeParameters(int argc,char *argv[])
+{
+  int err;
+
+      /* Take the corpus file name */
+ err=readSTLstring(argc,argv, "-c", &corpusFileName);
+ if(err==-1 || argc<2)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take the word predictor file name */
+ err=readSTLstring(argc,argv, "-wp", &wpFileName);
+ if(err==-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take number of suffixes */
+ err=readUnsignedInt(argc,argv, "-k", &maxSuffixes);
+ if(err==-1 || maxSuffixes==0)
+ {
+   maxSuffixes=WCI_DEFAULT_MAX_COMPLETIONS;
+ }
+
+     /* Take number of repetitions */
+ err=readUnsignedInt(argc,argv, "-r", &numReps);
+ if(err==-1 || numReps==0)
+ {
+   numReps=DEFAULT_NUM_REPETITIONS;
+ }
+
+ exhaustive=readOption(argc,argv,"-e")!=-1;
+
+ return THOT_OK;
+}
+
+//---------------
+void printUsage(void)
+{
+ printf("Usage: thot_bench_wp -c <string> -wp <string> [-k <int>] [-r <int>] [-e]\n");
+ printf("-c <string>          Corpus file with the words typed by the user.\n\n");
+ printf("-wp <string>         File with sentences used to train the word predictor.\n\n");
+ printf("-k <int>             Number of suffixes obtained for each keystroke\n");
+ printf("                     (%d by default).\n\n",WCI_DEFAULT_MAX_COMPLETIONS);
+ printf("-r <int>             Number of times the keystrokes are simulated\n");
+ printf("                     (%d by default).\n\n",DEFAULT_NUM_REPETITIONS);
+ printf("-e                   Also measure the latency of the exhaustive search\n");
+ printf("                     of suffixes.\n\n");
+}
@@ -0,0 +1,898 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_count_ngrams.cc
+ *
+ * @brief Extracts the n-gram counts of a monolingual corpus. Sentences
+ * are counted in parallel into hash-sharded tables, which are spilled
+ * to sorted temporary runs when the memory budget is exceeded. The
+ * runs are k-way merged and the result is written either in the text
+ * format generated by thot_get_ngram_counts or as a LevelDB database.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LM_Defs.h"
+  // NOTE: this file should be included first, since it defines the
+  // _FILE_OFFSET_BITS constant. This constant has to be defined
+  // before including any STL header files to avoid conflicts.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <map>
+#include <string>
+#include <algorithm>
+#include <unordered_map>
+#include "options.h"
+#include "ThreadPool.h"
+#include "SortedRunUtils.h"
+#ifdef HAVE_LEVELDB_LIB
+#include "LevelDbNgramTable.h"
+#include "im_pair.h"
+#endif
+
+//--------------- Constants ------------------------------------------
+
+#define DEFAULT_MEM_MB      512
+#define BLOCK_NUM_LINES     100000
+#define ENTRY_MEM_OVERHEAD  64
+#define OUT_BUFF_SIZE       (1<<20)
+#define KEY_SEP             '\0'
+
+//--------------- Type definitions -----------------------------------
+
+typedef unsigned long long NgramCount;
+typedef std::unordered_map<std::string,NgramCount> NgramCountMap;
+typedef std::pair<std::string,NgramCount> NgramCountEntry;
+  // N-gram keys store the words separated by KEY_SEP, so sorting the
+  // keys places each n-gram right after its history and before any
+  // other n-gram not sharing such history
+
+struct CountShard
+{
+  NgramCountMap countMap;
+  size_t memBytes;
+  std::vector<NgramCountEntry> sortedEntries;
+};
+
+struct CountTask
+{
+  const std::vector<std::string>* linesPtr;
+  size_t begin;
+  size_t end;
+  std::vector<NgramCountMap> shardMaps;
+  NgramCount numWords;
+};
+
+struct MergeShardTask
+{
+  CountShard* shardPtr;
+  unsigned int shardIdx;
+  const std::vector<CountTask*>* countTasksPtr;
+};
+
+    // Sorted sequences of n-gram counts stored in memory or in
+    // temporary run files
+typedef SortedRunSource<NgramCountEntry> NgramCountSource;
+typedef MemRunSource<NgramCountEntry> MemNgramCountSource;
+typedef KeyValueRunSource<NgramCount> RunNgramCountSource;
+typedef SortedRunMerger<NgramCountEntry,KeyLess<NgramCountEntry> > NgramCountMerger;
+
+//--------------- NgramCountSink class
+
+/**
+ * @brief Receives n-gram counts sorted by key.
+ */
+
+class NgramCountSink
+{
+ public:
+  virtual int add(const NgramCountEntry& entry)=0;
+  virtual ~NgramCountSink(){}
+};
+
+class RunNgramCountSink: public NgramCountSink
+{
+ public:
+  RunNgramCountSink(FILE* _file);
+  int add(const NgramCountEntry& entry);
+
+ private:
+  FILE* file;
+};
+
+/**
+ * @brief Base class for sinks generating the final n-gram table. The
+ * count of the history of each n-gram is obtained from the path of
+ * n-grams currently being visited.
+ */
+
+class NgramTableSink: public NgramCountSink
+{
+ public:
+  NgramTableSink(NgramCount _numWords);
+  int add(const NgramCountEntry& entry);
+
+ protected:
+  virtual int writeEntry(const std::vector<std::string>& words,
+                         NgramCount histCount,
+                         NgramCount count)=0;
+
+ private:
+  NgramCount numWords;
+  std::vector<std::string> pathWords;
+  std::vector<NgramCount> pathCounts;
+};
+
+class TextNgramTableSink: public NgramTableSink
+{
+ public:
+  TextNgramTableSink(NgramCount _numWords,
+                     FILE* _file);
+
+ protected:
+  int writeEntry(const std::vector<std::string>& words,
+                 NgramCount histCount,
+                 NgramCount count);
+
+ private:
+  FILE* file;
+};
+
+#ifdef HAVE_LEVELDB_LIB
+class LevelDbNgramTableSink: public NgramTableSink
+{
+ public:
+  LevelDbNgramTableSink(NgramCount _numWords,
+                        LevelDbNgramTable* _levelDbNtPtr);
+  const std::map<std::string,WordIndex>& getVocab(void)const;
+
+ protected:
+  int writeEntry(const std::vector<std::string>& words,
+                 NgramCount histCount,
+                 NgramCount count);
+
+ private:
+  LevelDbNgramTable* levelDbNtPtr;
+  std::map<std::string,WordIndex> vocab;
+
+  WordIndex getSymbolId(const std::string& symbol);
+};
+#endif
+
+//--------------- Function Declarations ------------------------------
+
+int countCorpus(ThreadPool& pool,
+                std::vector<CountShard>& shards,
+                std::vector<FILE*>& runFiles,
+                NgramCount& numWords,
+                NgramCount& numSents);
+void processBlock(ThreadPool& pool,
+                  const std::vector<std::string>& lines,
+                  std::vector<CountShard>& shards,
+                  NgramCount& numWords);
+void sortShards(ThreadPool& pool,
+                std::vector<CountShard>& shards);
+int spillShards(ThreadPool& pool,
+                std::vector<CountShard>& shards,
+                std::vector<FILE*>& runFiles);
+int mergeSources(std::vector<NgramCountSource*>& sources,
+                 NgramCountSink& sink);
+int writeTable(std::vector<NgramCountSource*>& sources,
+               NgramCount numWords);
+void countTask(void* taskData);
+void mergeShardTask(void* taskData);
+void sortShardTask(void* taskData);
+void splitLine(const std::string& line,
+               std::vector<std::string>& words);
+void replaceFirstOccurrencesByUnk(std::string& line,
+                                  std::map<std::string,bool>& vocab);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+void printDesc(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string corpusFileName;
+unsigned int ngramOrder;
+bool unkGiven;
+bool levelDbOutput;
+unsigned int numThreads;
+unsigned int memMb;
+std::string tmpDir;
+std::string outFileName;
+
+//--------------- Function Definitions -------------------------------
+
+//--------------- main function
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+    ThreadPool pool(numThreads);
+    std::vector<CountShard> shards(numThreads);
+    std::vector<FILE*> runFiles;
+    NgramCount numWords;
+    NgramCount numSents;
+    int ret;
+
+        // Count n-grams of the corpus
+    ret=countCorpus(pool,shards,runFiles,numWords,numSents);
+
+        // Obtain sorted sources to be merged. The last block is
+        // spilled only if previous blocks were spilled
+    std::vector<NgramCountSource*> sources;
+    if(ret==THOT_OK)
+    {
+      if(!runFiles.empty())
+      {
+        ret=spillShards(pool,shards,runFiles);
+        for(unsigned int i=0;i<runFiles.size();++i)
+        {
+          rewind(runFiles[i]);
+          sources.push_back(new RunNgramCountSource(runFiles[i]));
+        }
+      }
+      else
+      {
+        sortShards(pool,shards);
+        for(unsigned int i=0;i<shards.size();++i)
+          sources.push_back(new MemNgramCountSource(&shards[i].sortedEntries));
+      }
+    }
+
+    if(ret==THOT_OK)
+    {
+          // Add begin and end of sentence symbols
+      std::vector<NgramCountEntry> bosEosEntries;
+      bosEosEntries.push_back(std::make_pair(std::string(EOS_STR),numSents));
+      bosEosEntries.push_back(std::make_pair(std::string(BOS_STR),numSents));
+      std::sort(bosEosEntries.begin(),bosEosEntries.end());
+      sources.push_back(new MemNgramCountSource(&bosEosEntries));
+
+          // Merge sources and write n-gram table
+      std::cerr<<"Number of sentences: "<<numSents<<" ; number of runs: "<<runFiles.size()<<std::endl;
+      ret=writeTable(sources,numWords);
+    }
+
+        // Release sources
+    for(unsigned int i=0;i<sources.size();++i)
+      delete sources[i];
+    for(unsigned int i=0;i<runFiles.size();++i)
+      fclose(runFiles[i]);
+
+    return ret;
+  }
+  else return THOT_ERROR;
+}
+
+//--------------- countCorpus() function
+int countCorpus(ThreadPool& pool,
+                std::vector<CountShard>& shards,
+                std::vector<FILE*>& runFiles,
+                NgramCount& numWords,
+                NgramCount& numSents)
+{
+  std::ifstream corpusStream(corpusFileName.c_str());
+  if(!corpusStream)
+  {
+    std::cerr<<"Error: file "<<corpusFileName<<" with training sentences does not exist"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  numWords=0;
+  numSents=0;
+  std::map<std::string,bool> unkVocab;
+  std::vector<std::string> lines;
+  lines.reserve(BLOCK_NUM_LINES);
+  std::string line;
+  bool endOfCorpus=false;
+  while(!endOfCorpus)
+  {
+        // Read block of lines
+    lines.clear();
+    while(lines.size()<BLOCK_NUM_LINES)
+    {
+      if(!std::getline(corpusStream,line))
+      {
+        endOfCorpus=true;
+        break;
+      }
+      if(unkGiven)
+        replaceFirstOccurrencesByUnk(line,unkVocab);
+      lines.push_back(line);
+    }
+    if(lines.empty())
+      break;
+    numSents+=lines.size();
+
+        // Count n-grams of the block
+    processBlock(pool,lines,shards,numWords);
+
+        // Spill shards if memory budget is exceeded
+    size_t memBytes=0;
+    for(unsigned int i=0;i<shards.size();++i)
+      memBytes+=shards[i].memBytes;
+    if(memBytes>((size_t)memMb<<20))
+    {
+      if(spillShards(pool,shards,runFiles)==THOT_ERROR)
+        return THOT_ERROR;
+    }
+  }
+  if(corpusStream.bad())
+  {
+    std::cerr<<"Error while reading file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//--------------- processBlock() function
+void processBlock(ThreadPool& pool,
+                  const std::vector<std::string>& lines,
+                  std::vector<CountShard>& shards,
+                  NgramCount& numWords)
+{
+      // Count n-grams of each fragment of the block into local
+      // shard maps
+  unsigned int numTasks=std::min((size_t)pool.getNumThreads(),lines.size());
+  std::vector<CountTask*> countTasks;
+  for(unsigned int k=0;k<numTasks;++k)
+  {
+    CountTask* task=new CountTask;
+    task->linesPtr=&lines;
+    task->begin=(lines.size()*k)/numTasks;
+    task->end=(lines.size()*(k+1))/numTasks;
+    task->shardMaps.resize(shards.size());
+    task->numWords=0;
+    countTasks.push_back(task);
+    pool.addTask(countTask,(void*)task);
+  }
+  pool.waitForTasks();
+
+      // Add local maps to the shards, each shard is updated by a
+      // different task
+  std::vector<MergeShardTask> mergeTasks(shards.size());
+  for(unsigned int i=0;i<shards.size();++i)
+  {
+    mergeTasks[i].shardPtr=&shards[i];
+    mergeTasks[i].shardIdx=i;
+    mergeTasks[i].countTasksPtr=&countTasks;
+    pool.addTask(mergeShardTask,(void*)&mergeTasks[i]);
+  }
+  pool.waitForTasks();
+
+  for(unsigned int k=0;k<countTasks.size();++k)
+  {
+    numWords+=countTasks[k]->numWords;
+    delete countTasks[k];
+  }
+}
+
+//--------------- sortShards() function
+void sortShards(ThreadPool& pool,
+                std::vector<CountShard>& shards)
+{
+  for(unsigned int i=0;i<shards.size();++i)
+    pool.addTask(sortShardTask,(void*)&shards[i]);
+  pool.waitForTasks();
+}
+
+//--------------- spillShards() function
+int spillShards(ThreadPool& pool,
+                std::vector<CountShard>& shards,
+                std::vector<FILE*>& runFiles)
+{
+  sortShards(pool,shards);
+
+  FILE* runFile=SortedRunUtils::createTmpFile(tmpDir,"thot_count_ngrams");
+  if(runFile==NULL)
+    return THOT_ERROR;
+  runFiles.push_back(runFile);
+
+      // Shards contain disjoint sets of n-grams, they are merged into
+      // a single sorted run
+  std::vector<NgramCountSource*> sources;
+  for(unsigned int i=0;i<shards.size();++i)
+    sources.push_back(new MemNgramCountSource(&shards[i].sortedEntries));
+  RunNgramCountSink sink(runFile);
+  int ret=mergeSources(sources,sink);
+  if(ret==THOT_OK && fflush(runFile)!=0)
+    ret=THOT_ERROR;
+  if(ret==THOT_ERROR)
+    std::cerr<<"Error while writing temporary run file"<<std::endl;
+
+  for(unsigned int i=0;i<sources.size();++i)
+    delete sources[i];
+  for(unsigned int i=0;i<shards.size();++i)
+    std::vector<NgramCountEntry>().swap(shards[i].sortedEntries);
+
+  return ret;
+}
+
+//--------------- mergeSources() function
+int mergeSources(std::vector<NgramCountSource*>& sources,
+                 NgramCountSink& sink)
+{
+  NgramCountMerger merger(sources);
+  int ret=THOT_OK;
+  NgramCountEntry entry;
+  unsigned int srcIdx;
+  NgramCountEntry currEntry;
+  bool currEntryValid=false;
+  while(merger.next(entry,srcIdx))
+  {
+        // Add counts of equal n-grams
+    if(currEntryValid && currEntry.first==entry.first)
+    {
+      currEntry.second+=entry.second;
+    }
+    else
+    {
+      if(currEntryValid && sink.add(currEntry)==THOT_ERROR)
+      {
+        ret=THOT_ERROR;
+        break;
+      }
+      currEntry.first.swap(entry.first);
+      currEntry.second=entry.second;
+      currEntryValid=true;
+    }
+  }
+  if(ret==THOT_OK && currEntryValid && sink.add(currEntry)==THOT_ERROR)
+    ret=THOT_ERROR;
+
+  if(merger.readError())
+  {
+    std::cerr<<"Error while reading temporary run file"<<std::endl;
+    ret=THOT_ERROR;
+  }
+
+  return ret;
+}
+
+//--------------- writeTable() function
+int writeTable(std::vector<NgramCountSource*>& sources,
+               NgramCount numWords)
+{
+  if(levelDbOutput)
+  {
+#ifdef HAVE_LEVELDB_LIB
+    LevelDbNgramTable levelDbNt;
+    if(levelDbNt.init(outFileName)==THOT_ERROR)
+    {
+      std::cerr<<"Cannot create or recreate database (LevelDB) for language model"<<std::endl;
+      return THOT_ERROR;
+    }
+    if(levelDbNt.startBulkLoad(tmpDir)==THOT_ERROR)
+    {
+      std::cerr<<"Cannot start bulk load of database (LevelDB)"<<std::endl;
+      return THOT_ERROR;
+    }
+    LevelDbNgramTableSink sink(numWords,&levelDbNt);
+    if(mergeSources(sources,sink)==THOT_ERROR)
+      return THOT_ERROR;
+    if(levelDbNt.endBulkLoad()==THOT_ERROR)
+    {
+      std::cerr<<"Error while writing database (LevelDB) in bulk load mode"<<std::endl;
+      return THOT_ERROR;
+    }
+    std::cerr<<"levelDB size: "<<levelDbNt.size()<<std::endl;
+
+        // Save vocabulary
+    std::string vocabFileName=outFileName+".ldb_vcb";
+    std::ofstream vocabFile(vocabFileName.c_str());
+    const std::map<std::string,WordIndex>& vocab=sink.getVocab();
+    for(std::map<std::string,WordIndex>::const_iterator iter=vocab.begin();iter!=vocab.end();++iter)
+      vocabFile<<iter->first<<" "<<iter->second<<std::endl;
+    if(!vocabFile)
+    {
+      std::cerr<<"Error while writing vocabulary file "<<vocabFileName<<std::endl;
+      return THOT_ERROR;
+    }
+    return THOT_OK;
+#else
+    std::cerr<<"Error: LevelDB output is not available, thot was built without LevelDB support"<<std::endl;
+    return THOT_ERROR;
+#endif
+  }
+  else
+  {
+        // Open output file
+    FILE* outFile=stdout;
+    if(!outFileName.empty())
+    {
+      outFile=fopen(outFileName.c_str(),"w");
+      if(outFile==NULL)
+      {
+        std::cerr<<"Error while opening output file "<<outFileName<<std::endl;
+        return THOT_ERROR;
+      }
+    }
+    static char outBuff[OUT_BUFF_SIZE];
+    setvbuf(outFile,outBuff,_IOFBF,OUT_BUFF_SIZE);
+
+    TextNgramTableSink sink(numWords,outFile);
+    int ret=mergeSources(sources,sink);
+    if(fflush(outFile)!=0)
+      ret=THOT_ERROR;
+    if(ret==THOT_ERROR)
+      std::cerr<<"Error while writing output"<<std::endl;
+    if(outFile!=stdout)
+      fclose(outFile);
+    return ret;
+  }
+}
+
+//--------------- countTask() function
+void countTask(void* taskData)
+{
+  CountTask* task=(CountTask*)taskData;
+  std::hash<std::string> strHash;
+  std::vector<std::string> words;
+  std::string key;
+
+  for(size_t n=task->begin;n<task->end;++n)
+  {
+        // Obtain sentence including begin and end of sentence symbols
+    words.clear();
+    words.push_back(BOS_STR);
+    splitLine((*task->linesPtr)[n],words);
+    words.push_back(EOS_STR);
+    task->numWords+=words.size();
+
+        // Count every n-gram of the sentence. Unigrams for the begin
+        // and end of sentence symbols are not counted, their counts
+        // are given by the number of sentences
+    for(size_t z=0;z<words.size();++z)
+    {
+      key.clear();
+      for(size_t i=0;i<ngramOrder && z+i<words.size();++i)
+      {
+        if(i>0) key+=KEY_SEP;
+        key+=words[z+i];
+        if(i==0 && (words[z]==BOS_STR || words[z]==EOS_STR))
+          continue;
+        ++task->shardMaps[strHash(key)%task->shardMaps.size()][key];
+      }
+    }
+  }
+}
+
+//--------------- mergeShardTask() function
+void mergeShardTask(void* taskData)
+{
+  MergeShardTask* task=(MergeShardTask*)taskData;
+  CountShard& shard=*task->shardPtr;
+  const std::vector<CountTask*>& countTasks=*task->countTasksPtr;
+
+  for(unsigned int k=0;k<countTasks.size();++k)
+  {
+    NgramCountMap& localMap=countTasks[k]->shardMaps[task->shardIdx];
+    if(shard.countMap.empty())
+    {
+      shard.countMap.swap(localMap);
+      for(NgramCountMap::const_iterator iter=shard.countMap.begin();iter!=shard.countMap.end();++iter)
+        shard.memBytes+=iter->first.size()+ENTRY_MEM_OVERHEAD;
+    }
+    else
+    {
+      for(NgramCountMap::const_iterator iter=localMap.begin();iter!=localMap.end();++iter)
+      {
+        std::pair<NgramCountMap::iterator,bool> insRes=shard.countMap.insert(*iter);
+        if(insRes.second)
+          shard.memBytes+=iter->first.size()+ENTRY_MEM_OVERHEAD;
+        else
+          insRes.first->second+=iter->second;
+      }
+    }
+    NgramCountMap().swap(localMap);
+  }
+}
+
+//--------------- sortShardTask() function
+void sortShardTask(void* taskData)
+{
+  CountShard* shard=(CountShard*)taskData;
+
+  shard->sortedEntries.clear();
+  shard->sortedEntries.reserve(shard->countMap.size());
+      // Keys are moved out of the map, which is not accessed again
+      // before being released
+  for(NgramCountMap::iterator iter=shard->countMap.begin();iter!=shard->countMap.end();++iter)
+  {
+    shard->sortedEntries.push_back(NgramCountEntry());
+    shard->sortedEntries.back().first.swap(const_cast<std::string&>(iter->first));
+    shard->sortedEntries.back().second=iter->second;
+  }
+  NgramCountMap().swap(shard->countMap);
+  shard->memBytes=0;
+
+  std::sort(shard->sortedEntries.begin(),shard->sortedEntries.end());
+}
+
+//--------------- splitLine() function
+void splitLine(const std::string& line,
+               std::vector<std::string>& words)
+{
+      // Fields are separated by blanks, as in awk
+  size_t pos=0;
+  while(pos<line.size())
+  {
+    while(pos<line.size() && (line[pos]==' ' || line[pos]=='\t'))
+      ++pos;
+    if(pos==line.size())
+      break;
+    size_t end=pos;
+    while(end<line.size() && line[end]!=' ' && line[end]!='\t')
+      ++end;
+    words.push_back(line.substr(pos,end-pos));
+    pos=end;
+  }
+}
+
+//--------------- replaceFirstOccurrencesByUnk() function
+void replaceFirstOccurrencesByUnk(std::string& line,
+                                  std::map<std::string,bool>& vocab)
+{
+  std::vector<std::string> words;
+  splitLine(line,words);
+  line.clear();
+  for(unsigned int i=0;i<words.size();++i)
+  {
+    if(i>0) line+=" ";
+    if(vocab.insert(std::make_pair(words[i],true)).second)
+      line+=UNK_SYMBOL_STR;
+    else
+      line+=words[i];
+  }
+}
+
+//--------------- NgramCountSink class function definitions
+
+//-------------------------
+RunNgramCountSink::RunNgramCountSink(FILE* _file)
+{
+  file=_file;
+}
+
+//-------------------------
+int RunNgramCountSink::add(const NgramCountEntry& entry)
+{
+  return SortedRunUtils::writeKeyValue(file,entry.first,entry.second);
+}
+
+//-------------------------
+NgramTableSink::NgramTableSink(NgramCount _numWords)
+{
+  numWords=_numWords;
+}
+
+//-------------------------
+int NgramTableSink::add(const NgramCountEntry& entry)
+{
+      // Split key into words
+  std::vector<std::string> words;
+  size_t pos=0;
+  while(true)
+  {
+    size_t end=entry.first.find(KEY_SEP,pos);
+    if(end==std::string::npos)
+    {
+      words.push_back(entry.first.substr(pos));
+      break;
+    }
+    words.push_back(entry.first.substr(pos,end-pos));
+    pos=end+1;
+  }
+
+      // Update path of visited n-grams. Since keys are sorted, the
+      // history of the n-gram has been visited just before
+  size_t common=0;
+  while(common<pathWords.size() && common+1<words.size() && pathWords[common]==words[common])
+    ++common;
+  pathWords.resize(common);
+  pathCounts.resize(common);
+  while(pathWords.size()<words.size()-1)
+  {
+        // History not present in the table
+    pathWords.push_back(words[pathWords.size()]);
+    pathCounts.push_back(0);
+  }
+  NgramCount histCount=(words.size()==1 ? numWords : pathCounts.back());
+  pathWords.push_back(words.back());
+  pathCounts.push_back(entry.second);
+
+  return writeEntry(words,histCount,entry.second);
+}
+
+//-------------------------
+TextNgramTableSink::TextNgramTableSink(NgramCount _numWords,
+                                       FILE* _file):NgramTableSink(_numWords)
+{
+  file=_file;
+}
+
+//-------------------------
+int TextNgramTableSink::writeEntry(const std::vector<std::string>& words,
+                                   NgramCount histCount,
+                                   NgramCount count)
+{
+  for(unsigned int i=0;i<words.size();++i)
+  {
+    fputs(words[i].c_str(),file);
+    fputc(' ',file);
+  }
+  if(fprintf(file,"%llu %llu\n",histCount,count)>0)
+    return THOT_OK;
+  else
+    return THOT_ERROR;
+}
+
+#ifdef HAVE_LEVELDB_LIB
+//-------------------------
+LevelDbNgramTableSink::LevelDbNgramTableSink(NgramCount _numWords,
+                                             LevelDbNgramTable* _levelDbNtPtr):NgramTableSink(_numWords)
+{
+  levelDbNtPtr=_levelDbNtPtr;
+
+      // Define language model constants
+  vocab[UNK_SYMBOL_STR]=UNK_SYMBOL;
+  vocab[BOS_STR]=S_BEGIN;
+  vocab[EOS_STR]=S_END;
+  vocab[SP_SYM1_LM_STR]=SP_SYM1_LM;
+}
+
+//-------------------------
+const std::map<std::string,WordIndex>& LevelDbNgramTableSink::getVocab(void)const
+{
+  return vocab;
+}
+
+//-------------------------
+WordIndex LevelDbNgramTableSink::getSymbolId(const std::string& symbol)
+{
+  std::map<std::string,WordIndex>::iterator iter=vocab.find(symbol);
+  if(iter==vocab.end())
+  {
+    WordIndex wi=vocab.size();
+    vocab[symbol]=wi;
+    return wi;
+  }
+  else return iter->second;
+}
+
+//-------------------------
+int LevelDbNgramTableSink::writeEntry(const std::vector<std::string>& words,
+                                      NgramCount histCount,
+                                      NgramCount count)
+{
+  std::vector<WordIndex> src;
+  for(unsigned int i=0;i+1<words.size();++i)
+    src.push_back(getSymbolId(words[i]));
+  WordIndex trg=getSymbolId(words.back());
+  im_pair<Count,Count> inf;
+  inf.first=(float)histCount;
+  inf.second=(float)count;
+  levelDbNtPtr->addTableEntry(src,trg,inf);
+  return THOT_OK;
+}
+#endif
+
+//--------------- TakeParameters function
+int TakeParameters(int argc,char *argv[])
+{
+ int err;
+
+ if(argc==1)
+ {
+   printDesc();
+   return THOT_ERROR;
+ }
+
+     /* Verify --help option */
+ err=readOption(argc,argv,"--help");
+ if(err!=-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take the corpus file name */
+ err=readSTLstring(argc,argv,"-c",&corpusFileName);
+ if(err==-1)
+ {
+   std::cerr<<"Error: corpus file not given"<<std::endl;
+   return THOT_ERROR;
+ }
+
+     /* Take order of the n-grams */
+ int val;
+ err=readInt(argc,argv,"-n",&val);
+ if(err==-1 || val<=0)
+ {
+   std::cerr<<"Error: order of the n-grams not provided"<<std::endl;
+   return THOT_ERROR;
+ }
+ ngramOrder=val;
+
+     /* Take optional parameters */
+ unkGiven=(readOption(argc,argv,"-unk")!=-1);
+ levelDbOutput=(readOption(argc,argv,"-ldb")!=-1);
+ numThreads=1;
+ if(readInt(argc,argv,"-nt",&val)!=-1)
+   numThreads=(val>0 ? val : 1);
+ memMb=DEFAULT_MEM_MB;
+ if(readInt(argc,argv,"-S",&val)!=-1)
+   memMb=(val>0 ? val : 1);
+ if(readSTLstring(argc,argv,"-T",&tmpDir)==-1)
+ {
+   const char* envTmpDir=getenv("TMPDIR");
+   if(envTmpDir!=NULL)
+     tmpDir=envTmpDir;
+   else
+     tmpDir="/tmp";
+ }
+ if(readSTLstring(argc,argv,"-o",&outFileName)==-1)
+   outFileName.clear();
+ if(levelDbOutput && outFileName.empty())
+ {
+   std::cerr<<"Error: -o option is required to generate LevelDB output"<<std::endl;
+   return THOT_ERROR;
+ }
+
+ return THOT_OK;
+}
+
+//--------------- printDesc() function
+void printDesc(void)
+{
+  printf("thot_count_ngrams written by Daniel Ortiz\n");
+  printf("A tool to extract n-gram counts from a monolingual corpus\n");
+  printf("type \"thot_count_ngrams --help\" to get usage information.\n");
+}
+
+//--------------- printUsage() function
+void printUsage(void)
+{
+  printf("Usage: thot_count_ngrams -c <string> -n <int> [-unk] [-nt <int>]\n");
+  printf("                         [-S <int>] [-T <string>] [-o <string> [-ldb]]\n");
+  printf("                         [--help]\n\n");
+  printf("-c <string>                Corpus file.\n");
+  printf("-n <int>                   Order of the n-grams.\n");
+  printf("-unk                       Reserve probability mass for the unknown word.\n");
+  printf("-nt <int>                  Number of threads used to count n-grams\n");
+  printf("                           (%d by default).\n",1);
+  printf("-S <int>                   Memory budget in megabytes for the n-gram\n");
+  printf("                           counts (%d by default). Counts are spilled\n",DEFAULT_MEM_MB);
+  printf("                           to sorted temporary runs when exceeded.\n");
+  printf("-T <string>                Directory for temporary files ($TMPDIR or /tmp by\n");
+  printf("                           default).\n");
+  printf("-o <string>                Output file (standard output by default).\n");
+  printf("-ldb                       Write the counts as a LevelDB database given by\n");
+  printf("                           -o instead of the text format.\n");
+  printf("--help                     Display this help and exit.\n\n");
+}
+
+//--------------------------------
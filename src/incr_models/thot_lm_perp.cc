@@ -60,6 +60,7 @@ void printUsage(void);
 std::string lmFileName;
 std::string corpusFileName;
 int verbose=0;
+unsigned int numThreads=1;
 unsigned int order;
 SimpleDynClassLoader<BaseNgramLM<std::vector<WordIndex> > > baseNgramLMDynClassLoader;
 BaseNgramLM<std::vector<WordIndex> >* lm;
@@ -93,7 +94,11 @@ int main(int argc,char *argv[])
       lm->setNgramOrder(order);
       
       ctimer(&elapsed_ant,&ucpu,&scpu);
-      int ret=lm->perplexity(corpusFileName.c_str(),sentenceNo,numWords,total_logp,perp,verbose);
+      int ret;
+      if(verbose || numThreads<=1)
+        ret=lm->perplexity(corpusFileName.c_str(),sentenceNo,numWords,total_logp,perp,verbose);
+      else
+        ret=lm->parallelPerplexity(corpusFileName.c_str(),numThreads,sentenceNo,numWords,total_logp,perp);
       if(ret==THOT_ERROR)
       {
         release_lm(true);
@@ -199,6 +204,13 @@ int TakeParameters(int argc,char *argv[])
    return THOT_ERROR;
  }
 
+     /* Take number of threads */
+ err=readUnsignedInt(argc,argv, "-t", &numThreads);
+ if(err==-1 || numThreads==0)
+ {
+   numThreads=1;
+ }
+
      /* Check verbosity option */
  err=readOption(argc,argv, "-v");
  if(err!=-1)
@@ -219,9 +231,11 @@ int TakeParameters(int argc,char *argv[])
 void printUsage(void)
 {
  printf("Usage: thot_lm_perp -c <string> -lm <string> -n <int>\n");
- printf("                     [-v|-v1]\n");
+ printf("                     [-t <int>] [-v|-v1]\n");
  printf("-c <string>          Corpus file to be processed.\n\n"); 
  printf("-lm <string>         Language model file name.\n\n");
  printf("-n <int>             Order of the n-grams.\n\n");
+ printf("-t <int>             Number of threads used to score the corpus (1 by\n");
+ printf("                     default). Verbose modes use a single thread.\n\n");
  printf("-v|-v1               Verbose modes.\n\n");
 }
@@ -31,6 +31,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "LM_Defs.h"
 #include "LevelDbNgramTable.h"
 #include "im_pair.h"
+#include <stdlib.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -51,6 +52,8 @@ int process_ttable(void);
 //--------------- Global variables -----------------------------------
 
 std::string outputFile;
+std::string tmpDir;
+bool bulkLoad;
 
 //--------------- Function Definitions -------------------------------
 
@@ -146,6 +149,13 @@ int process_ttable(void)
             return THOT_ERROR;
         }
 
+        // Entries are sorted before being written in bulk load mode
+        if(bulkLoad && levelDbNt.startBulkLoad(tmpDir) == THOT_ERROR)
+        {
+            std::cerr << "Cannot start bulk load of database (LevelDB)" << std::endl;
+            return THOT_ERROR;
+        }
+
         // Define language model constants
         vocab[UNK_SYMBOL_STR] = UNK_SYMBOL;
         vocab[BOS_STR] = S_BEGIN;
@@ -174,6 +184,12 @@ int process_ttable(void)
                 std::cerr << "Processed " << i << " lines" << std::endl;
         }
 
+        if(bulkLoad && levelDbNt.endBulkLoad() == THOT_ERROR)
+        {
+            std::cerr << "Error while writing database (LevelDB) in bulk load mode" << std::endl;
+            return THOT_ERROR;
+        }
+
         std::cerr << "levelDB size: " << levelDbNt.size() << std::endl;
 
         // Save vocabulary
@@ -208,14 +224,28 @@ int TakeParameters(int argc, char *argv[])
         return THOT_ERROR;
     }
 
+    // Takes the directory for temporary files
+    if(readSTLstring(argc, argv, "-T", &tmpDir) == -1)
+    {
+        const char* envTmpDir = getenv("TMPDIR");
+        tmpDir = (envTmpDir != NULL) ? envTmpDir : "/tmp";
+    }
+
+    // Verify -nb option
+    bulkLoad = (readOption(argc, argv, "-nb") == -1);
+
     return THOT_OK;  
 }
 
 //---------------
 void printUsage(void)
 {
-    printf("Usage: thot_ngram_to_leveldb -o <string> [--help]\n\n");
+    printf("Usage: thot_ngram_to_leveldb -o <string> [-T <string>] [-nb] [--help]\n\n");
     printf("-o <string>                  Name of output file.\n\n");
+    printf("-T <string>                  Directory for temporary files used in bulk\n");
+    printf("                             load mode ($TMPDIR or /tmp by default).\n\n");
+    printf("-nb                          Disable bulk load mode, entries are written\n");
+    printf("                             one at a time.\n\n");
     printf("--help                       Display this help and exit.\n\n");
 }
 
@@ -34,10 +34,12 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "BaseIncrCondProbTable.h"
 #include "TrieVecs.h"
+#include "FrozenTrieVecs.h"
 #include "ErrorDefs.h"
 
 //--------------- Constants ------------------------------------------
 
+#define VECX_X_INCR_CPTABLE_OVERLAY_RATIO 0.1
 
 //--------------- typedefs -------------------------------------------
 
@@ -58,6 +60,11 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
   typedef typename BaseIncrCondProbTable<std::vector<X>,X,SRC_INFO,SRCTRG_INFO>::TrgTableNode TrgTableNode;
   typedef TrieVecs<X,SRCTRG_INFO> SrcTrgInfo;
   typedef TrieVecs<X,SRC_INFO> SrcInfo;
+  typedef FrozenTrieVecs<X,SRCTRG_INFO> FrozenSrcTrgInfo;
+  typedef FrozenTrieVecs<X,SRC_INFO> FrozenSrcInfo;
+
+      // Constructor
+  vecx_x_incr_cptable(void);
 
       // Basic functions
   void addTableEntry(const std::vector<X>& s,
@@ -73,6 +80,13 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
                                           bool& found);
   SRC_INFO getSrcInfo(const std::vector<X>& s,bool& found);
   SRCTRG_INFO getSrcTrgInfo(const std::vector<X>& s,const X& t,bool& found);
+  void infSrcTrgForSrcSuffixes(const std::vector<X>& s,
+                               unsigned int maxSuffixLen,
+                               const X& t,
+                               std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec);
+      // Obtains the information of the entries (s_k,t), where s_k is
+      // the suffix of s of length k, for k=0...maxSuffixLen. The
+      // information of each entry is stored in infVec[k]
   Prob pTrgGivenSrc(const std::vector<X>& s,const X& t);
   LgProb logpTrgGivenSrc(const std::vector<X>& s,const X& t);
   Prob pSrcGivenTrg(const std::vector<X>& s,const X& t);
@@ -90,6 +104,28 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
   LogCount lcSrc(const std::vector<X>& s);
   LogCount lcTrg(const X& t);
 
+      // Functions to manage the compact read-only representation
+  void freeze(void);
+      // Moves the content of the table to compact read-only tries.
+      // Subsequent updates are stored in mutable tries (the overlay)
+      // that are merged back into the read-only ones when they grow
+      // beyond a fraction of their size
+  bool isFrozen(void)const;
+  bool writeFrozen(std::ostream& outS);
+      // Freezes the table and writes the read-only tries in a
+      // relocatable binary format
+  bool attachFrozen(const char* bufPtr,
+                    size_t bufSize,
+                    size_t& offset);
+      // Replaces the content of the table by the read-only tries
+      // written by writeFrozen() at the given offset of a buffer
+      // (usually a memory-mapped file), without copying them. The
+      // buffer has to remain valid while the table is used. Updates
+      // are stored in the overlay as usual, but the overlay is not
+      // merged automatically, so the read-only tries stay shared with
+      // the other processes mapping the same buffer (freeze() merges
+      // it into private tries)
+
       // size, clear functions
   size_t size(void);
   void clear(void);
@@ -106,16 +142,27 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
   class const_iterator
   {
    protected:
+        // Entries stored in the overlay are visited first, then
+        // those only stored in the read-only trie
+    const vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>* tablePtr;
     typename SrcTrgInfo::const_iterator srcTrgInfoIter;
+    unsigned int frozenLevel;
+    size_t frozenNodeIdx;
+    std::pair<std::vector<X>,SRCTRG_INFO> frozenKeyDataPair;
+
+    bool inOverlay(void)const;
+    void skipOverriddenFrozenNodes(void);
       
    public:
     const_iterator(void){}
-    const_iterator(typename SrcTrgInfo::const_iterator _srcTrgInfoIter);
+    const_iterator(const vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>* _tablePtr,
+                   typename SrcTrgInfo::const_iterator _srcTrgInfoIter,
+                   unsigned int _frozenLevel);
     bool operator++(void); //prefix
     bool operator++(int);  //postfix
     int operator==(const const_iterator& right);
     int operator!=(const const_iterator& right);
-    const typename SrcTrgInfo::const_iterator& operator->(void)const;
+    const std::pair<std::vector<X>,SRCTRG_INFO>* operator->(void)const;
     std::pair<std::vector<X>,SRCTRG_INFO> operator*(void)const;
     ~const_iterator(){}
   };
@@ -127,15 +174,63 @@ class vecx_x_incr_cptable: public BaseIncrCondProbTable<std::vector<X>,X,SRC_INF
   SrcTrgInfo srcTrgInfo;
   SrcInfo srcInfo;
   SRC_INFO srcInfoNull;
+  FrozenSrcTrgInfo frozenSrcTrgInfo;
+  FrozenSrcInfo frozenSrcInfo;
+  size_t numOverlayEntries;
+
+      // Auxiliary functions to access the overlay and the read-only
+      // tries
+  template<class DATA_TYPE>
+  const DATA_TYPE* findEntry(const TrieVecs<X,DATA_TYPE>& overlay,
+                             const FrozenTrieVecs<X,DATA_TYPE>& frozen,
+                             const X* keySeqBegin,
+                             const X* keySeqEnd)const;
+      // Returns the data for the (non-empty) key sequence, or NULL if
+      // not found. Entries stored in the overlay take precedence
+  template<class DATA_TYPE>
+  DATA_TYPE* findOverlayEntry(TrieVecs<X,DATA_TYPE>& overlay,
+                              const FrozenTrieVecs<X,DATA_TYPE>& frozen,
+                              const std::vector<X>& keySeq);
+      // Returns a modifiable pointer to the data for the key
+      // sequence, creating it if necessary. The nodes of the path
+      // that are created in the overlay take their data from the
+      // read-only trie
+  template<class DATA_TYPE>
+  void mergeOverlay(TrieVecs<X,DATA_TYPE>& overlay,
+                    FrozenTrieVecs<X,DATA_TYPE>& frozen);
+  void compactIfNeeded(void);
+  const SRC_INFO* findSrcInfo(const std::vector<X>& s)const;
+  const SRCTRG_INFO* findSrcTrgInfo(const std::vector<X>& s,const X& t)const;
 };
 
 //--------------- Template function definitions
 
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::vecx_x_incr_cptable(void)
+{
+  numOverlayEntries=0;
+}
+
 //-------------------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 size_t vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::size(void)
 {
-  return srcTrgInfo.size();
+  if(frozenSrcTrgInfo.empty())
+    return srcTrgInfo.size();
+  else
+  {
+        // Count nodes of the read-only trie and nodes only stored in
+        // the overlay (the root node is included in both cases)
+    size_t s=frozenSrcTrgInfo.size()+1;
+    typename SrcTrgInfo::const_iterator titer;
+    for(titer=srcTrgInfo.begin();titer!=srcTrgInfo.end();++titer)
+    {
+      if(!titer->first.empty() && frozenSrcTrgInfo.find(titer->first)==NULL)
+        ++s;
+    }
+    return s;
+  }
 }
 //-------------------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
@@ -143,6 +238,9 @@ void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::clear(void)
 {
   srcTrgInfo.clear();
   srcInfo.clear();
+  frozenSrcTrgInfo.clear();
+  frozenSrcInfo.clear();
+  numOverlayEntries=0;
   SRC_INFO srcInfoNullAux;
   srcInfoNull=srcInfoNullAux;
 }
@@ -170,7 +268,8 @@ void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::addSrcInfo(const std::vector<X
 {
   if(s.size()!=0)
   {
-    srcInfo.insert(s,s_inf);
+    *findOverlayEntry(srcInfo,frozenSrcInfo,s)=s_inf;
+    compactIfNeeded();
   }
   else
   {
@@ -195,7 +294,8 @@ void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::addSrcTrgInfo(const std::vecto
 
   vecx.push_back(t);
 
-  srcTrgInfo.insert(vecx,st_inf);
+  *findOverlayEntry(srcTrgInfo,frozenSrcTrgInfo,vecx)=st_inf;
+  compactIfNeeded();
 }
 
 //-------------------------
@@ -204,8 +304,6 @@ void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::incrCountsOfEntryLog(const std
                                                                        const X& t,
                                                                        LogCount lc)
 {
-  SRCTRG_INFO* stiPtr;
-  SRC_INFO* siPtr;
   std::vector<X> vecx;
     
   for(unsigned int i=0;i<s.size();++i)
@@ -215,38 +313,17 @@ void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::incrCountsOfEntryLog(const std
 
   vecx.push_back(t);
 
-  stiPtr=srcTrgInfo.find(vecx);
-  if(stiPtr==NULL)
-  {
-    SRCTRG_INFO sti;
-
-    sti.incr_logcount((float)lc);
-    srcTrgInfo.insert(vecx,sti);
-  }
-  else
-  {
-    stiPtr->incr_logcount((float)lc);
-  }
+  findOverlayEntry(srcTrgInfo,frozenSrcTrgInfo,vecx)->incr_logcount((float)lc);
 
   if(s.size()!=0)
   {
-    siPtr=srcInfo.find(s);
-    if(siPtr==NULL)
-    {
-      SRC_INFO si;
-      
-      si.incr_logcount((float)lc);
-      srcInfo.insert(s,si);
-    }
-    else
-    {
-      siPtr->incr_logcount((float)lc);
-    }
+    findOverlayEntry(srcInfo,frozenSrcInfo,s)->incr_logcount((float)lc);
   }
   else
   {
     srcInfoNull.incr_logcount((float)lc);
   }
+  compactIfNeeded();
 }
 
 //-------------------------
@@ -256,17 +333,8 @@ vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::infSrcTrg(const std::vector<X>& s,
                                                        const X& t,
                                                        bool& found)
 {
-  SRCTRG_INFO* stiPtr;
+  const SRCTRG_INFO* stiPtr;
   im_pair<SRC_INFO,SRCTRG_INFO> psst;
-  std::vector<X> vecx;
-  unsigned int i;
-  
-  for(i=0;i<s.size();++i)
-  {
-    vecx.push_back(s[i]);
-  }
-
-  vecx.push_back(t);
 
   if(s.size()==0)
   {
@@ -274,12 +342,12 @@ vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::infSrcTrg(const std::vector<X>& s,
   }
   else
   {
-    SRC_INFO* srcInfoPtr=srcInfo.find(s);
+    const SRC_INFO* srcInfoPtr=findSrcInfo(s);
     if(srcInfoPtr!=NULL) psst.first=*srcInfoPtr;
     else psst.first=0;
   }
 
-  stiPtr=srcTrgInfo.find(vecx);
+  stiPtr=findSrcTrgInfo(s,t);
   if(stiPtr==NULL)
   {
     found=false;
@@ -299,9 +367,9 @@ SRC_INFO vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getSrcInfo(const std::vect
 {
   if(s.size()!=0)
   {
-    SRC_INFO* sinfoPtr;
+    const SRC_INFO* sinfoPtr;
   
-    sinfoPtr=srcInfo.find(s);
+    sinfoPtr=findSrcInfo(s);
     if(sinfoPtr==NULL)
     {
       SRC_INFO sinfo;
@@ -327,18 +395,9 @@ SRCTRG_INFO vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getSrcTrgInfo(const std
                                                                        const X& t,
                                                                        bool& found)
 {
-  SRCTRG_INFO* stiPtr;
-  std::vector<X> vecx;
-  unsigned int i;
-  
-  for(i=0;i<s.size();++i)
-  {
-    vecx.push_back(s[i]);
-  }
+  const SRCTRG_INFO* stiPtr;
 
-  vecx.push_back(t);
-
-  stiPtr=srcTrgInfo.find(vecx);
+  stiPtr=findSrcTrgInfo(s,t);
   if(stiPtr==NULL)
   {
     SRCTRG_INFO sti;
@@ -353,6 +412,87 @@ SRCTRG_INFO vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getSrcTrgInfo(const std
   }
 }
 
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::infSrcTrgForSrcSuffixes(const std::vector<X>& s,
+                                                                          unsigned int maxSuffixLen,
+                                                                          const X& t,
+                                                                          std::vector<im_pair<SRC_INFO,SRCTRG_INFO> >& infVec)
+{
+  infVec.resize(maxSuffixLen+1);
+  if(frozenSrcTrgInfo.empty())
+  {
+        // Descend through the trie from the node of each suffix
+    const X* sEnd=s.data()+s.size();
+    for(unsigned int k=0;k<=maxSuffixLen;++k)
+    {
+      const X* suffixBegin=sEnd-k;
+
+          // Obtain source information
+      if(k==0)
+      {
+        infVec[k].first=srcInfoNull;
+      }
+      else
+      {
+        SrcInfo* srcInfoNodePtr=srcInfo.findSubtrie(suffixBegin,sEnd);
+        if(srcInfoNodePtr!=NULL) infVec[k].first=srcInfoNodePtr->getData();
+        else infVec[k].first=0;
+      }
+
+          // Obtain source-target information (entries with unseen
+          // sources are not looked up, since their probability is zero)
+      SRCTRG_INFO srcTrgInfoNull;
+      infVec[k].second=srcTrgInfoNull;
+      if((float)infVec[k].first!=0)
+      {
+        SrcTrgInfo* srcTrgInfoNodePtr=srcTrgInfo.findSubtrie(suffixBegin,sEnd);
+        if(srcTrgInfoNodePtr!=NULL)
+        {
+          srcTrgInfoNodePtr=srcTrgInfoNodePtr->findSubtrie(&t,&t+1);
+          if(srcTrgInfoNodePtr!=NULL)
+            infVec[k].second=srcTrgInfoNodePtr->getData();
+        }
+      }
+    }
+  }
+  else
+  {
+        // Look up each suffix in the overlay and in the read-only
+        // tries. The suffixes of s followed by t are stored in a
+        // contiguous buffer
+    std::vector<X> st(s);
+    st.push_back(t);
+    const X* sEnd=st.data()+s.size();
+    for(unsigned int k=0;k<=maxSuffixLen;++k)
+    {
+      const X* suffixBegin=sEnd-k;
+
+          // Obtain source information
+      if(k==0)
+      {
+        infVec[k].first=srcInfoNull;
+      }
+      else
+      {
+        const SRC_INFO* srcInfoPtr=findEntry(srcInfo,frozenSrcInfo,suffixBegin,sEnd);
+        if(srcInfoPtr!=NULL) infVec[k].first=*srcInfoPtr;
+        else infVec[k].first=0;
+      }
+
+          // Obtain source-target information
+      SRCTRG_INFO srcTrgInfoNull;
+      infVec[k].second=srcTrgInfoNull;
+      if((float)infVec[k].first!=0)
+      {
+        const SRCTRG_INFO* srcTrgInfoPtr=findEntry(srcTrgInfo,frozenSrcTrgInfo,suffixBegin,sEnd+1);
+        if(srcTrgInfoPtr!=NULL)
+          infVec[k].second=*srcTrgInfoPtr;
+      }
+    }
+  }
+}
+
 //-------------------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 Prob vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::pTrgGivenSrc(const std::vector<X>& s,
@@ -430,16 +570,16 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getEntriesForSource(const std::vector<X>& s,
                                                                       TrgTableNode& trgtn)
 {
-  typename SrcTrgInfo::const_iterator titer;
+  const_iterator titer;
   unsigned int i;
   std::pair<X,im_pair<SRC_INFO,SRCTRG_INFO> > pdp;
   std::vector<X> vecx;
-  SRC_INFO* siPtr;
+  const SRC_INFO* siPtr;
 
-  siPtr=srcInfo.find(s);
+  siPtr=findSrcInfo(s);
   
   trgtn.clear();
-  for(titer=srcTrgInfo.begin();titer!=srcTrgInfo.end();++titer)
+  for(titer=begin();titer!=end();++titer)
   {
     if((double)titer->second.get_c_st()!=0)
     {
@@ -469,12 +609,12 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 bool
 vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getEntriesForTarget(const X& t,typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::SrcTableNode& tnode)
 {
-  typename SrcTrgInfo::const_iterator titer;
+  const_iterator titer;
   unsigned int i;
   std::pair<std::vector<X>,im_pair<SRC_INFO,SRCTRG_INFO> > pdp;
 
   tnode.clear();
-  for(titer=srcTrgInfo.begin();titer!=srcTrgInfo.end();++titer)
+  for(titer=begin();titer!=end();++titer)
   {
     if((double)titer->second.get_c_st()!=0)
     {
@@ -487,7 +627,7 @@ vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getEntriesForTarget(const X& t,type
           {
             pdp.first.push_back(titer->first[i]);
           }
-          pdp.second.first=*srcInfo.find(pdp.first);
+          pdp.second.first=*findSrcInfo(pdp.first);
           pdp.second.second=titer->second;
           tnode.insert(pdp);
         }
@@ -504,13 +644,13 @@ bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getNbestForSrc(const std::vect
 {
   TrgTableNode tnode;
   typename TrgTableNode::iterator tNodeIter;
-  SRC_INFO* siPtr;
+  const SRC_INFO* siPtr;
   bool ret;
 
   nbt.clear();
   ret=getEntriesForSource(s,tnode);
 
-  siPtr=srcInfo.find(s);
+  siPtr=findSrcInfo(s);
 
   for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
   {
@@ -533,9 +673,9 @@ bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::getNbestForTrg(const X& t,
   ret=getEntriesForTarget(t,tnode);
   for(tNodeIter=tnode.begin();tNodeIter!=tnode.end();++tNodeIter)
   {
-    SRC_INFO* siPtr;
+    const SRC_INFO* siPtr;
 
-    siPtr=srcInfo.find(tNodeIter->first);
+    siPtr=findSrcInfo(tNodeIter->first);
     nbt.insert((float)tNodeIter->second.second.get_lc_st()-(float)siPtr->get_lc_s(),tNodeIter->first);
   }
 
@@ -550,17 +690,9 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cSrcTrg(const std::vector<X>& s,
                                                            const X& t)
 {
-  SRCTRG_INFO* stiPtr;
-  std::vector<X> vecx;
-  unsigned int i;
-  
-  for(i=0;i<s.size();++i)
-  {
-    vecx.push_back(s[i]);
-  }
-  vecx.push_back(t);
+  const SRCTRG_INFO* stiPtr;
 
-  stiPtr=srcTrgInfo.find(vecx);
+  stiPtr=findSrcTrgInfo(s,t);
 
   if(stiPtr==NULL)
   {
@@ -576,7 +708,7 @@ Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cSrcTrg(const std::vector<X>&
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cSrc(const std::vector<X>& s)
 {
-  SRC_INFO* siPtr;
+  const SRC_INFO* siPtr;
 
   if(s.size()==0)
   {
@@ -584,7 +716,7 @@ Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cSrc(const std::vector<X>& s)
   }
   else
   {
-    siPtr=srcInfo.find(s);
+    siPtr=findSrcInfo(s);
     if(siPtr==NULL)
     {
       return 0;
@@ -597,10 +729,10 @@ Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cSrc(const std::vector<X>& s)
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 Count vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::cTrg(const X& t)
 {
-  typename SrcTrgInfo::const_iterator titer;
+  const_iterator titer;
   Count c_t=SMALL_LG_NUM;
   
-  for(titer=srcTrgInfo.begin();titer!=srcTrgInfo.end();++titer)
+  for(titer=begin();titer!=end();++titer)
   {
     if((double)titer->second.get_c_st()>0)
     {
@@ -621,17 +753,9 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcSrcTrg(const std::vector<X>& s,
                                                                const X& t)
 {
-  SRCTRG_INFO* stiPtr;
-  std::vector<X> vecx;
-  unsigned int i;
-  
-  for(i=0;i<s.size();++i)
-  {
-    vecx.push_back(s[i]);
-  }
-  vecx.push_back(t);
+  const SRCTRG_INFO* stiPtr;
 
-  stiPtr=srcTrgInfo.find(vecx);
+  stiPtr=findSrcTrgInfo(s,t);
 
   if(stiPtr==NULL)
   {
@@ -647,7 +771,7 @@ LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcSrcTrg(const std::vector
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcSrc(const std::vector<X>& s)
 {
-  SRC_INFO* siPtr;
+  const SRC_INFO* siPtr;
 
   if(s.size()==0)
   {
@@ -655,7 +779,7 @@ LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcSrc(const std::vector<X>
   }
   else
   {
-    siPtr=srcInfo.find(s);
+    siPtr=findSrcInfo(s);
     if(siPtr==NULL)
     {
       return SMALL_LG_NUM;
@@ -668,10 +792,10 @@ LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcSrc(const std::vector<X>
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcTrg(const X& t)
 {
-  typename SrcTrgInfo::const_iterator titer;
+  const_iterator titer;
   LogCount lc_t=SMALL_LG_NUM;
   
-  for(titer=srcTrgInfo.begin();titer!=srcTrgInfo.end();++titer)
+  for(titer=begin();titer!=end();++titer)
   {
     if((double)titer->second.get_lc_st()>SMALL_LG_NUM)
     {
@@ -687,22 +811,241 @@ LogCount vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::lcTrg(const X& t)
   return lc_t;
 }
 
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::freeze(void)
+{
+  mergeOverlay(srcTrgInfo,frozenSrcTrgInfo);
+  mergeOverlay(srcInfo,frozenSrcInfo);
+  numOverlayEntries=0;
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::isFrozen(void)const
+{
+  return !frozenSrcTrgInfo.empty();
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::writeFrozen(std::ostream& outS)
+{
+  freeze();
+
+  outS.write((const char*)&srcInfoNull,sizeof(SRC_INFO));
+  if(frozenSrcTrgInfo.write(outS)==THOT_ERROR)
+    return THOT_ERROR;
+  return frozenSrcInfo.write(outS);
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::attachFrozen(const char* bufPtr,
+                                                               size_t bufSize,
+                                                               size_t& offset)
+{
+  clear();
+
+  if(offset>bufSize || bufSize-offset<sizeof(SRC_INFO))
+    return THOT_ERROR;
+  memcpy(&srcInfoNull,bufPtr+offset,sizeof(SRC_INFO));
+  offset+=sizeof(SRC_INFO);
+
+  if(frozenSrcTrgInfo.attach(bufPtr,bufSize,offset)==THOT_ERROR ||
+     frozenSrcInfo.attach(bufPtr,bufSize,offset)==THOT_ERROR)
+  {
+    clear();
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+template<class DATA_TYPE>
+const DATA_TYPE*
+vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::findEntry(const TrieVecs<X,DATA_TYPE>& overlay,
+                                                       const FrozenTrieVecs<X,DATA_TYPE>& frozen,
+                                                       const X* keySeqBegin,
+                                                       const X* keySeqEnd)const
+{
+      // The nodes stored in the overlay contain up-to-date data,
+      // since they are initialized from the read-only trie when
+      // created
+  const TrieVecs<X,DATA_TYPE>* nodePtr=overlay.findSubtrie(keySeqBegin,keySeqEnd);
+  if(nodePtr!=NULL)
+    return &nodePtr->getData();
+  else
+    return frozen.find(keySeqBegin,keySeqEnd);
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+template<class DATA_TYPE>
+DATA_TYPE*
+vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::findOverlayEntry(TrieVecs<X,DATA_TYPE>& overlay,
+                                                              const FrozenTrieVecs<X,DATA_TYPE>& frozen,
+                                                              const std::vector<X>& keySeq)
+{
+  TrieVecs<X,DATA_TYPE>* nodePtr=&overlay;
+  bool inFrozen=!frozen.empty();
+  for(unsigned int i=0;i<keySeq.size();++i)
+  {
+    const X* keyPtr=keySeq.data()+i;
+    TrieVecs<X,DATA_TYPE>* childPtr=nodePtr->findSubtrie(keyPtr,keyPtr+1);
+    if(childPtr==NULL)
+    {
+          // Create node, copying its data from the read-only trie if
+          // available
+      const DATA_TYPE* frozenDataPtr=NULL;
+      if(inFrozen)
+      {
+        frozenDataPtr=frozen.find(keySeq.data(),keyPtr+1);
+        if(frozenDataPtr==NULL) inFrozen=false;
+      }
+      std::vector<X> key(1,*keyPtr);
+      if(frozenDataPtr!=NULL)
+        childPtr=nodePtr->insert(key,*frozenDataPtr);
+      else
+        childPtr=nodePtr->insert(key,DATA_TYPE());
+      ++numOverlayEntries;
+    }
+    nodePtr=childPtr;
+  }
+  return &nodePtr->getData();
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+template<class DATA_TYPE>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::mergeOverlay(TrieVecs<X,DATA_TYPE>& overlay,
+                                                               FrozenTrieVecs<X,DATA_TYPE>& frozen)
+{
+      // Obtain entries of the overlay, which replace those of the
+      // read-only trie
+  std::vector<std::pair<std::vector<X>,DATA_TYPE> > entries;
+  typename TrieVecs<X,DATA_TYPE>::const_iterator titer;
+  for(titer=overlay.begin();titer!=overlay.end();++titer)
+  {
+    if(!titer->first.empty())
+      entries.push_back(*titer);
+  }
+  overlay.clear();
+
+      // Merge them level by level into the read-only trie, without
+      // extracting its entries
+  frozen.merge(entries);
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::compactIfNeeded(void)
+{
+      // Attached tries are not merged, since that would replace the
+      // shared mapping by private copies of the arrays
+  if(!frozenSrcTrgInfo.empty() && !frozenSrcTrgInfo.isAttached() &&
+     numOverlayEntries>VECX_X_INCR_CPTABLE_OVERLAY_RATIO*frozenSrcTrgInfo.size())
+  {
+    freeze();
+  }
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+const SRC_INFO* vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::findSrcInfo(const std::vector<X>& s)const
+{
+  if(s.empty())
+    return NULL;
+  else
+    return findEntry(srcInfo,frozenSrcInfo,s.data(),s.data()+s.size());
+}
+
+//-------------------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+const SRCTRG_INFO* vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::findSrcTrgInfo(const std::vector<X>& s,
+                                                                               const X& t)const
+{
+      // Descend to the node of s and then to its child t
+  const SrcTrgInfo* nodePtr=srcTrgInfo.findSubtrie(s.data(),s.data()+s.size());
+  if(nodePtr!=NULL)
+    nodePtr=nodePtr->findSubtrie(&t,&t+1);
+  if(nodePtr!=NULL)
+    return &nodePtr->getData();
+  else if(frozenSrcTrgInfo.empty())
+    return NULL;
+  else
+  {
+    std::vector<X> vecx(s);
+    vecx.push_back(t);
+    return frozenSrcTrgInfo.find(vecx);
+  }
+}
+
 // nested-const_iterator member functions
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
-vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::const_iterator(typename SrcTrgInfo::const_iterator _srcTrgInfoIter)
+vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::const_iterator(const vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>* _tablePtr,
+                                                                            typename SrcTrgInfo::const_iterator _srcTrgInfoIter,
+                                                                            unsigned int _frozenLevel)
 {
+  tablePtr=_tablePtr;
   srcTrgInfoIter=_srcTrgInfoIter;
+  frozenLevel=_frozenLevel;
+  frozenNodeIdx=0;
+  if(!inOverlay())
+    skipOverriddenFrozenNodes();
+}
+//---------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::inOverlay(void)const
+{
+  typename SrcTrgInfo::const_iterator srcTrgInfoIterAux=srcTrgInfoIter;
+  return srcTrgInfoIterAux!=tablePtr->srcTrgInfo.end();
+}
+//---------------
+template<class X,class SRC_INFO,class SRCTRG_INFO>
+void vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::skipOverriddenFrozenNodes(void)
+{
+  const FrozenSrcTrgInfo& frozen=tablePtr->frozenSrcTrgInfo;
+  while(frozenLevel<frozen.getNumLevels())
+  {
+    if(frozenNodeIdx>=frozen.getLevelSize(frozenLevel))
+    {
+      ++frozenLevel;
+      frozenNodeIdx=0;
+    }
+    else
+    {
+          // Nodes also stored in the overlay have already been
+          // visited
+      frozen.getNode(frozenLevel,frozenNodeIdx,frozenKeyDataPair.first,frozenKeyDataPair.second);
+      const std::vector<X>& keySeq=frozenKeyDataPair.first;
+      if(tablePtr->srcTrgInfo.findSubtrie(keySeq.data(),keySeq.data()+keySeq.size())==NULL)
+        break;
+      ++frozenNodeIdx;
+    }
+  }
 }
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator++(void) //prefix
 {
-  typename SrcTrgInfo::const_iterator srcTrgInfoIterAux;
-
-  srcTrgInfoIterAux=srcTrgInfoIter;
-  ++srcTrgInfoIter;
-  return srcTrgInfoIterAux!=srcTrgInfoIter;
+  if(inOverlay())
+  {
+    ++srcTrgInfoIter;
+    if(!inOverlay())
+      skipOverriddenFrozenNodes();
+    return true;
+  }
+  else
+  {
+    if(frozenLevel>=tablePtr->frozenSrcTrgInfo.getNumLevels())
+      return false;
+    ++frozenNodeIdx;
+    skipOverriddenFrozenNodes();
+    return true;
+  }
 }
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
@@ -714,7 +1057,9 @@ bool vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator++(int
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 int vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator==(const const_iterator& right)
 {
-  return this->srcTrgInfoIter==right.srcTrgInfoIter;
+  return this->srcTrgInfoIter==right.srcTrgInfoIter &&
+    this->frozenLevel==right.frozenLevel &&
+    this->frozenNodeIdx==right.frozenNodeIdx;
 }
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
@@ -724,16 +1069,19 @@ int vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator!=(cons
 }
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
-const typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::SrcTrgInfo::const_iterator&
+const std::pair<std::vector<X>,SRCTRG_INFO>*
 vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator->(void)const
 {
-  return srcTrgInfoIter;
+  if(inOverlay())
+    return srcTrgInfoIter.operator->();
+  else
+    return &frozenKeyDataPair;
 }
 //---------------
 template<class X,class SRC_INFO,class SRCTRG_INFO>
 std::pair<std::vector<X>,SRCTRG_INFO > vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator::operator*(void)const
 {
-  return *srcTrgInfoIter;
+  return *operator->();
 }
 
 // const iterator functions
@@ -742,7 +1090,7 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator
 vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::begin(void)const
 {
-  typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator iter(this->srcTrgInfo.begin());
+  typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator iter(this,this->srcTrgInfo.begin(),0);
 
   return iter;
 }
@@ -752,7 +1100,7 @@ template<class X,class SRC_INFO,class SRCTRG_INFO>
 typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator
 vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::end(void)const
 {
-  typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator iter(this->srcTrgInfo.end());
+  typename vecx_x_incr_cptable<X,SRC_INFO,SRCTRG_INFO>::const_iterator iter(this,this->srcTrgInfo.end(),this->frozenSrcTrgInfo.getNumLevels());
 
   return iter;
 }
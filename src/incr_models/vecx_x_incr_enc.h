@@ -300,6 +300,8 @@ bool vecx_x_incr_enc<HX,X>::load(const char *prefixFileName)
           //cout<<s<< " ||| " <<t<<" ||| "<<inf<<std::endl;
       this->hx_to_x[hx]=x;
       this->x_to_hx[x]=hx;
+          // New codes have to be greater than the loaded ones
+      if(x_object<x) x_object=x;
     }
     return THOT_OK;
   }  
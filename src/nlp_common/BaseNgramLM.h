@@ -33,12 +33,15 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "LM_Defs.h"
 #include "AwkInputStream.h"
+#include "ThreadPool.h"
 #include <string>
 #include <vector>
+#include <algorithm>
 #include <math.h>
 
 //--------------- Constants ------------------------------------------
 
+#define LM_PERP_BLOCK_SIZE 10000
 
 //--------------- typedefs -------------------------------------------
 
@@ -63,6 +66,10 @@ class BaseNgramLM
 
       // Thread/Process safety related functions
   virtual bool modelReadsAreProcessSafe(void);
+  virtual bool modelReadsAreThreadSafe(void);
+      // Returns true if the probability functions can be called by
+      // several threads at the same time. Models whose reads modify
+      // internal state (e.g. caches) must return false
 
       // Probability functions
   virtual LgProb getNgramLgProb(WordIndex w,const std::vector<WordIndex>& vu)=0;
@@ -118,6 +125,16 @@ class BaseNgramLM
                          LgProb& totalLogProb,
                          double& perp,
                          int verbose=0);
+  int parallelPerplexity(const char *corpusFileName,
+                         unsigned int numThreads,
+                         unsigned int& numOfSentences,
+                         unsigned int& numWords,
+                         LgProb& totalLogProb,
+                         double& perp);
+      // Same as perplexity() but the corpus is read in blocks whose
+      // sentences are scored by numThreads threads sharing the model,
+      // which should not be modified during the call. The serial
+      // version is used if model reads are not thread safe
   
       // Functions to extend the model
   virtual int trainSentence(std::vector<std::string> strVec,
@@ -143,6 +160,18 @@ class BaseNgramLM
 
       // Destructor
   virtual ~BaseNgramLM(){};
+
+ private:
+
+  struct PerpTask
+  {
+    BaseNgramLM<LM_STATE>* lmPtr;
+    const std::vector<std::vector<std::string> >* sentVecPtr;
+    unsigned int begin;
+    unsigned int end;
+    std::vector<LgProb>* logProbVecPtr;
+  };
+  static void perpTaskFunc(void* taskData);
 };
 
 //--------------- Template function definitions
@@ -157,6 +186,16 @@ bool BaseNgramLM<LM_STATE>::modelReadsAreProcessSafe(void)
   return true;
 }
 
+//---------------
+template<class LM_STATE>
+bool BaseNgramLM<LM_STATE>::modelReadsAreThreadSafe(void)
+{
+      // By default it will be assumed that model reads are not thread
+      // safe, those safe classes will override this method returning
+      // true instead
+  return false;
+}
+
 //---------------
 template<class LM_STATE>
 Prob BaseNgramLM<LM_STATE>::getZeroGramProb(void)
@@ -299,6 +338,101 @@ int BaseNgramLM<LM_STATE>::perplexity(const char *corpusFileName,
   return THOT_OK;
 }
 
+//---------------
+template<class LM_STATE>
+int BaseNgramLM<LM_STATE>::parallelPerplexity(const char *corpusFileName,
+                                              unsigned int numThreads,
+                                              unsigned int& numOfSentences,
+                                              unsigned int& numWords,
+                                              LgProb& totalLogProb,
+                                              double& perp)
+{
+  if(numThreads<=1 || !modelReadsAreThreadSafe())
+    return perplexity(corpusFileName,numOfSentences,numWords,totalLogProb,perp);
+  
+  LgProb logp=0;
+  totalLogProb=0;
+  AwkInputStream awk;
+  std::vector<std::vector<std::string> > sentVec;
+  std::vector<LgProb> logProbVec;
+  numWords=0;
+  numOfSentences=0;
+
+      // Open corpus file
+  if(awk.open(corpusFileName)==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening corpus file "<<corpusFileName<<std::endl;
+    return THOT_ERROR;
+  }  
+
+  ThreadPool pool(numThreads);
+  bool end=false;
+  while(!end)
+  {
+        // Read block of sentences
+    sentVec.clear();
+    while(sentVec.size()<LM_PERP_BLOCK_SIZE && awk.getln())
+    {
+      sentVec.push_back(std::vector<std::string>());
+      for(unsigned int i=1;i<=awk.NF;++i)
+        sentVec.back().push_back(awk.dollar(i));
+    }
+    if(sentVec.size()<LM_PERP_BLOCK_SIZE)
+      end=true;
+    if(sentVec.empty())
+      break;
+
+        // Score the sentences of the block, splitting it into several
+        // ranges per thread to balance the load
+    unsigned int numSents=sentVec.size();
+    unsigned int numTasks=std::min(numSents,4*numThreads);
+    std::vector<PerpTask> tasks(numTasks);
+    logProbVec.clear();
+    logProbVec.resize(numSents,0);
+    for(unsigned int k=0;k<numTasks;++k)
+    {
+      tasks[k].lmPtr=this;
+      tasks[k].sentVecPtr=&sentVec;
+      tasks[k].begin=(unsigned int)(((unsigned long long)numSents*k)/numTasks);
+      tasks[k].end=(unsigned int)(((unsigned long long)numSents*(k+1))/numTasks);
+      tasks[k].logProbVecPtr=&logProbVec;
+      pool.addTask(perpTaskFunc,(void*)&tasks[k]);
+    }
+    pool.waitForTasks();
+
+        // Accumulate results following corpus order, so the result
+        // matches the one obtained by the serial version (including
+        // the treatment of empty lines)
+    for(unsigned int n=0;n<numSents;++n)
+    {
+      if(!sentVec[n].empty())
+      {
+        numWords+=sentVec[n].size();
+        logp=logProbVec[n];
+      }
+      totalLogProb+=logp;
+      ++numOfSentences;
+    }
+  }
+
+  perp=exp(-((double)totalLogProb/(numWords+numOfSentences))*M_LN10);
+
+  return THOT_OK;
+}
+
+//---------------
+template<class LM_STATE>
+void BaseNgramLM<LM_STATE>::perpTaskFunc(void* taskData)
+{
+  PerpTask* taskPtr=(PerpTask*)taskData;
+  const std::vector<std::vector<std::string> >& sentVec=*taskPtr->sentVecPtr;
+  for(unsigned int n=taskPtr->begin;n<taskPtr->end;++n)
+  {
+    if(!sentVec[n].empty())
+      (*taskPtr->logProbVecPtr)[n]=taskPtr->lmPtr->getSentenceLog10ProbStr(sentVec[n]);
+  }
+}
+
 //---------------
 template<class LM_STATE>
 int BaseNgramLM<LM_STATE>::trainSentence(std::vector<std::string> /*strVec*/,
@@ -0,0 +1,686 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file FrozenTrieVecs.h
+ *
+ * @brief Implements a read-only trie data structure whose nodes are
+ * stored level by level in contiguous sorted arrays.
+ */
+
+#ifndef _FrozenTrieVecs_h
+#define _FrozenTrieVecs_h
+
+//--------------- Include files --------------------------------------
+
+#include "ErrorDefs.h"
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+//--------------- Constants ------------------------------------------
+
+#define FROZEN_TRIE_VECS_ALIGNMENT 8
+
+
+//--------------- User defined types ---------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- FrozenTrieVecs class
+
+/**
+ * @brief Read-only trie built from a set of key sequences. The nodes
+ * of depth d are stored in the d-th level, sorted by parent and key,
+ * so the children of a node occupy a contiguous range of the next
+ * level and are located by binary search. The levels contain no
+ * pointers, so they can be written to a file and used directly from
+ * a read-only memory mapping of it (KEY and DATA_TYPE have to be
+ * trivially copyable types).
+ */
+
+template<class KEY,class DATA_TYPE>
+class FrozenTrieVecs
+{
+ public:
+
+     // Constructors and assignment operator
+   FrozenTrieVecs(void);
+   FrozenTrieVecs(const FrozenTrieVecs& ftv);
+   FrozenTrieVecs& operator=(const FrozenTrieVecs& ftv);
+
+     // Basic functions
+   void build(std::vector<std::pair<std::vector<KEY>,DATA_TYPE> >& entries);
+     // Builds the trie from the given entries (the vector is sorted
+     // by the function). Entries for every prefix of the inserted
+     // sequences are created if not present. If a key sequence
+     // appears more than once, the data of the last occurrence is
+     // kept
+   void merge(std::vector<std::pair<std::vector<KEY>,DATA_TYPE> >& entries);
+     // Inserts the given entries in the trie, replacing the data of
+     // the key sequences already stored (the vector is sorted by the
+     // function). The levels are merged one at a time and the memory
+     // of each old level is released as soon as it has been merged,
+     // so no temporary copy of the whole trie is created
+   const DATA_TYPE* find(const KEY* keySeqBegin,
+                         const KEY* keySeqEnd)const;
+     // Returns the data stored for the key sequence in the range
+     // [keySeqBegin,keySeqEnd), or NULL if not found
+   const DATA_TYPE* find(const std::vector<KEY>& keySeq)const;
+
+     // Functions to access the nodes
+   unsigned int getNumLevels(void)const;
+   size_t getLevelSize(unsigned int level)const;
+   void getNode(unsigned int level,
+                size_t nodeIdx,
+                std::vector<KEY>& keySeq,
+                DATA_TYPE& data)const;
+     // Obtains the key sequence and the data of the given node
+
+   size_t size(void)const;
+   bool empty(void)const;
+   void clear(void);
+
+     // Functions to store the trie in a relocatable binary format
+   bool write(std::ostream& outS)const;
+     // Writes the levels of the trie. The written data starts at an
+     // offset multiple of FROZEN_TRIE_VECS_ALIGNMENT
+   bool attach(const char* bufPtr,
+               size_t bufSize,
+               size_t& offset);
+     // Makes the trie use the levels written by write() at the given
+     // offset of a buffer, without copying them. The buffer has to
+     // be aligned and remain valid while the trie is used. offset is
+     // advanced to the end of the trie data
+   bool isAttached(void)const;
+
+ private:
+
+   struct LevelView
+   {
+     const KEY* keys;
+     const DATA_TYPE* data;
+     const unsigned int* parents;
+     const unsigned int* childBegin;
+     size_t size;
+   };
+
+   std::vector<LevelView> levels;
+     // Arrays of each level. The children of the i-th node of level l
+     // are stored in the range
+     // [levels[l].childBegin[i],levels[l].childBegin[i+1]) of level
+     // l+1. The arrays point to the owned vectors below or to an
+     // attached buffer
+   bool attached;
+
+   std::vector<std::vector<KEY> > levelKeys;
+   std::vector<std::vector<DATA_TYPE> > levelData;
+   std::vector<std::vector<unsigned int> > levelParents;
+   std::vector<std::vector<unsigned int> > levelChildBegin;
+
+   void setOwnedLevelViews(void);
+   void setChildRanges(void);
+   static void writePadding(std::ostream& outS,
+                            size_t& written);
+   static bool alignOffset(size_t bufSize,
+                           size_t& offset);
+
+   static bool lessKeySeq(const std::pair<std::vector<KEY>,DATA_TYPE>& a,
+                          const std::pair<std::vector<KEY>,DATA_TYPE>& b);
+};
+
+//--------------- Template method definitions
+
+
+//--------------- FrozenTrieVecs class method definitions
+
+template<class KEY,class DATA_TYPE>
+FrozenTrieVecs<KEY,DATA_TYPE>::FrozenTrieVecs(void)
+{
+  attached=false;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+FrozenTrieVecs<KEY,DATA_TYPE>::FrozenTrieVecs(const FrozenTrieVecs& ftv)
+{
+  attached=false;
+  *this=ftv;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+FrozenTrieVecs<KEY,DATA_TYPE>& FrozenTrieVecs<KEY,DATA_TYPE>::operator=(const FrozenTrieVecs& ftv)
+{
+  if(this!=&ftv)
+  {
+    levelKeys=ftv.levelKeys;
+    levelData=ftv.levelData;
+    levelParents=ftv.levelParents;
+    levelChildBegin=ftv.levelChildBegin;
+
+        // Attached levels are shared, owned ones point to the copies
+    if(ftv.attached)
+    {
+      levels=ftv.levels;
+      attached=true;
+    }
+    else
+      setOwnedLevelViews();
+  }
+  return *this;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::lessKeySeq(const std::pair<std::vector<KEY>,DATA_TYPE>& a,
+                                               const std::pair<std::vector<KEY>,DATA_TYPE>& b)
+{
+  return a.first<b.first;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::build(std::vector<std::pair<std::vector<KEY>,DATA_TYPE> >& entries)
+{
+  clear();
+
+      // Sort entries, prefixes are placed before the sequences
+      // containing them and repeated sequences keep their relative
+      // order
+  std::stable_sort(entries.begin(),entries.end(),lessKeySeq);
+
+      // Assign each entry to its level. pathIdx stores the index of
+      // the nodes of the path of the last processed entry
+  std::vector<unsigned int> pathIdx;
+  std::vector<KEY> pathKeys;
+  for(size_t i=0;i<entries.size();++i)
+  {
+    const std::vector<KEY>& keySeq=entries[i].first;
+    if(keySeq.empty())
+      continue;
+
+        // Determine length of the prefix shared with the last path
+    size_t common=0;
+    while(common<pathKeys.size() && common<keySeq.size() && pathKeys[common]==keySeq[common])
+      ++common;
+    if(common==keySeq.size())
+    {
+          // Duplicated entry, keep the last one
+      levelData[keySeq.size()-1][pathIdx[keySeq.size()-1]]=entries[i].second;
+      continue;
+    }
+    pathIdx.resize(common);
+    pathKeys.resize(common);
+
+        // Add missing nodes
+    for(size_t l=common;l<keySeq.size();++l)
+    {
+      if(levelKeys.size()<=l)
+      {
+        levelKeys.push_back(std::vector<KEY>());
+        levelData.push_back(std::vector<DATA_TYPE>());
+        levelParents.push_back(std::vector<unsigned int>());
+      }
+      levelKeys[l].push_back(keySeq[l]);
+      if(l+1==keySeq.size())
+        levelData[l].push_back(entries[i].second);
+      else
+        levelData[l].push_back(DATA_TYPE());
+      levelParents[l].push_back(l==0 ? 0 : pathIdx[l-1]);
+      pathIdx.push_back(levelKeys[l].size()-1);
+      pathKeys.push_back(keySeq[l]);
+    }
+  }
+
+  setChildRanges();
+  setOwnedLevelViews();
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::merge(std::vector<std::pair<std::vector<KEY>,DATA_TYPE> >& entries)
+{
+  std::stable_sort(entries.begin(),entries.end(),lessKeySeq);
+
+      // Group entries by level, keeping the last occurrence of
+      // repeated sequences. Entries for missing prefixes are added
+      // with the data currently stored for them
+  std::vector<std::vector<size_t> > levelEntries;
+  std::vector<std::pair<std::vector<KEY>,DATA_TYPE> > prefixEntries;
+  for(size_t i=0;i<entries.size();++i)
+  {
+    const std::vector<KEY>& keySeq=entries[i].first;
+    if(keySeq.empty() || (i+1<entries.size() && entries[i+1].first==keySeq))
+      continue;
+    for(size_t len=1;len<keySeq.size();++len)
+    {
+      std::pair<std::vector<KEY>,DATA_TYPE> prefixEntry;
+      prefixEntry.first.assign(keySeq.begin(),keySeq.begin()+len);
+      if(!std::binary_search(entries.begin(),entries.end(),prefixEntry,lessKeySeq) &&
+         !std::binary_search(prefixEntries.begin(),prefixEntries.end(),prefixEntry,lessKeySeq))
+      {
+        const DATA_TYPE* dataPtr=find(prefixEntry.first);
+        if(dataPtr) prefixEntry.second=*dataPtr;
+        prefixEntries.insert(std::upper_bound(prefixEntries.begin(),prefixEntries.end(),prefixEntry,lessKeySeq),prefixEntry);
+      }
+    }
+  }
+  if(!prefixEntries.empty())
+  {
+    entries.insert(entries.end(),prefixEntries.begin(),prefixEntries.end());
+    std::vector<std::pair<std::vector<KEY>,DATA_TYPE> >().swap(prefixEntries);
+    std::stable_sort(entries.begin(),entries.end(),lessKeySeq);
+  }
+  for(size_t i=0;i<entries.size();++i)
+  {
+    const std::vector<KEY>& keySeq=entries[i].first;
+    if(keySeq.empty() || (i+1<entries.size() && entries[i+1].first==keySeq))
+      continue;
+    while(levelEntries.size()<keySeq.size())
+      levelEntries.push_back(std::vector<size_t>());
+    levelEntries[keySeq.size()-1].push_back(i);
+  }
+
+      // Take old levels, owned arrays are released as soon as their
+      // level has been merged
+  std::vector<LevelView> oldLevels;
+  oldLevels.swap(levels);
+  std::vector<std::vector<KEY> > oldLevelKeys;
+  std::vector<std::vector<DATA_TYPE> > oldLevelData;
+  std::vector<std::vector<unsigned int> > oldLevelParents;
+  oldLevelKeys.swap(levelKeys);
+  oldLevelData.swap(levelData);
+  oldLevelParents.swap(levelParents);
+  std::vector<std::vector<unsigned int> >().swap(levelChildBegin);
+  bool oldLevelsOwned=!attached;
+
+      // Merge each level. The nodes of both sources are sorted by
+      // parent and key, and the new indices of the parents preserve
+      // their relative order, so a single pass is enough
+  size_t numLevels=std::max(oldLevels.size(),levelEntries.size());
+  levelKeys.resize(numLevels);
+  levelData.resize(numLevels);
+  levelParents.resize(numLevels);
+  std::vector<unsigned int> prevOldToNew;
+  std::vector<unsigned int> prevEntryToNew;
+  for(size_t l=0;l<numLevels;++l)
+  {
+    size_t oldSize=(l<oldLevels.size() ? oldLevels[l].size : 0);
+    const std::vector<size_t> emptyIdxVec;
+    const std::vector<size_t>& entryIdxVec=(l<levelEntries.size() ? levelEntries[l] : emptyIdxVec);
+    std::vector<unsigned int> oldToNew(oldSize);
+    std::vector<unsigned int> entryToNew(entryIdxVec.size());
+    levelKeys[l].reserve(oldSize+entryIdxVec.size());
+    levelData[l].reserve(oldSize+entryIdxVec.size());
+    levelParents[l].reserve(oldSize+entryIdxVec.size());
+
+        // Obtain new parent indices of the entries, their parents are
+        // entries of the previous level
+    std::vector<unsigned int> entryParents(entryIdxVec.size(),0);
+    if(l>0)
+    {
+      size_t p=0;
+      for(size_t j=0;j<entryIdxVec.size();++j)
+      {
+        const std::vector<KEY>& keySeq=entries[entryIdxVec[j]].first;
+        while(!std::equal(keySeq.begin(),keySeq.end()-1,entries[levelEntries[l-1][p]].first.begin()))
+          ++p;
+        entryParents[j]=prevEntryToNew[p];
+      }
+    }
+
+    size_t i=0;
+    size_t j=0;
+    while(i<oldSize || j<entryIdxVec.size())
+    {
+      unsigned int oldParent=0;
+      if(i<oldSize && l>0)
+        oldParent=prevOldToNew[oldLevels[l].parents[i]];
+      bool takeOld;
+      bool takeEntry;
+      if(i==oldSize)
+      {
+        takeOld=false;
+        takeEntry=true;
+      }
+      else if(j==entryIdxVec.size())
+      {
+        takeOld=true;
+        takeEntry=false;
+      }
+      else
+      {
+        const KEY& oldKey=oldLevels[l].keys[i];
+        const KEY& entryKey=entries[entryIdxVec[j]].first[l];
+        takeOld=(oldParent<entryParents[j] || (oldParent==entryParents[j] && !(entryKey<oldKey)));
+        takeEntry=(entryParents[j]<oldParent || (oldParent==entryParents[j] && !(oldKey<entryKey)));
+      }
+
+      unsigned int newIdx=levelKeys[l].size();
+      if(takeEntry)
+      {
+        levelKeys[l].push_back(entries[entryIdxVec[j]].first[l]);
+        levelData[l].push_back(entries[entryIdxVec[j]].second);
+        levelParents[l].push_back(entryParents[j]);
+        entryToNew[j++]=newIdx;
+      }
+      else
+      {
+        levelKeys[l].push_back(oldLevels[l].keys[i]);
+        levelData[l].push_back(oldLevels[l].data[i]);
+        levelParents[l].push_back(oldParent);
+      }
+      if(takeOld)
+        oldToNew[i++]=newIdx;
+    }
+
+        // Release old level
+    if(oldLevelsOwned && l<oldLevels.size())
+    {
+      std::vector<KEY>().swap(oldLevelKeys[l]);
+      std::vector<DATA_TYPE>().swap(oldLevelData[l]);
+      std::vector<unsigned int>().swap(oldLevelParents[l]);
+    }
+    prevOldToNew.swap(oldToNew);
+    prevEntryToNew.swap(entryToNew);
+  }
+
+  setChildRanges();
+  setOwnedLevelViews();
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::setChildRanges(void)
+{
+      // Obtain children ranges from parent indices
+  levelChildBegin.resize(levelKeys.size());
+  for(unsigned int l=0;l<levelKeys.size();++l)
+  {
+    levelChildBegin[l].assign(levelKeys[l].size()+1,0);
+    if(l+1<levelKeys.size())
+    {
+      const std::vector<unsigned int>& childParents=levelParents[l+1];
+      for(size_t j=0;j<childParents.size();++j)
+        ++levelChildBegin[l][childParents[j]+1];
+      for(size_t i=1;i<levelChildBegin[l].size();++i)
+        levelChildBegin[l][i]+=levelChildBegin[l][i-1];
+    }
+  }
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::setOwnedLevelViews(void)
+{
+  levels.resize(levelKeys.size());
+  for(unsigned int l=0;l<levelKeys.size();++l)
+  {
+    levels[l].keys=levelKeys[l].data();
+    levels[l].data=levelData[l].data();
+    levels[l].parents=levelParents[l].data();
+    levels[l].childBegin=levelChildBegin[l].data();
+    levels[l].size=levelKeys[l].size();
+  }
+  attached=false;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+const DATA_TYPE* FrozenTrieVecs<KEY,DATA_TYPE>::find(const KEY* keySeqBegin,
+                                                     const KEY* keySeqEnd)const
+{
+  size_t len=keySeqEnd-keySeqBegin;
+  if(len==0 || len>levels.size()) return NULL;
+
+  size_t rangeBegin=0;
+  size_t rangeEnd=levels[0].size;
+  size_t nodeIdx=0;
+  for(size_t l=0;l<len;++l)
+  {
+        // Search key in the children range of the current node
+    const KEY* keys=levels[l].keys;
+    const KEY* keyPtr=std::lower_bound(keys+rangeBegin,keys+rangeEnd,keySeqBegin[l]);
+    if(keyPtr==keys+rangeEnd || *keyPtr!=keySeqBegin[l])
+      return NULL;
+    nodeIdx=keyPtr-keys;
+
+        // Obtain children range
+    rangeBegin=levels[l].childBegin[nodeIdx];
+    rangeEnd=levels[l].childBegin[nodeIdx+1];
+  }
+  return &levels[len-1].data[nodeIdx];
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+const DATA_TYPE* FrozenTrieVecs<KEY,DATA_TYPE>::find(const std::vector<KEY>& keySeq)const
+{
+  return find(keySeq.data(),keySeq.data()+keySeq.size());
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+unsigned int FrozenTrieVecs<KEY,DATA_TYPE>::getNumLevels(void)const
+{
+  return levels.size();
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+size_t FrozenTrieVecs<KEY,DATA_TYPE>::getLevelSize(unsigned int level)const
+{
+  return levels[level].size;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::getNode(unsigned int level,
+                                            size_t nodeIdx,
+                                            std::vector<KEY>& keySeq,
+                                            DATA_TYPE& data)const
+{
+  data=levels[level].data[nodeIdx];
+  keySeq.resize(level+1);
+  for(unsigned int l=level+1;l>0;--l)
+  {
+    keySeq[l-1]=levels[l-1].keys[nodeIdx];
+    nodeIdx=levels[l-1].parents[nodeIdx];
+  }
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+size_t FrozenTrieVecs<KEY,DATA_TYPE>::size(void)const
+{
+  size_t s=0;
+  for(unsigned int l=0;l<levels.size();++l)
+    s+=levels[l].size;
+  return s;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::empty(void)const
+{
+  return levels.empty();
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::clear(void)
+{
+      // Release memory
+  std::vector<std::vector<KEY> >().swap(levelKeys);
+  std::vector<std::vector<DATA_TYPE> >().swap(levelData);
+  std::vector<std::vector<unsigned int> >().swap(levelParents);
+  std::vector<std::vector<unsigned int> >().swap(levelChildBegin);
+  levels.clear();
+  attached=false;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+void FrozenTrieVecs<KEY,DATA_TYPE>::writePadding(std::ostream& outS,
+                                                 size_t& written)
+{
+  while(written%FROZEN_TRIE_VECS_ALIGNMENT!=0)
+  {
+    outS.put('\0');
+    ++written;
+  }
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::write(std::ostream& outS)const
+{
+      // The format is composed of the number of levels, the size of
+      // each level and the arrays of each level. Every item starts at
+      // an aligned offset
+  size_t written=outS.tellp();
+  writePadding(outS,written);
+
+  unsigned long long numLevels=levels.size();
+  outS.write((const char*)&numLevels,sizeof(unsigned long long));
+  for(unsigned int l=0;l<levels.size();++l)
+  {
+    unsigned long long levelSize=levels[l].size;
+    outS.write((const char*)&levelSize,sizeof(unsigned long long));
+  }
+  written+=(levels.size()+1)*sizeof(unsigned long long);
+
+  for(unsigned int l=0;l<levels.size();++l)
+  {
+    const LevelView& level=levels[l];
+    outS.write((const char*)level.keys,level.size*sizeof(KEY));
+    written+=level.size*sizeof(KEY);
+    writePadding(outS,written);
+    outS.write((const char*)level.data,level.size*sizeof(DATA_TYPE));
+    written+=level.size*sizeof(DATA_TYPE);
+    writePadding(outS,written);
+    outS.write((const char*)level.parents,level.size*sizeof(unsigned int));
+    written+=level.size*sizeof(unsigned int);
+    writePadding(outS,written);
+    outS.write((const char*)level.childBegin,(level.size+1)*sizeof(unsigned int));
+    written+=(level.size+1)*sizeof(unsigned int);
+    writePadding(outS,written);
+  }
+
+  if(!outS)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::alignOffset(size_t bufSize,
+                                                size_t& offset)
+{
+  if(offset%FROZEN_TRIE_VECS_ALIGNMENT!=0)
+    offset+=FROZEN_TRIE_VECS_ALIGNMENT-offset%FROZEN_TRIE_VECS_ALIGNMENT;
+  return offset<=bufSize;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::attach(const char* bufPtr,
+                                           size_t bufSize,
+                                           size_t& offset)
+{
+  clear();
+
+      // Read number of levels and their sizes
+  unsigned long long numLevels;
+  if(!alignOffset(bufSize,offset) || bufSize-offset<sizeof(unsigned long long))
+    return THOT_ERROR;
+  memcpy(&numLevels,bufPtr+offset,sizeof(unsigned long long));
+  offset+=sizeof(unsigned long long);
+  if(numLevels>(bufSize-offset)/sizeof(unsigned long long))
+    return THOT_ERROR;
+  std::vector<LevelView> attachedLevels(numLevels);
+  for(unsigned int l=0;l<numLevels;++l)
+  {
+    unsigned long long levelSize;
+    memcpy(&levelSize,bufPtr+offset,sizeof(unsigned long long));
+    offset+=sizeof(unsigned long long);
+    attachedLevels[l].size=levelSize;
+  }
+
+      // Set arrays of each level
+  for(unsigned int l=0;l<numLevels;++l)
+  {
+    LevelView& level=attachedLevels[l];
+    if(level.size>bufSize)
+      return THOT_ERROR;
+    size_t arraySizes[4]={level.size*sizeof(KEY),
+                          level.size*sizeof(DATA_TYPE),
+                          level.size*sizeof(unsigned int),
+                          (level.size+1)*sizeof(unsigned int)};
+    const char* arrayPtrs[4];
+    for(unsigned int i=0;i<4;++i)
+    {
+      if(!alignOffset(bufSize,offset) || bufSize-offset<arraySizes[i])
+        return THOT_ERROR;
+      arrayPtrs[i]=bufPtr+offset;
+      offset+=arraySizes[i];
+    }
+    level.keys=(const KEY*)arrayPtrs[0];
+    level.data=(const DATA_TYPE*)arrayPtrs[1];
+    level.parents=(const unsigned int*)arrayPtrs[2];
+    level.childBegin=(const unsigned int*)arrayPtrs[3];
+  }
+  alignOffset(bufSize,offset);
+
+      // Check the children ranges and the parent indices, so that a
+      // corrupted image cannot make lookups access memory outside of
+      // the levels
+  for(unsigned int l=0;l<numLevels;++l)
+  {
+    const LevelView& level=attachedLevels[l];
+    size_t nextLevelSize=(l+1<numLevels ? attachedLevels[l+1].size : 0);
+    if(level.childBegin[0]!=0 || level.childBegin[level.size]!=nextLevelSize)
+      return THOT_ERROR;
+    for(size_t i=0;i<level.size;++i)
+    {
+      if(level.childBegin[i+1]<level.childBegin[i])
+        return THOT_ERROR;
+      if(l>0 && level.parents[i]>=attachedLevels[l-1].size)
+        return THOT_ERROR;
+    }
+  }
+
+  levels.swap(attachedLevels);
+  attached=true;
+  return THOT_OK;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE>
+bool FrozenTrieVecs<KEY,DATA_TYPE>::isAttached(void)const
+{
+  return attached;
+}
+
+//---------------
+
+#endif
@@ -30,17 +30,27 @@ KenLm::KenLm(void)
   modelPtr=NULL;
 }
 
+//-------------------------
+bool KenLm::modelReadsAreThreadSafe(void)
+{
+      // Queries to kenlm models do not modify them
+  return true;
+}
+
 //-------------------------
 LgProb KenLm::getNgramLgProb(WordIndex w,
                              const std::vector<WordIndex>& vu)
 {
-      // Reverse history (required by kenlm library)
-  std::vector<WordIndex> rev_vu=vu;
-  std::reverse(rev_vu.begin(),rev_vu.end());
+      // Store the relevant part of the history in reverse order
+      // (required by kenlm library)
+  lm::WordIndex rev_vu[KENLM_MAX_ORDER-1];
+  unsigned int histLen=std::min((unsigned int)vu.size(),(unsigned int)modelPtr->Order()-1);
+  for(unsigned int i=0;i<histLen;++i)
+    rev_vu[i]=vu[vu.size()-1-i];
 
       // Obtain log-prob
   lm::ngram::State out_st;
-  return modelPtr->FullScoreForgotState(&*rev_vu.begin(),&*rev_vu.end(),w,out_st).prob*M_LN10;
+  return modelPtr->FullScoreForgotState(rev_vu,rev_vu+histLen,w,out_st).prob*M_LN10;
 }
 
 //-------------------------
@@ -81,32 +91,23 @@ LgProb KenLm::getLgProbEndStr(const std::vector<std::string>& rq)
 bool KenLm::getStateForWordSeq(const std::vector<WordIndex>& wordSeq,
                                std::vector<WordIndex>& state)
 {
-  state=wordSeq;
+  packState(modelPtr->NullContextState(),state);
+  for(unsigned int i=0;i<wordSeq.size();++i)
+    getNgramLgProbGivenKlmState(wordSeq[i],state);
   return true;
 }
 
 //-------------------------
 void KenLm::getStateForBeginOfSentence(std::vector<WordIndex>& state)
 {
-  bool found;
-  unsigned int ngramOrder=getNgramOrder();
-  state.clear();
-  
-  if(ngramOrder>0)
-  {
-    for(unsigned int i=0;i<ngramOrder-1;++i)
-      state.push_back(getBosId(found));
-  }
+  packState(modelPtr->BeginSentenceState(),state);
 }
 
 //-------------------------
 LgProb KenLm::getNgramLgProbGivenState(WordIndex w,
                                        std::vector<WordIndex>& state)
 {
-  LgProb lp=getNgramLgProb(w,state);
-  for(unsigned int i=1;i<state.size();++i) state[i-1]=state[i];
-  if(state.size()>0) state[state.size()-1]=w;
-  return lp;
+  return getNgramLgProbGivenKlmState(w,state);
 }
 
 //-------------------------
@@ -122,13 +123,54 @@ LgProb KenLm::getNgramLgProbGivenStateStr(std::string s,
 LgProb KenLm::getLgProbEndGivenState(std::vector<WordIndex>& state)
 {
   bool found;
+  return getNgramLgProbGivenKlmState(getEosId(found),state);
+}
 
-  LgProb lp=getLgProbEnd(state);
-  for(unsigned int i=1;i<state.size();++i) state[i-1]=state[i];
-  if(state.size()>0) state[state.size()-1]=getEosId(found);
+//-------------------------
+LgProb KenLm::getNgramLgProbGivenKlmState(WordIndex w,
+                                          std::vector<WordIndex>& state)
+{
+  lm::ngram::State in_st;
+  lm::ngram::State out_st;
+  unpackState(state,in_st);
+  LgProb lp=modelPtr->FullScore(in_st,w,out_st).prob*M_LN10;
+  packState(out_st,state);
   return lp;
 }
 
+//-------------------------
+void KenLm::packState(const lm::ngram::State& klmState,
+                      std::vector<WordIndex>& state)const
+{
+      // The packed state stores the context words followed by their
+      // backoff weights. Only the first klmState.length entries are
+      // meaningful, this is the minimized state computed by kenlm
+  unsigned int len=klmState.length;
+  size_t wordsBytes=len*sizeof(lm::WordIndex);
+  size_t backoffBytes=len*sizeof(float);
+  state.resize((wordsBytes+backoffBytes)/sizeof(WordIndex));
+  if(len>0)
+  {
+    memcpy(&state[0],klmState.words,wordsBytes);
+    memcpy((char*)&state[0]+wordsBytes,klmState.backoff,backoffBytes);
+  }
+}
+
+//-------------------------
+void KenLm::unpackState(const std::vector<WordIndex>& state,
+                        lm::ngram::State& klmState)const
+{
+  size_t stateBytes=state.size()*sizeof(WordIndex);
+  unsigned int len=stateBytes/(sizeof(lm::WordIndex)+sizeof(float));
+  klmState.length=len;
+  if(len>0)
+  {
+    size_t wordsBytes=len*sizeof(lm::WordIndex);
+    memcpy(klmState.words,&state[0],wordsBytes);
+    memcpy(klmState.backoff,(const char*)&state[0]+wordsBytes,len*sizeof(float));
+  }
+}
+
 //-------------------------
 bool KenLm::existSymbol(std::string s)const
 {
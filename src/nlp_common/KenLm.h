@@ -35,6 +35,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "BaseNgramLM.h"
 #include "ModelDescriptorUtils.h"
 #include <algorithm>
+#include <string.h>
 
 //--------------- Constants ------------------------------------------
 
@@ -58,6 +59,9 @@ class KenLm: public BaseNgramLM<std::vector<WordIndex> >
       // Constructor
   KenLm();
 
+      // Thread safety related functions
+  bool modelReadsAreThreadSafe(void);
+
         // Probability functions
   LgProb getNgramLgProb(WordIndex w,const std::vector<WordIndex>& vu);
       // returns the probability of an n-gram, uv[0] stores the n-1'th
@@ -68,7 +72,10 @@ class KenLm: public BaseNgramLM<std::vector<WordIndex> >
   LgProb getLgProbEnd(const std::vector<WordIndex>& vu);
   LgProb getLgProbEndStr(const std::vector<std::string>& rq);
 
-        // Probability functions using states
+        // Probability functions using states. States store native
+        // kenlm states (minimized context words and their backoff
+        // weights) packed into a vector, so hypotheses whose contexts
+        // are equivalent for the model share the same state
   bool getStateForWordSeq(const std::vector<WordIndex>& wordSeq,
                           std::vector<WordIndex>& state);
   void getStateForBeginOfSentence(std::vector<WordIndex> &state);
@@ -115,6 +122,14 @@ class KenLm: public BaseNgramLM<std::vector<WordIndex> >
 
   KenLangModel* modelPtr;
 
+      // Functions to convert between native and packed states
+  void packState(const lm::ngram::State& klmState,
+                 std::vector<WordIndex>& state)const;
+  void unpackState(const std::vector<WordIndex>& state,
+                   lm::ngram::State& klmState)const;
+  LgProb getNgramLgProbGivenKlmState(WordIndex w,
+                                     std::vector<WordIndex>& state);
+
       // Auxiliary functions
   bool load_kenlm_file(const char *fileName);
 };
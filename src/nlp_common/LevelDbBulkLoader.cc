@@ -0,0 +1,328 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LevelDbBulkLoader.cc
+ *
+ * @brief Definitions file for LevelDbBulkLoader.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LevelDbBulkLoader.h"
+#include <stdlib.h>
+#include <math.h>
+#include <iostream>
+#include <sstream>
+#include <algorithm>
+
+//--------------- LevelDbBulkLoader class function definitions
+
+//-------------------------
+LevelDbBulkLoader::LevelDbBulkLoader(leveldb::DB* _db,
+                                     bool _sumValues,
+                                     bool _intValues,
+                                     std::string _tmpDir,
+                                     size_t _memBytes)
+{
+  db=_db;
+  sumValues=_sumValues;
+  intValues=_intValues;
+  tmpDir=_tmpDir;
+  memBytes=_memBytes;
+  entriesBytes=0;
+  error=false;
+  batchBytes=0;
+  numKeys=0;
+
+      // Stored values are only looked up when the database already
+      // contains entries, so loading into an empty database does not
+      // pay for the reads
+  mergeStoredValues=false;
+  if(sumValues)
+  {
+    leveldb::ReadOptions readOptions;
+    readOptions.fill_cache=false;
+    leveldb::Iterator* iter=db->NewIterator(readOptions);
+    iter->SeekToFirst();
+    mergeStoredValues=iter->Valid();
+    delete iter;
+  }
+}
+
+//-------------------------
+int LevelDbBulkLoader::add(const std::string& key,
+                           double value)
+{
+  if(error)
+    return THOT_ERROR;
+
+  entries.push_back(BulkEntry());
+  entries.back().key=key;
+  entries.back().value=value;
+  entriesBytes+=key.size()+LDB_BULK_ENTRY_OVERHEAD;
+
+      // Spill entries to a sorted run if memory budget is exceeded
+  if(entriesBytes>memBytes)
+    return spillEntries();
+  else
+    return THOT_OK;
+}
+
+//-------------------------
+void LevelDbBulkLoader::sortEntries(void)
+{
+      // Stable sort keeps the insertion order of repeated keys
+  std::stable_sort(entries.begin(),entries.end());
+
+  size_t numDiffEntries=0;
+  for(size_t i=0;i<entries.size();++i)
+  {
+    if(numDiffEntries>0 && entries[numDiffEntries-1].key==entries[i].key)
+    {
+      if(sumValues)
+        entries[numDiffEntries-1].value+=entries[i].value;
+      else
+        entries[numDiffEntries-1].value=entries[i].value;
+    }
+    else
+    {
+      if(numDiffEntries!=i)
+      {
+        entries[numDiffEntries].key.swap(entries[i].key);
+        entries[numDiffEntries].value=entries[i].value;
+      }
+      ++numDiffEntries;
+    }
+  }
+  entries.resize(numDiffEntries);
+}
+
+//-------------------------
+int LevelDbBulkLoader::spillEntries(void)
+{
+  sortEntries();
+
+  FILE* runFile=SortedRunUtils::createTmpFile(tmpDir,"thot_ldb_bulk");
+  if(runFile==NULL)
+  {
+    error=true;
+    return THOT_ERROR;
+  }
+  runFiles.push_back(runFile);
+
+  for(size_t i=0;i<entries.size();++i)
+  {
+    if(SortedRunUtils::writeKeyValue(runFile,entries[i].key,entries[i].value)==THOT_ERROR)
+    {
+      std::cerr<<"Error while writing temporary run file"<<std::endl;
+      error=true;
+      return THOT_ERROR;
+    }
+  }
+  std::vector<BulkEntry>().swap(entries);
+  entriesBytes=0;
+
+  return THOT_OK;
+}
+
+//-------------------------
+int LevelDbBulkLoader::finish(void)
+{
+  if(error)
+  {
+    closeRuns();
+    return THOT_ERROR;
+  }
+
+  int ret=THOT_OK;
+  if(runFiles.empty())
+  {
+        // All entries fit in memory
+    sortEntries();
+    for(size_t i=0;i<entries.size() && ret==THOT_OK;++i)
+      ret=writeEntry(entries[i].key,entries[i].value);
+    std::vector<BulkEntry>().swap(entries);
+    entriesBytes=0;
+  }
+  else
+  {
+    ret=spillEntries();
+    if(ret==THOT_OK)
+      ret=mergeRuns();
+  }
+  closeRuns();
+
+  if(ret==THOT_OK)
+    ret=flushBatch();
+  if(ret==THOT_OK)
+    ret=verify();
+  return ret;
+}
+
+//-------------------------
+int LevelDbBulkLoader::mergeRuns(void)
+{
+  std::vector<SortedRunSource<RunEntry>*> sources;
+  for(unsigned int i=0;i<runFiles.size();++i)
+  {
+    rewind(runFiles[i]);
+    sources.push_back(new KeyValueRunSource<double>(runFiles[i]));
+  }
+
+  RunMerger merger(sources);
+  int ret=THOT_OK;
+  RunEntry runEntry;
+  unsigned int runIdx;
+  BulkEntry currEntry;
+  bool currEntryValid=false;
+  while(merger.next(runEntry,runIdx))
+  {
+    if(currEntryValid && currEntry.key==runEntry.first)
+    {
+      if(sumValues)
+        currEntry.value+=runEntry.second;
+      else
+        currEntry.value=runEntry.second;
+    }
+    else
+    {
+      if(currEntryValid && writeEntry(currEntry.key,currEntry.value)==THOT_ERROR)
+      {
+        ret=THOT_ERROR;
+        break;
+      }
+      currEntry.key.swap(runEntry.first);
+      currEntry.value=runEntry.second;
+      currEntryValid=true;
+    }
+  }
+  if(ret==THOT_OK && currEntryValid)
+    ret=writeEntry(currEntry.key,currEntry.value);
+
+  if(merger.readError())
+  {
+    std::cerr<<"Error while reading temporary run file"<<std::endl;
+    ret=THOT_ERROR;
+  }
+
+  for(unsigned int i=0;i<sources.size();++i)
+    delete sources[i];
+
+  return ret;
+}
+
+//-------------------------
+int LevelDbBulkLoader::writeEntry(const std::string& key,
+                                  double value)
+{
+      // Add the value stored before the bulk load started, each key is
+      // written only once, so the stored value has not been modified
+  if(mergeStoredValues)
+  {
+    leveldb::ReadOptions readOptions;
+    readOptions.fill_cache=false;
+    std::string storedValueStr;
+    leveldb::Status status=db->Get(readOptions,key,&storedValueStr);
+    if(status.ok())
+      value+=atof(storedValueStr.c_str());
+    else if(!status.IsNotFound())
+    {
+      std::cerr<<"Retrieving data status: "<<status.ToString()<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  std::string valueStr=valueToString(value);
+  batch.Put(key,valueStr);
+  batchBytes+=key.size()+valueStr.size();
+
+      // Keep a sample of the entries to verify the result
+  if(numKeys%LDB_BULK_VERIFY_RATE==0)
+    verifySamples.push_back(std::make_pair(key,valueStr));
+  ++numKeys;
+
+  if(batchBytes>=LDB_BULK_BATCH_BYTES)
+    return flushBatch();
+  else
+    return THOT_OK;
+}
+
+//-------------------------
+int LevelDbBulkLoader::flushBatch(void)
+{
+  if(batchBytes==0)
+    return THOT_OK;
+
+  leveldb::Status status=db->Write(leveldb::WriteOptions(),&batch);
+  batch.Clear();
+  batchBytes=0;
+  if(!status.ok())
+  {
+    std::cerr<<"Storing data status: "<<status.ToString()<<std::endl;
+    return THOT_ERROR;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+int LevelDbBulkLoader::verify(void)
+{
+  for(size_t i=0;i<verifySamples.size();++i)
+  {
+    std::string valueStr;
+    leveldb::Status status=db->Get(leveldb::ReadOptions(),verifySamples[i].first,&valueStr);
+    if(!status.ok() || valueStr!=verifySamples[i].second)
+    {
+      std::cerr<<"Error: verification of bulk loaded database failed"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+std::string LevelDbBulkLoader::valueToString(double value)const
+{
+  std::stringstream ss;
+  if(intValues)
+    ss<<(int)round(value);
+  else
+    ss<<(float)value;
+  return ss.str();
+}
+
+//-------------------------
+size_t LevelDbBulkLoader::getNumKeys(void)const
+{
+  return numKeys;
+}
+
+//-------------------------
+void LevelDbBulkLoader::closeRuns(void)
+{
+  for(unsigned int i=0;i<runFiles.size();++i)
+    fclose(runFiles[i]);
+  runFiles.clear();
+}
+
+//-------------------------
+LevelDbBulkLoader::~LevelDbBulkLoader()
+{
+  closeRuns();
+}
@@ -0,0 +1,139 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LevelDbBulkLoader.h
+ *
+ * @brief Defines the LevelDbBulkLoader class, which loads a large set
+ * of key-value pairs into a LevelDB database in key order.
+ */
+
+#ifndef _LevelDbBulkLoader_h
+#define _LevelDbBulkLoader_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "leveldb/db.h"
+#include "leveldb/write_batch.h"
+#include "ErrorDefs.h"
+#include "SortedRunUtils.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define LDB_BULK_MEM_BYTES          (512*1048576)
+#define LDB_BULK_BATCH_BYTES        (16*1048576)
+#define LDB_BULK_WRITE_BUFFER_SIZE  (256*1048576)
+#define LDB_BULK_VERIFY_RATE        1000
+#define LDB_BULK_ENTRY_OVERHEAD     48
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LevelDbBulkLoader class
+
+/**
+ * @brief Buffers the values added for a set of keys, sorts them using
+ * temporary runs if the memory budget is exceeded and writes them to
+ * the database in key order using large write batches. Writing keys
+ * in order produces non-overlapping table files, which are moved
+ * between levels without being compacted again.
+ */
+
+class LevelDbBulkLoader
+{
+ public:
+
+      // Constructor
+  LevelDbBulkLoader(leveldb::DB* _db,
+                    bool _sumValues,
+                    bool _intValues,
+                    std::string _tmpDir,
+                    size_t _memBytes=LDB_BULK_MEM_BYTES);
+      // If _sumValues is true, the values added for the same key are
+      // added up, together with the value already stored in the
+      // database for the key, if any. Otherwise the last value added
+      // replaces the stored one. If _intValues is true, values are
+      // stored as integers
+
+  int add(const std::string& key,
+          double value);
+      // Adds value for key, returns THOT_ERROR if a temporary run
+      // could not be written
+  int finish(void);
+      // Writes the buffered entries into the database and verifies a
+      // sample of them
+  size_t getNumKeys(void)const;
+      // Returns the number of different keys written by finish()
+
+      // Destructor
+  ~LevelDbBulkLoader();
+
+ private:
+
+  struct BulkEntry
+  {
+    std::string key;
+    double value;
+    bool operator<(const BulkEntry& right)const
+      {
+        return key<right.key;
+      }
+  };
+
+  typedef std::pair<std::string,double> RunEntry;
+  typedef SortedRunMerger<RunEntry,KeyLess<RunEntry> > RunMerger;
+      // The merger returns the entries of older runs first
+
+  leveldb::DB* db;
+  bool sumValues;
+  bool intValues;
+  bool mergeStoredValues;
+      // True if stored values have to be added to the buffered ones,
+      // i.e. values are added up and the database was not empty
+  std::string tmpDir;
+  size_t memBytes;
+
+  std::vector<BulkEntry> entries;
+  size_t entriesBytes;
+  std::vector<FILE*> runFiles;
+  bool error;
+
+  leveldb::WriteBatch batch;
+  size_t batchBytes;
+  size_t numKeys;
+  std::vector<std::pair<std::string,std::string> > verifySamples;
+
+  void sortEntries(void);
+      // Sorts the buffered entries combining those with the same key
+  int spillEntries(void);
+  int mergeRuns(void);
+  int writeEntry(const std::string& key,
+                 double value);
+  int flushBatch(void);
+  int verify(void);
+  std::string valueToString(double value)const;
+  void closeRuns(void);
+};
+
+#endif
@@ -0,0 +1,169 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LevelDbConfig.cc
+ *
+ * @brief Definitions file for LevelDbConfig.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LevelDbConfig.h"
+#include "StrProcUtils.h"
+#include <stdlib.h>
+
+//--------------- Static members
+
+leveldb::Cache* LevelDbConfig::sharedCachePtr=NULL;
+size_t LevelDbConfig::sharedCacheMb=0;
+pthread_mutex_t LevelDbConfig::sharedCacheMut=PTHREAD_MUTEX_INITIALIZER;
+
+//--------------- LevelDbConfig class function definitions
+
+//-------------------------
+LevelDbConfig::LevelDbConfig(size_t _blockCacheMb,
+                             int _bloomBitsPerKey,
+                             int _maxOpenFiles)
+{
+  blockCacheMb=_blockCacheMb;
+  bloomBitsPerKey=_bloomBitsPerKey;
+  maxOpenFiles=_maxOpenFiles;
+  fillCache=true;
+  sharedBlockCache=false;
+  valueCacheSize=LDB_DEFAULT_VALUE_CACHE_SIZE;
+}
+
+//-------------------------
+bool LevelDbConfig::parseInitPars(const std::string& initPars)
+{
+  std::vector<std::string> strVec=StrProcUtils::stringToStringVector(initPars);
+  for(unsigned int i=0;i<strVec.size();++i)
+  {
+    bool takesValue=(strVec[i]=="-ldb-cache-mb" || strVec[i]=="-ldb-bloom-bits" ||
+                     strVec[i]=="-ldb-max-open-files" || strVec[i]=="-ldb-value-cache");
+    if(takesValue)
+    {
+      if(i+1>=strVec.size())
+      {
+        std::cerr<<"Error: no value given for option "<<strVec[i]<<std::endl;
+        return THOT_ERROR;
+      }
+      int val=atoi(strVec[i+1].c_str());
+      if(val<0)
+      {
+        std::cerr<<"Error: invalid value for option "<<strVec[i]<<std::endl;
+        return THOT_ERROR;
+      }
+      if(strVec[i]=="-ldb-cache-mb")
+        blockCacheMb=val;
+      else if(strVec[i]=="-ldb-bloom-bits")
+        bloomBitsPerKey=val;
+      else if(strVec[i]=="-ldb-max-open-files")
+        maxOpenFiles=val;
+      else
+        valueCacheSize=val;
+      ++i;
+    }
+    else if(strVec[i]=="-ldb-no-fill-cache")
+      fillCache=false;
+    else if(strVec[i]=="-ldb-shared-cache")
+      sharedBlockCache=true;
+  }
+  return THOT_OK;
+}
+
+//-------------------------
+void LevelDbConfig::setOptions(leveldb::Options& options)const
+{
+  options.create_if_missing=true;
+  if(maxOpenFiles>0)
+    options.max_open_files=maxOpenFiles;
+
+      // Use index store in memory to reduce number of disk operations
+  if(bloomBitsPerKey>0)
+    options.filter_policy=leveldb::NewBloomFilterPolicy(bloomBitsPerKey);
+  else
+    options.filter_policy=NULL;
+
+      // A null block cache makes LevelDB use its own 8MB cache
+  if(blockCacheMb==0)
+    options.block_cache=NULL;
+  else if(sharedBlockCache)
+    options.block_cache=getSharedCache(blockCacheMb);
+  else
+    options.block_cache=leveldb::NewLRUCache(blockCacheMb*1048576);
+}
+
+//-------------------------
+void LevelDbConfig::releaseOptions(leveldb::Options& options)const
+{
+  if(options.filter_policy!=NULL)
+  {
+    delete options.filter_policy;
+    options.filter_policy=NULL;
+  }
+
+  if(options.block_cache!=NULL)
+  {
+    pthread_mutex_lock(&sharedCacheMut);
+    bool isShared=(options.block_cache==sharedCachePtr);
+    pthread_mutex_unlock(&sharedCacheMut);
+    if(!isShared)
+      delete options.block_cache;
+    options.block_cache=NULL;
+  }
+}
+
+//-------------------------
+leveldb::ReadOptions LevelDbConfig::getReadOptions(void)const
+{
+  leveldb::ReadOptions readOptions;
+  readOptions.fill_cache=fillCache;
+  return readOptions;
+}
+
+//-------------------------
+void LevelDbConfig::print(std::ostream& outS)const
+{
+  outS<<"block cache: "<<blockCacheMb<<" MB"<<(sharedBlockCache?" (shared)":"");
+  outS<<" ; bloom bits per key: "<<bloomBitsPerKey;
+  outS<<" ; max open files: "<<maxOpenFiles;
+  outS<<" ; fill cache: "<<fillCache;
+  outS<<" ; value cache: "<<valueCacheSize<<" entries"<<std::endl;
+}
+
+//-------------------------
+leveldb::Cache* LevelDbConfig::getSharedCache(size_t capacityMb)
+{
+      // The shared cache is created by the first database requesting
+      // it and lives until the process ends
+  pthread_mutex_lock(&sharedCacheMut);
+  if(sharedCachePtr==NULL)
+  {
+    sharedCachePtr=leveldb::NewLRUCache(capacityMb*1048576);
+    sharedCacheMb=capacityMb;
+  }
+  else if(capacityMb!=sharedCacheMb)
+  {
+    std::cerr<<"Warning: shared LevelDB block cache already created with "<<sharedCacheMb<<" MB"<<std::endl;
+  }
+  leveldb::Cache* cachePtr=sharedCachePtr;
+  pthread_mutex_unlock(&sharedCacheMut);
+  return cachePtr;
+}
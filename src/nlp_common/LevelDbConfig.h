@@ -0,0 +1,109 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LevelDbConfig.h
+ *
+ * @brief Defines the LevelDbConfig class, which stores the tuning
+ * parameters of the LevelDB databases used by the models.
+ */
+
+#ifndef _LevelDbConfig_h
+#define _LevelDbConfig_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "leveldb/cache.h"
+#include "leveldb/db.h"
+#include "leveldb/filter_policy.h"
+#include "ErrorDefs.h"
+#include <pthread.h>
+#include <iostream>
+#include <string>
+
+//--------------- Constants ------------------------------------------
+
+#define LDB_DEFAULT_BLOCK_CACHE_MB      100
+#define LDB_DEFAULT_BLOOM_BITS_PER_KEY  48
+#define LDB_DEFAULT_MAX_OPEN_FILES      4000
+#define LDB_DEFAULT_VALUE_CACHE_SIZE    0
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LevelDbConfig class
+
+/**
+ * @brief Stores the parameters used to open a LevelDB database: size
+ * of the block cache, bits per key of the bloom filter, maximum
+ * number of open files, whether reads fill the block cache and size
+ * of the cache of decoded values kept by the tables. The block cache
+ * can be shared by all the databases opened by the process, so a
+ * single memory budget is used for the language, phrase and lexical
+ * models.
+ */
+
+class LevelDbConfig
+{
+ public:
+
+  size_t blockCacheMb;
+  int bloomBitsPerKey;
+  int maxOpenFiles;
+  bool fillCache;
+  bool sharedBlockCache;
+  size_t valueCacheSize;
+      // Maximum number of decoded values cached by the table, zero
+      // (the default) disables the cache
+
+      // Constructor
+  LevelDbConfig(size_t _blockCacheMb=LDB_DEFAULT_BLOCK_CACHE_MB,
+                int _bloomBitsPerKey=LDB_DEFAULT_BLOOM_BITS_PER_KEY,
+                int _maxOpenFiles=LDB_DEFAULT_MAX_OPEN_FILES);
+
+  bool parseInitPars(const std::string& initPars);
+      // Overrides the parameters given in an initialization string
+      // of a model factory. Recognized options are "-ldb-cache-mb
+      // <int>", "-ldb-bloom-bits <int>", "-ldb-max-open-files <int>",
+      // "-ldb-value-cache <int>", "-ldb-no-fill-cache" and
+      // "-ldb-shared-cache". Other options are ignored
+
+  void setOptions(leveldb::Options& options)const;
+      // Sets the filter policy, block cache and open files limit of
+      // options. The resources allocated here have to be released
+      // with releaseOptions()
+  void releaseOptions(leveldb::Options& options)const;
+      // Deletes the filter policy and the block cache of options,
+      // except the block cache shared by the process
+  leveldb::ReadOptions getReadOptions(void)const;
+
+  void print(std::ostream& outS)const;
+
+ private:
+
+  static leveldb::Cache* sharedCachePtr;
+  static size_t sharedCacheMb;
+  static pthread_mutex_t sharedCacheMut;
+
+  static leveldb::Cache* getSharedCache(size_t capacityMb);
+};
+
+#endif
@@ -0,0 +1,332 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LevelDbValueCache.h
+ *
+ * @brief Defines the LevelDbValueCache class template, a thread-safe
+ * LRU cache of the decoded values read from a LevelDB database.
+ */
+
+#ifndef _LevelDbValueCache_h
+#define _LevelDbValueCache_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <pthread.h>
+#include <iostream>
+#include <string>
+#include <list>
+#include <utility>
+#include <functional>
+#include <unordered_map>
+
+//--------------- Constants ------------------------------------------
+
+#define LDB_VALUE_CACHE_NUM_SHARDS 16
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LevelDbValueCache class
+
+/**
+ * @brief LRU cache mapping database keys to decoded values. Keys not
+ * present in the database are also cached, so repeated lookups of
+ * unseen n-grams or phrases do not reach the database. The entries
+ * are distributed by key hash among LDB_VALUE_CACHE_NUM_SHARDS
+ * shards, each one with its own mutex and LRU list, so concurrent
+ * lookups of different keys rarely wait for each other. The cache
+ * counts hits and misses to evaluate its usefulness.
+ */
+
+template<class VALUE>
+class LevelDbValueCache
+{
+ public:
+
+      // Constructor
+  LevelDbValueCache(size_t _capacity=0);
+
+  void setCapacity(size_t _capacity);
+      // Sets the maximum number of entries, zero disables the cache
+  size_t getCapacity(void)const;
+
+  bool lookup(const std::string& key,
+              VALUE& value,
+              bool& found);
+      // Returns true if key is cached. In such case, found indicates
+      // whether the key is present in the database and value stores
+      // its value
+  void insert(const std::string& key,
+              const VALUE& value,
+              bool found);
+  void erase(const std::string& key);
+  void clear(void);
+      // Removes all entries, keeping the hit and miss counters
+
+  unsigned long long getNumHits(void)const;
+  unsigned long long getNumMisses(void)const;
+  void printStats(const std::string& name,
+                  std::ostream& outS)const;
+      // Prints the hit rate, nothing is printed if the cache is
+      // disabled
+
+      // Destructor
+  ~LevelDbValueCache();
+
+ private:
+
+  struct CacheEntry
+  {
+    VALUE value;
+    bool found;
+  };
+  typedef std::list<std::pair<std::string,CacheEntry> > EntryList;
+
+  struct Shard
+  {
+    EntryList entryList;
+        // Entries ordered from most to least recently used
+    std::unordered_map<std::string,typename EntryList::iterator> entryMap;
+    unsigned long long numHits;
+    unsigned long long numMisses;
+    pthread_mutex_t shard_mut;
+  };
+
+  size_t capacity;
+  size_t shardCapacity;
+  mutable Shard shards[LDB_VALUE_CACHE_NUM_SHARDS];
+
+  Shard& getShard(const std::string& key)const;
+  void eraseUnlocked(Shard& shard,
+                     const std::string& key);
+  void shrinkUnlocked(Shard& shard);
+};
+
+//--------------- LevelDbValueCache class function definitions
+
+//-------------------------
+template<class VALUE>
+LevelDbValueCache<VALUE>::LevelDbValueCache(size_t _capacity)
+{
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    shards[i].numHits=0;
+    shards[i].numMisses=0;
+    pthread_mutex_init(&shards[i].shard_mut,NULL);
+  }
+  capacity=0;
+  shardCapacity=0;
+  setCapacity(_capacity);
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::setCapacity(size_t _capacity)
+{
+      // The capacity is divided among the shards
+  capacity=_capacity;
+  shardCapacity=(capacity+LDB_VALUE_CACHE_NUM_SHARDS-1)/LDB_VALUE_CACHE_NUM_SHARDS;
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    pthread_mutex_lock(&shards[i].shard_mut);
+    shrinkUnlocked(shards[i]);
+    pthread_mutex_unlock(&shards[i].shard_mut);
+  }
+}
+
+//-------------------------
+template<class VALUE>
+size_t LevelDbValueCache<VALUE>::getCapacity(void)const
+{
+  return capacity;
+}
+
+//-------------------------
+template<class VALUE>
+typename LevelDbValueCache<VALUE>::Shard& LevelDbValueCache<VALUE>::getShard(const std::string& key)const
+{
+  return shards[std::hash<std::string>()(key)%LDB_VALUE_CACHE_NUM_SHARDS];
+}
+
+//-------------------------
+template<class VALUE>
+bool LevelDbValueCache<VALUE>::lookup(const std::string& key,
+                                      VALUE& value,
+                                      bool& found)
+{
+  if(capacity==0)
+    return false;
+
+  Shard& shard=getShard(key);
+  pthread_mutex_lock(&shard.shard_mut);
+  typename std::unordered_map<std::string,typename EntryList::iterator>::iterator mapIter=shard.entryMap.find(key);
+  bool cached=(mapIter!=shard.entryMap.end());
+  if(cached)
+  {
+        // Move entry to the front of the list
+    shard.entryList.splice(shard.entryList.begin(),shard.entryList,mapIter->second);
+    value=mapIter->second->second.value;
+    found=mapIter->second->second.found;
+    ++shard.numHits;
+  }
+  else
+  {
+    ++shard.numMisses;
+  }
+  pthread_mutex_unlock(&shard.shard_mut);
+
+  return cached;
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::insert(const std::string& key,
+                                      const VALUE& value,
+                                      bool found)
+{
+  if(capacity==0)
+    return;
+
+  Shard& shard=getShard(key);
+  pthread_mutex_lock(&shard.shard_mut);
+  eraseUnlocked(shard,key);
+  CacheEntry cacheEntry;
+  cacheEntry.value=value;
+  cacheEntry.found=found;
+  shard.entryList.push_front(std::make_pair(key,cacheEntry));
+  shard.entryMap[key]=shard.entryList.begin();
+  shrinkUnlocked(shard);
+  pthread_mutex_unlock(&shard.shard_mut);
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::erase(const std::string& key)
+{
+  if(capacity==0)
+    return;
+
+  Shard& shard=getShard(key);
+  pthread_mutex_lock(&shard.shard_mut);
+  eraseUnlocked(shard,key);
+  pthread_mutex_unlock(&shard.shard_mut);
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::eraseUnlocked(Shard& shard,
+                                             const std::string& key)
+{
+  typename std::unordered_map<std::string,typename EntryList::iterator>::iterator mapIter=shard.entryMap.find(key);
+  if(mapIter!=shard.entryMap.end())
+  {
+    shard.entryList.erase(mapIter->second);
+    shard.entryMap.erase(mapIter);
+  }
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::shrinkUnlocked(Shard& shard)
+{
+  while(shard.entryList.size()>shardCapacity)
+  {
+    shard.entryMap.erase(shard.entryList.back().first);
+    shard.entryList.pop_back();
+  }
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::clear(void)
+{
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    pthread_mutex_lock(&shards[i].shard_mut);
+    shards[i].entryList.clear();
+    shards[i].entryMap.clear();
+    pthread_mutex_unlock(&shards[i].shard_mut);
+  }
+}
+
+//-------------------------
+template<class VALUE>
+unsigned long long LevelDbValueCache<VALUE>::getNumHits(void)const
+{
+  unsigned long long numHits=0;
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    pthread_mutex_lock(&shards[i].shard_mut);
+    numHits+=shards[i].numHits;
+    pthread_mutex_unlock(&shards[i].shard_mut);
+  }
+  return numHits;
+}
+
+//-------------------------
+template<class VALUE>
+unsigned long long LevelDbValueCache<VALUE>::getNumMisses(void)const
+{
+  unsigned long long numMisses=0;
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    pthread_mutex_lock(&shards[i].shard_mut);
+    numMisses+=shards[i].numMisses;
+    pthread_mutex_unlock(&shards[i].shard_mut);
+  }
+  return numMisses;
+}
+
+//-------------------------
+template<class VALUE>
+void LevelDbValueCache<VALUE>::printStats(const std::string& name,
+                                          std::ostream& outS)const
+{
+  if(capacity==0)
+    return;
+
+  size_t numEntries=0;
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+  {
+    pthread_mutex_lock(&shards[i].shard_mut);
+    numEntries+=shards[i].entryList.size();
+    pthread_mutex_unlock(&shards[i].shard_mut);
+  }
+  unsigned long long numHits=getNumHits();
+  unsigned long long numLookups=numHits+getNumMisses();
+  outS<<name<<" value cache: "<<numEntries<<"/"<<capacity<<" entries";
+  outS<<" ; lookups: "<<numLookups<<" ; hits: "<<numHits;
+  if(numLookups>0)
+    outS<<" ("<<100.0*numHits/numLookups<<"%)";
+  outS<<std::endl;
+}
+
+//-------------------------
+template<class VALUE>
+LevelDbValueCache<VALUE>::~LevelDbValueCache()
+{
+  for(unsigned int i=0;i<LDB_VALUE_CACHE_NUM_SHARDS;++i)
+    pthread_mutex_destroy(&shards[i].shard_mut);
+}
+
+#endif
@@ -0,0 +1,121 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MappedFile.cc
+ *
+ * @brief Definitions file for MappedFile.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "MappedFile.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+
+//--------------- MappedFile class function definitions
+
+//-------------------------
+MappedFile::MappedFile(void)
+{
+  mapPtr=NULL;
+  mapSize=0;
+}
+
+//-------------------------
+bool MappedFile::open(const char* fileName)
+{
+  close();
+
+  int fd=::open(fileName,O_RDONLY);
+  if(fd==-1)
+  {
+    std::cerr<<"Error while opening file "<<fileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  struct stat fileStat;
+  if(fstat(fd,&fileStat)==-1 || fileStat.st_size==0)
+  {
+    std::cerr<<"Error: file "<<fileName<<" is empty or cannot be accessed"<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+
+  void* ptr=mmap(NULL,fileStat.st_size,PROT_READ,MAP_SHARED,fd,0);
+      // The mapping remains valid after closing the descriptor
+  ::close(fd);
+  if(ptr==MAP_FAILED)
+  {
+    std::cerr<<"Error while mapping file "<<fileName<<" into memory"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  mapPtr=ptr;
+  mapSize=fileStat.st_size;
+  return THOT_OK;
+}
+
+//-------------------------
+bool MappedFile::isOpen(void)const
+{
+  return mapPtr!=NULL;
+}
+
+//-------------------------
+const char* MappedFile::getData(void)const
+{
+  return (const char*)mapPtr;
+}
+
+//-------------------------
+size_t MappedFile::getSize(void)const
+{
+  return mapSize;
+}
+
+//-------------------------
+void MappedFile::close(void)
+{
+  if(mapPtr!=NULL)
+  {
+    munmap(mapPtr,mapSize);
+    mapPtr=NULL;
+    mapSize=0;
+  }
+}
+
+//-------------------------
+bool MappedFile::isNewerThan(const char* fileName,
+                             const char* refFileName)
+{
+  struct stat fileStat;
+  struct stat refFileStat;
+  if(stat(fileName,&fileStat)==-1 || stat(refFileName,&refFileStat)==-1)
+    return false;
+  return fileStat.st_mtime>=refFileStat.st_mtime;
+}
+
+//-------------------------
+MappedFile::~MappedFile()
+{
+  close();
+}
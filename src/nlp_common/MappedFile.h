@@ -0,0 +1,82 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file MappedFile.h
+ *
+ * @brief Defines the MappedFile class, which maps a file into memory
+ * in read-only mode.
+ */
+
+#ifndef _MappedFile_h
+#define _MappedFile_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <stddef.h>
+#include <string>
+
+//--------------- Classes --------------------------------------------
+
+//--------------- MappedFile class
+
+/**
+ * @brief Read-only shared memory mapping of a file. The pages of the
+ * file are kept in the page cache of the operating system, so all the
+ * processes mapping the same file use a single copy of its content.
+ */
+
+class MappedFile
+{
+ public:
+
+      // Constructor
+  MappedFile(void);
+
+  bool open(const char* fileName);
+      // Maps the given file, returns THOT_ERROR if it cannot be
+      // opened or mapped
+  bool isOpen(void)const;
+  const char* getData(void)const;
+  size_t getSize(void)const;
+  void close(void);
+
+  static bool isNewerThan(const char* fileName,
+                          const char* refFileName);
+      // Returns true if both files exist and fileName is not older
+      // than refFileName
+
+      // Destructor
+  ~MappedFile();
+
+ private:
+
+  void* mapPtr;
+  size_t mapSize;
+
+      // Mappings cannot be copied
+  MappedFile(const MappedFile&);
+  MappedFile& operator=(const MappedFile&);
+};
+
+#endif
@@ -68,6 +68,7 @@ class OrderedVector
 	void pop(void);
     const std::pair<KEY,DATA>& top(void);
     DATA* findPtr(const KEY& k);
+    const DATA* findPtr(const KEY& k)const;
     iterator find(const KEY& k);
     DATA& operator[](const KEY& k);
     bool empty(void)const;
@@ -311,6 +312,18 @@ DATA* OrderedVector<KEY,DATA,KEY_ORDER_REL>::findPtr(const KEY& k)
     return NULL;
 }
 
+//-------------------------
+template<class KEY,class DATA,class KEY_ORDER_REL>
+const DATA* OrderedVector<KEY,DATA,KEY_ORDER_REL>::findPtr(const KEY& k)const
+{
+  size_t index;
+
+  if(findIndex(k,index))
+    return &vec[index].second;
+  else
+    return NULL;
+}
+
 //-------------------------
 template<class KEY,class DATA,class KEY_ORDER_REL>
 typename OrderedVector<KEY,DATA,KEY_ORDER_REL>::iterator
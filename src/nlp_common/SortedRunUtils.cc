@@ -0,0 +1,52 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SortedRunUtils.cc
+ *
+ * @brief Definitions file for SortedRunUtils.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "SortedRunUtils.h"
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+
+//--------------- SortedRunUtils function definitions
+
+//-------------------------
+FILE* SortedRunUtils::createTmpFile(const std::string& tmpDir,
+                                    const std::string& prefix)
+{
+  std::string templ=tmpDir+"/"+prefix+"_XXXXXX";
+  std::vector<char> templBuff(templ.begin(),templ.end());
+  templBuff.push_back('\0');
+  int fd=mkstemp(&templBuff[0]);
+  if(fd==-1)
+  {
+    std::cerr<<"Error while creating temporary file in directory "<<tmpDir<<std::endl;
+    return NULL;
+  }
+  unlink(&templBuff[0]);
+  FILE* file=fdopen(fd,"w+b");
+  if(file==NULL)
+    close(fd);
+  return file;
+}
@@ -0,0 +1,307 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SortedRunUtils.h
+ *
+ * @brief Defines utilities to sort large sets of entries using
+ * temporary sorted runs, which are combined by means of a k-way merge.
+ */
+
+#ifndef _SortedRunUtils_h
+#define _SortedRunUtils_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "ErrorDefs.h"
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <queue>
+#include <utility>
+
+//--------------- Functions ------------------------------------------
+
+namespace SortedRunUtils
+{
+  FILE* createTmpFile(const std::string& tmpDir,
+                      const std::string& prefix);
+      // Creates a temporary file in tmpDir whose name starts with
+      // prefix. The file is unlinked after its creation, so it is
+      // removed when closed. Returns NULL on error
+
+  template<class VALUE>
+  int writeKeyValue(FILE* file,
+                    const std::string& key,
+                    const VALUE& value);
+      // Writes a record composed of the key length, the key and the
+      // value
+  template<class VALUE>
+  bool readKeyValue(FILE* file,
+                    std::string& key,
+                    VALUE& value,
+                    bool& readError);
+      // Reads a record written by writeKeyValue(), returns false at
+      // the end of the file or on error, in which case readError is
+      // set to true
+}
+
+//--------------- Classes --------------------------------------------
+
+//--------------- SortedRunSource class
+
+/**
+ * @brief Sequence of entries sorted by key, which may be stored in
+ * memory or in a temporary run file.
+ */
+
+template<class ENTRY>
+class SortedRunSource
+{
+ public:
+  virtual bool next(ENTRY& entry)=0;
+      // Obtains the next entry, returns false when there are no more
+      // entries
+  virtual bool readError(void)const
+    {
+      return false;
+    }
+  virtual ~SortedRunSource(){}
+};
+
+//--------------- MemRunSource class
+
+/**
+ * @brief Sorted entries stored in a vector.
+ */
+
+template<class ENTRY>
+class MemRunSource: public SortedRunSource<ENTRY>
+{
+ public:
+  MemRunSource(const std::vector<ENTRY>* _entriesPtr)
+    {
+      entriesPtr=_entriesPtr;
+      pos=0;
+    }
+  bool next(ENTRY& entry)
+    {
+      if(pos==entriesPtr->size())
+        return false;
+      entry=(*entriesPtr)[pos];
+      ++pos;
+      return true;
+    }
+
+ private:
+  const std::vector<ENTRY>* entriesPtr;
+  size_t pos;
+};
+
+//--------------- KeyValueRunSource class
+
+/**
+ * @brief Sorted key-value pairs stored in a run file written by
+ * SortedRunUtils::writeKeyValue(). The file is read from its current
+ * position and is not closed by the source.
+ */
+
+template<class VALUE>
+class KeyValueRunSource: public SortedRunSource<std::pair<std::string,VALUE> >
+{
+ public:
+  KeyValueRunSource(FILE* _file)
+    {
+      file=_file;
+      error=false;
+    }
+  bool next(std::pair<std::string,VALUE>& entry)
+    {
+      return SortedRunUtils::readKeyValue(file,entry.first,entry.second,error);
+    }
+  bool readError(void)const
+    {
+      return error;
+    }
+
+ private:
+  FILE* file;
+  bool error;
+};
+
+//--------------- KeyLess class
+
+/**
+ * @brief Compares key-value pairs by key only.
+ */
+
+template<class ENTRY>
+struct KeyLess
+{
+  bool operator() (const ENTRY& a,
+                   const ENTRY& b)const
+    {
+      return a.first<b.first;
+    }
+};
+
+//--------------- SortedRunMerger class
+
+/**
+ * @brief Performs a k-way merge of a set of sorted sources. Entries
+ * with equal keys are returned in the order of their sources, so that
+ * entries of older runs come first.
+ */
+
+template<class ENTRY,class LESS>
+class SortedRunMerger
+{
+ public:
+
+      // Constructor
+  SortedRunMerger(const std::vector<SortedRunSource<ENTRY>*>& _sources);
+      // Sources are not owned by the merger
+
+  bool next(ENTRY& entry,
+            unsigned int& srcIdx);
+      // Obtains the lowest entry of the sources and the index of the
+      // source containing it. Returns false when all the sources have
+      // been consumed
+  bool readError(void)const;
+      // Returns true if any of the sources reported a read error
+
+ private:
+
+  struct QueueEntry
+  {
+    ENTRY entry;
+    unsigned int srcIdx;
+  };
+
+  struct QueueEntryGreater
+  {
+    bool operator() (const QueueEntry& a,
+                     const QueueEntry& b)const
+      {
+        if(LESS()(b.entry,a.entry)) return true;
+        if(LESS()(a.entry,b.entry)) return false;
+        return b.srcIdx<a.srcIdx;
+      }
+  };
+
+  std::vector<SortedRunSource<ENTRY>*> sources;
+  std::priority_queue<QueueEntry,std::vector<QueueEntry>,QueueEntryGreater> entryPrQueue;
+};
+
+//--------------- SortedRunUtils template function definitions
+
+//-------------------------
+template<class VALUE>
+int SortedRunUtils::writeKeyValue(FILE* file,
+                                  const std::string& key,
+                                  const VALUE& value)
+{
+  unsigned int keyLen=key.size();
+  if(fwrite(&keyLen,sizeof(unsigned int),1,file)!=1 ||
+     fwrite(key.data(),1,keyLen,file)!=keyLen ||
+     fwrite(&value,sizeof(VALUE),1,file)!=1)
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//-------------------------
+template<class VALUE>
+bool SortedRunUtils::readKeyValue(FILE* file,
+                                  std::string& key,
+                                  VALUE& value,
+                                  bool& readError)
+{
+  unsigned int keyLen;
+  if(fread(&keyLen,sizeof(unsigned int),1,file)!=1)
+  {
+    if(ferror(file))
+      readError=true;
+    return false;
+  }
+  key.resize(keyLen);
+  if((keyLen>0 && fread(&key[0],1,keyLen,file)!=keyLen) ||
+     fread(&value,sizeof(VALUE),1,file)!=1)
+  {
+        // Truncated record or I/O error
+    readError=true;
+    return false;
+  }
+  return true;
+}
+
+//--------------- SortedRunMerger class function definitions
+
+//-------------------------
+template<class ENTRY,class LESS>
+SortedRunMerger<ENTRY,LESS>::SortedRunMerger(const std::vector<SortedRunSource<ENTRY>*>& _sources)
+{
+  sources=_sources;
+  for(unsigned int i=0;i<sources.size();++i)
+  {
+    QueueEntry qEntry;
+    if(sources[i]->next(qEntry.entry))
+    {
+      qEntry.srcIdx=i;
+      entryPrQueue.push(qEntry);
+    }
+  }
+}
+
+//-------------------------
+template<class ENTRY,class LESS>
+bool SortedRunMerger<ENTRY,LESS>::next(ENTRY& entry,
+                                       unsigned int& srcIdx)
+{
+  if(entryPrQueue.empty())
+    return false;
+
+  QueueEntry qEntry=entryPrQueue.top();
+  entryPrQueue.pop();
+  std::swap(entry,qEntry.entry);
+  srcIdx=qEntry.srcIdx;
+
+      // Push next entry of the same source
+  if(sources[srcIdx]->next(qEntry.entry))
+    entryPrQueue.push(qEntry);
+
+  return true;
+}
+
+//-------------------------
+template<class ENTRY,class LESS>
+bool SortedRunMerger<ENTRY,LESS>::readError(void)const
+{
+  for(unsigned int i=0;i<sources.size();++i)
+  {
+    if(sources[i]->readError())
+      return true;
+  }
+  return false;
+}
+
+#endif
@@ -0,0 +1,185 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ThreadPool.cc
+ *
+ * @brief Definitions file for ThreadPool.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "ThreadPool.h"
+
+#include <iostream>
+
+//--------------- ThreadPool class function definitions
+
+//-------------------------
+ThreadPool::ThreadPool(unsigned int _numThreads)
+{
+  numPendingTasks=0;
+  stopWorkers=false;
+  pthread_mutex_init(&queue_mut,NULL);
+  pthread_cond_init(&task_avail_cond,NULL);
+  pthread_cond_init(&tasks_done_cond,NULL);
+
+      // Create worker threads
+  if(_numThreads>1)
+  {
+    for(unsigned int i=0;i<_numThreads;++i)
+    {
+      pthread_t tid;
+      if(pthread_create(&tid,NULL,workerFunc,(void*)this)==0)
+        threads.push_back(tid);
+      else
+        std::cerr<<"Warning: call to pthread_create failed"<<std::endl;
+    }
+  }
+}
+
+//-------------------------
+ThreadPool::~ThreadPool()
+{
+  waitForTasks();
+
+      // Stop worker threads
+  pthread_mutex_lock(&queue_mut);
+  stopWorkers=true;
+  pthread_cond_broadcast(&task_avail_cond);
+  pthread_mutex_unlock(&queue_mut);
+
+  for(unsigned int i=0;i<threads.size();++i)
+    pthread_join(threads[i],NULL);
+
+  pthread_mutex_destroy(&queue_mut);
+  pthread_cond_destroy(&task_avail_cond);
+  pthread_cond_destroy(&tasks_done_cond);
+}
+
+//-------------------------
+unsigned int ThreadPool::getNumThreads(void)const
+{
+  if(threads.empty())
+    return 1;
+  else
+    return threads.size();
+}
+
+//-------------------------
+void ThreadPool::addTask(ThreadPoolTaskFunc taskFunc,
+                         void* taskData)
+{
+  addTask(taskFunc,taskData,NULL);
+}
+
+//-------------------------
+void ThreadPool::addTask(ThreadPoolTaskFunc taskFunc,
+                         void* taskData,
+                         TaskGroup& taskGroup)
+{
+  addTask(taskFunc,taskData,&taskGroup);
+}
+
+//-------------------------
+void ThreadPool::addTask(ThreadPoolTaskFunc taskFunc,
+                         void* taskData,
+                         TaskGroup* taskGroupPtr)
+{
+  if(threads.empty())
+  {
+        // No workers available, execute task synchronously
+    taskFunc(taskData);
+  }
+  else
+  {
+    Task task;
+    task.taskFunc=taskFunc;
+    task.taskData=taskData;
+    task.taskGroupPtr=taskGroupPtr;
+    pthread_mutex_lock(&queue_mut);
+    taskQueue.push_back(task);
+    ++numPendingTasks;
+    if(taskGroupPtr)
+      ++taskGroupPtr->numPendingTasks;
+    pthread_cond_signal(&task_avail_cond);
+    pthread_mutex_unlock(&queue_mut);
+  }
+}
+
+//-------------------------
+void ThreadPool::waitForTasks(void)
+{
+  pthread_mutex_lock(&queue_mut);
+  while(numPendingTasks>0)
+    pthread_cond_wait(&tasks_done_cond,&queue_mut);
+  pthread_mutex_unlock(&queue_mut);
+}
+
+//-------------------------
+void ThreadPool::waitForTasks(TaskGroup& taskGroup)
+{
+  pthread_mutex_lock(&queue_mut);
+  while(taskGroup.numPendingTasks>0)
+    pthread_cond_wait(&tasks_done_cond,&queue_mut);
+  pthread_mutex_unlock(&queue_mut);
+}
+
+//-------------------------
+void* ThreadPool::workerFunc(void* poolPtr)
+{
+  ((ThreadPool*)poolPtr)->processTasks();
+  return NULL;
+}
+
+//-------------------------
+void ThreadPool::processTasks(void)
+{
+  while(true)
+  {
+        // Obtain next task
+    pthread_mutex_lock(&queue_mut);
+    while(taskQueue.empty() && !stopWorkers)
+      pthread_cond_wait(&task_avail_cond,&queue_mut);
+    if(taskQueue.empty())
+    {
+          // Pool is being destroyed
+      pthread_mutex_unlock(&queue_mut);
+      return;
+    }
+    Task task=taskQueue.front();
+    taskQueue.pop_front();
+    pthread_mutex_unlock(&queue_mut);
+
+        // Execute task
+    task.taskFunc(task.taskData);
+
+        // Notify completion
+    pthread_mutex_lock(&queue_mut);
+    --numPendingTasks;
+    bool groupDone=false;
+    if(task.taskGroupPtr)
+    {
+      --task.taskGroupPtr->numPendingTasks;
+      groupDone=(task.taskGroupPtr->numPendingTasks==0);
+    }
+    if(numPendingTasks==0 || groupDone)
+      pthread_cond_broadcast(&tasks_done_cond);
+    pthread_mutex_unlock(&queue_mut);
+  }
+}
@@ -0,0 +1,115 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file ThreadPool.h
+ *
+ * @brief Declares the ThreadPool class, a fixed-size pool of pthread
+ * workers executing tasks from a shared queue.
+ */
+
+#ifndef _ThreadPool_h
+#define _ThreadPool_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <pthread.h>
+#include <deque>
+#include <vector>
+#include <utility>
+
+//--------------- Constants ------------------------------------------
+
+
+//--------------- typedefs -------------------------------------------
+
+typedef void (*ThreadPoolTaskFunc)(void* taskData);
+
+//--------------- Classes --------------------------------------------
+
+//--------------- ThreadPool class
+
+/**
+ * @brief Class implementing a fixed-size pool of worker threads.
+ * When the pool is created with less than two threads, tasks are
+ * executed synchronously by the caller. Tasks can be added to task
+ * groups, so a pool shared by several callers allows each of them to
+ * wait only for its own tasks.
+ */
+
+class ThreadPool
+{
+ public:
+
+      // Constructor and destructor
+  ThreadPool(unsigned int _numThreads);
+  ~ThreadPool();
+
+  unsigned int getNumThreads(void)const;
+
+  struct TaskGroup
+  {
+    unsigned int numPendingTasks;
+    TaskGroup(void){numPendingTasks=0;}
+  };
+
+      // Functions to execute tasks
+  void addTask(ThreadPoolTaskFunc taskFunc,
+               void* taskData);
+  void addTask(ThreadPoolTaskFunc taskFunc,
+               void* taskData,
+               TaskGroup& taskGroup);
+  void waitForTasks(void);
+      // Blocks until all the tasks added so far have been executed
+  void waitForTasks(TaskGroup& taskGroup);
+      // Blocks until all the tasks added to taskGroup have been
+      // executed
+
+ private:
+
+  struct Task
+  {
+    ThreadPoolTaskFunc taskFunc;
+    void* taskData;
+    TaskGroup* taskGroupPtr;
+  };
+
+  std::vector<pthread_t> threads;
+  std::deque<Task> taskQueue;
+  unsigned int numPendingTasks;
+  bool stopWorkers;
+  pthread_mutex_t queue_mut;
+  pthread_cond_t task_avail_cond;
+  pthread_cond_t tasks_done_cond;
+
+  void addTask(ThreadPoolTaskFunc taskFunc,
+               void* taskData,
+               TaskGroup* taskGroupPtr);
+  static void* workerFunc(void* poolPtr);
+  void processTasks(void);
+
+      // Copies are not allowed
+  ThreadPool(const ThreadPool&);
+  ThreadPool& operator=(const ThreadPool&);
+};
+
+#endif
@@ -58,6 +58,15 @@ class TrieVecs
      // Inserts a sequence of elements of class key. The last element 
      // of vector keySeq is the first element of the sequence.
    DATA_TYPE* find(const std::vector<KEY>& keySeq);
+   TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>* findSubtrie(const KEY* keySeqBegin,
+                                                           const KEY* keySeqEnd);
+   const TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>* findSubtrie(const KEY* keySeqBegin,
+                                                                 const KEY* keySeqEnd)const;
+     // Returns the node reached after descending through the elements
+     // stored in the range [keySeqBegin,keySeqEnd), or NULL if the
+     // sequence is not found. An empty range returns the trie itself
+   DATA_TYPE& getData(void);
+   const DATA_TYPE& getData(void)const;
 
    size_t size(void)const;
    unsigned int height(void)const;
@@ -195,6 +204,52 @@ DATA_TYPE* TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::find(const std::vector<KE
   return ((DATA_TYPE*)&(t->data));
 }
 
+//---------------
+template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
+TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>*
+TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::findSubtrie(const KEY* keySeqBegin,
+                                                        const KEY* keySeqEnd)
+{
+  TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION> *t=this;
+
+  for(const KEY* keyPtr=keySeqBegin;keyPtr!=keySeqEnd;++keyPtr)
+  {
+    t=t->children.findPtr(*keyPtr);
+    if(t==NULL) return NULL;
+  }
+  return t;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
+const TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>*
+TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::findSubtrie(const KEY* keySeqBegin,
+                                                        const KEY* keySeqEnd)const
+{
+  const TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION> *t=this;
+
+  for(const KEY* keyPtr=keySeqBegin;keyPtr!=keySeqEnd;++keyPtr)
+  {
+    t=t->children.findPtr(*keyPtr);
+    if(t==NULL) return NULL;
+  }
+  return t;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
+DATA_TYPE& TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::getData(void)
+{
+  return data;
+}
+
+//---------------
+template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
+const DATA_TYPE& TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::getData(void)const
+{
+  return data;
+}
+
 //---------------
 template<class KEY,class DATA_TYPE,class KEY_SORT_CRITERION>
 size_t TrieVecs<KEY,DATA_TYPE,KEY_SORT_CRITERION>::size(void)const
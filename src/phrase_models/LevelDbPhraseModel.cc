@@ -369,6 +369,8 @@ bool LevelDbPhraseModel::load_seglentable(const char *segmLengthTableFileName)
 //-------------------------
 bool LevelDbPhraseModel::print(const char *prefix)
 {
+  levelDbPhraseTable.printCacheStats(std::cerr);
+
       // TO-BE-DONE
   
   std::string prefixStl = prefix;
@@ -383,6 +385,18 @@ bool LevelDbPhraseModel::print(const char *prefix)
   }
 }
 
+//-------------------------
+const LevelDbConfig& LevelDbPhraseModel::getLevelDbConfig(void)const
+{
+  return levelDbPhraseTable.getConfig();
+}
+
+//-------------------------
+bool LevelDbPhraseModel::setLevelDbConfig(const LevelDbConfig& config)
+{
+  return levelDbPhraseTable.setConfig(config);
+}
+
 //-------------------------
 size_t LevelDbPhraseModel::getSrcVocabSize(void)const
 {
@@ -154,7 +154,12 @@ class LevelDbPhraseModel: public BaseIncrPhraseModel
 
         // Printing functions
     bool print(const char* prefix);
-        // Prints the whole model
+        // Prints the whole model. Also reports the hit rate of the
+        // cache of the phrase table to the standard error
+
+        // Functions to tune the access to the phrase table database
+    const LevelDbConfig& getLevelDbConfig(void)const;
+    bool setLevelDbConfig(const LevelDbConfig& config);
     
         // Source vocabulary functions
 	size_t getSrcVocabSize(void)const;
@@ -29,9 +29,17 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Function definitions
 
-extern "C" BasePhraseModel* create(const char* /*str*/)
+extern "C" BasePhraseModel* create(const char* str)
 {
-  return new LevelDbPhraseModel;
+  LevelDbPhraseModel* levelDbPhraseModelPtr=new LevelDbPhraseModel;
+
+      // Initialization parameters such as "-ldb-cache-mb 512" tune
+      // the access to the LevelDB database (see LevelDbConfig.h)
+  LevelDbConfig config=levelDbPhraseModelPtr->getLevelDbConfig();
+  if(config.parseInitPars(str)==THOT_OK)
+    levelDbPhraseModelPtr->setLevelDbConfig(config);
+
+  return levelDbPhraseModelPtr;
 }
 
 //---------------
@@ -30,12 +30,12 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //-------------------------
 LevelDbPhraseTable::LevelDbPhraseTable(void)
 {
-    options.create_if_missing = true;
-    options.max_open_files = 4000;
-    options.filter_policy = leveldb::NewBloomFilterPolicy(48);
-    options.block_cache = leveldb::NewLRUCache(100 * 1048576);  // 100 MB for cache
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
     db = NULL;
     dbName = "";
+    bulkLoaderPtr = NULL;
 }
 
 //-------------------------
@@ -90,13 +90,20 @@ bool LevelDbPhraseTable::retrieveData(const std::vector<WordIndex>& phrase, int
     std::string value_str;
     count = 0;
     std::string key = vectorToString(phrase);
-    
-    leveldb::Status result = db->Get(leveldb::ReadOptions(), key, &value_str);  // Read stored src value
+
+    bool found;
+    if(valueCache.lookup(key, count, found))
+        return found;
+
+    leveldb::Status result = db->Get(readOptions, key, &value_str);  // Read stored src value
 
     if (result.ok()) {
         count = atoi(value_str.c_str());
+        valueCache.insert(key, count, true);
         return true;
     } else {
+        if(result.IsNotFound())
+            valueCache.insert(key, count, false);
         return false;
     }
 }
@@ -104,16 +111,27 @@ bool LevelDbPhraseTable::retrieveData(const std::vector<WordIndex>& phrase, int
 //-------------------------
 bool LevelDbPhraseTable::storeData(const std::vector<WordIndex>& phrase, int count)const
 {
+    if(bulkLoaderPtr != NULL)
+        return (bulkLoaderPtr->add(vectorToString(phrase), count) == THOT_OK);
+
     std::stringstream ss;
     ss << count;
     std::string count_str = ss.str();
 
+    std::string key = vectorToString(phrase);
     leveldb::WriteBatch batch;
-    batch.Put(vectorToString(phrase), count_str);
+    batch.Put(key, count_str);
     leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
 
-    if(!s.ok())
+    if(s.ok())
+    {
+        valueCache.insert(key, count, true);
+    }
+    else
+    {
+        valueCache.erase(key);
         std::cerr << "Storing data status: " << s.ToString() << std::endl;
+    }
 
     return s.ok();
 }
@@ -145,6 +163,7 @@ bool LevelDbPhraseTable::drop()
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     leveldb::Status status = leveldb::DestroyDB(dbName, options);
 
@@ -168,6 +187,7 @@ bool LevelDbPhraseTable::load(std::string levelDbPath)
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     dbName = levelDbPath;
     leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
@@ -183,6 +203,88 @@ bool LevelDbPhraseTable::load(std::string levelDbPath)
     }
 }
 
+//-------------------------
+bool LevelDbPhraseTable::startBulkLoad(std::string tmpDir)
+{
+    if(db == NULL)
+        return THOT_ERROR;
+
+    delete bulkLoaderPtr;
+    bulkLoaderPtr = NULL;
+
+    // Reopen database using a large write buffer, so sorted entries
+    // are flushed into few non-overlapping table files
+    options.write_buffer_size = LDB_BULK_WRITE_BUFFER_SIZE;
+    if(load(dbName) != THOT_OK)
+        return THOT_ERROR;
+
+    bulkLoaderPtr = new LevelDbBulkLoader(db, true, true, tmpDir);
+
+    return THOT_OK;
+}
+
+//-------------------------
+bool LevelDbPhraseTable::endBulkLoad(void)
+{
+    if(bulkLoaderPtr == NULL)
+        return THOT_ERROR;
+
+    int ret = bulkLoaderPtr->finish();
+    std::cerr << "Bulk loaded " << bulkLoaderPtr->getNumKeys() << " keys" << std::endl;
+    delete bulkLoaderPtr;
+    bulkLoaderPtr = NULL;
+
+    // Restore default write buffer size
+    options.write_buffer_size = leveldb::Options().write_buffer_size;
+    if(load(dbName) != THOT_OK)
+        return THOT_ERROR;
+
+    return ret;
+}
+
+//-------------------------
+bool LevelDbPhraseTable::setConfig(const LevelDbConfig& _config)
+{
+    if(bulkLoaderPtr != NULL)
+    {
+        std::cerr << "Error: the LevelDB configuration cannot be changed during a bulk load" << std::endl;
+        return THOT_ERROR;
+    }
+
+    // The database uses the filter policy and the block cache of the
+    // current options, so it is closed before they are released
+    bool dbWasOpen = (db != NULL);
+    if(db != NULL)
+    {
+        delete db;
+        db = NULL;
+    }
+
+    config.releaseOptions(options);
+    config = _config;
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
+    valueCache.clear();
+
+    if(dbWasOpen)
+        return load(dbName);
+    else
+        return THOT_OK;
+}
+
+//-------------------------
+const LevelDbConfig& LevelDbPhraseTable::getConfig(void)const
+{
+    return config;
+}
+
+//-------------------------
+void LevelDbPhraseTable::printCacheStats(std::ostream& outS)const
+{
+    valueCache.printStats("LevelDB phrase table", outS);
+}
+
 //-------------------------
 std::vector<WordIndex> LevelDbPhraseTable::encodeSrc(const std::vector<WordIndex>& s)
 {
@@ -294,6 +396,16 @@ void LevelDbPhraseTable::incrCountsOfEntry(const std::vector<WordIndex>& s,
                                            const std::vector<WordIndex>& t,
                                            Count c)
 {
+    if(bulkLoaderPtr != NULL)
+    {
+        // Counts are added up by the bulk loader
+        int count = (int) round(c.get_c_s());
+        storeData(encodeSrc(s), count);  // (USUSED_WORD, s)
+        storeData(t, count);  // (t)
+        storeData(encodeTrgSrc(s, t), count);  // (t, UNUSED_WORD, s)
+        return;
+    }
+
     // Retrieve previous states
     Count s_count = cSrc(s);
     Count t_count = cTrg(t);
@@ -428,7 +540,7 @@ bool LevelDbPhraseTable::getEntriesForTarget(const std::vector<WordIndex>& t,
     leveldb::Slice start = start_str;
     leveldb::Slice end = end_str;
 
-    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    leveldb::Iterator* it = db->NewIterator(readOptions);
     
     srctn.clear();  // Make sure that structure does not keep old values
     
@@ -539,20 +651,22 @@ void LevelDbPhraseTable::clear(void)
 //-------------------------
 LevelDbPhraseTable::~LevelDbPhraseTable(void)
 {
+    delete bulkLoaderPtr;
+
     if(db != NULL)
         delete db;
 
-    if(options.filter_policy != NULL)
-        delete options.filter_policy;
-
-    if(options.block_cache != NULL)
-        delete options.block_cache;
+    config.releaseOptions(options);
 }
 
 //-------------------------
 LevelDbPhraseTable::const_iterator LevelDbPhraseTable::begin(void)const
 {
-    leveldb::Iterator *local_iter = db->NewIterator(leveldb::ReadOptions());
+    // Full scans do not fill the block cache, so they do not evict
+    // the blocks used by the lookups
+    leveldb::ReadOptions scanOptions = readOptions;
+    scanOptions.fill_cache = false;
+    leveldb::Iterator *local_iter = db->NewIterator(scanOptions);
     local_iter->SeekToFirst();
 
     if(!local_iter->Valid()) {
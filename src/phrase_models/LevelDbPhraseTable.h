@@ -42,6 +42,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "leveldb/write_batch.h"
 
 #include "BasePhraseTable.h"
+#include "LevelDbBulkLoader.h"
+#include "LevelDbConfig.h"
+#include "LevelDbValueCache.h"
 #include "ErrorDefs.h"
 
 
@@ -63,7 +66,11 @@ class LevelDbPhraseTable: public BasePhraseTable
 {
     leveldb::DB* db;
     leveldb::Options options;
+    leveldb::ReadOptions readOptions;
+    LevelDbConfig config;
+    mutable LevelDbValueCache<int> valueCache;
     std::string dbName;
+    LevelDbBulkLoader* bulkLoaderPtr;
 
         // Converters
     virtual std::string vectorToString(const std::vector<WordIndex>& vec)const;
@@ -98,6 +105,25 @@ class LevelDbPhraseTable: public BasePhraseTable
     virtual bool drop();
         // Wrapper for loading existing levelDB
     virtual bool load(std::string levelDbPath);
+
+        // Bulk load functions. Between both calls, the stored counts
+        // are buffered, sorted by key and written in large batches
+        // when endBulkLoad() is called. Counts stored more than once
+        // for the same key are added up, so incrCountsOfEntry() does
+        // not need to read the previous counts. Counts already present
+        // in the database are added to the buffered ones when they are
+        // written, so bulk loading into a non-empty table increments
+        // its counts as incrCountsOfEntry() does outside bulk mode
+    virtual bool startBulkLoad(std::string tmpDir);
+    virtual bool endBulkLoad(void);
+
+        // Functions to tune database access. The new configuration
+        // reopens the database if it was already loaded. It cannot
+        // be changed during a bulk load
+    bool setConfig(const LevelDbConfig& _config);
+    const LevelDbConfig& getConfig(void)const;
+    void printCacheStats(std::ostream& outS)const;
+
         // Abstract function definitions
     virtual void addTableEntry(const std::vector<WordIndex>& s,
                                const std::vector<WordIndex>& t,
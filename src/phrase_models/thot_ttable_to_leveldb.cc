@@ -30,6 +30,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include <LevelDbPhraseTable.h>
 #include "PhraseDefs.h"
+#include <stdlib.h>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -55,6 +56,8 @@ int process_ttable(void);
 //--------------- Global variables -----------------------------------
 
 std::string outputFile;
+std::string tmpDir;
+bool bulkLoad;
 
 //--------------- Function Definitions -------------------------------
 
@@ -125,6 +128,14 @@ int process_ttable(void)
       std::cerr << "Cannot create or recreate database (LevelDB)" << std::endl;
       return THOT_ERROR;
     }
+
+        // Counts are sorted and added up before being written in bulk
+        // load mode
+    if(bulkLoad && levelDbPt.startBulkLoad(tmpDir) == THOT_ERROR)
+    {
+      std::cerr << "Cannot start bulk load of database (LevelDB)" << std::endl;
+      return THOT_ERROR;
+    }
     
         // Process translation table
     int i = 0;
@@ -147,6 +158,12 @@ int process_ttable(void)
         std::cerr << "Processed " << i << " lines" << std::endl;
     }
 
+    if(bulkLoad && levelDbPt.endBulkLoad() == THOT_ERROR)
+    {
+      std::cerr << "Error while writing database (LevelDB) in bulk load mode" << std::endl;
+      return THOT_ERROR;
+    }
+
     std::cerr << "levelDB size: " << levelDbPt.size() << std::endl;
     
     return THOT_OK;
@@ -174,14 +191,28 @@ int TakeParameters(int argc,char *argv[])
     return THOT_ERROR;
   }
 
+      /* Takes the directory for temporary files */
+  if(readSTLstring(argc, argv, "-T", &tmpDir) == -1)
+  {
+    const char* envTmpDir = getenv("TMPDIR");
+    tmpDir = (envTmpDir != NULL) ? envTmpDir : "/tmp";
+  }
+
+      /* Verify -nb option */
+  bulkLoad = (readOption(argc, argv, "-nb") == -1);
+
   return THOT_OK;  
 }
 
 //---------------
 void printUsage(void)
 {
-  printf("Usage: thot_ttable_to_leveldb -o <string> [--help]\n\n");
+  printf("Usage: thot_ttable_to_leveldb -o <string> [-T <string>] [-nb] [--help]\n\n");
   printf("-o <string>                   Name of output file.\n\n");
+  printf("-T <string>                   Directory for temporary files used in bulk\n");
+  printf("                              load mode ($TMPDIR or /tmp by default).\n\n");
+  printf("-nb                           Disable bulk load mode, entries are written\n");
+  printf("                              one at a time.\n\n");
   printf("--help                        Display this help and exit.\n\n");
 }
 
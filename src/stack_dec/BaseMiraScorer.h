@@ -67,6 +67,16 @@ class BaseMiraScorer: public BaseScorer
                          const std::string& reference,
                          double& score)=0;
 
+    // Additive statistics for sentence, the statistics of a corpus
+    // are the sum of the statistics of its sentences
+  virtual void sentStats(const std::string& candidate,
+                         const std::string& reference,
+                         std::vector<double>& stats)=0;
+
+    // Score for corpus given the sum of its sentence statistics
+  virtual void corpusScoreFromStats(const std::vector<double>& stats,
+                                    double& score)=0;
+
     // Destructor
   virtual ~BaseMiraScorer(){};
 };
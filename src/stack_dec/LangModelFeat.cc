@@ -38,7 +38,8 @@ LangModelFeat<PhrScoreInfo>::nullHypScore(const HypScoreInfo& predHypScrInf,
 
       // Obtain language model state for null hypothesis
   HypScoreInfo hypScrInf=predHypScrInf;
-  lModelPtr->getStateForBeginOfSentence(hypScrInf.lmHist);
+  if(ownsLmHist)
+    lModelPtr->getStateForBeginOfSentence(hypScrInf.lmHist);
   
   return hypScrInf;
 }
@@ -57,14 +58,21 @@ LangModelFeat<PhrScoreInfo>::extensionScore(const std::vector<std::string>& srcS
   HypScoreInfo hypScrInf=predHypScrInf;
   unweightedScore=0;
 
-      // Obtain current partial translation
-  std::vector<std::string> currPartialTrans;
-  obtainCurrPartialTrans(predHypDataStr,currPartialTrans);
-
       // Initialize state
   LM_State state;
-  lModelPtr->getStateForBeginOfSentence(state);
-  addWordSeqToStateStr(currPartialTrans,state);
+  if(ownsLmHist)
+  {
+        // Continue from the state of the predecessor hypothesis
+    state=predHypScrInf.lmHist;
+  }
+  else
+  {
+        // Obtain state from current partial translation
+    std::vector<std::string> currPartialTrans;
+    obtainCurrPartialTrans(predHypDataStr,currPartialTrans);
+    lModelPtr->getStateForBeginOfSentence(state);
+    addWordSeqToStateStr(currPartialTrans,state);
+  }
   
   for(unsigned int i=predHypDataStr.sourceSegmentation.size();i<newHypDataStr.sourceSegmentation.size();++i)
   {
@@ -92,13 +100,11 @@ LangModelFeat<PhrScoreInfo>::extensionScore(const std::vector<std::string>& srcS
     Score scrCompl=getEosScoreGivenState(state);
     unweightedScore+= scrCompl;
     hypScrInf.score+= weight*scrCompl;
-
-        // Add end of sentence to current translation
-    currPartialTrans.push_back(EOS_STR);
   }
 
       // Set language model history for hypothesis
-  hypScrInf.lmHist=state;
+  if(ownsLmHist)
+    hypScrInf.lmHist=state;
   
   return hypScrInf;
 }
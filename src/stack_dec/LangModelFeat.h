@@ -38,7 +38,11 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "BaseNgramLM.h"
 #include "WordPredictor.h"
 #include "PhrScoreInfo.h"
+#include <float.h>
 #include "BasePbTransModelFeature.h"
+#include "LmScoreCache.h"
+#include <pthread.h>
+#include <set>
 
 //--------------- Constants ------------------------------------------
 
@@ -93,15 +97,57 @@ class LangModelFeat: public BasePbTransModelFeature<SCORE_INFO>
   void link_lm(BaseNgramLM<LM_State>* _lModelPtr);
   BaseNgramLM<LM_State>* get_lmptr(void);
   void link_wp(WordPredictor* _wordPredPtr);
+
+      // Functions to manage the language model state stored in the
+      // hypotheses
+  void setLmHistOwnership(bool _ownsLmHist);
+      // When the feature owns the language model history of the
+      // hypotheses, extension scores are obtained starting from the
+      // state of the predecessor hypothesis instead of rescoring the
+      // whole partial translation. Only one language model feature
+      // can own the history, since it is shared by all features
+  bool getLmHistOwnership(void)const;
+
+      // Functions to manage the cache of language model scores
+  void setScoreCacheMaxEntries(size_t maxEntries);
+      // Sets the maximum number of entries of the cache, zero
+      // disables it
+  size_t getScoreCacheMaxEntries(void)const;
+  void clearScoreCache(void);
+      // Clears the cache of the calling thread, it should be invoked
+      // before translating a new sentence
+
+      // Destructor
+  ~LangModelFeat();
   
  protected:
 
+  struct ThreadScoreCache
+  {
+    LangModelFeat* featPtr;
+    LmScoreCache lmScoreCache;
+  };
+
   BaseNgramLM<LM_State>* lModelPtr;
   WordPredictor* wordPredPtr;
+  bool ownsLmHist;
+
+      // Each thread scores its own hypotheses, so it keeps a private
+      // cache of language model scores
+  size_t scoreCacheMaxEntries;
+  pthread_key_t scoreCacheKey;
+  std::set<ThreadScoreCache*> threadScoreCacheSet;
+  pthread_mutex_t scoreCacheMut;
+
+  LmScoreCache* getScoreCache(void);
+  Score getCachedScoreGivenStateId(LmScoreCache* lmScoreCachePtr,
+                                   WordIndex w,
+                                   unsigned int& stateId);
+  static void deleteThreadScoreCache(void* threadScoreCachePtr);
   
       // Functions to access language model parameters
   Score getEosScoreGivenState(LM_State& lmHist);
-  Score getNgramScoreGivenState(std::vector<std::string> trgphrase,
+  Score getNgramScoreGivenState(const std::vector<std::string>& trgphrase,
                                 LM_State& lmHist);
   void addWordSeqToStateStr(const std::vector<std::string>& trgPhrase,
                             LM_State& state);
@@ -112,6 +158,12 @@ class LangModelFeat: public BasePbTransModelFeature<SCORE_INFO>
   void obtainCurrPartialTrans(const PhrHypDataStr& predHypDataStr,
                               std::vector<std::string>& currPartialTrans);
   WordIndex stringToWordIndex(std::string str);
+
+ private:
+
+      // Features own thread-specific data, so they cannot be copied
+  LangModelFeat(const LangModelFeat&);
+  LangModelFeat& operator=(const LangModelFeat&);
 };
 
 //--------------- WordPenaltyFeat class functions
@@ -122,6 +174,10 @@ LangModelFeat<SCORE_INFO>::LangModelFeat()
 {
   lModelPtr=NULL;
   wordPredPtr=NULL;
+  ownsLmHist=true;
+  scoreCacheMaxEntries=LMSC_DEFAULT_MAX_ENTRIES;
+  pthread_key_create(&scoreCacheKey,deleteThreadScoreCache);
+  pthread_mutex_init(&scoreCacheMut,NULL);
 }
 
 //---------------------------------
@@ -198,14 +254,14 @@ std::pair<Count,std::string>
 LangModelFeat<SCORE_INFO>::getBestSuffixGivenHist(std::vector<std::string> hist,
                                                   std::string input)
 {
-  WordPredictor::SuffixList suffixList;
-  WordPredictor::SuffixList::iterator suffixListIter;
+  WordPredictor::NbestSuffixList suffixList;
+  WordPredictor::NbestSuffixList::iterator suffixListIter;
   LgProb lp;
   LgProb maxlp=-FLT_MAX;
   std::pair<Count,std::string> bestCountSuffix;
 
-      // Get suffix list for input
-  wordPredPtr->getSuffixList(input,suffixList);
+      // Get list of best suffixes for input
+  wordPredPtr->getNbestSuffixList(input,suffixList);
   if(suffixList.size()==0)
   {
         // There are not any suffix
@@ -249,6 +305,13 @@ template<class SCORE_INFO>
 void LangModelFeat<SCORE_INFO>::link_lm(BaseNgramLM<LM_State>* _lModelPtr)
 {
   lModelPtr=_lModelPtr;
+
+      // Scores cached for the previous model are no longer valid
+  pthread_mutex_lock(&scoreCacheMut);
+  typename std::set<ThreadScoreCache*>::iterator setIter;
+  for(setIter=threadScoreCacheSet.begin();setIter!=threadScoreCacheSet.end();++setIter)
+    (*setIter)->lmScoreCache.clear();
+  pthread_mutex_unlock(&scoreCacheMut);
 }
 
 //---------------------------------
@@ -265,6 +328,103 @@ void LangModelFeat<SCORE_INFO>::link_wp(WordPredictor* _wordPredPtr)
   wordPredPtr=_wordPredPtr;
 }
 
+//---------------------------------
+template<class SCORE_INFO>
+void LangModelFeat<SCORE_INFO>::setLmHistOwnership(bool _ownsLmHist)
+{
+  ownsLmHist=_ownsLmHist;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+bool LangModelFeat<SCORE_INFO>::getLmHistOwnership(void)const
+{
+  return ownsLmHist;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+void LangModelFeat<SCORE_INFO>::setScoreCacheMaxEntries(size_t maxEntries)
+{
+  scoreCacheMaxEntries=maxEntries;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+size_t LangModelFeat<SCORE_INFO>::getScoreCacheMaxEntries(void)const
+{
+  return scoreCacheMaxEntries;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+void LangModelFeat<SCORE_INFO>::clearScoreCache(void)
+{
+  ThreadScoreCache* threadScoreCachePtr=(ThreadScoreCache*)pthread_getspecific(scoreCacheKey);
+  if(threadScoreCachePtr!=NULL)
+  {
+    threadScoreCachePtr->lmScoreCache.clear();
+    threadScoreCachePtr->lmScoreCache.setMaxEntries(scoreCacheMaxEntries);
+  }
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+LmScoreCache* LangModelFeat<SCORE_INFO>::getScoreCache(void)
+{
+  if(scoreCacheMaxEntries==0)
+    return NULL;
+
+  ThreadScoreCache* threadScoreCachePtr=(ThreadScoreCache*)pthread_getspecific(scoreCacheKey);
+  if(threadScoreCachePtr==NULL)
+  {
+        // Create cache for the calling thread
+    threadScoreCachePtr=new ThreadScoreCache;
+    threadScoreCachePtr->featPtr=this;
+    threadScoreCachePtr->lmScoreCache.setMaxEntries(scoreCacheMaxEntries);
+    pthread_mutex_lock(&scoreCacheMut);
+    threadScoreCacheSet.insert(threadScoreCachePtr);
+    pthread_mutex_unlock(&scoreCacheMut);
+    pthread_setspecific(scoreCacheKey,threadScoreCachePtr);
+  }
+  return &threadScoreCachePtr->lmScoreCache;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+void LangModelFeat<SCORE_INFO>::deleteThreadScoreCache(void* threadScoreCachePtr)
+{
+      // Invoked when a thread finishes
+  ThreadScoreCache* tscPtr=(ThreadScoreCache*)threadScoreCachePtr;
+  LangModelFeat* featPtr=tscPtr->featPtr;
+  pthread_mutex_lock(&featPtr->scoreCacheMut);
+  featPtr->threadScoreCacheSet.erase(tscPtr);
+  pthread_mutex_unlock(&featPtr->scoreCacheMut);
+  delete tscPtr;
+}
+
+//---------------------------------
+template<class SCORE_INFO>
+Score LangModelFeat<SCORE_INFO>::getCachedScoreGivenStateId(LmScoreCache* lmScoreCachePtr,
+                                                            WordIndex w,
+                                                            unsigned int& stateId)
+{
+  Score scr;
+  unsigned int nextStateId;
+  if(!lmScoreCachePtr->lookup(stateId,w,scr,nextStateId))
+  {
+    LM_State state=lmScoreCachePtr->getState(stateId);
+    if(w==LMSC_EOS_WORD)
+      scr=this->lModelPtr->getLgProbEndGivenState(state);
+    else
+      scr=this->lModelPtr->getNgramLgProbGivenState(w,state);
+    nextStateId=lmScoreCachePtr->getStateId(state);
+    lmScoreCachePtr->insert(stateId,w,scr,nextStateId);
+  }
+  stateId=nextStateId;
+  return scr;
+}
+
 //---------------------------------
 template<class SCORE_INFO>
 Score LangModelFeat<SCORE_INFO>::getEosScoreGivenState(LM_State& lmHist)
@@ -272,13 +432,23 @@ Score LangModelFeat<SCORE_INFO>::getEosScoreGivenState(LM_State& lmHist)
 #ifdef WORK_WITH_ZERO_GRAM_PROB
   return this->lModelPtr->getZeroGramProb());
 #else
-  return this->lModelPtr->getLgProbEndGivenState(lmHist);
+  LmScoreCache* lmScoreCachePtr=getScoreCache();
+  if(lmScoreCachePtr==NULL)
+    return this->lModelPtr->getLgProbEndGivenState(lmHist);
+
+      // State ids remain valid until the cache is cleared
+  if(lmScoreCachePtr->full())
+    lmScoreCachePtr->clear();
+  unsigned int stateId=lmScoreCachePtr->getStateId(lmHist);
+  Score scr=getCachedScoreGivenStateId(lmScoreCachePtr,LMSC_EOS_WORD,stateId);
+  lmHist=lmScoreCachePtr->getState(stateId);
+  return scr;
 #endif
 }
 
 //---------------------------------
 template<class SCORE_INFO>
-Score LangModelFeat<SCORE_INFO>::getNgramScoreGivenState(std::vector<std::string> trgphrase,
+Score LangModelFeat<SCORE_INFO>::getNgramScoreGivenState(const std::vector<std::string>& trgphrase,
                                                          LM_State& lmHist)
 {
         // Score not present in cache table
@@ -290,6 +460,22 @@ Score LangModelFeat<SCORE_INFO>::getNgramScoreGivenState(std::vector<std::string
   {
     trgPhraseIdx.push_back(this->stringToWordIndex(trgphrase[i]));
   }
+
+#ifndef WORK_WITH_ZERO_GRAM_PROB
+  LmScoreCache* lmScoreCachePtr=getScoreCache();
+  if(lmScoreCachePtr!=NULL)
+  {
+        // Follow the state ids stored in the cache, querying the
+        // language model only for the unseen (state,word) pairs
+    if(lmScoreCachePtr->full())
+      lmScoreCachePtr->clear();
+    unsigned int stateId=lmScoreCachePtr->getStateId(lmHist);
+    for(unsigned int i=0;i<trgPhraseIdx.size();++i)
+      result+=getCachedScoreGivenStateId(lmScoreCachePtr,trgPhraseIdx[i],stateId);
+    lmHist=lmScoreCachePtr->getState(stateId);
+    return result;
+  }
+#endif
       
   for(unsigned int i=0;i<trgPhraseIdx.size();++i)
   {
@@ -344,4 +530,15 @@ WordIndex LangModelFeat<SCORE_INFO>::stringToWordIndex(std::string str)
     return UNK_SYMBOL;
 }
 
+//---------------------------------
+template<class SCORE_INFO>
+LangModelFeat<SCORE_INFO>::~LangModelFeat()
+{
+  pthread_key_delete(scoreCacheKey);
+  typename std::set<ThreadScoreCache*>::iterator setIter;
+  for(setIter=threadScoreCacheSet.begin();setIter!=threadScoreCacheSet.end();++setIter)
+    delete *setIter;
+  pthread_mutex_destroy(&scoreCacheMut);
+}
+
 #endif
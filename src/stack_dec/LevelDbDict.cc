@@ -30,10 +30,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //-------------------------
 LevelDbDict::LevelDbDict(void)
 {
-    options.create_if_missing = true;
-    options.max_open_files = 4000;
-    options.filter_policy = leveldb::NewBloomFilterPolicy(48);
-    options.block_cache = leveldb::NewLRUCache(100 * 1048576);  // 100 MB for cache
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
     db = NULL;
     dbName = "";
 }
@@ -44,16 +43,23 @@ bool LevelDbDict::retrieveData(const std::vector<std::string>& phrase, Score &sc
     std::string value_str;
     score = 0;
     std::string key = StrProcUtils::stringVectorToString(phrase);
-    
-    leveldb::Status result = db->Get(leveldb::ReadOptions(), key, &value_str);  // Read stored src value
+
+    bool found;
+    if(valueCache.lookup(key, score, found))
+        return found;
+
+    leveldb::Status result = db->Get(readOptions, key, &value_str);  // Read stored src value
 
     if (result.ok())
     {
         score = atof(value_str.c_str());
+        valueCache.insert(key, score, true);
         return true;
     }
     else
     {
+        if(result.IsNotFound())
+            valueCache.insert(key, score, false);
         return false;
     }
 }
@@ -64,17 +70,63 @@ bool LevelDbDict::storeData(const std::vector<std::string>& phrase, Score score)
     std::stringstream ss;
     ss << score;
     std::string score_str = ss.str();
+    std::string key = StrProcUtils::stringVectorToString(phrase);
 
     leveldb::WriteBatch batch;
-    batch.Put(StrProcUtils::stringVectorToString(phrase), score_str);
+    batch.Put(key, score_str);
     leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
 
-    if(!s.ok())
+    if(s.ok())
+    {
+        // Cache the score as it is read from its text representation
+        valueCache.insert(key, atof(score_str.c_str()), true);
+    }
+    else
+    {
+        valueCache.erase(key);
         std::cerr << "Storing data status: " << s.ToString() << std::endl;
+    }
 
     return s.ok();
 }
 
+//-------------------------
+bool LevelDbDict::setConfig(const LevelDbConfig& _config)
+{
+    // The database uses the filter policy and the block cache of the
+    // current options, so it is closed before they are released
+    bool dbWasOpen = (db != NULL);
+    if(db != NULL)
+    {
+        delete db;
+        db = NULL;
+    }
+
+    config.releaseOptions(options);
+    config = _config;
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
+    valueCache.clear();
+
+    if(dbWasOpen)
+        return load(dbName);
+    else
+        return THOT_OK;
+}
+
+//-------------------------
+const LevelDbConfig& LevelDbDict::getConfig(void)const
+{
+    return config;
+}
+
+//-------------------------
+void LevelDbDict::printCacheStats(std::ostream& outS)const
+{
+    valueCache.printStats("LevelDB dictionary", outS);
+}
+
 //-------------------------
 bool LevelDbDict::init(std::string levelDbPath)
 {
@@ -102,6 +154,7 @@ bool LevelDbDict::drop()
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     leveldb::Status status = leveldb::DestroyDB(dbName, options);
 
@@ -125,6 +178,7 @@ bool LevelDbDict::load(std::string levelDbPath)
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     dbName = levelDbPath;
     leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
@@ -239,7 +293,7 @@ bool LevelDbDict::getTransOptsForSource(const std::vector<std::string>& s,
   leveldb::Slice start = start_str;
   leveldb::Slice end = end_str;
 
-  leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+  leveldb::Iterator* it = db->NewIterator(readOptions);
     
   transOptVec.clear();  // Make sure that structure does not keep old values
   
@@ -264,17 +318,17 @@ LevelDbDict::~LevelDbDict(void)
     if(db != NULL)
         delete db;
 
-    if(options.filter_policy != NULL)
-        delete options.filter_policy;
-
-    if(options.block_cache != NULL)
-        delete options.block_cache;
+    config.releaseOptions(options);
 }
 
 //-------------------------
 LevelDbDict::const_iterator LevelDbDict::begin(void)const
 {
-    leveldb::Iterator *local_iter = db->NewIterator(leveldb::ReadOptions());
+    // Full scans do not fill the block cache, so they do not evict
+    // the blocks used by the lookups
+    leveldb::ReadOptions scanOptions = readOptions;
+    scanOptions.fill_cache = false;
+    leveldb::Iterator *local_iter = db->NewIterator(scanOptions);
     local_iter->SeekToFirst();
 
     if(!local_iter->Valid()) {
@@ -41,6 +41,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "StatModelDefs.h"
 #include "StrProcUtils.h"
 #include "ErrorDefs.h"
+#include "LevelDbConfig.h"
+#include "LevelDbValueCache.h"
 #include <iostream>
 #include <map>
 #include <vector>
@@ -66,6 +68,9 @@ class LevelDbDict
 {
     leveldb::DB* db;
     leveldb::Options options;
+    leveldb::ReadOptions readOptions;
+    LevelDbConfig config;
+    mutable LevelDbValueCache<Score> valueCache;
     std::string dbName;
 
         // Read and write data
@@ -89,6 +94,12 @@ class LevelDbDict
     virtual bool drop();
         // Wrapper for loading existing levelDB
     virtual bool load(std::string levelDbPath);
+
+        // Functions to tune database access. The new configuration
+        // reopens the database if it was already loaded
+    bool setConfig(const LevelDbConfig& _config);
+    const LevelDbConfig& getConfig(void)const;
+    void printCacheStats(std::ostream& outS)const;
     
         // Abstract function definitions
     virtual void addDictEntry(const std::vector<std::string>& s,
@@ -0,0 +1,146 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LmScoreCache.cc
+ *
+ * @brief Definitions file for LmScoreCache.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "LmScoreCache.h"
+
+//--------------- LmScoreCache class function definitions
+
+//-------------------------
+LmScoreCache::LmScoreCache(size_t _maxEntries)
+{
+  maxEntries=_maxEntries;
+  numHits=0;
+  numMisses=0;
+}
+
+//-------------------------
+unsigned int LmScoreCache::getStateId(const LM_State& state)
+{
+  std::map<LM_State,unsigned int>::iterator mapIter=stateToIdMap.find(state);
+  if(mapIter!=stateToIdMap.end())
+    return mapIter->second;
+
+  unsigned int stateId=idToStateVec.size();
+  idToStateVec.push_back(state);
+  stateToIdMap.insert(std::make_pair(state,stateId));
+  return stateId;
+}
+
+//-------------------------
+const LM_State& LmScoreCache::getState(unsigned int stateId)const
+{
+  return idToStateVec[stateId];
+}
+
+//-------------------------
+bool LmScoreCache::lookup(unsigned int stateId,
+                          WordIndex w,
+                          Score& score,
+                          unsigned int& nextStateId)
+{
+  std::unordered_map<unsigned long long,CacheEntry>::const_iterator entryIter=entryMap.find(getKey(stateId,w));
+  if(entryIter==entryMap.end())
+  {
+    ++numMisses;
+    return false;
+  }
+  else
+  {
+    ++numHits;
+    score=entryIter->second.score;
+    nextStateId=entryIter->second.nextStateId;
+    return true;
+  }
+}
+
+//-------------------------
+bool LmScoreCache::insert(unsigned int stateId,
+                          WordIndex w,
+                          Score score,
+                          unsigned int nextStateId)
+{
+  if(full())
+    return false;
+
+  CacheEntry cacheEntry;
+  cacheEntry.score=score;
+  cacheEntry.nextStateId=nextStateId;
+  entryMap[getKey(stateId,w)]=cacheEntry;
+  return true;
+}
+
+//-------------------------
+bool LmScoreCache::full(void)const
+{
+  return entryMap.size()>=maxEntries || idToStateVec.size()>=maxEntries;
+}
+
+//-------------------------
+void LmScoreCache::setMaxEntries(size_t _maxEntries)
+{
+  maxEntries=_maxEntries;
+  if(full())
+    clear();
+}
+
+//-------------------------
+size_t LmScoreCache::getMaxEntries(void)const
+{
+  return maxEntries;
+}
+
+//-------------------------
+size_t LmScoreCache::size(void)const
+{
+  return entryMap.size();
+}
+
+//-------------------------
+unsigned long long LmScoreCache::getNumHits(void)const
+{
+  return numHits;
+}
+
+//-------------------------
+unsigned long long LmScoreCache::getNumMisses(void)const
+{
+  return numMisses;
+}
+
+//-------------------------
+void LmScoreCache::clear(void)
+{
+  stateToIdMap.clear();
+  idToStateVec.clear();
+  entryMap.clear();
+}
+
+//-------------------------
+unsigned long long LmScoreCache::getKey(unsigned int stateId,
+                                        WordIndex w)const
+{
+  return (((unsigned long long)stateId)<<32) | (unsigned long long)w;
+}
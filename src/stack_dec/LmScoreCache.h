@@ -0,0 +1,114 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file LmScoreCache.h
+ *
+ * @brief Defines the LmScoreCache class, which memoizes the n-gram
+ * language model scores obtained while translating a sentence.
+ */
+
+#ifndef _LmScoreCache_h
+#define _LmScoreCache_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include THOT_LM_STATE_H // Define LM_State type. It is set in
+                         // configure by checking LM_STATE_H
+                         // variable (default value: LM_State.h)
+#include "Score.h"
+#include <map>
+#include <vector>
+#include <unordered_map>
+
+//--------------- Constants ------------------------------------------
+
+#define LMSC_DEFAULT_MAX_ENTRIES 1000000
+#define LMSC_EOS_WORD            ((WordIndex)-1)
+    // Pseudo-word used to cache end of sentence scores
+
+//--------------- Classes --------------------------------------------
+
+//--------------- LmScoreCache class
+
+/**
+ * @brief Cache of language model scores keyed by (state id, word
+ * id). Language model states are interned to dense integer ids, and
+ * each entry stores the score of the word and the id of the state
+ * reached after it, so a target phrase is scored by following state
+ * ids without building intermediate states. The cache is intended to
+ * be cleared before translating each sentence, its size is bounded by
+ * a maximum number of entries.
+ */
+
+class LmScoreCache
+{
+ public:
+
+      // Constructor
+  LmScoreCache(size_t _maxEntries=LMSC_DEFAULT_MAX_ENTRIES);
+
+  unsigned int getStateId(const LM_State& state);
+      // Returns the id of state, assigning a new one if required
+  const LM_State& getState(unsigned int stateId)const;
+
+  bool lookup(unsigned int stateId,
+              WordIndex w,
+              Score& score,
+              unsigned int& nextStateId);
+      // Returns true if the score of w given the state was cached
+  bool insert(unsigned int stateId,
+              WordIndex w,
+              Score score,
+              unsigned int nextStateId);
+      // Returns false if the entry was not inserted because the cache
+      // is full. In such case, the cache should be cleared before
+      // interning new states
+
+  bool full(void)const;
+  void setMaxEntries(size_t _maxEntries);
+  size_t getMaxEntries(void)const;
+  size_t size(void)const;
+  unsigned long long getNumHits(void)const;
+  unsigned long long getNumMisses(void)const;
+  void clear(void);
+
+ private:
+
+  struct CacheEntry
+  {
+    Score score;
+    unsigned int nextStateId;
+  };
+
+  std::map<LM_State,unsigned int> stateToIdMap;
+  std::vector<LM_State> idToStateVec;
+  std::unordered_map<unsigned long long,CacheEntry> entryMap;
+  size_t maxEntries;
+  unsigned long long numHits;
+  unsigned long long numMisses;
+
+  unsigned long long getKey(unsigned int stateId,
+                            WordIndex w)const;
+};
+
+#endif
@@ -132,3 +132,27 @@ void MiraBleu::corpusScore(const std::vector<std::string>& candidates,
   bleu = scoreFromStats(corpusStats);
 }
 
+//---------------------------------------
+void MiraBleu::sentStats(const std::string& candidate,
+                         const std::string& reference,
+                         std::vector<double>& stats)
+{
+  std::vector<std::string> candidate_tokens, reference_tokens;
+  candidate_tokens = StrProcUtils::stringToStringVector(candidate);
+  reference_tokens = StrProcUtils::stringToStringVector(reference);
+
+  std::vector<unsigned int> sentStats;
+  statsForSentence(candidate_tokens, reference_tokens, sentStats);
+  stats.assign(sentStats.begin(), sentStats.end());
+}
+
+//---------------------------------------
+void MiraBleu::corpusScoreFromStats(const std::vector<double>& stats,
+                                    double& bleu)
+{
+  std::vector<unsigned int> corpusStats(N_STATS, 0);
+  for (unsigned int i=0; i<N_STATS && i<stats.size(); i++)
+    corpusStats[i] = (unsigned int)(stats[i] + 0.5);
+  bleu = scoreFromStats(corpusStats);
+}
+
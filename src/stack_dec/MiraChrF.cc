@@ -59,3 +59,24 @@ void MiraChrF::corpusScore(const std::vector<std::string>& candidates,
 
     score /= candidates.size();
 }
+
+void MiraChrF::sentStats(const std::string& candidate,
+                         const std::string& reference,
+                         std::vector<double>& stats)
+{
+    // stats = [chrf, number of sentences]
+    double sentenceScore;
+    sentScore(candidate, reference, sentenceScore);
+    stats.clear();
+    stats.push_back(sentenceScore);
+    stats.push_back(1);
+}
+
+void MiraChrF::corpusScoreFromStats(const std::vector<double>& stats,
+                                    double& score)
+{
+    if (stats.size() < 2 || stats[1] == 0)
+        score = 0;
+    else
+        score = stats[0] / stats[1];
+}
@@ -64,6 +64,15 @@ public:
                      const std::vector<std::string>& references,
                      double& score);
 
+    // Additive statistics for sentence
+    void sentStats(const std::string& candidate,
+                   const std::string& reference,
+                   std::vector<double>& stats);
+
+    // Score for corpus given the sum of its sentence statistics
+    void corpusScoreFromStats(const std::vector<double>& stats,
+                              double& score);
+
 private:
     unsigned int N_STATS;
 };
@@ -222,3 +222,27 @@ void MiraGtm::corpusScore(const std::vector<std::string>& candidates,
   score = scoreFromStats(corpusStats);
 }
 
+//---------------------------------------
+void MiraGtm::sentStats(const std::string& candidate,
+                        const std::string& reference,
+                        std::vector<double>& stats)
+{
+  std::vector<std::string> candidate_tokens, reference_tokens;
+  candidate_tokens = StrProcUtils::stringToStringVector(candidate);
+  reference_tokens = StrProcUtils::stringToStringVector(reference);
+
+  std::vector<unsigned int> sentStats;
+  statsForSentence(candidate_tokens, reference_tokens, sentStats);
+  stats.assign(sentStats.begin(), sentStats.end());
+}
+
+//---------------------------------------
+void MiraGtm::corpusScoreFromStats(const std::vector<double>& stats,
+                                   double& score)
+{
+  std::vector<unsigned int> corpusStats(N_STATS, 0);
+  for (unsigned int j=0; j<N_STATS && j<stats.size(); j++)
+    corpusStats[j] = (unsigned int)(stats[j] + 0.5);
+  score = scoreFromStats(corpusStats);
+}
+
@@ -25,6 +25,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "MiraWer.h"
 #include "StrProcUtils.h"
+#include "BitParallelEditDist.h"
 
 //--------------- MiraWer class functions
 
@@ -87,22 +88,33 @@ void MiraWer::corpusScore(const std::vector<std::string>& candidates,
 }
 
 //---------------------------------------
-int MiraWer::ed(std::vector<std::string>& s1, std::vector<std::string>& s2) 
+void MiraWer::sentStats(const std::string& candidate,
+                        const std::string& reference,
+                        std::vector<double>& stats)
 {
-  const std::size_t len1 = s1.size(), len2 = s2.size();
-  std::vector<unsigned int> col(len2+1), prevCol(len2+1);
-  
-  for (unsigned int i = 0; i < prevCol.size(); i++)
-    prevCol[i] = i;
-  for (unsigned int i = 0; i < len1; i++) {
-    col[0] = i+1;
-    for (unsigned int j = 0; j < len2; j++)
-                        // note that std::min({arg1, arg2, arg3}) works only in C++11,
-                        // for C++98 use std::min(std::min(arg1, arg2), arg3)
-      //col[j+1] = std::min({ prevCol[1 + j] + 1, col[j] + 1, prevCol[j] + (s1[i]==s2[j] ? 0 : 1) });
-      col[j+1] = std::min(std::min(prevCol[1+j] + 1, col[j] + 1), prevCol[j]+( s1[i]==s2[j] ? 0 : 1) );
-    col.swap(prevCol);
-  }
-  return prevCol[len2];
+  // stats = [edits, reference_len]
+  std::vector<std::string> candidate_tokens, reference_tokens;
+  candidate_tokens = StrProcUtils::stringToStringVector(candidate);
+  reference_tokens = StrProcUtils::stringToStringVector(reference);
+
+  stats.clear();
+  stats.push_back(ed(candidate_tokens, reference_tokens));
+  stats.push_back(reference_tokens.size());
 }
 
+//---------------------------------------
+void MiraWer::corpusScoreFromStats(const std::vector<double>& stats,
+                                   double& score)
+{
+  if (stats.size() < 2 || stats[1] == 0)
+    score = 0.0;
+  else
+    score = 1.0 - stats[0]/stats[1];
+}
+
+//---------------------------------------
+int MiraWer::ed(std::vector<std::string>& s1, std::vector<std::string>& s2) 
+{
+  BitParallelEditDist bitParallelEditDist;
+  return bitParallelEditDist.calculateEditDist(s1,s2);
+}
@@ -39,6 +39,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define WER_BASED_LEARNING_RATE_POL    3
 #define DEFAULT_INTERLACED_TRAIN_E_PAR 1
 #define DEFAULT_INTERLACED_TRAIN_R_PAR 0
+#define DEFAULT_ASYNC_BATCH_SIZE       0
 
 //--------------- OnlineTrainingPars template class
 
@@ -52,6 +53,9 @@ class OnlineTrainingPars
   unsigned int emIters;
   unsigned int E_par;
   unsigned int R_par;
+  unsigned int asyncBatchSize; // Maximum size of the mini-batches
+                               // processed by the asynchronous
+                               // trainer (0 -> synchronous training)
   
   OnlineTrainingPars()
   {
@@ -66,6 +70,7 @@ class OnlineTrainingPars
     emIters=5;
     E_par=DEFAULT_INTERLACED_TRAIN_E_PAR;
     R_par=DEFAULT_INTERLACED_TRAIN_R_PAR;
+    asyncBatchSize=DEFAULT_ASYNC_BATCH_SIZE;
   }
 };
 
@@ -989,20 +989,15 @@ float PhrLocalSwLiTm::calculateNewLearningRate(int verbose/*=0*/)
 //---------------------------------
 float PhrLocalSwLiTm::werBasedLearningRate(int verbose/*=0*/)
 {
-  EditDistForVec<std::string> edDistVecStr;
-  unsigned int hCount,iCount,sCount,dCount;
+  BitParallelEditDist bitParallelEditDist;
   unsigned int totalOps=0;
   unsigned int totalTrgWords=0;
   float wer;
   float lr;
    
-      // Set error model
-  edDistVecStr.setErrorModel(0,1,1,1);
-
   for(unsigned int n=0;n<vecTrgSent.size();++n)
   {
-    double dist=edDistVecStr.calculateEditDistOps(vecTrgSent[n],vecSysSent[n],hCount,iCount,sCount,dCount,0);
-    unsigned int ops=(unsigned int) dist;
+    unsigned int ops=bitParallelEditDist.calculateEditDist(vecTrgSent[n],vecSysSent[n]);
     unsigned int trgWords=vecTrgSent[n].size();
     totalOps+=ops;
     totalTrgWords+=trgWords;
@@ -47,7 +47,7 @@ extern "C" {
 #include "BaseIncrPhraseModel.h"
 #include <PhrasePair.h>
 #include <PhraseExtractParameters.h>
-#include "EditDistForVec.h"
+#include "BitParallelEditDist.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -23,6 +23,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
  */
 
 #include "SmtModelUtils.h"
+#include "_incrSwAligModel.h"
 
 namespace SmtModelUtils
 {
@@ -113,6 +114,33 @@ namespace SmtModelUtils
     return THOT_OK;
   }
 
+  //--------------------------
+  void setDirectSwModelSrcVocabFilter(BaseSwAligModel<PpInfo>* baseSwAligModelPtr,
+                                      const std::set<std::string>& srcVocab)
+  {
+        // Only the lexical parameters of the words of srcVocab will be
+        // loaded (the source language of the decoder is the source
+        // language of the direct model)
+    _incrSwAligModel<PpInfo>* incrSwAligModelPtr=dynamic_cast<_incrSwAligModel<PpInfo>*>(baseSwAligModelPtr);
+    if(incrSwAligModelPtr)
+      incrSwAligModelPtr->setSrcLexLoadFilter(srcVocab);
+    else
+      std::cerr<<"Warning: vocabulary filter not supported by current single word model type"<<std::endl;
+  }
+
+  //--------------------------
+  void setInverseSwModelSrcVocabFilter(BaseSwAligModel<PpInfo>* baseSwAligModelPtr,
+                                       const std::set<std::string>& srcVocab)
+  {
+        // The source language of the decoder is the target language
+        // of the inverse model
+    _incrSwAligModel<PpInfo>* incrSwAligModelPtr=dynamic_cast<_incrSwAligModel<PpInfo>*>(baseSwAligModelPtr);
+    if(incrSwAligModelPtr)
+      incrSwAligModelPtr->setTrgLexLoadFilter(srcVocab);
+    else
+      std::cerr<<"Warning: vocabulary filter not supported by current single word model type"<<std::endl;
+  }
+
   //--------------------------
   int loadLangModel(BaseNgramLM<LM_State>* baseNgLmPtr,
                     std::string modelFileName)
@@ -40,6 +40,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <stdio.h>
 #include <string>
 #include <vector>
+#include <set>
 
 namespace SmtModelUtils
 {
@@ -55,6 +56,10 @@ namespace SmtModelUtils
                          std::string modelFileName);
   int printInverseSwModel(BaseSwAligModel<PpInfo>* baseSwAligModelPtr,
                           std::string modelFileName);
+  void setDirectSwModelSrcVocabFilter(BaseSwAligModel<PpInfo>* baseSwAligModelPtr,
+                                      const std::set<std::string>& srcVocab);
+  void setInverseSwModelSrcVocabFilter(BaseSwAligModel<PpInfo>* baseSwAligModelPtr,
+                                       const std::set<std::string>& srcVocab);
   int loadLangModel(BaseNgramLM<LM_State>* baseNgLmPtr,
                     std::string modelFileName);
   int printLangModel(BaseNgramLM<LM_State>* baseNgLmPtr,
@@ -30,6 +30,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 StdFeatureHandler::StdFeatureHandler()
 {  
+  swmSrcVocabFilterEnabled=false;
+  stepNum=0;
 }
 
 //---------------
@@ -53,6 +55,13 @@ int StdFeatureHandler::loadMonolingualFeats(std::string lmFileName,
   return THOT_OK;
 }
 
+//---------------
+void StdFeatureHandler::setSwmSrcVocabFilter(const std::set<std::string>& srcVocab)
+{
+  swmSrcVocabFilterEnabled=true;
+  swmSrcVocabFilter=srcVocab;
+}
+
 //---------------
 int StdFeatureHandler::loadBilingualFeats(std::string tmFilesPrefix,
                                           int verbose)
@@ -203,7 +212,7 @@ int StdFeatureHandler::updatePmLinInterpWeights(std::string srcCorpusFileName,
 int StdFeatureHandler::onlineTrainFeats(OnlineTrainingPars onlineTrainingPars,
                                         std::string srcSent,
                                         std::string refSent,
-                                        std::string /*sysSent*/,
+                                        std::string sysSent,
                                         int verbose/*=0*/)
 {
        // Check if input sentences are empty
@@ -219,9 +228,13 @@ int StdFeatureHandler::onlineTrainFeats(OnlineTrainingPars onlineTrainingPars,
     case BASIC_INCR_TRAINING:
       return incrTrainFeatsSentPair(onlineTrainingPars,srcSent,refSent,verbose);
       break;
-    // case MINIBATCH_TRAINING:
-    //   return minibatchTrainFeatsSentPair(srcSent,refSent,sysSent,verbose);
-    //   break;
+    case MINIBATCH_TRAINING:
+      return minibatchTrainFeats(onlineTrainingPars,
+                                 std::vector<std::string>(1,srcSent),
+                                 std::vector<std::string>(1,refSent),
+                                 std::vector<std::string>(1,sysSent),
+                                 verbose);
+      break;
     // case BATCH_RETRAINING:
     //   return batchRetrainFeatsSentPair(srcSent,refSent,verbose);
     //   break;
@@ -232,6 +245,231 @@ int StdFeatureHandler::onlineTrainFeats(OnlineTrainingPars onlineTrainingPars,
   } 
 }
 
+//---------------------------------
+int StdFeatureHandler::onlineTrainFeatsBatch(OnlineTrainingPars onlineTrainingPars,
+                                             const std::vector<std::string>& srcSentVec,
+                                             const std::vector<std::string>& refSentVec,
+                                             const std::vector<std::string>& sysSentVec,
+                                             int verbose/*=0*/)
+{
+      // Check if input sentences are empty
+  for(unsigned int n=0;n<srcSentVec.size();++n)
+  {
+    if(srcSentVec[n].size()==0 || refSentVec[n].size()==0)
+    {
+      std::cerr<<"Error: cannot process empty input sentences"<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  if(onlineTrainingPars.onlineLearningAlgorithm==MINIBATCH_TRAINING)
+  {
+    return minibatchTrainFeats(onlineTrainingPars,srcSentVec,refSentVec,sysSentVec,verbose);
+  }
+  else
+  {
+        // Train sentence pairs one at a time
+    int ret=THOT_OK;
+    for(unsigned int n=0;n<srcSentVec.size();++n)
+    {
+      if(onlineTrainFeats(onlineTrainingPars,srcSentVec[n],refSentVec[n],sysSentVec[n],verbose)==THOT_ERROR)
+        ret=THOT_ERROR;
+    }
+    return ret;
+  }
+}
+
+//---------------------------------
+int StdFeatureHandler::minibatchTrainFeats(OnlineTrainingPars onlineTrainingPars,
+                                           const std::vector<std::string>& srcSentVec,
+                                           const std::vector<std::string>& refSentVec,
+                                           const std::vector<std::string>& sysSentVec,
+                                           int verbose/*=0*/)
+{
+      // onlineTrainingPars.learnStepSize determines the size of the
+      // mini-batch
+  unsigned int minibatchSize=(unsigned int)onlineTrainingPars.learnStepSize;
+  if(minibatchSize==0)
+    minibatchSize=1;
+
+  int ret=THOT_OK;
+  for(unsigned int n=0;n<srcSentVec.size();++n)
+  {
+        // Store source, target and system sentences
+    vecSrcSent.push_back(StrProcUtils::stringToStringVector(srcSentVec[n]));
+    vecTrgSent.push_back(StrProcUtils::stringToStringVector(refSentVec[n]));
+    vecSysSent.push_back(StrProcUtils::stringToStringVector(sysSentVec[n]));
+
+        // Check if a mini-batch has to be processed
+    if((vecSrcSent.size()%minibatchSize)==0)
+    {
+      if(trainStoredMinibatch(onlineTrainingPars,verbose)==THOT_ERROR)
+        ret=THOT_ERROR;
+    }
+  }
+
+  return ret;
+}
+
+//---------------------------------
+int StdFeatureHandler::trainStoredMinibatch(OnlineTrainingPars onlineTrainingPars,
+                                            int verbose/*=0*/)
+{
+  DirectPhraseModelFeat<SmtModel::HypScoreInfo>* dirPmFeatPtr=getDirectPhraseModelFeatPtr(swModelsInfo.featNameVec[0]);
+  InversePhraseModelFeat<SmtModel::HypScoreInfo>* invPmFeatPtr=getInversePhraseModelFeatPtr(swModelsInfo.invFeatNameVec[0]);
+  BasePhraseModel* invPbModelPtr=dirPmFeatPtr->get_pmptr();
+  BaseSwAligModel<PpInfo>* swAligModelPtr=dirPmFeatPtr->get_swmptr();
+  BaseSwAligModel<PpInfo>* invSwAligModelPtr=invPmFeatPtr->get_swmptr();
+
+  float learningRate=calculateNewLearningRate(onlineTrainingPars,verbose);
+
+      // Add sentence pairs to the single word models
+  std::pair<unsigned int,unsigned int> sentRange;
+  for(unsigned int n=0;n<vecSrcSent.size();++n)
+  {
+        // Revise vocabularies of the alignment models
+    updateAligModelsSrcVoc(invPbModelPtr,swAligModelPtr,invSwAligModelPtr,vecSrcSent[n]);
+    updateAligModelsTrgVoc(invPbModelPtr,swAligModelPtr,invSwAligModelPtr,vecTrgSent[n]);
+
+    swAligModelPtr->addSentPair(vecSrcSent[n],vecTrgSent[n],1,sentRange);
+    invSwAligModelPtr->addSentPair(vecTrgSent[n],vecSrcSent[n],1,sentRange);
+  }
+
+      // Initialize minibatchSentRange variable
+  std::pair<unsigned int,unsigned int> minibatchSentRange;
+  minibatchSentRange.first=sentRange.second-vecSrcSent.size()+1;
+  minibatchSentRange.second=sentRange.second;
+
+  if(verbose)
+    std::cerr<<"Processing mini-batch of size "<<vecSrcSent.size()<<" , "<<minibatchSentRange.first<<" - "<<minibatchSentRange.second<<std::endl;
+
+      // Set learning rate for sw models if possible
+  BaseStepwiseAligModel* bswamPtr=dynamic_cast<BaseStepwiseAligModel*>(swAligModelPtr);
+  if(bswamPtr) bswamPtr->set_nu_val(learningRate);
+  BaseStepwiseAligModel* ibswamPtr=dynamic_cast<BaseStepwiseAligModel*>(invSwAligModelPtr);
+  if(ibswamPtr) ibswamPtr->set_nu_val(learningRate);
+
+      // Train sw models
+  for(unsigned int i=0;i<onlineTrainingPars.emIters;++i)
+  {
+    if(verbose) std::cerr<<"Training single-word models, iteration "<<i<<" ..."<<std::endl;
+    swAligModelPtr->trainSentPairRange(minibatchSentRange,verbose);
+    invSwAligModelPtr->trainSentPairRange(minibatchSentRange,verbose);
+  }
+
+      // Add new translation options (the extracted phrase pairs are
+      // kept in vecVecInvPhPair, so their counts can be subtracted if
+      // the sentence pairs are revisited)
+  int ret=THOT_OK;
+  if(verbose) std::cerr<<"Adding new translation options..."<<std::endl;
+  for(unsigned int n=minibatchSentRange.first;n<=minibatchSentRange.second;++n)
+  {
+    if(addNewTransOpts(invPbModelPtr,swAligModelPtr,invSwAligModelPtr,n,verbose)==THOT_ERROR)
+      ret=THOT_ERROR;
+  }
+
+      // Train language model (the learning rate is used as the count
+      // of the target sentences)
+  for(unsigned int n=0;n<vecTrgSent.size();++n)
+  {
+    if(trainLangModel(langModelsInfo.lModelPtrVec[0],learningRate,vecTrgSent[n],verbose)==THOT_ERROR)
+      ret=THOT_ERROR;
+  }
+
+      // Clear vectors with source and target sentences
+  vecSrcSent.clear();
+  vecTrgSent.clear();
+  vecSysSent.clear();
+
+      // Increase stepNum
+  ++stepNum;
+
+  return ret;
+}
+
+//---------------------------------
+float StdFeatureHandler::calculateNewLearningRate(OnlineTrainingPars onlineTrainingPars,
+                                                  int verbose/*=0*/)
+{
+  if(verbose) std::cerr<<"Calculating new learning rate..."<<std::endl;
+                
+  float lr;
+  
+  switch(onlineTrainingPars.learningRatePolicy)
+  {
+    float alpha;
+    float par1;
+    float par2;
+    case FIXED_LEARNING_RATE_POL:
+      if(verbose) std::cerr<<"Using fixed learning rate."<<std::endl;
+      lr=STDFEATHANDLER_DEFAULT_LR;
+      break;
+    case LIANG_LEARNING_RATE_POL:
+      if(verbose) std::cerr<<"Using Liang learning rate."<<std::endl;
+      alpha=STDFEATHANDLER_DEFAULT_LR_ALPHA_PAR;
+      lr=1.0/(float)pow((float)stepNum+2,(float)alpha);
+      break;
+    case OWN_LEARNING_RATE_POL:
+      if(verbose) std::cerr<<"Using own learning rate."<<std::endl;
+      par1=STDFEATHANDLER_DEFAULT_LR_PAR1;
+      par2=STDFEATHANDLER_DEFAULT_LR_PAR2;
+      lr=par1/(1.0+((float)stepNum/par2));
+      break;
+    case WER_BASED_LEARNING_RATE_POL:
+      if(verbose) std::cerr<<"Using WER-based learning rate."<<std::endl;
+      lr=werBasedLearningRate(verbose);
+      break;
+    default:
+      lr=STDFEATHANDLER_DEFAULT_LR;
+      break;
+  }
+
+  if(verbose)
+    std::cerr<<"New learning rate: "<<lr<<std::endl;
+
+  if(lr>=1) std::cerr<<"WARNING: learning rate greater or equal than 1.0!"<<std::endl;
+  
+  return lr;
+}
+
+//---------------------------------
+float StdFeatureHandler::werBasedLearningRate(int verbose/*=0*/)
+{
+  BitParallelEditDist bitParallelEditDist;
+  unsigned int totalOps=0;
+  unsigned int totalTrgWords=0;
+  float wer;
+  float lr;
+   
+  for(unsigned int n=0;n<vecTrgSent.size();++n)
+  {
+    unsigned int ops=bitParallelEditDist.calculateEditDist(vecTrgSent[n],vecSysSent[n]);
+    unsigned int trgWords=vecTrgSent[n].size();
+    totalOps+=ops;
+    totalTrgWords+=trgWords;
+    if(verbose)
+    {
+      std::cerr<<"Sentence pair "<<n;
+      std::cerr<<" ; PARTIAL WER= "<<(float)ops/trgWords<<" ( "<<ops<<" , "<<trgWords<<" )";
+      std::cerr<<" ; ACUM WER= "<<(float)totalOps/totalTrgWords<<" ( "<<totalOps<<" , "<<totalTrgWords<<" )"<<std::endl;
+    }
+  }
+
+      // Obtain WER for block of sentences
+  if(totalTrgWords>0) wer=(float)totalOps/totalTrgWords;
+  else wer=0;
+
+      // Obtain learning rate
+  lr=wer-STDFEATHANDLER_LR_RESID_WER;
+  if(lr>0.999) lr=0.999;
+  if(lr<0.001) lr=0.001;
+   
+  if(verbose)
+    std::cerr<<"WER of block: "<<wer<<std::endl;
+   
+  return lr;
+}
+
 //---------------------------------
 int StdFeatureHandler::incrTrainFeatsSentPair(OnlineTrainingPars onlineTrainingPars,
                                               std::string srcSent,
@@ -667,6 +905,8 @@ int StdFeatureHandler::createDirectPhrModelFeat(std::string featName,
 
       // Load direct single word model
   std::cerr<<"* Loading direct single word model..."<<std::endl;
+  if(swmSrcVocabFilterEnabled)
+    SmtModelUtils::setDirectSwModelSrcVocabFilter(baseSwAligModelPtr,swmSrcVocabFilter);
   ret=SmtModelUtils::loadDirectSwModel(baseSwAligModelPtr,modelDescEntry.absolutizedModelFileName);
   if(ret==THOT_ERROR)
     return THOT_ERROR;
@@ -728,6 +968,8 @@ int StdFeatureHandler::createInversePhrModelFeat(std::string featName,
 
       // Load inverse single word model
   std::cerr<<"* Loading inverse single word model..."<<std::endl;
+  if(swmSrcVocabFilterEnabled)
+    SmtModelUtils::setInverseSwModelSrcVocabFilter(baseSwAligModelPtr,swmSrcVocabFilter);
   int ret=SmtModelUtils::loadInverseSwModel(baseSwAligModelPtr,modelDescEntry.absolutizedModelFileName);
   if(ret==THOT_ERROR)
     return THOT_ERROR;
@@ -1007,6 +1249,10 @@ int StdFeatureHandler::createLangModelFeat(std::string featName,
       // Link pointer to feature
   langModelFeatPtr->link_lm(baseNgLmPtr);
 
+      // Only the first language model feature threads its state
+      // through the hypotheses
+  langModelFeatPtr->setLmHistOwnership(langModelsInfo.lModelPtrVec.size()==1);
+
       // Link word predictor to feature
   langModelFeatPtr->link_wp(wordPredPtr);
   
@@ -1256,7 +1502,11 @@ bool StdFeatureHandler::printLangModels(std::string lmFileName,
 void StdFeatureHandler::clear(void)
 {
       // Clear training related data
+  vecSrcSent.clear();
+  vecTrgSent.clear();
+  vecSysSent.clear();
   vecVecInvPhPair.clear();
+  stepNum=0;
   
       // Delete model pointers
   deleteWpModelPtr();
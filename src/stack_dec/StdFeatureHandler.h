@@ -53,6 +53,16 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "SimpleDynClassLoader.h"
 #include "ModelDescriptorUtils.h"
 #include "StrProcUtils.h"
+#include <BaseStepwiseAligModel.h>
+#include "BitParallelEditDist.h"
+
+//--------------- Constants ------------------------------------------
+
+#define STDFEATHANDLER_DEFAULT_LR            0.5
+#define STDFEATHANDLER_DEFAULT_LR_ALPHA_PAR  0.75
+#define STDFEATHANDLER_DEFAULT_LR_PAR1       0.99
+#define STDFEATHANDLER_DEFAULT_LR_PAR2       0.75
+#define STDFEATHANDLER_LR_RESID_WER          0.2
 
 //--------------- StdFeatureHandler class
 
@@ -86,6 +96,11 @@ class StdFeatureHandler
   int setDefaultTransSoFile(std::string soFileName);
   int setDefaultSingleWordSoFile(std::string soFileName);
 
+      // Function to restrict the single word model parameters loaded
+      // by loadBilingualFeats() to those required to translate
+      // sentences with the given source vocabulary
+  void setSwmSrcVocabFilter(const std::set<std::string>& srcVocab);
+
       // Function to get pointers to features
   FeaturesInfo<SmtModel::HypScoreInfo>* getFeatureInfoPtr(void);
   
@@ -102,6 +117,15 @@ class StdFeatureHandler
                        std::string refSent,
                        std::string sysSent,
                        int verbose=0);
+  int onlineTrainFeatsBatch(OnlineTrainingPars onlineTrainingPars,
+                            const std::vector<std::string>& srcSentVec,
+                            const std::vector<std::string>& refSentVec,
+                            const std::vector<std::string>& sysSentVec,
+                            int verbose=0);
+      // Trains a vector of sentence pairs. When mini-batch training is
+      // selected, the sentence pairs are stored until a mini-batch of
+      // onlineTrainingPars.learnStepSize pairs is completed, as it is
+      // done when they are given one at a time
 
       // Functions to train word predictor
   void trainWordPred(std::vector<std::string> strVec);
@@ -120,6 +144,10 @@ class StdFeatureHandler
   std::string defaultTransSoFile;
   std::string defaultSingleWordSoFile;
 
+      // Vocabulary filter for single word models
+  bool swmSrcVocabFilterEnabled;
+  std::set<std::string> swmSrcVocabFilter;
+
       // Model information
   SwModelsInfo swModelsInfo;
   PhraseModelsInfo phraseModelsInfo;
@@ -128,7 +156,11 @@ class StdFeatureHandler
   FeaturesInfo<SmtModel::HypScoreInfo> featuresInfo;
 
       // Training-related data members
+  std::vector<std::vector<std::string> > vecSrcSent;
+  std::vector<std::vector<std::string> > vecTrgSent;
+  std::vector<std::vector<std::string> > vecSysSent;
   std::vector<std::vector<PhrasePair> > vecVecInvPhPair;
+  unsigned int stepNum;
 
       // Auxiliary functions
 
@@ -187,6 +219,16 @@ class StdFeatureHandler
                              std::string srcSent,
                              std::string refSent,
                              int verbose=0);
+  int minibatchTrainFeats(OnlineTrainingPars onlineTrainingPars,
+                          const std::vector<std::string>& srcSentVec,
+                          const std::vector<std::string>& refSentVec,
+                          const std::vector<std::string>& sysSentVec,
+                          int verbose=0);
+  int trainStoredMinibatch(OnlineTrainingPars onlineTrainingPars,
+                           int verbose=0);
+  float calculateNewLearningRate(OnlineTrainingPars onlineTrainingPars,
+                                 int verbose=0);
+  float werBasedLearningRate(int verbose=0);
   int trainLangModel(BaseNgramLM<LM_State>* lModelPtr,
                      float learnStepSize,
                      std::vector<std::string> refSentStrVec,
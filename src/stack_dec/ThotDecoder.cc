@@ -43,6 +43,12 @@ ThotDecoder::ThotDecoder()
   else
     init_translator_legacy_impl();
 
+      // Initialize variables for asynchronous online training
+  init_online_train_vars();
+
+      // Initialize variables for speculative prefix processing
+  init_spec_pref_vars();
+
       // Execute checkings for software modules
   testSoftwareModulesInMasterIni();
 }
@@ -525,8 +531,20 @@ size_t ThotDecoder::get_vecidx_for_user_id(int user_id)
     
     std::string totalPrefix;
     totalPrefixVec.push_back(totalPrefix);
+
+    SpecPrefCache specPrefCache;
+    specPrefCache.maxSpecPrefs=TD_USER_SPEC_DEFAULT;
+    specPrefCache.reqId=0;
+    specPrefCache.modelsVersion=0;
+    specPrefCacheVec.push_back(specPrefCache);
   }
 
+      // Initialize counters of pending requests
+  pthread_mutex_lock(&spec_pref_mut);
+  while(pendingUserReqs.size()<=idx)
+    pendingUserReqs.push_back(0);
+  pthread_mutex_unlock(&spec_pref_mut);
+
       // Initialize per user mutexes
   while(per_user_mut.size()<=idx)
   {
@@ -794,6 +812,23 @@ int ThotDecoder::initUsingCfgFile(std::string cfgFile,
       }
     }
 
+        // -olasync parameter
+    if(argv_stl[i]=="-olasync" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -olasync parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        std::cerr<<"-olasync parameter changed from \""<<onlineTrainingPars.asyncBatchSize<<"\" to \""<<argv_stl[i+1]<<"\""<<std::endl;
+        onlineTrainingPars.asyncBatchSize=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -tmw parameter
     if(argv_stl[i]=="-tmw" && !matched)
     {
@@ -915,6 +950,23 @@ int ThotDecoder::initUsingCfgFile(std::string cfgFile,
       }
     }
 
+        // -wgpp parameter
+    if(argv_stl[i]=="-wgpp" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -wgpp parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        std::cerr<<"-wgpp parameter changed from \""<<tdup.wgpp<<"\" to \""<<argv_stl[i+1]<<"\""<<std::endl;
+        tdup.wgpp=atof(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -wgh parameter
     if(argv_stl[i]=="-wgh" && !matched)
     {
@@ -941,6 +993,23 @@ int ThotDecoder::initUsingCfgFile(std::string cfgFile,
       ++i;
     }
 
+        // -spec parameter
+    if(argv_stl[i]=="-spec" && !matched)
+    {
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -spec parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        std::cerr<<"-spec parameter changed from \""<<tdup.spec<<"\" to \""<<argv_stl[i+1]<<"\""<<std::endl;
+        tdup.spec=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -uc parameter
     if(argv_stl[i]=="-uc" && !matched)
     {
@@ -1057,6 +1126,9 @@ int ThotDecoder::initUserPars(int user_id,
       // Set wgp parameter
   ret=set_wgp(user_id,tdup.wgp,verbose);
 
+      // Set wgpp parameter
+  ret=set_wgpp(user_id,tdup.wgpp,verbose);
+
       // Set sp flag
   set_preproc(user_id,tdup.sp,verbose);
 
@@ -1068,6 +1140,12 @@ int ThotDecoder::initUserPars(int user_id,
       // Set cat weights
   set_catw(user_id,tdup.catWeightsVec,verbose);
 
+      // Set spec parameter
+  set_spec(user_id,tdup.spec,verbose);
+
+      // Models may have changed
+  ++modelsVersion;
+
       // Unlock non_atomic_op_cond mutex
   pthread_mutex_unlock(&non_atomic_op_mut);
 
@@ -1361,7 +1439,55 @@ bool ThotDecoder::set_wgp(int user_id,
 
   return THOT_OK;
 }
+
+//--------------------------
+bool ThotDecoder::set_wgpp(int user_id,
+                           float wgpp_par,
+                           int verbose/*=0*/)
+{
+      // Check if ECM can be used to process word graphs
+  if(!tdCommonVars.curr_ecm_valid_for_wg)
+  {
+    StdCerrThreadSafe<<"Error: EC model is not valid for word-graphs"<<std::endl;
+    return THOT_ERROR;
+  }
+  
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose)
+  {
+    StdCerrThreadSafe<<"user_id: "<<user_id<<", wgpp parameter is set to "<<wgpp_par<<std::endl;
+  }
+      // Set wgpp value
+  if(tdPerUserVarsVec[idx].wgUncoupledAssistedTransPtr)
+    tdPerUserVarsVec[idx].wgUncoupledAssistedTransPtr->set_wgpp(wgpp_par);
+  else if(wgpp_par>0)
+  {
+    StdCerrThreadSafe<<"Warning! wgpp parameter cannot be applied to translators that do not use word-graphs."<<std::endl;
+  }
+
+  return THOT_OK;
+}
   
+//--------------------------
+void ThotDecoder::set_spec(int user_id,
+                           unsigned int spec_par,
+                           int verbose/*=0*/)
+{
+      // Obtain index vector given user_id
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose)
+  {
+    StdCerrThreadSafe<<"user_id: "<<user_id<<", spec parameter is set to "<<spec_par<<std::endl;
+  }
+      // Set spec value
+  specPrefCacheVec[idx].maxSpecPrefs=spec_par;
+
+      // Start thread for speculative prefix processing if required
+  if(spec_par>0)
+    startSpecPrefThread();
+}
+
 //--------------------------
 void ThotDecoder::set_preproc(int user_id,
                               unsigned int preprocId_par,
@@ -1904,6 +2030,13 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
     StdCerrThreadSafeCond(printTid)<<"Error: one or both of the input sentences to be trained are empty"<<std::endl;
     return THOT_ERROR;
   }
+
+      // Queue sentence pair if asynchronous training is enabled
+  pthread_mutex_lock(&online_train_mut);
+  bool asyncTraining=(onlineTrainThreadRunning && !stopOnlineTrainThreadFlag);
+  pthread_mutex_unlock(&online_train_mut);
+  if(asyncTraining)
+    return queueOnlineTrainSentPair(user_id,srcSent,refSent,verbose);
     
   pthread_mutex_lock(&atomic_op_mut);
   /////////// begin of mutex 
@@ -1922,71 +2055,357 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
     StdCerrThreadSafeCond(printTid)<<" - reference: "<<refSent<<std::endl;
   }
 
+      // Obtain sentences to be used in training
+  std::string trainSrcSent;
+  std::string trainRefSent;
+  std::string sysSent;
+  obtainOnlineTrainSents(idx,srcSent,refSent,trainSrcSent,trainRefSent,sysSent,verbose);
+
+      // Add sentence to word-predictor
+  addSentenceToWordPred(trainRefSent,externalFuncVerbosity(verbose));
+
+#ifdef THOT_ENABLE_UPDATE_LLWEIGHTS
+
+  if(!tdState.preprocId)
+    onlineTrainLogLinWeights(srcSent,refSent,externalFuncVerbosity(verbose));
+  
+#endif
+
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"Training models..."<<std::endl;
+
+      // Measure training time
+  double prevElapsedTime,elapsedTime,ucpu,scpu;
+  ctimer(&prevElapsedTime,&ucpu,&scpu);
+
+      // Train generative models
+  ret=onlineTrainFeats(trainSrcSent,trainRefSent,sysSent,externalFuncVerbosity(verbose));
+  ++modelsVersion;
+
+  ctimer(&elapsedTime,&ucpu,&scpu);
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"Training time: "<<elapsedTime-prevElapsedTime<<std::endl;
+
+      // Unlock non_atomic_op_cond mutex
+  pthread_mutex_unlock(&non_atomic_op_mut);
+
+  /////////// end of mutex 
+  pthread_mutex_unlock(&atomic_op_mut);
+
+  return ret;
+}
+
+//--------------------------
+void ThotDecoder::obtainOnlineTrainSents(size_t idx,
+                                         const char *srcSent,
+                                         const char *refSent,
+                                         std::string& trainSrcSent,
+                                         std::string& trainRefSent,
+                                         std::string& sysSent,
+                                         int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
       // Check if pre/post processing is enabled
   if(tdState.preprocId)
   {
         // Pre/post processing enabled
-    std::string preprocSrcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,srcSent,tdState.caseconv,false);
-    std::string preprocRefSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,refSent,tdState.caseconv,false);
+    trainSrcSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,srcSent,tdState.caseconv,false);
+    trainRefSent=preprocLine(tdPerUserVarsVec[idx].prePosProcessorPtr,refSent,tdState.caseconv,false);
 
         // Obtain system translation
-    SmtModel::Hypothesis hyp=tdPerUserVarsVec[idx].stackDecoderPtr->translate(preprocSrcSent.c_str());
-    std::string preprocSysSent=tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp);
+    SmtModel::Hypothesis hyp=tdPerUserVarsVec[idx].stackDecoderPtr->translate(trainSrcSent.c_str());
+    sysSent=tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp);
 
     if(verbose)
     {
-      StdCerrThreadSafeCond(printTid)<<" - preproc. source: "<<preprocSrcSent<<std::endl;
-      StdCerrThreadSafeCond(printTid)<<" - preproc. reference: "<<preprocRefSent<<std::endl;
-      StdCerrThreadSafeCond(printTid)<<" - preproc. sys translation: "<<preprocSysSent<<std::endl;
-    }
-        // Add sentence to word-predictor
-    addSentenceToWordPred(preprocRefSent,externalFuncVerbosity(verbose));
-
-    if(verbose) StdCerrThreadSafeCond(printTid)<<"Training models..."<<std::endl;
-
-        // Measure training time
-    double prevElapsedTime,elapsedTime,ucpu,scpu;
-    ctimer(&prevElapsedTime,&ucpu,&scpu);
-    
-        // Train generative models
-    ret=onlineTrainFeats(preprocSrcSent,preprocRefSent,preprocSysSent,externalFuncVerbosity(verbose));
-
-    ctimer(&elapsedTime,&ucpu,&scpu);
-    if(verbose)
-    {
-      StdCerrThreadSafeCond(printTid)<<"Training process ended."<<std::endl;
-      StdCerrThreadSafeCond(printTid)<<"Training time: "<<elapsedTime-prevElapsedTime<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - preproc. source: "<<trainSrcSent<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - preproc. reference: "<<trainRefSent<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - preproc. sys translation: "<<sysSent<<std::endl;
     }
   }
   else
   {
         // Pre/post processing disabled
+    trainSrcSent=srcSent;
+    trainRefSent=refSent;
 
-        // Obtain system translation
+        // Obtain system translation (the word graph is generated so
+        // that it can be used to update the log-linear weights, the
+        // previous setting is restored afterwards)
+    bool wordGraphEnabled=false;
     if(tdPerUserVarsVec[idx].stackDecoderRecPtr)
+    {
+      wordGraphEnabled=tdPerUserVarsVec[idx].stackDecoderRecPtr->isWordGraphEnabled();
       tdPerUserVarsVec[idx].stackDecoderRecPtr->enableWordGraph();
+    }
 
     SmtModel::Hypothesis hyp=tdPerUserVarsVec[idx].stackDecoderPtr->translate(srcSent);
-    std::string sysSent=tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp);
+    sysSent=tdPerUserVarsVec[idx].smtModelPtr->getTransInPlainText(hyp);
 
-        // Add sentence to word-predictor
-    addSentenceToWordPred(refSent,externalFuncVerbosity(verbose));
+    if(tdPerUserVarsVec[idx].stackDecoderRecPtr && !wordGraphEnabled)
+      tdPerUserVarsVec[idx].stackDecoderRecPtr->disableWordGraph();
+  }
+}
+
+//--------------------------
+int ThotDecoder::queueOnlineTrainSentPair(int user_id,
+                                          const char *srcSent,
+                                          const char *refSent,
+                                          int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // The sentences used in training are obtained here as a
+      // non-atomic operation, so the decoder of the user is not used
+      // by the trainer while the user may be carrying out a new
+      // request
+  increase_non_atomic_ops_running();
+
+  size_t idx=get_vecidx_for_user_id(user_id);
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
+
+  OnlineTrainRequest request;
+  request.user_id=user_id;
+  request.verbose=verbose;
+  pthread_mutex_lock(&online_train_mut);
+  request.clearCount=onlineTrainClearCount;
+  pthread_mutex_unlock(&online_train_mut);
 
-    if(verbose) StdCerrThreadSafeCond(printTid)<<"Training models..."<<std::endl;
+  lock_user_mut_for_request(idx);
+  /////////// begin of user mutex
+
+  obtainOnlineTrainSents(idx,srcSent,refSent,request.srcSent,request.refSent,request.sysSent,verbose);
+
+  /////////// end of user mutex 
+  pthread_mutex_unlock(&per_user_mut[idx]);
+
+  decrease_non_atomic_ops_running();
+
+      // Queue request (the sentence pair is trained here if the
+      // trainer was stopped in the meantime)
+  int ret=THOT_OK;
+  pthread_mutex_lock(&online_train_mut);
+  if(!onlineTrainThreadRunning || stopOnlineTrainThreadFlag)
+  {
+    pthread_mutex_unlock(&online_train_mut);
+    return onlineTrainSentPairBatch(std::vector<OnlineTrainRequest>(1,request));
+  }
+  onlineTrainQueue.push_back(request);
+  ++onlineTrainPending;
+  pthread_cond_signal(&online_train_avail_cond);
+  if(onlineTrainFailed)
+  {
+        // Report failures of previously queued sentence pairs
+    onlineTrainFailed=false;
+    ret=THOT_ERROR;
+  }
+  pthread_mutex_unlock(&online_train_mut);
+
+  if(verbose) StdCerrThreadSafeCond(printTid)<<"Sentence pair queued for asynchronous training"<<std::endl;
+  if(ret==THOT_ERROR)
+    StdCerrThreadSafeCond(printTid)<<"Error: training of previously queued sentence pairs failed"<<std::endl;
+
+  return ret;
+}
+
+//--------------------------
+int ThotDecoder::waitForOnlineTraining(void)
+{
+  pthread_mutex_lock(&online_train_mut);
+  while(onlineTrainPending>0)
+    pthread_cond_wait(&online_train_done_cond,&online_train_mut);
+  pthread_mutex_unlock(&online_train_mut);
+
+  if(onlineTrainingFailed())
+    return THOT_ERROR;
+  else
+    return THOT_OK;
+}
+
+//--------------------------
+bool ThotDecoder::onlineTrainingFailed(void)
+{
+  pthread_mutex_lock(&online_train_mut);
+  bool result=onlineTrainFailed;
+  onlineTrainFailed=false;
+  pthread_mutex_unlock(&online_train_mut);
+  return result;
+}
+
+//--------------------------
+void ThotDecoder::init_online_train_vars(void)
+{
+  onlineTrainPending=0;
+  onlineTrainClearCount=0;
+  onlineTrainFailed=false;
+  onlineTrainBatchSize=0;
+  onlineTrainThreadRunning=false;
+  stopOnlineTrainThreadFlag=false;
+  pthread_mutex_init(&online_train_mut,NULL);
+  pthread_cond_init(&online_train_avail_cond,NULL);
+  pthread_cond_init(&online_train_done_cond,NULL);
+}
+
+//--------------------------
+void ThotDecoder::destroy_online_train_vars(void)
+{
+  pthread_mutex_destroy(&online_train_mut);
+  pthread_cond_destroy(&online_train_avail_cond);
+  pthread_cond_destroy(&online_train_done_cond);
+}
+
+//--------------------------
+void ThotDecoder::startOnlineTrainThread(void)
+{
+  pthread_mutex_lock(&online_train_mut);
+
+  onlineTrainBatchSize=tdCommonVars.onlineTrainingPars.asyncBatchSize;
+  if(!onlineTrainThreadRunning)
+  {
+    stopOnlineTrainThreadFlag=false;
+    if(pthread_create(&onlineTrainThread,NULL,onlineTrainThreadFunc,(void*)this)==0)
+      onlineTrainThreadRunning=true;
+    else
+      std::cerr<<"Warning: asynchronous trainer could not be created, sentence pairs will be trained synchronously"<<std::endl;
+  }
+
+  pthread_mutex_unlock(&online_train_mut);
+}
+
+//--------------------------
+void ThotDecoder::stopOnlineTrainThread(void)
+{
+  pthread_mutex_lock(&online_train_mut);
+  if(!onlineTrainThreadRunning)
+  {
+    pthread_mutex_unlock(&online_train_mut);
+    return;
+  }
+  stopOnlineTrainThreadFlag=true;
+  pthread_cond_broadcast(&online_train_avail_cond);
+  pthread_mutex_unlock(&online_train_mut);
+
+      // The trainer processes the queued sentence pairs before
+      // finishing
+  pthread_join(onlineTrainThread,NULL);
+
+  pthread_mutex_lock(&online_train_mut);
+  onlineTrainThreadRunning=false;
+  stopOnlineTrainThreadFlag=false;
+  pthread_mutex_unlock(&online_train_mut);
+}
+
+//--------------------------
+void* ThotDecoder::onlineTrainThreadFunc(void* thotDecoderPtr)
+{
+  ((ThotDecoder*)thotDecoderPtr)->processOnlineTrainQueue();
+  return NULL;
+}
+
+//--------------------------
+void ThotDecoder::processOnlineTrainQueue(void)
+{
+  while(true)
+  {
+        // Wait for new sentence pairs
+    pthread_mutex_lock(&online_train_mut);
+    while(onlineTrainQueue.empty() && !stopOnlineTrainThreadFlag)
+      pthread_cond_wait(&online_train_avail_cond,&online_train_mut);
+    if(onlineTrainQueue.empty())
+    {
+          // Trainer is being stopped
+      pthread_mutex_unlock(&online_train_mut);
+      return;
+    }
+
+        // Extract mini-batch
+    std::vector<OnlineTrainRequest> requestVec;
+    while(!onlineTrainQueue.empty() && (onlineTrainBatchSize==0 || requestVec.size()<onlineTrainBatchSize))
+    {
+      requestVec.push_back(onlineTrainQueue.front());
+      onlineTrainQueue.pop_front();
+    }
+    pthread_mutex_unlock(&online_train_mut);
+
+        // Train mini-batch
+    int ret=onlineTrainSentPairBatch(requestVec);
+
+        // Notify completion
+    pthread_mutex_lock(&online_train_mut);
+    if(ret==THOT_ERROR)
+      onlineTrainFailed=true;
+    onlineTrainPending-=requestVec.size();
+    if(onlineTrainPending==0)
+      pthread_cond_broadcast(&online_train_done_cond);
+    pthread_mutex_unlock(&online_train_mut);
+  }
+}
+
+//--------------------------
+int ThotDecoder::onlineTrainSentPairBatch(const std::vector<OnlineTrainRequest>& requestVec)
+{
+  int verbose=0;
+  for(unsigned int n=0;n<requestVec.size();++n)
+  {
+    if(requestVec[n].verbose>verbose)
+      verbose=requestVec[n].verbose;
+  }
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+      // The models are modified inside an atomic operation, so
+      // translation requests only observe them before or after the
+      // whole mini-batch is applied. The lock is only held while the
+      // models are being updated
+  pthread_mutex_lock(&atomic_op_mut);
+  /////////// begin of mutex 
+
+      // Wait until all non-atomic operations have finished
+  wait_on_non_atomic_op_cond();
+
+      // Collect sentences to be used in training (they were obtained
+      // when the requests were queued). Requests created before the
+      // translator was cleared are discarded
+  pthread_mutex_lock(&online_train_mut);
+  unsigned int clearCount=onlineTrainClearCount;
+  pthread_mutex_unlock(&online_train_mut);
+  std::vector<std::string> srcSentVec;
+  std::vector<std::string> refSentVec;
+  std::vector<std::string> sysSentVec;
+  for(unsigned int n=0;n<requestVec.size();++n)
+  {
+    if(requestVec[n].clearCount!=clearCount)
+    {
+      if(requestVec[n].verbose) StdCerrThreadSafeCond(printTid)<<"Queued sentence pair discarded, the translator was cleared (user_id: "<<requestVec[n].user_id<<")"<<std::endl;
+      continue;
+    }
+    if(requestVec[n].verbose)
+    {
+      StdCerrThreadSafeCond(printTid)<<"Training queued sentence pair (user_id: "<<requestVec[n].user_id<<"):"<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - source: "<<requestVec[n].srcSent<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - reference: "<<requestVec[n].refSent<<std::endl;
+      StdCerrThreadSafeCond(printTid)<<" - sys translation: "<<requestVec[n].sysSent<<std::endl;
+    }
+    srcSentVec.push_back(requestVec[n].srcSent);
+    refSentVec.push_back(requestVec[n].refSent);
+    sysSentVec.push_back(requestVec[n].sysSent);
+  }
+
+  int ret=THOT_OK;
+  if(!srcSentVec.empty())
+  {
+        // Add sentences to word-predictor
+    for(unsigned int n=0;n<refSentVec.size();++n)
+      addSentenceToWordPred(refSentVec[n],externalFuncVerbosity(verbose));
+
+    if(verbose) StdCerrThreadSafeCond(printTid)<<"Training models with a mini-batch of "<<srcSentVec.size()<<" sentence pairs..."<<std::endl;
 
         // Measure training time
     double prevElapsedTime,elapsedTime,ucpu,scpu;
     ctimer(&prevElapsedTime,&ucpu,&scpu);
 
-#ifdef THOT_ENABLE_UPDATE_LLWEIGHTS
-
-    onlineTrainLogLinWeights(srcSent,refSent,externalFuncVerbosity(verbose));
-  
-#endif
-
         // Train generative models
-    ret=onlineTrainFeats(srcSent,refSent,sysSent,externalFuncVerbosity(verbose));
-   
+    ret=onlineTrainFeatsBatch(srcSentVec,refSentVec,sysSentVec,externalFuncVerbosity(verbose));
+    ++modelsVersion;
+
     ctimer(&elapsedTime,&ucpu,&scpu);
     if(verbose) StdCerrThreadSafeCond(printTid)<<"Training time: "<<elapsedTime-prevElapsedTime<<std::endl;
   }
@@ -1997,6 +2416,9 @@ int ThotDecoder::onlineTrainSentPair(int user_id,
   /////////// end of mutex 
   pthread_mutex_unlock(&atomic_op_mut);
 
+  if(ret==THOT_ERROR)
+    StdCerrThreadSafeCond(printTid)<<"Error while training mini-batch of queued sentence pairs"<<std::endl;
+
   return ret;
 }
 
@@ -2034,6 +2456,32 @@ int ThotDecoder::onlineTrainFeats(std::string srcSent,
   }  
 }
 
+//--------------------------
+int ThotDecoder::onlineTrainFeatsBatch(const std::vector<std::string>& srcSentVec,
+                                       const std::vector<std::string>& refSentVec,
+                                       const std::vector<std::string>& sysSentVec,
+                                       int verbose/*=0*/)
+{
+  if(tdCommonVars.featureBasedImplEnabled)
+  {
+    return tdCommonVars.stdFeatureHandler.onlineTrainFeatsBatch(tdCommonVars.onlineTrainingPars,
+                                                                srcSentVec,
+                                                                refSentVec,
+                                                                sysSentVec,
+                                                                verbose);
+  }
+  else
+  {
+    int ret=THOT_OK;
+    for(unsigned int n=0;n<srcSentVec.size();++n)
+    {
+      if(tdCommonVars.smtModelPtr->onlineTrainFeatsSentPair(srcSentVec[n].c_str(),refSentVec[n].c_str(),sysSentVec[n].c_str(),verbose)==THOT_ERROR)
+        ret=THOT_ERROR;
+    }
+    return ret;
+  }  
+}
+
 //--------------------------
 void ThotDecoder::onlineTrainLogLinWeights(size_t idx,
                                            const char *srcSent,
@@ -2097,7 +2545,8 @@ void ThotDecoder::setOnlineTrainPars(OnlineTrainingPars onlineTrainingPars,
     StdCerrThreadSafe<<"learnStepSize= "<<onlineTrainingPars.learnStepSize<<" ; ";
     StdCerrThreadSafe<<"emIters= "<<onlineTrainingPars.emIters<<" ; ";
     StdCerrThreadSafe<<"E_par= "<<onlineTrainingPars.E_par<<" ; ";
-    StdCerrThreadSafe<<"R_par= "<<onlineTrainingPars.R_par<<std::endl;
+    StdCerrThreadSafe<<"R_par= "<<onlineTrainingPars.R_par<<" ; ";
+    StdCerrThreadSafe<<"asyncBatchSize= "<<onlineTrainingPars.asyncBatchSize<<std::endl;
   }
 
   tdCommonVars.onlineTrainingPars=onlineTrainingPars;
@@ -2106,6 +2555,12 @@ void ThotDecoder::setOnlineTrainPars(OnlineTrainingPars onlineTrainingPars,
   _phraseBasedTransModel<SmtModel::Hypothesis>* pbtm_ptr=dynamic_cast<_phraseBasedTransModel<SmtModel::Hypothesis>* >(tdCommonVars.smtModelPtr);
   if(pbtm_ptr)
     pbtm_ptr->setOnlineTrainingPars(onlineTrainingPars,verbose);
+
+      // Start or stop asynchronous trainer
+  if(onlineTrainingPars.asyncBatchSize>0)
+    startOnlineTrainThread();
+  else
+    stopOnlineTrainThread();
 }
 
 //--------------------------
@@ -2149,6 +2604,7 @@ int ThotDecoder::trainEcm(int user_id,
   {
     ret=tdCommonVars.ecModelPtr->trainStrPair(strx,stry,externalFuncVerbosity(verbose));
   }
+  ++modelsVersion;
 
       // Unlock non_atomic_op_cond mutex
   pthread_mutex_unlock(&non_atomic_op_mut);
@@ -2175,7 +2631,7 @@ void ThotDecoder::translateSentence(int user_id,
   size_t idx=get_vecidx_for_user_id(user_id);
   if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
 
   if(verbose)
@@ -2323,7 +2779,7 @@ void ThotDecoder::sentPairVerCov(int user_id,
   if(verbose)
     StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
 
   if(verbose)
@@ -2379,9 +2835,12 @@ void ThotDecoder::startCat(int user_id,
 
   if(verbose) StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
 
+      // Results obtained for the previous sentence are no longer valid
+  newCatRequest(idx,true);
+
   if(tdPerUserVarsVec[idx]._nbUncoupledAssistedTransPtr)
   {
         // Execute specific actions for uncoupled assisted translators
@@ -2433,6 +2892,9 @@ void ThotDecoder::startCat(int user_id,
     tdPerUserVarsVec[idx].stackDecoderPtr->useBestScorePruning(true);
   }
 
+      // Precompute results for the most likely initial prefixes
+  addSpecPrefRequest(idx,catResult,verbose);
+
   /////////// end of user mutex 
   pthread_mutex_unlock(&per_user_mut[idx]);
 
@@ -2458,7 +2920,7 @@ void ThotDecoder::addStrToPref(int user_id,
   if(verbose)
     StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
   
   addStrToPrefAux(idx,strToAddToPref,rejectedWords,catResult,verbose);
@@ -2479,13 +2941,6 @@ void ThotDecoder::addStrToPrefAux(size_t idx,
 {
   bool printTid=threadIdShouldBePrinted(verbose);
 
-  if(tdPerUserVarsVec[idx]._nbUncoupledAssistedTransPtr)
-  {
-        // Execute specific actions for uncoupled assisted translators
-        // Disable best score pruning
-    tdPerUserVarsVec[idx].stackDecoderPtr->useBestScorePruning(false);
-  }
-  
   if(totalPrefixVec[idx]=="") totalPrefixVec[idx]=strToAddToPref;
   else totalPrefixVec[idx]=totalPrefixVec[idx]+strToAddToPref;
 
@@ -2494,6 +2949,38 @@ void ThotDecoder::addStrToPrefAux(size_t idx,
     StdCerrThreadSafeCond(printTid)<<"Add string to prefix: "<<strToAddToPref<<"|"<<std::endl;
     StdCerrThreadSafeCond(printTid)<<"Total prefix (not preprocessed): "<<totalPrefixVec[idx]<<"|"<<std::endl;
   }
+
+      // Pending speculative work for the user is no longer needed
+  newCatRequest(idx,false);
+
+      // Obtain result, speculative results are only available for
+      // requests without rejected words
+  if(rejectedWords.empty() && getSpecPrefCatResult(idx,catResult))
+  {
+    if(verbose)
+      StdCerrThreadSafeCond(printTid)<<"Final output (obtained from speculative prefix cache): "<<catResult<<"|"<<std::endl;
+  }
+  else
+    obtainCatResultForPref(idx,rejectedWords,catResult,verbose);
+
+      // Precompute results for the most likely extensions of the prefix
+  addSpecPrefRequest(idx,catResult,verbose);
+}
+
+//--------------------------
+void ThotDecoder::obtainCatResultForPref(size_t idx,
+                                         const RejectedWordsSet& rejectedWords,
+                                         std::string &catResult,
+                                         int verbose/*=0*/)
+{
+  bool printTid=threadIdShouldBePrinted(verbose);
+
+  if(tdPerUserVarsVec[idx]._nbUncoupledAssistedTransPtr)
+  {
+        // Execute specific actions for uncoupled assisted translators
+        // Disable best score pruning
+    tdPerUserVarsVec[idx].stackDecoderPtr->useBestScorePruning(false);
+  }
   if(tdState.preprocId)
   {    
     std::string trans;
@@ -2565,7 +3052,7 @@ void ThotDecoder::setPref(int user_id,
       // Obtain index vector given user_id
   size_t idx=get_vecidx_for_user_id(user_id);
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
 
   std::string strToAddToPref;
@@ -2608,7 +3095,7 @@ void ThotDecoder::resetPrefix(int user_id,
   if(verbose)
     StdCerrThreadSafeCond(printTid)<<"user_id: "<<user_id<<", idx: "<<idx<<std::endl;
 
-  pthread_mutex_lock(&per_user_mut[idx]);
+  lock_user_mut_for_request(idx);
   /////////// begin of user mutex
 
   if(verbose)
@@ -2632,6 +3119,297 @@ void ThotDecoder::resetPrefixAux(size_t idx)
   tdPerUserVarsVec[idx].assistedTransPtr->resetPrefix();
 }
 
+//--------------------------
+void ThotDecoder::init_spec_pref_vars(void)
+{
+  modelsVersion=0;
+  specPrefThreadRunning=false;
+  stopSpecPrefThreadFlag=false;
+  pthread_mutex_init(&spec_pref_mut,NULL);
+  pthread_cond_init(&spec_pref_avail_cond,NULL);
+}
+
+//--------------------------
+void ThotDecoder::destroy_spec_pref_vars(void)
+{
+  pthread_mutex_destroy(&spec_pref_mut);
+  pthread_cond_destroy(&spec_pref_avail_cond);
+}
+
+//--------------------------
+void ThotDecoder::startSpecPrefThread(void)
+{
+  pthread_mutex_lock(&spec_pref_mut);
+
+  if(!specPrefThreadRunning)
+  {
+    stopSpecPrefThreadFlag=false;
+    if(pthread_create(&specPrefThread,NULL,specPrefThreadFunc,(void*)this)==0)
+      specPrefThreadRunning=true;
+    else
+      std::cerr<<"Warning: thread for speculative prefix processing could not be created"<<std::endl;
+  }
+
+  pthread_mutex_unlock(&spec_pref_mut);
+}
+
+//--------------------------
+void ThotDecoder::stopSpecPrefThread(void)
+{
+  pthread_mutex_lock(&spec_pref_mut);
+  if(!specPrefThreadRunning)
+  {
+    pthread_mutex_unlock(&spec_pref_mut);
+    return;
+  }
+  stopSpecPrefThreadFlag=true;
+  pthread_cond_broadcast(&spec_pref_avail_cond);
+  pthread_mutex_unlock(&spec_pref_mut);
+
+      // Queued requests are discarded
+  pthread_join(specPrefThread,NULL);
+
+  pthread_mutex_lock(&spec_pref_mut);
+  specPrefThreadRunning=false;
+  stopSpecPrefThreadFlag=false;
+  specPrefQueue.clear();
+  pthread_mutex_unlock(&spec_pref_mut);
+}
+
+//--------------------------
+void* ThotDecoder::specPrefThreadFunc(void* thotDecoderPtr)
+{
+  ((ThotDecoder*)thotDecoderPtr)->processSpecPrefQueue();
+  return NULL;
+}
+
+//--------------------------
+void ThotDecoder::processSpecPrefQueue(void)
+{
+  while(true)
+  {
+        // Wait for new requests
+    pthread_mutex_lock(&spec_pref_mut);
+    while(specPrefQueue.empty() && !stopSpecPrefThreadFlag)
+      pthread_cond_wait(&spec_pref_avail_cond,&spec_pref_mut);
+    if(stopSpecPrefThreadFlag)
+    {
+      pthread_mutex_unlock(&spec_pref_mut);
+      return;
+    }
+    SpecPrefRequest request=specPrefQueue.front();
+    specPrefQueue.pop_front();
+    pthread_mutex_unlock(&spec_pref_mut);
+
+        // Process prefixes, the user mutex is released after each one
+        // so new requests of the user are not delayed. Speculative work
+        // is abandoned as soon as a request of the user is waiting for
+        // the mutex, so such request waits for one prefix at most
+    bool printTid=threadIdShouldBePrinted(request.verbose);
+    size_t idx=request.idx;
+    for(unsigned int i=0;i<request.prefixVec.size();++i)
+    {
+      if(user_has_pending_requests(idx))
+        break;
+      
+      increase_non_atomic_ops_running();
+      pthread_mutex_lock(&per_user_mut[idx]);
+      /////////// begin of user mutex
+
+          // The request is discarded if the user has sent a new one or
+          // is about to do so
+      bool requestIsValid=(idx<specPrefCacheVec.size() && !idxDataReleased[idx] && specPrefCacheVec[idx].reqId==request.reqId && !user_has_pending_requests(idx));
+      if(requestIsValid)
+      {
+        SpecPrefCache& specPrefCache=specPrefCacheVec[idx];
+        unsigned int currModelsVersion=modelsVersion;
+        if(specPrefCache.modelsVersion!=currModelsVersion)
+        {
+          specPrefCache.catResults.clear();
+          specPrefCache.modelsVersion=currModelsVersion;
+        }
+        if(specPrefCache.catResults.find(request.prefixVec[i])==specPrefCache.catResults.end())
+        {
+              // Obtain result for the prefix, keeping the prefix of
+              // the user (the assisted translator is reset at each
+              // request, so its state need not be restored)
+          std::string totalPrefix=totalPrefixVec[idx];
+          totalPrefixVec[idx]=request.prefixVec[i];
+          RejectedWordsSet emptyRejWordsSet;
+          std::string catResult;
+          obtainCatResultForPref(idx,emptyRejWordsSet,catResult);
+          totalPrefixVec[idx]=totalPrefix;
+
+          if(specPrefCache.catResults.size()>=TDEC_SPEC_CACHE_MAX_SIZE)
+            specPrefCache.catResults.clear();
+          specPrefCache.catResults[request.prefixVec[i]]=catResult;
+
+          if(request.verbose)
+            StdCerrThreadSafeCond(printTid)<<"Speculative prefix processed: "<<request.prefixVec[i]<<"|"<<std::endl;
+        }
+      }
+
+      /////////// end of user mutex 
+      pthread_mutex_unlock(&per_user_mut[idx]);
+      decrease_non_atomic_ops_running();
+
+      if(!requestIsValid)
+        break;
+    }
+  }
+}
+
+//--------------------------
+bool ThotDecoder::getSpecPrefCatResult(size_t idx,
+                                       std::string &catResult)
+{
+  SpecPrefCache& specPrefCache=specPrefCacheVec[idx];
+
+      // Results obtained with previous models are discarded
+  unsigned int currModelsVersion=modelsVersion;
+  if(specPrefCache.modelsVersion!=currModelsVersion)
+  {
+    specPrefCache.catResults.clear();
+    specPrefCache.modelsVersion=currModelsVersion;
+    return false;
+  }
+
+  std::map<std::string,std::string>::const_iterator catResultsIter=specPrefCache.catResults.find(totalPrefixVec[idx]);
+  if(catResultsIter==specPrefCache.catResults.end())
+    return false;
+  catResult=catResultsIter->second;
+  return true;
+}
+
+//--------------------------
+void ThotDecoder::addSpecPrefRequest(size_t idx,
+                                     const std::string &catResult,
+                                     int verbose/*=0*/)
+{
+  if(specPrefCacheVec[idx].maxSpecPrefs==0)
+    return;
+
+      // Obtain prefixes whose results are not cached
+  std::vector<std::string> specPrefVec;
+  obtainSpecPrefs(idx,catResult,specPrefVec);
+  SpecPrefRequest request;
+  request.idx=idx;
+  request.reqId=specPrefCacheVec[idx].reqId;
+  request.verbose=verbose;
+  for(unsigned int i=0;i<specPrefVec.size();++i)
+  {
+    if(specPrefCacheVec[idx].catResults.find(specPrefVec[i])==specPrefCacheVec[idx].catResults.end())
+      request.prefixVec.push_back(specPrefVec[i]);
+  }
+  if(request.prefixVec.empty())
+    return;
+
+      // Queue request, replacing previous requests of the user
+  pthread_mutex_lock(&spec_pref_mut);
+  if(specPrefThreadRunning && !stopSpecPrefThreadFlag)
+  {
+    std::deque<SpecPrefRequest>::iterator queueIter=specPrefQueue.begin();
+    while(queueIter!=specPrefQueue.end())
+    {
+      if(queueIter->idx==idx)
+        queueIter=specPrefQueue.erase(queueIter);
+      else
+        ++queueIter;
+    }
+    specPrefQueue.push_back(request);
+    pthread_cond_signal(&spec_pref_avail_cond);
+  }
+  pthread_mutex_unlock(&spec_pref_mut);
+}
+
+//--------------------------
+void ThotDecoder::obtainSpecPrefs(size_t idx,
+                                  const std::string &catResult,
+                                  std::vector<std::string>& specPrefVec)
+{
+  const std::string& totalPrefix=totalPrefixVec[idx];
+  std::vector<std::string> candPrefVec;
+  specPrefVec.clear();
+
+      // Extensions proposed by the system: next character and
+      // acceptance of the current word
+  if(StrProcUtils::isPrefix(totalPrefix,catResult) && catResult.size()>totalPrefix.size())
+  {
+    size_t pos=totalPrefix.size()+1;
+    while(pos<catResult.size() && (catResult[pos]&0xC0)==0x80)
+      ++pos;
+    candPrefVec.push_back(catResult.substr(0,pos));
+
+    pos=totalPrefix.size();
+    while(pos<catResult.size() && catResult[pos]==' ')
+      ++pos;
+    while(pos<catResult.size() && catResult[pos]!=' ')
+      ++pos;
+    candPrefVec.push_back(catResult.substr(0,pos)+" ");
+  }
+
+      // Extensions given by the word predictor for the last word
+  size_t lastWordPos=totalPrefix.rfind(' ');
+  if(lastWordPos==std::string::npos) lastWordPos=0;
+  else ++lastWordPos;
+  std::string lastWord=totalPrefix.substr(lastWordPos);
+  if(lastWord.size()>MINIMUM_WORD_LENGTH_TO_EXPAND)
+  {
+    std::vector<std::string> strVec=StrProcUtils::stringToStringVector(totalPrefix);
+    std::vector<std::string> hist;
+    if(strVec.size()>=3) hist.push_back(strVec[strVec.size()-3]);
+    if(strVec.size()>=2) hist.push_back(strVec[strVec.size()-2]);
+    std::pair<Count,std::string> pcs=getBestSuffixGivenHist(hist,lastWord);
+    if(!pcs.second.empty())
+    {
+      candPrefVec.push_back(totalPrefix+pcs.second+" ");
+      size_t pos=1;
+      while(pos<pcs.second.size() && (pcs.second[pos]&0xC0)==0x80)
+        ++pos;
+      candPrefVec.push_back(totalPrefix+pcs.second.substr(0,pos));
+    }
+  }
+
+      // Select distinct prefixes
+  for(unsigned int i=0;i<candPrefVec.size() && specPrefVec.size()<specPrefCacheVec[idx].maxSpecPrefs;++i)
+  {
+    if(candPrefVec[i]!=totalPrefix && std::find(specPrefVec.begin(),specPrefVec.end(),candPrefVec[i])==specPrefVec.end())
+      specPrefVec.push_back(candPrefVec[i]);
+  }
+}
+
+//--------------------------
+void ThotDecoder::newCatRequest(size_t idx,
+                                bool clearSpecPrefCache)
+{
+  ++specPrefCacheVec[idx].reqId;
+  if(clearSpecPrefCache)
+    specPrefCacheVec[idx].catResults.clear();
+}
+
+//--------------------------
+void ThotDecoder::lock_user_mut_for_request(size_t idx)
+{
+  pthread_mutex_lock(&spec_pref_mut);
+  ++pendingUserReqs[idx];
+  pthread_mutex_unlock(&spec_pref_mut);
+
+  pthread_mutex_lock(&per_user_mut[idx]);
+
+  pthread_mutex_lock(&spec_pref_mut);
+  --pendingUserReqs[idx];
+  pthread_mutex_unlock(&spec_pref_mut);
+}
+
+//--------------------------
+bool ThotDecoder::user_has_pending_requests(size_t idx)
+{
+  pthread_mutex_lock(&spec_pref_mut);
+  bool result=(idx<pendingUserReqs.size() && pendingUserReqs[idx]>0);
+  pthread_mutex_unlock(&spec_pref_mut);
+  return result;
+}
+
 //--------------------------
 int ThotDecoder::use_caseconv(int user_id,
                               const char *caseConvFile,
@@ -2671,6 +3449,23 @@ void ThotDecoder::clearTrans(int /*verbose=0*/)
       // Wait until all non-atomic operations have finished
   wait_on_non_atomic_op_cond();
 
+      // Discard sentence pairs queued for asynchronous training. The
+      // mini-batch being processed by the trainer, if any, cannot be
+      // waited for here since it is applied inside an atomic
+      // operation, it is discarded by the trainer instead
+  pthread_mutex_lock(&online_train_mut);
+  ++onlineTrainClearCount;
+  onlineTrainPending-=onlineTrainQueue.size();
+  onlineTrainQueue.clear();
+  if(onlineTrainPending==0)
+    pthread_cond_broadcast(&online_train_done_cond);
+  pthread_mutex_unlock(&online_train_mut);
+
+      // Discard speculative prefix requests
+  pthread_mutex_lock(&spec_pref_mut);
+  specPrefQueue.clear();
+  pthread_mutex_unlock(&spec_pref_mut);
+
   tdCommonVars.wgHandlerPtr->clear();
   tdCommonVars.smtModelPtr->clear();
   tdCommonVars.ecModelPtr->clear();
@@ -2683,6 +3478,8 @@ void ThotDecoder::clearTrans(int /*verbose=0*/)
   tdPerUserVarsVec.clear();
   tdState.default_values();
   totalPrefixVec.clear();
+  specPrefCacheVec.clear();
+  ++modelsVersion;
   userIdToIdx.clear();
   idxDataReleased.clear();
 
@@ -2696,6 +3493,11 @@ void ThotDecoder::clearTrans(int /*verbose=0*/)
 //--------------------------
 int ThotDecoder::printModels(int verbose/*=0*/)
 {
+      // Printed models should incorporate all the queued sentence
+      // pairs
+  if(waitForOnlineTraining()==THOT_ERROR)
+    std::cerr<<"Warning: training of queued sentence pairs failed, printed models may be incomplete"<<std::endl;
+
   if(tdCommonVars.featureBasedImplEnabled)
     return printModelsFeatImpl(verbose);
   else
@@ -3348,8 +4150,17 @@ int ThotDecoder::externalFuncVerbosity(int verbosity)
 //--------------------------
 ThotDecoder::~ThotDecoder()
 {
+      // Stop speculative prefix processing
+  stopSpecPrefThread();
+
+      // Train pending sentence pairs and stop asynchronous trainer
+  stopOnlineTrainThread();
+
   if(tdCommonVars.featureBasedImplEnabled)
     destroy_feat_impl();
   else
     destroy_legacy_impl();
+
+  destroy_online_train_vars();
+  destroy_spec_pref_vars();
 }
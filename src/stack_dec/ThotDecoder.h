@@ -60,6 +60,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <options.h>
 #include <pthread.h>
 #include <sstream>
+#include <deque>
+#include <atomic>
+#include <algorithm>
 
 //--------------- Constants ------------------------------------------
 
@@ -76,6 +79,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
                                            // a word using the word
                                            // predictor
 
+#define TDEC_SPEC_CACHE_MAX_SIZE     64    // Maximum number of results
+                                           // kept in the speculative
+                                           // prefix cache of each user
+
 #define THOTDEC_NON_VERBOSE_MODE      0
 #define THOTDEC_NORMAL_VERBOSE_MODE   1
 #define THOTDEC_DEBUG_VERBOSE_MODE    2
@@ -112,6 +119,18 @@ class ThotDecoder
                           const char *srcSent,
                           const char *refSent,
                           int verbose=0);
+      // If asynchronous training is enabled, the system translation
+      // is obtained, the sentence pair is queued and the function
+      // returns without waiting for the models to be updated. In that
+      // case, THOT_ERROR is returned if the training of previously
+      // queued sentence pairs failed
+  int waitForOnlineTraining(void);
+      // Blocks until all the queued sentence pairs have been trained,
+      // returns THOT_ERROR if the training of any of them failed
+  bool onlineTrainingFailed(void);
+      // Returns true if the training of queued sentence pairs failed
+      // since the last call to this function or to
+      // waitForOnlineTraining()
   void updateLogLinearWeights(std::string refSent,
                               WordGraph* wgPtr,
                               int verbose=0);
@@ -184,6 +203,66 @@ class ThotDecoder
   pthread_cond_t non_atomic_op_cond;
   unsigned int non_atomic_ops_running;
   std::vector<pthread_mutex_t> per_user_mut;
+
+      // Data members related to speculative prefix processing (after
+      // each CAT request, the results for the most likely extensions
+      // of the prefix are computed by a background thread, so the next
+      // request may be answered from the cache of the user)
+  struct SpecPrefCache
+  {
+    unsigned int maxSpecPrefs;  // Extensions computed after each
+                                // request (0 disables speculation)
+    unsigned int reqId;         // Identifier of the last request
+    unsigned int modelsVersion; // Models used to obtain the results
+    std::map<std::string,std::string> catResults;
+  };
+  struct SpecPrefRequest
+  {
+    size_t idx;
+    unsigned int reqId;
+    std::vector<std::string> prefixVec;
+    int verbose;
+  };
+  std::vector<SpecPrefCache> specPrefCacheVec;
+  std::atomic<unsigned int> modelsVersion; // Increased by the
+                                           // operations that modify
+                                           // the models
+  std::vector<unsigned int> pendingUserReqs; // Requests of each user
+                                             // waiting for the user
+                                             // mutex (protected by
+                                             // spec_pref_mut)
+  std::deque<SpecPrefRequest> specPrefQueue;
+  bool specPrefThreadRunning;
+  bool stopSpecPrefThreadFlag;
+  pthread_t specPrefThread;
+  pthread_mutex_t spec_pref_mut;
+  pthread_cond_t spec_pref_avail_cond;
+
+      // Data members related to asynchronous online training
+  struct OnlineTrainRequest
+  {
+    int user_id;
+    std::string srcSent;  // Sentences used to train the models,
+    std::string refSent;  // obtained when the request is queued
+    std::string sysSent;
+    int verbose;
+    unsigned int clearCount; // Value of onlineTrainClearCount when the
+                             // request was created
+  };
+  std::deque<OnlineTrainRequest> onlineTrainQueue;
+  unsigned int onlineTrainPending;
+  unsigned int onlineTrainClearCount; // Number of times the translator
+                                      // has been cleared, requests
+                                      // created before the last clear
+                                      // are discarded
+  bool onlineTrainFailed;
+  unsigned int onlineTrainBatchSize;
+  bool onlineTrainThreadRunning;
+  bool stopOnlineTrainThreadFlag;
+  pthread_t onlineTrainThread;
+  pthread_mutex_t online_train_mut;
+  pthread_cond_t online_train_avail_cond;
+  pthread_cond_t online_train_done_cond;
   
       // Mutex- and condition-related functions
   void wait_on_non_atomic_op_cond(void);
@@ -240,6 +319,58 @@ class ThotDecoder
       // Training-related functions
   void setOnlineTrainPars(OnlineTrainingPars onlineTrainingPars,
                           int verbose=0);
+  void obtainOnlineTrainSents(size_t idx,
+                              const char *srcSent,
+                              const char *refSent,
+                              std::string& trainSrcSent,
+                              std::string& trainRefSent,
+                              std::string& sysSent,
+                              int verbose=0);
+      // Obtains the sentences used to train the models (applying
+      // pre-processing and translating the source sentence if
+      // appliable). The models are not modified, so it only requires
+      // exclusive access to the data of the user
+
+      // Functions related to speculative prefix processing
+  void init_spec_pref_vars(void);
+  void destroy_spec_pref_vars(void);
+  void startSpecPrefThread(void);
+  void stopSpecPrefThread(void);
+  static void* specPrefThreadFunc(void* thotDecoderPtr);
+  void processSpecPrefQueue(void);
+  bool getSpecPrefCatResult(size_t idx,
+                            std::string &catResult);
+      // Obtains the cached result for the current prefix of the user
+      // if available
+  void addSpecPrefRequest(size_t idx,
+                          const std::string &catResult,
+                          int verbose=0);
+      // Queues the most likely extensions of the current prefix of
+      // the user given the result returned for it
+  void obtainSpecPrefs(size_t idx,
+                       const std::string &catResult,
+                       std::vector<std::string>& specPrefVec);
+  void newCatRequest(size_t idx,
+                     bool clearSpecPrefCache);
+      // Invalidates the pending speculative work of the user
+  void lock_user_mut_for_request(size_t idx);
+      // Locks the mutex of the user, registering the request as
+      // pending while waiting so speculative work gives way to it
+  bool user_has_pending_requests(size_t idx);
+      // Returns true if requests of the user are waiting for its mutex
+
+      // Functions related to asynchronous online training
+  void init_online_train_vars(void);
+  void destroy_online_train_vars(void);
+  void startOnlineTrainThread(void);
+  void stopOnlineTrainThread(void);
+  static void* onlineTrainThreadFunc(void* thotDecoderPtr);
+  void processOnlineTrainQueue(void);
+  int queueOnlineTrainSentPair(int user_id,
+                               const char *srcSent,
+                               const char *refSent,
+                               int verbose=0);
+  int onlineTrainSentPairBatch(const std::vector<OnlineTrainRequest>& requestVec);
 
       // Functions to set decoder parameters
   void setNonMonotonicity(int nomon,
@@ -267,6 +398,12 @@ class ThotDecoder
   bool set_wgp(int user_id,
                float wgp_par,
                int verbose=0);
+  bool set_wgpp(int user_id,
+                float wgpp_par,
+                int verbose=0);
+  void set_spec(int user_id,
+                unsigned int spec_par,
+                int verbose=0);
   void set_preproc(int user_id,
                    unsigned int preprocId_par,
                    int verbose=0);
@@ -298,6 +435,10 @@ class ThotDecoder
                        std::string refSent,
                        std::string sysSent,
                        int verbose=0);
+  int onlineTrainFeatsBatch(const std::vector<std::string>& srcSentVec,
+                            const std::vector<std::string>& refSentVec,
+                            const std::vector<std::string>& sysSentVec,
+                            int verbose=0);
   void onlineTrainLogLinWeights(size_t idx,
                                 const char *srcSent,
                                 const char *refSent,
@@ -310,6 +451,11 @@ class ThotDecoder
                        const RejectedWordsSet& rejectedWords,
                        std::string &catResult,
                        int verbose=0);
+  void obtainCatResultForPref(size_t idx,
+                              const RejectedWordsSet& rejectedWords,
+                              std::string &catResult,
+                              int verbose=0);
+      // Obtains the result for the current prefix of the user
 
       // Pre-posprocessing related functions
   std::string robustObtainFinalOutput(BasePrePosProcessor* prePosProcessorPtr,
@@ -35,7 +35,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #define TD_USER_G_DEFAULT          0
 #define TD_USER_NP_DEFAULT        10
 #define TD_USER_WGP_DEFAULT        UNLIMITED_DENSITY
+#define TD_USER_WGPP_DEFAULT       0
 #define TD_USER_SP_DEFAULT         0
+#define TD_USER_SPEC_DEFAULT       0
 
 //--------------- Classes --------------------------------------------
 
@@ -48,8 +50,10 @@ class ThotDecoderUserPars
   unsigned int G;
   unsigned int np;
   float wgp;
+  float wgpp;
   std::string wgh_str;
   unsigned int sp;
+  unsigned int spec;
   std::string uc_str;
   std::vector<float> catWeightsVec;
   
@@ -65,7 +69,9 @@ class ThotDecoderUserPars
     G=TD_USER_G_DEFAULT;
     np=TD_USER_NP_DEFAULT;
     wgp=TD_USER_WGP_DEFAULT;
+    wgpp=TD_USER_WGPP_DEFAULT;
     sp=TD_USER_SP_DEFAULT;
+    spec=TD_USER_SPEC_DEFAULT;
     uc_str="";//"/home/dortiz/traduccion/software/smt_preproc/data/training.enes.en.sim.tabla";
     wgh_str="";
     catWeightsVec.clear();
@@ -0,0 +1,463 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgMertLlWu.cc
+ *
+ * @brief Definitions file for WgMertLlWu.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "WgMertLlWu.h"
+#include "ErrorDefs.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+
+//--------------- Type definitions -----------------------------------
+
+struct EnvelopeEvent
+{
+  double x;
+  unsigned int sentIdx;
+  unsigned int segIdx;
+
+  bool operator<(const EnvelopeEvent& e)const
+  {
+    return x<e.x;
+  }
+};
+
+//--------------- WgMertLlWu class function definitions
+
+//---------------------------------------
+WgMertLlWu::WgMertLlWu(unsigned int _numRandDirs,
+                       unsigned int _maxIters)
+{
+  numRandDirs=_numRandDirs;
+  maxIters=_maxIters;
+  scorer=NULL;
+  tunedScore=0;
+}
+
+//---------------------------------------
+bool WgMertLlWu::link_scorer(BaseScorer* baseScorerPtr)
+{
+  scorer=dynamic_cast<BaseMiraScorer*>(baseScorerPtr);
+  if(scorer)
+    return true;
+  else
+    return false;
+}
+
+//---------------------------------------
+int WgMertLlWu::tune(const std::vector<std::string>& references,
+                     const std::vector<const WordGraph*>& wgPtrVec,
+                     const std::vector<double>& currWeightsVec,
+                     const std::vector<bool>& includeVarVec,
+                     std::vector<double>& newWeightsVec,
+                     int verbose/*=0*/)
+{
+  newWeightsVec=currWeightsVec;
+  if(scorer==NULL)
+  {
+    std::cerr<<"Error: no scorer was linked to the weight updater"<<std::endl;
+    return THOT_ERROR;
+  }
+  if(references.size()!=wgPtrVec.size())
+  {
+    std::cerr<<"Error: the number of references and word graphs differ"<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Determine components to be tuned
+  std::vector<bool> tunedVarVec=includeVarVec;
+  if(tunedVarVec.empty())
+    tunedVarVec.resize(currWeightsVec.size(),true);
+  if(tunedVarVec.size()!=currWeightsVec.size())
+  {
+    std::cerr<<"Error: the number of weights and included variables differ"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  srand(WGMERT_RANDOM_SEED);
+  bool scoreInitialized=false;
+  for(unsigned int iter=0;iter<maxIters;++iter)
+  {
+        // Obtain search directions, coordinate axes are followed by
+        // random directions
+    std::vector<std::vector<double> > dirVecs;
+    for(unsigned int k=0;k<tunedVarVec.size();++k)
+    {
+      if(tunedVarVec[k])
+      {
+        std::vector<double> dirVec(currWeightsVec.size(),0);
+        dirVec[k]=1;
+        dirVecs.push_back(dirVec);
+      }
+    }
+    for(unsigned int r=0;r<numRandDirs;++r)
+    {
+      std::vector<double> dirVec;
+      obtainRandomDir(tunedVarVec,dirVec);
+      dirVecs.push_back(dirVec);
+    }
+
+        // Carry out line searches
+    bool improved=false;
+    for(unsigned int d=0;d<dirVecs.size();++d)
+    {
+      double gamma;
+      double currScore;
+      double bestScore;
+      int ret=lineSearch(references,wgPtrVec,newWeightsVec,dirVecs[d],gamma,currScore,bestScore);
+      if(ret==THOT_ERROR)
+        return THOT_ERROR;
+
+      if(!scoreInitialized)
+      {
+        if(verbose)
+          std::cerr<<"Initial score: "<<currScore<<std::endl;
+        scoreInitialized=true;
+      }
+
+      if(gamma!=0)
+      {
+        for(unsigned int k=0;k<newWeightsVec.size();++k)
+          newWeightsVec[k]+=gamma*dirVecs[d][k];
+        improved=true;
+        if(verbose)
+          std::cerr<<"Iteration "<<iter<<", direction "<<d<<": step "<<gamma<<", score "<<currScore<<" -> "<<bestScore<<std::endl;
+      }
+      tunedScore=bestScore;
+    }
+
+        // Stop if no direction improved the score
+    if(!improved)
+      break;
+  }
+  if(verbose)
+    std::cerr<<"Final score: "<<tunedScore<<std::endl;
+
+  return THOT_OK;
+}
+
+//---------------------------------------
+double WgMertLlWu::getTunedScore(void)const
+{
+  return tunedScore;
+}
+
+//---------------------------------------
+int WgMertLlWu::lineSearch(const std::vector<std::string>& references,
+                           const std::vector<const WordGraph*>& wgPtrVec,
+                           const std::vector<double>& weightsVec,
+                           const std::vector<double>& dirVec,
+                           double& gamma,
+                           double& currScore,
+                           double& bestScore)
+{
+      // Obtain envelope segments for each sentence
+  std::vector<std::vector<EnvelopeSegment> > segmentsVec(wgPtrVec.size());
+  for(unsigned int n=0;n<wgPtrVec.size();++n)
+  {
+    int ret=obtainEnvelopeSegments(references[n],*wgPtrVec[n],weightsVec,dirVec,segmentsVec[n]);
+    if(ret==THOT_ERROR)
+      return THOT_ERROR;
+  }
+
+      // Obtain the statistics for the leftmost interval and the points
+      // where the best translation of a sentence changes
+  std::vector<double> corpusStats;
+  std::vector<EnvelopeEvent> events;
+  for(unsigned int n=0;n<segmentsVec.size();++n)
+  {
+    const std::vector<double>& stats=segmentsVec[n][0].stats;
+    if(corpusStats.size()<stats.size())
+      corpusStats.resize(stats.size(),0);
+    for(unsigned int i=0;i<stats.size();++i)
+      corpusStats[i]+=stats[i];
+
+    for(unsigned int s=1;s<segmentsVec[n].size();++s)
+    {
+      EnvelopeEvent event;
+      event.x=segmentsVec[n][s].x;
+      event.sentIdx=n;
+      event.segIdx=s;
+      events.push_back(event);
+    }
+  }
+  std::sort(events.begin(),events.end());
+
+      // Sweep the intervals of the error surface from left to right
+  double score;
+  scorer->corpusScoreFromStats(corpusStats,score);
+  double left=-HUGE_VAL;
+  double bestLeft=left;
+  double bestRight=(events.empty() ? HUGE_VAL : events[0].x);
+  bestScore=score;
+  currScore=score;
+  unsigned int e=0;
+  while(e<events.size())
+  {
+        // Update statistics of the sentences changing at the current
+        // point
+    left=events[e].x;
+    while(e<events.size() && events[e].x==left)
+    {
+      const std::vector<EnvelopeSegment>& segments=segmentsVec[events[e].sentIdx];
+      const std::vector<double>& prevStats=segments[events[e].segIdx-1].stats;
+      const std::vector<double>& stats=segments[events[e].segIdx].stats;
+      for(unsigned int i=0;i<stats.size() && i<corpusStats.size();++i)
+        corpusStats[i]+=stats[i]-prevStats[i];
+      ++e;
+    }
+    double right=(e<events.size() ? events[e].x : HUGE_VAL);
+
+    scorer->corpusScoreFromStats(corpusStats,score);
+    if(left<=0 && 0<right)
+      currScore=score;
+    if(score>bestScore)
+    {
+      bestScore=score;
+      bestLeft=left;
+      bestRight=right;
+    }
+  }
+
+      // Obtain step, the current weights are kept unless the score is
+      // improved
+  if(bestScore<=currScore+WGMERT_MIN_SCORE_IMPROVEMENT)
+  {
+    gamma=0;
+    bestScore=currScore;
+  }
+  else
+  {
+    if(bestLeft==-HUGE_VAL && bestRight==HUGE_VAL)
+      gamma=0;
+    else if(bestLeft==-HUGE_VAL)
+      gamma=bestRight-1;
+    else if(bestRight==HUGE_VAL)
+      gamma=bestLeft+1;
+    else
+      gamma=(bestLeft+bestRight)/2;
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+int WgMertLlWu::obtainEnvelopeSegments(const std::string& reference,
+                                       const WordGraph& wordGraph,
+                                       const std::vector<double>& weightsVec,
+                                       const std::vector<double>& dirVec,
+                                       std::vector<EnvelopeSegment>& segments)
+{
+  segments.clear();
+
+      // Initialize envelope of the initial state with the empty path
+  std::vector<std::vector<EnvelopeLine> > envelopes(wordGraph.numStates());
+  std::vector<bool> envelopeObtained(wordGraph.numStates(),false);
+  if(!envelopes.empty())
+  {
+    EnvelopeLine line;
+    line.slope=0;
+    line.intercept=0;
+    line.x=-HUGE_VAL;
+    line.arcId=INVALID_ARCID;
+    line.predLineIdx=0;
+    envelopes[INITIAL_STATE].push_back(line);
+    envelopeObtained[INITIAL_STATE]=true;
+  }
+
+      // Propagate envelopes following the arcs (arcs are assumed to be
+      // topologically ordered, so the lines of a state are complete
+      // when its first outgoing arc is visited)
+  std::vector<Score> scoreComps;
+  for(WordGraphArcId wgArcId=0;wgArcId<wordGraph.numArcs();++wgArcId)
+  {
+    if(wordGraph.arcPruned(wgArcId))
+      continue;
+    HypStateIndex predIdx=wordGraph.getArcPredStateIndex(wgArcId);
+    HypStateIndex succIdx=wordGraph.getArcSuccStateIndex(wgArcId);
+
+        // Paths end when a final state is reached
+    if(envelopes[predIdx].empty() || (predIdx!=INITIAL_STATE && wordGraph.stateIsFinal(predIdx)))
+      continue;
+    if(!envelopeObtained[predIdx])
+    {
+      obtainUpperEnvelope(envelopes[predIdx]);
+      envelopeObtained[predIdx]=true;
+    }
+
+    wordGraph.getArcScoreComps(wgArcId,scoreComps);
+    if(scoreComps.size()!=weightsVec.size())
+    {
+      std::cerr<<"Error: arcs of word graph do not contain "<<weightsVec.size()<<" score components"<<std::endl;
+      return THOT_ERROR;
+    }
+    double arcIntercept=dotProduct(weightsVec,scoreComps);
+    double arcSlope=dotProduct(dirVec,scoreComps);
+    for(unsigned int i=0;i<envelopes[predIdx].size();++i)
+    {
+      EnvelopeLine line;
+      line.slope=envelopes[predIdx][i].slope+arcSlope;
+      line.intercept=envelopes[predIdx][i].intercept+arcIntercept;
+      line.arcId=wgArcId;
+      line.predLineIdx=i;
+      envelopes[succIdx].push_back(line);
+    }
+  }
+
+      // Obtain envelope of the complete paths, predLineIdx points to
+      // finalLineRefs for these lines
+  std::vector<std::pair<HypStateIndex,unsigned int> > finalLineRefs;
+  std::vector<EnvelopeLine> finalLines;
+  for(HypStateIndex idx=INITIAL_STATE+1;idx<envelopes.size();++idx)
+  {
+    if(wordGraph.stateIsFinal(idx) && !envelopes[idx].empty())
+    {
+      if(!envelopeObtained[idx])
+      {
+        obtainUpperEnvelope(envelopes[idx]);
+        envelopeObtained[idx]=true;
+      }
+      for(unsigned int i=0;i<envelopes[idx].size();++i)
+      {
+        EnvelopeLine line=envelopes[idx][i];
+        line.predLineIdx=finalLineRefs.size();
+        finalLineRefs.push_back(std::make_pair(idx,i));
+        finalLines.push_back(line);
+      }
+    }
+  }
+  obtainUpperEnvelope(finalLines);
+
+      // Obtain translation and statistics for each segment of the
+      // envelope
+  std::string prevTrans;
+  for(unsigned int l=0;l<finalLines.size();++l)
+  {
+    std::vector<WordGraphArcId> arcIds;
+    HypStateIndex idx=finalLineRefs[finalLines[l].predLineIdx].first;
+    unsigned int lineIdx=finalLineRefs[finalLines[l].predLineIdx].second;
+    while(envelopes[idx][lineIdx].arcId!=INVALID_ARCID)
+    {
+      const EnvelopeLine& line=envelopes[idx][lineIdx];
+      arcIds.push_back(line.arcId);
+      idx=wordGraph.getArcPredStateIndex(line.arcId);
+      lineIdx=line.predLineIdx;
+    }
+
+    std::string trans;
+    for(unsigned int i=arcIds.size();i>0;--i)
+    {
+      for(unsigned int w=0;w<wordGraph.getArcNumWords(arcIds[i-1]);++w)
+      {
+        if(!trans.empty()) trans+=" ";
+        trans+=wordGraph.getArcWord(arcIds[i-1],w);
+      }
+    }
+
+        // Adjacent segments with the same translation are merged
+    if(l>0 && trans==prevTrans)
+      continue;
+    EnvelopeSegment segment;
+    segment.x=finalLines[l].x;
+    scorer->sentStats(trans,reference,segment.stats);
+    segments.push_back(segment);
+    prevTrans=trans;
+  }
+
+      // Word graphs without complete paths produce the empty
+      // translation
+  if(segments.empty())
+  {
+    EnvelopeSegment segment;
+    segment.x=-HUGE_VAL;
+    scorer->sentStats("",reference,segment.stats);
+    segments.push_back(segment);
+  }
+  return THOT_OK;
+}
+
+//---------------------------------------
+void WgMertLlWu::obtainUpperEnvelope(std::vector<EnvelopeLine>& lines)
+{
+      // Sweep lines by increasing slope, each line is maximal to the
+      // right of its intersection with the previous one
+  std::sort(lines.begin(),lines.end(),lineSlopeLess);
+  std::vector<EnvelopeLine> envelope;
+  for(unsigned int i=0;i<lines.size();++i)
+  {
+    EnvelopeLine line=lines[i];
+    if(!envelope.empty() && envelope.back().slope==line.slope)
+      envelope.pop_back();
+
+    double x=-HUGE_VAL;
+    while(!envelope.empty())
+    {
+      const EnvelopeLine& lastLine=envelope.back();
+      x=(lastLine.intercept-line.intercept)/(line.slope-lastLine.slope);
+      if(x<=lastLine.x)
+      {
+        envelope.pop_back();
+        x=-HUGE_VAL;
+      }
+      else
+        break;
+    }
+    line.x=x;
+    envelope.push_back(line);
+  }
+  lines.swap(envelope);
+}
+
+//---------------------------------------
+bool WgMertLlWu::lineSlopeLess(const EnvelopeLine& l1,
+                               const EnvelopeLine& l2)
+{
+  if(l1.slope!=l2.slope)
+    return l1.slope<l2.slope;
+  else
+    return l1.intercept<l2.intercept;
+}
+
+//---------------------------------------
+double WgMertLlWu::dotProduct(const std::vector<double>& v,
+                              const std::vector<Score>& scoreComps)
+{
+  double result=0;
+  for(unsigned int i=0;i<v.size() && i<scoreComps.size();++i)
+    result+=v[i]*scoreComps[i];
+  return result;
+}
+
+//---------------------------------------
+void WgMertLlWu::obtainRandomDir(const std::vector<bool>& includeVarVec,
+                                 std::vector<double>& dirVec)
+{
+  dirVec.assign(includeVarVec.size(),0);
+  for(unsigned int k=0;k<includeVarVec.size();++k)
+  {
+    if(includeVarVec[k])
+      dirVec[k]=2*((double)rand()/RAND_MAX)-1;
+  }
+}
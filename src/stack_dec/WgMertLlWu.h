@@ -0,0 +1,137 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file WgMertLlWu.h
+ *
+ * @brief Defines the WgMertLlWu class, which tunes log-linear weights
+ * by means of minimum error rate training over word graphs.
+ */
+
+#ifndef _WgMertLlWu_h
+#define _WgMertLlWu_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseMiraScorer.h"
+#include "WordGraph.h"
+#include <string>
+#include <vector>
+
+//--------------- Constants ------------------------------------------
+
+#define WGMERT_RANDOM_SEED         31415
+#define WGMERT_DEFAULT_NUM_RAND_DIRS  10
+#define WGMERT_DEFAULT_MAX_ITERS      20
+#define WGMERT_MIN_SCORE_IMPROVEMENT  1e-6
+
+//--------------- Classes --------------------------------------------
+
+//--------------- WgMertLlWu class
+
+/**
+ * @brief Implements lattice MERT [Macherey et al. 2008]. Given a
+ * search direction, the upper envelope of the lines (intercept: score
+ * given the current weights, slope: score given the direction) of all
+ * the paths of a word graph is obtained by propagating the envelopes
+ * of the states in topological order. The error surface of the corpus
+ * is then obtained by merging the envelopes of the word graphs, and
+ * the weights are moved to the best interval found. Searches are
+ * carried out along the coordinate axes and a number of random
+ * directions until no improvement is obtained. The word graphs must
+ * contain the score components of their arcs, and no decoding is
+ * needed to evaluate new weights.
+ */
+
+class WgMertLlWu
+{
+ public:
+  WgMertLlWu(unsigned int numRandDirs=WGMERT_DEFAULT_NUM_RAND_DIRS,
+             unsigned int maxIters=WGMERT_DEFAULT_MAX_ITERS);
+
+      // Function to link scorer
+  bool link_scorer(BaseScorer* baseScorerPtr);
+
+  int tune(const std::vector<std::string>& references,
+           const std::vector<const WordGraph*>& wgPtrVec,
+           const std::vector<double>& currWeightsVec,
+           const std::vector<bool>& includeVarVec,
+           std::vector<double>& newWeightsVec,
+           int verbose=0);
+      // Obtains new weights for the score components of the word
+      // graphs. Components whose entry of includeVarVec is false keep
+      // their current weight (all components are tuned if
+      // includeVarVec is empty)
+  double getTunedScore(void)const;
+      // Returns the corpus score obtained with the weights given by
+      // the last call to tune()
+
+ private:
+
+  struct EnvelopeLine
+  {
+    double slope;
+    double intercept;
+    double x;
+        // Left end of the interval in which the line is maximal
+    WordGraphArcId arcId;
+    unsigned int predLineIdx;
+        // Arc of the path and line of the predecessor state
+  };
+
+  struct EnvelopeSegment
+  {
+    double x;
+    std::vector<double> stats;
+        // Left end of the segment and scorer statistics of the
+        // translation that is best in it
+  };
+
+  unsigned int numRandDirs;
+  unsigned int maxIters;
+  BaseMiraScorer* scorer;
+  double tunedScore;
+
+  int lineSearch(const std::vector<std::string>& references,
+                 const std::vector<const WordGraph*>& wgPtrVec,
+                 const std::vector<double>& weightsVec,
+                 const std::vector<double>& dirVec,
+                 double& gamma,
+                 double& currScore,
+                 double& bestScore);
+      // Obtains the step along dirVec that maximizes the corpus score,
+      // and the corpus score for the current weights
+  int obtainEnvelopeSegments(const std::string& reference,
+                             const WordGraph& wordGraph,
+                             const std::vector<double>& weightsVec,
+                             const std::vector<double>& dirVec,
+                             std::vector<EnvelopeSegment>& segments);
+  static void obtainUpperEnvelope(std::vector<EnvelopeLine>& lines);
+  static bool lineSlopeLess(const EnvelopeLine& l1,
+                            const EnvelopeLine& l2);
+  static double dotProduct(const std::vector<double>& v,
+                           const std::vector<Score>& scoreComps);
+  void obtainRandomDir(const std::vector<bool>& includeVarVec,
+                       std::vector<double>& dirVec);
+};
+
+#endif
@@ -88,6 +88,10 @@ class WgUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
   void set_wgp(float _wgp);
       // Sets the word-graph pruning parameter used in uncoupled
       // assisted translation
+  void set_wgpp(float _wgpp);
+      // Sets the arc posterior threshold used to prune the word graph
+      // in uncoupled assisted translation (0 disables posterior
+      // pruning)
 
       // Model weights functions
   void setWeights(std::vector<float> wVec);
@@ -127,6 +131,8 @@ class WgUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
 
   float wgp; // Word-graph pruning threshold
 
+  float wgpp; // Word-graph posterior pruning threshold
+
   unsigned int number_of_results;
 
       // Auxiliary functions
@@ -136,6 +142,9 @@ class WgUncoupledAssistedTrans: public _assistedTrans<SMT_MODEL>
   WordGraph* obtainWgUsingWgHandler(std::string s,
                                     bool& completeHypReachable,
                                     unsigned int verbose=0);
+  void preprocWg(WordGraph* wg_ptr_aux,
+                 unsigned int verbose=0);
+      // Prunes the word graph and removes its non-useful states
 
 };
 
@@ -148,6 +157,7 @@ WgUncoupledAssistedTrans<SMT_MODEL>::WgUncoupledAssistedTrans(void):_assistedTra
   psutw=1;
   putw=1;
   wgp=UNLIMITED_DENSITY;
+  wgpp=0;
   number_of_results=1;
   sdr_ptr=NULL;
   wgp_ptr=NULL;
@@ -194,19 +204,14 @@ std::string WgUncoupledAssistedTrans<SMT_MODEL>::translateWithPrefix(std::string
 
       // Try to obtain word-graph using word-graph handler
   bool completeHypReachable;
-  WordGraph* wg_ptr_aux=obtainWgUsingWgHandler(s,completeHypReachable);
+  WordGraph* wg_ptr_aux=obtainWgUsingWgHandler(s,completeHypReachable,verbose);
   
       // Otherwise, obtain word-graph using translator
   if(wg_ptr_aux==NULL)
+  {
     wg_ptr_aux=obtainWgUsingTranslator(s,completeHypReachable);
-  
-      // Prune word-graph
-  unsigned int numPrunedArcs=wg_ptr_aux->prune(wgp);
-  if(verbose)
-    std::cerr<<numPrunedArcs<<" arcs were pruned"<<std::endl;
-
-      // Remove non-useful states from word-graph
-  wg_ptr_aux->obtainWgComposedOfUsefulStates();
+    preprocWg(wg_ptr_aux,verbose);
+  }
   
       // Initialize word-graph processor with word-graph
   wgp_ptr->link_wg(wg_ptr_aux);
@@ -265,6 +270,23 @@ WgUncoupledAssistedTrans<SMT_MODEL>::obtainWgUsingWgHandler(std::string s,
   std::string wgPathStr=wgh_ptr->pathAssociatedToSentence(sentStrVec,found);
   if(found)
   {
+        // Obtain current component weights
+    std::vector<std::pair<std::string,float> > currCompWeights;
+    SMT_MODEL* smtm_ptr=sdr_ptr->get_smt_model_ptr();
+    smtm_ptr->getWeights(currCompWeights);
+    std::vector<float> currWeightVec;
+    for(unsigned int i=0;i<currCompWeights.size();++i)
+      currWeightVec.push_back(currCompWeights[i].second);
+
+        // Reuse word graph if it was already preprocessed for another
+        // CAT session
+    if(wgh_ptr->obtainPreprocWg(wgPathStr,currWeightVec,wgp,wgpp,*wg_ptr,completeHypReachable))
+    {
+      if(verbose)
+        std::cerr<<"Reusing preprocessed word graph "<<wgPathStr<<std::endl;
+      return wg_ptr;
+    }
+    
         // Load word graph
     wg_ptr->clear();
     wg_ptr->load(wgPathStr.c_str());
@@ -285,9 +307,6 @@ WgUncoupledAssistedTrans<SMT_MODEL>::obtainWgUsingWgHandler(std::string s,
         // Set current component weights (this operation causes a
         // complete re-scoring of the word graph arcs if there exist
         // score component information for them)
-    std::vector<std::pair<std::string,float> > currCompWeights;
-    SMT_MODEL* smtm_ptr=sdr_ptr->get_smt_model_ptr();
-    smtm_ptr->getWeights(currCompWeights);
     wg_ptr->setCompWeights(currCompWeights);
 
         // Print component weight info to the error output
@@ -306,6 +325,10 @@ WgUncoupledAssistedTrans<SMT_MODEL>::obtainWgUsingWgHandler(std::string s,
 
     if(score!=SMALL_SCORE)
       completeHypReachable=true;
+
+        // Preprocess word graph and share it with other CAT sessions
+    preprocWg(wg_ptr,verbose);
+    wgh_ptr->storePreprocWg(wgPathStr,currWeightVec,wgp,wgpp,*wg_ptr,completeHypReachable);
     return wg_ptr;
   }
   else
@@ -338,6 +361,33 @@ WgUncoupledAssistedTrans<SMT_MODEL>::obtainWgUsingTranslator(std::string s,
   return sdr_ptr->getWordGraphPtr();
 }
 
+//---------------------------------
+template<class SMT_MODEL>
+void WgUncoupledAssistedTrans<SMT_MODEL>::preprocWg(WordGraph* wg_ptr_aux,
+                                                    unsigned int verbose/*=0*/)
+{
+      // Prune word-graph
+  unsigned int numPrunedArcs=wg_ptr_aux->prune(wgp);
+  if(verbose)
+    std::cerr<<numPrunedArcs<<" arcs were pruned"<<std::endl;
+
+      // Prune arcs with low posterior probability, the arcs of the
+      // best path are kept
+  if(wgpp>0)
+  {
+    numPrunedArcs=wg_ptr_aux->pruneGivenPosteriors(wgpp);
+    if(verbose)
+      std::cerr<<numPrunedArcs<<" arcs were pruned given their posteriors"<<std::endl;
+  }
+
+      // Remove non-useful states from word-graph
+  wg_ptr_aux->obtainWgComposedOfUsefulStates();
+
+      // Precompute rest scores, they are cached in the word graph
+  std::vector<Score> restScores;
+  wg_ptr_aux->obtainRestScores(restScores);
+}
+
 //---------------------------------
 template<class SMT_MODEL>
 std::string WgUncoupledAssistedTrans<SMT_MODEL>::addStrToPrefix(std::string s,
@@ -421,4 +471,11 @@ void WgUncoupledAssistedTrans<SMT_MODEL>::set_wgp(float _wgp)
   wgp=_wgp;
 }
 
+//---------------------------------
+template<class SMT_MODEL>
+void WgUncoupledAssistedTrans<SMT_MODEL>::set_wgpp(float _wgpp)
+{
+  wgpp=_wgpp;
+}
+
 #endif
@@ -1097,6 +1097,15 @@ void _pbTransModel<HYPOTHESIS>::clearTempVars(void)
 
       // Clear n-best translation cache data
   nbTransCacheData.clear();
+
+      // Clear language model scores cached by the calling thread
+  if(standardFeaturesInfoPtr!=NULL)
+  {
+    std::vector<unsigned int> featIndexVec;
+    std::vector<LangModelFeat<HypScoreInfo>* > langModelFeatPtrs=standardFeaturesInfoPtr->getLangModelFeatPtrs(featIndexVec);
+    for(unsigned int i=0;i<langModelFeatPtrs.size();++i)
+      langModelFeatPtrs[i]->clearScoreCache();
+  }
 }
 
 //---------------------------------------
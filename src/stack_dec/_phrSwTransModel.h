@@ -36,6 +36,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "_phraseBasedTransModel.h"
 #include "SwModelInfo.h"
 #include "ModelDescriptorUtils.h"
+#include "SmtModelUtils.h"
+#include <set>
 
 //--------------- Constants ------------------------------------------
 
@@ -71,6 +73,11 @@ class _phrSwTransModel: public _phraseBasedTransModel<HYPOTHESIS>
       // Link sw model information
   void link_swm_info(SwModelInfo* _swModelInfoPtr);
 
+      // Restrict the single word model parameters obtained by
+      // loadAligModel() to those required to translate sentences with
+      // the given source vocabulary
+  void setSwmSrcVocabFilter(const std::set<std::string>& srcVocab);
+
       // Init alignment model
   bool loadAligModel(const char* prefixFileName);
 
@@ -98,6 +105,10 @@ class _phrSwTransModel: public _phraseBasedTransModel<HYPOTHESIS>
       // SwModelInfo pointer
   SwModelInfo* swModelInfoPtr;
 
+      // Vocabulary filter for single word models
+  bool swmSrcVocabFilterEnabled;
+  std::set<std::string> swmSrcVocabFilter;
+
       // Precalculated lgProbs
   std::vector<std::vector<Prob> > sumSentLenProbVec;
       // sumSentLenProbVec[slen][tlen] stores p(sl=slen|tl<=tlen)
@@ -154,6 +165,7 @@ class _phrSwTransModel: public _phraseBasedTransModel<HYPOTHESIS>
 template<class HYPOTHESIS>
 _phrSwTransModel<HYPOTHESIS>::_phrSwTransModel(void):_phraseBasedTransModel<HYPOTHESIS>()
 {
+  swmSrcVocabFilterEnabled=false;
 }
 
 //---------------------------------
@@ -163,6 +175,14 @@ void _phrSwTransModel<HYPOTHESIS>::link_swm_info(SwModelInfo* _swModelInfoPtr)
   swModelInfoPtr=_swModelInfoPtr;
 }
 
+//---------------------------------
+template<class HYPOTHESIS>
+void _phrSwTransModel<HYPOTHESIS>::setSwmSrcVocabFilter(const std::set<std::string>& srcVocab)
+{
+  swmSrcVocabFilterEnabled=true;
+  swmSrcVocabFilter=srcVocab;
+}
+
 //---------------------------------
 template<class HYPOTHESIS>
 bool _phrSwTransModel<HYPOTHESIS>::loadMultipleSwModelsPrefix(const char* prefixFileName)
@@ -176,6 +196,8 @@ bool _phrSwTransModel<HYPOTHESIS>::loadMultipleSwModelsPrefix(const char* prefix
   std::string invReadTablePrefix=prefixFileName;
   invReadTablePrefix+="_invswm";
   swModelInfoPtr->swModelPars.readTablePrefixVec.push_back(invReadTablePrefix);
+  if(swmSrcVocabFilterEnabled)
+    SmtModelUtils::setDirectSwModelSrcVocabFilter(swModelInfoPtr->swAligModelPtrVec[0],swmSrcVocabFilter);
   bool ret=swModelInfoPtr->swAligModelPtrVec[0]->load(invReadTablePrefix.c_str());
   if(ret==THOT_ERROR) return THOT_ERROR;
   
@@ -183,6 +205,8 @@ bool _phrSwTransModel<HYPOTHESIS>::loadMultipleSwModelsPrefix(const char* prefix
   std::string readTablePrefix=prefixFileName;
   readTablePrefix+="_swm";
   swModelInfoPtr->invSwModelPars.readTablePrefixVec.push_back(readTablePrefix);
+  if(swmSrcVocabFilterEnabled)
+    SmtModelUtils::setInverseSwModelSrcVocabFilter(swModelInfoPtr->invSwAligModelPtrVec[0],swmSrcVocabFilter);
   ret=swModelInfoPtr->invSwAligModelPtrVec[0]->load(readTablePrefix.c_str());
   if(ret==THOT_ERROR) return THOT_ERROR;
 
@@ -209,12 +233,16 @@ bool _phrSwTransModel<HYPOTHESIS>::loadMultipleSwModelsDescriptor(std::vector<Mo
         // sw model (The direct model is the one with the prefix _invswm)
     std::string readTablePrefix=modelDescEntryVec[i].absolutizedModelFileName+"_invswm";
     swModelInfoPtr->swModelPars.readTablePrefixVec.push_back(readTablePrefix);
+    if(swmSrcVocabFilterEnabled)
+      SmtModelUtils::setDirectSwModelSrcVocabFilter(swModelInfoPtr->swAligModelPtrVec[i],swmSrcVocabFilter);
     bool ret=swModelInfoPtr->swAligModelPtrVec[i]->load(readTablePrefix.c_str());
     if(ret==THOT_ERROR) return THOT_ERROR;
     
         // Inverse sw model
     readTablePrefix=modelDescEntryVec[i].absolutizedModelFileName+"_swm";
     swModelInfoPtr->invSwModelPars.readTablePrefixVec.push_back(readTablePrefix);
+    if(swmSrcVocabFilterEnabled)
+      SmtModelUtils::setInverseSwModelSrcVocabFilter(swModelInfoPtr->invSwAligModelPtrVec[i],swmSrcVocabFilter);
     ret=swModelInfoPtr->invSwAligModelPtrVec[i]->load(readTablePrefix.c_str());
     if(ret==THOT_ERROR) return THOT_ERROR;
     
@@ -1589,14 +1589,14 @@ std::pair<Count,std::string>
 _phraseBasedTransModel<HYPOTHESIS>::getBestSuffixGivenHist(std::vector<std::string> hist,
                                                            std::string input)
 {
-  WordPredictor::SuffixList suffixList;
-  WordPredictor::SuffixList::iterator suffixListIter;
+  WordPredictor::NbestSuffixList suffixList;
+  WordPredictor::NbestSuffixList::iterator suffixListIter;
   LgProb lp;
   LgProb maxlp=-FLT_MAX;
   std::pair<Count,std::string> bestCountSuffix;
 
-      // Get suffix list for input
-  langModelInfoPtr->wordPredictor.getSuffixList(input,suffixList);
+      // Get list of best suffixes for input
+  langModelInfoPtr->wordPredictor.getNbestSuffixList(input,suffixList);
   if(suffixList.size()==0)
   {
         // There are not any suffix
@@ -36,6 +36,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include "_stackDecoder.h"
 #include "HypStateDict.h"
 #include "WordGraph.h"
+#include "WgContainerWriter.h"
 
 //--------------- Constants ------------------------------------------
 
@@ -71,6 +72,8 @@ class _stackDecoderRec: public _stackDecoder<SMT_MODEL>
       // Enable word graph
   void disableWordGraph(void);
       // Disable word graph
+  bool isWordGraphEnabled(void)const;
+      // Returns true if the word graph is enabled
   void includeScoreCompsInWg(void);
       // Include score componentes in word graph
   void excludeScoreCompsInWg(void);
@@ -80,7 +83,12 @@ class _stackDecoderRec: public _stackDecoder<SMT_MODEL>
       // pruned arcs
      
       // Functions to print word graphs
-  bool printWordGraph(const char* filename);
+  bool printWordGraph(const char* filename,
+                      bool binary=false);
+  bool printWordGraph(WgContainerWriter& wgContainerWriter,
+                      unsigned int sentId);
+      // Adds the word graph of the given sentence to a word graph
+      // container. The hypothesis state index info is not stored
   
 
   void clear(void);
@@ -114,6 +122,9 @@ class _stackDecoderRec: public _stackDecoder<SMT_MODEL>
       // value of existIndex will be set to true, and false otherwise
   bool printHypStateIdxInfo(const char* filename);
   void printHypStateIdxInfo(std::ostream &outS);
+  void setWordGraphCompWeights(void);
+      // Stores the weights of the score components in the word graph
+      // if they are included
 };
 
 //--------------- _stackDecoderRec template class function definitions
@@ -144,6 +155,13 @@ void _stackDecoderRec<SMT_MODEL>::disableWordGraph(void)
   wordGraphEnabled=false;
 }
 
+//---------------------------------------
+template<class SMT_MODEL>
+bool _stackDecoderRec<SMT_MODEL>::isWordGraphEnabled(void)const
+{
+  return wordGraphEnabled;
+}
+
 //---------------------------------------
 template<class SMT_MODEL>
 void _stackDecoderRec<SMT_MODEL>::includeScoreCompsInWg(void)
@@ -187,25 +205,24 @@ unsigned int _stackDecoderRec<SMT_MODEL>::pruneWordGraph(float threshold)
 
 //---------------------------------------
 template<class SMT_MODEL>
-bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename)
+bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename,
+                                                 bool binary/*=false*/)
 {
   int ret;
 
-  if(scoreCompsInWgIncluded)
-  {
-        // Set weights of the components in the wordgraph (this may be
-        // misplaced)
-    std::vector<std::pair<std::string,float> > compWeights;
-    this->smtm_ptr->getWeights(compWeights);
-    wordGraphPtr->setCompWeights(compWeights);
-  }
+  setWordGraphCompWeights();
+
       // Print word graph
   std::string filenameWordGraph=filename;
   filenameWordGraph=filenameWordGraph+".wg";
-  ret=wordGraphPtr->print(filenameWordGraph.c_str(),true);
+  if(binary)
+    ret=wordGraphPtr->printBinary(filenameWordGraph.c_str(),true);
+  else
+    ret=wordGraphPtr->print(filenameWordGraph.c_str(),true);
       // NOTE: if the second parameter of wordGraphPtr->print() is set to
       // true, only useful states (those that allow us to reach to a
-      // final state) are printed
+      // final state) are printed. Word graphs in binary format are
+      // also read by the WordGraph::load() function
   if(ret==THOT_ERROR) return THOT_ERROR;
   
       // Print state index info
@@ -214,6 +231,29 @@ bool _stackDecoderRec<SMT_MODEL>::printWordGraph(const char* filename)
   return printHypStateIdxInfo(filenameHypStateIdx.c_str());
 }
 
+//---------------------------------------
+template<class SMT_MODEL>
+bool _stackDecoderRec<SMT_MODEL>::printWordGraph(WgContainerWriter& wgContainerWriter,
+                                                 unsigned int sentId)
+{
+  setWordGraphCompWeights();
+  return wgContainerWriter.addWordGraph(sentId,*wordGraphPtr,true);
+}
+
+//---------------------------------------
+template<class SMT_MODEL>
+void _stackDecoderRec<SMT_MODEL>::setWordGraphCompWeights(void)
+{
+  if(scoreCompsInWgIncluded)
+  {
+        // Set weights of the components in the wordgraph (this may be
+        // misplaced)
+    std::vector<std::pair<std::string,float> > compWeights;
+    this->smtm_ptr->getWeights(compWeights);
+    wordGraphPtr->setCompWeights(compWeights);
+  }
+}
+
 //---------------------------------------
 template<class SMT_MODEL>
 void _stackDecoderRec<SMT_MODEL>::clear(void)
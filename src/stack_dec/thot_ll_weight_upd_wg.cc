@@ -0,0 +1,401 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_ll_weight_upd_wg.cc
+ *
+ * @brief Implements a log-linear weight updater given a set of word
+ * graphs (lattice MERT).
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include "BaseScorer.h"
+#include "WgMertLlWu.h"
+#include "WordGraph.h"
+
+#include "DynClassFactoryHandler.h"
+#include "AwkInputStream.h"
+#include "ErrorDefs.h"
+#include "options.h"
+#include <iostream>
+
+//--------------- Constants ------------------------------------------
+
+struct thot_llwu_wg_pars
+{
+  std::vector<float> llWeightVec;
+  std::vector<std::string> includeVarStr;
+  std::vector<bool> includeVarBool;
+  std::string fileWithWordGraphs;
+  std::string fileWithReferences;
+  int numRandDirs;
+  int maxIters;
+  bool verbose;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_llwu_wg_pars& pars);
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_llwu_wg_pars& pars);
+int checkParameters(thot_llwu_wg_pars& pars);
+
+int obtain_references(const thot_llwu_wg_pars& pars,
+                      std::vector<std::string>& referenceVec);
+int obtain_word_graphs(const thot_llwu_wg_pars& pars,
+                       std::vector<WordGraph*>& wgPtrVec);
+int update_ll_weights(const thot_llwu_wg_pars& pars);
+void printUsage(void);
+void version(void);
+
+//--------------- Global variables -----------------------------------
+
+DynClassFactoryHandler dynClassFactoryHandler;
+BaseScorer* baseScorerPtr;
+
+//--------------- Function Definitions -------------------------------
+
+//--------------------------------
+int main(int argc,char *argv[])
+{
+  thot_llwu_wg_pars pars;
+
+  if(handleParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+        // Print parameters
+    std::cerr<<"-w option is";
+    for(unsigned int i=0;i<pars.llWeightVec.size();++i)
+      std::cerr<<" "<<pars.llWeightVec[i];
+    std::cerr<<std::endl;
+    std::cerr<<"-wg option is "<<pars.fileWithWordGraphs<<std::endl;
+    std::cerr<<"-r option is "<<pars.fileWithReferences<<std::endl;
+    std::cerr<<"-va option is";
+    for(unsigned int i=0;i<pars.includeVarStr.size();++i)
+      std::cerr<<" "<<pars.includeVarBool[i];
+    std::cerr<<std::endl;
+    std::cerr<<"-nrd option is "<<pars.numRandDirs<<std::endl;
+    std::cerr<<"-maxit option is "<<pars.maxIters<<std::endl;
+
+        // Initialize pointers
+    int err=dynClassFactoryHandler.init_smt(THOT_MASTER_INI_PATH,false);
+    if(err==THOT_ERROR)
+      return THOT_ERROR;
+
+    baseScorerPtr=dynClassFactoryHandler.baseScorerDynClassLoader.make_obj(dynClassFactoryHandler.baseScorerInitPars);
+    if(baseScorerPtr==NULL)
+    {
+      std::cerr<<"Error: BaseScorer pointer could not be instantiated"<<std::endl;
+      return THOT_ERROR;
+    }
+
+        // Update log-linear weights
+    int retVal=update_ll_weights(pars);
+
+        // Release pointers
+    delete baseScorerPtr;
+
+        // Release class factories
+    dynClassFactoryHandler.release_smt(false);
+
+    return retVal;
+  }
+}
+
+//--------------------------------
+int handleParameters(int argc,
+                     char *argv[],
+                     thot_llwu_wg_pars& pars)
+{
+  if(argc==1 || readOption(argc,argv,"--version")!=-1)
+  {
+    version();
+    return THOT_ERROR;
+  }
+  if(readOption(argc,argv,"--help")!=-1)
+  {
+    printUsage();
+    return THOT_ERROR;
+  }
+  if(takeParameters(argc,argv,pars)==THOT_ERROR)
+  {
+    return THOT_ERROR;
+  }
+  else
+  {
+    if(checkParameters(pars)==THOT_OK)
+    {
+      return THOT_OK;
+    }
+    else
+    {
+      return THOT_ERROR;
+    }
+  }
+}
+
+//--------------------------------
+int takeParameters(int argc,
+                   char *argv[],
+                   thot_llwu_wg_pars& pars)
+{
+      // Take -wg parameter
+  int err=readSTLstring(argc,argv, "-wg", &pars.fileWithWordGraphs);
+  if(err==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Take -r parameter
+  err=readSTLstring(argc,argv, "-r", &pars.fileWithReferences);
+  if(err==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Obtain included variables
+  err=readStringSeq(argc,argv, "-va", pars.includeVarStr);
+  if(err==THOT_ERROR)
+    return THOT_ERROR;
+  else
+  {
+    for(unsigned int i=0;i<pars.includeVarStr.size();++i)
+    {
+      pars.includeVarBool.push_back(atoi(pars.includeVarStr[i].c_str()));
+    }
+  }
+
+      // Obtain weight vector used to generate the word graphs
+  err=readFloatSeq(argc,argv, "-w", pars.llWeightVec);
+  if(err==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Take -nrd parameter
+  if(readInt(argc,argv, "-nrd", &pars.numRandDirs)==-1)
+    pars.numRandDirs=WGMERT_DEFAULT_NUM_RAND_DIRS;
+
+      // Take -maxit parameter
+  if(readInt(argc,argv, "-maxit", &pars.maxIters)==-1)
+    pars.maxIters=WGMERT_DEFAULT_MAX_ITERS;
+
+  pars.verbose=(readOption(argc,argv,"-v")!=-1);
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int checkParameters(thot_llwu_wg_pars& pars)
+{
+  if(pars.fileWithWordGraphs.empty())
+  {
+    std::cerr<<"Error: parameter -wg not given!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(pars.fileWithReferences.empty())
+  {
+    std::cerr<<"Error: parameter -r not given!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(!pars.llWeightVec.empty() && !pars.includeVarStr.empty() && pars.includeVarStr.size()!=pars.llWeightVec.size())
+  {
+    std::cerr<<"Error: number of weights provided by -w and -va options are not equal!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  if(pars.numRandDirs<0 || pars.maxIters<0)
+  {
+    std::cerr<<"Error: -nrd and -maxit values should not be negative!"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int obtain_references(const thot_llwu_wg_pars& pars,
+                      std::vector<std::string>& referenceVec)
+{
+      // Clear output variable
+  referenceVec.clear();
+
+      // Fill output variable
+  AwkInputStream awk;
+
+  if(awk.open(pars.fileWithReferences.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<pars.fileWithReferences<<std::endl;
+    return THOT_ERROR;
+  }
+
+  while(awk.getln())
+  {
+    referenceVec.push_back(awk.dollar(0));
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int obtain_word_graphs(const thot_llwu_wg_pars& pars,
+                       std::vector<WordGraph*>& wgPtrVec)
+{
+  AwkInputStream awk;
+
+  if(awk.open(pars.fileWithWordGraphs.c_str())==THOT_ERROR)
+  {
+    std::cerr<<"Error while opening file "<<pars.fileWithWordGraphs<<std::endl;
+    return THOT_ERROR;
+  }
+
+  while(awk.getln())
+  {
+        // Load word graph
+    WordGraph* wgPtr=new WordGraph;
+    wgPtrVec.push_back(wgPtr);
+    if(wgPtr->load(awk.dollar(0).c_str())==THOT_ERROR)
+      return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//--------------------------------
+int update_ll_weights(const thot_llwu_wg_pars& pars)
+{
+  int retVal;
+  std::vector<std::string> referenceVec;
+  std::vector<WordGraph*> wgPtrVec;
+
+      // Obtain references
+  retVal=obtain_references(pars,referenceVec);
+  if(retVal==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Obtain word graphs
+  retVal=obtain_word_graphs(pars,wgPtrVec);
+  if(retVal==THOT_OK && referenceVec.size()!=wgPtrVec.size())
+  {
+    std::cerr<<"Error: number of references and word graphs are not equal!"<<std::endl;
+    retVal=THOT_ERROR;
+  }
+
+  if(retVal==THOT_OK)
+  {
+        // Generate vector with current weights, the weights of the
+        // first word graph are used if -w option was not given
+    std::vector<double> currWeightsVec;
+    if(pars.llWeightVec.empty())
+    {
+      std::vector<std::pair<std::string,float> > compWeights;
+      if(!wgPtrVec.empty())
+        wgPtrVec[0]->getCompWeights(compWeights);
+      for(unsigned int i=0;i<compWeights.size();++i)
+        currWeightsVec.push_back(compWeights[i].second);
+    }
+    else
+    {
+      for(unsigned int i=0;i<pars.llWeightVec.size();++i)
+        currWeightsVec.push_back(pars.llWeightVec[i]);
+    }
+    if(!pars.includeVarBool.empty() && pars.includeVarBool.size()!=currWeightsVec.size())
+    {
+      std::cerr<<"Error: number of weights and values provided by -va option are not equal!"<<std::endl;
+      retVal=THOT_ERROR;
+    }
+    else
+    {
+          // Update log-linear weights
+      WgMertLlWu wgMertLlWu(pars.numRandDirs,pars.maxIters);
+      if(!wgMertLlWu.link_scorer(baseScorerPtr))
+      {
+        std::cerr<<"Error: Scorer class could not be linked to log-linear weight updater"<<std::endl;
+        retVal=THOT_ERROR;
+      }
+      else
+      {
+        std::vector<const WordGraph*> constWgPtrVec(wgPtrVec.begin(),wgPtrVec.end());
+        std::vector<double> newWeightsVec;
+        retVal=wgMertLlWu.tune(referenceVec,
+                               constWgPtrVec,
+                               currWeightsVec,
+                               pars.includeVarBool,
+                               newWeightsVec,
+                               pars.verbose);
+        if(retVal==THOT_OK)
+        {
+              // Print result
+          std::cout<<"Updated weights:";
+          for(unsigned int i=0;i<newWeightsVec.size();++i)
+            std::cout<<" "<<newWeightsVec[i];
+          std::cout<<std::endl;
+          std::cerr<<"Score with updated weights: "<<wgMertLlWu.getTunedScore()<<std::endl;
+        }
+      }
+    }
+  }
+
+      // Release word graphs
+  for(unsigned int i=0;i<wgPtrVec.size();++i)
+    delete wgPtrVec[i];
+
+  return retVal;
+}
+
+//--------------------------------
+void printUsage(void)
+{
+  std::cerr<<"thot_ll_weight_upd_wg     [-w <float> ... <float>]"<<std::endl;
+  std::cerr<<"                          [-va <bool> ... <bool>]"<<std::endl;
+  std::cerr<<"                          -wg <string> -r <string>"<<std::endl;
+  std::cerr<<"                          [-nrd <int>] [-maxit <int>] [-v]"<<std::endl;
+  std::cerr<<"                          [--help] [--version]"<<std::endl;
+  std::cerr<<std::endl;
+  std::cerr<<"-w <float>...<float>     Initial weights (weights stored in the first word"<<std::endl;
+  std::cerr<<"                         graph by default)."<<std::endl;
+  std::cerr<<"-va <bool>...<bool>      Set variable values to be excluded or included."<<std::endl;
+  std::cerr<<"                         Each value equal to 0 excludes the variable and values"<<std::endl;
+  std::cerr<<"                         equal to 1 include the variable. Excluded variables"<<std::endl;
+  std::cerr<<"                         keep their initial weight."<<std::endl;
+  std::cerr<<"-wg <string>             File containing the names of files with word graphs."<<std::endl;
+  std::cerr<<"                         Word graphs should contain score components."<<std::endl;
+  std::cerr<<"-r <string>              File with reference sentences associated to each"<<std::endl;
+  std::cerr<<"                         word graph."<<std::endl;
+  std::cerr<<"-nrd <int>               Number of random search directions per iteration"<<std::endl;
+  std::cerr<<"                         ("<<WGMERT_DEFAULT_NUM_RAND_DIRS<<" by default)."<<std::endl;
+  std::cerr<<"-maxit <int>             Maximum number of iterations ("<<WGMERT_DEFAULT_MAX_ITERS<<" by default)."<<std::endl;
+  std::cerr<<"-v                       Verbose mode."<<std::endl;
+  std::cerr<<"--help                   Display this help and exit."<<std::endl;
+  std::cerr<<"--version                Output version information and exit."<<std::endl;
+}
+
+//--------------------------------
+void version(void)
+{
+  std::cerr<<"thot_ll_weight_upd_wg is part of the thot package"<<std::endl;
+  std::cerr<<"thot version "<<THOT_VERSION<<std::endl;
+  std::cerr<<"thot is GNU software written by Daniel Ortiz"<<std::endl;
+}
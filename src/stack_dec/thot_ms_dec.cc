@@ -79,6 +79,7 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 struct thot_ms_dec_pars
 {
   bool be;
+  bool swmVocabFilter;
   float W;
   int A,nomon,S,I,G,heuristic,verbosity;
   std::string sourceSentencesFile;
@@ -88,6 +89,8 @@ struct thot_ms_dec_pars
   std::string wordGraphFileName;
   std::string outFile;
   float wgPruningThreshold;
+  bool wgBinary;
+  bool wgContainer;
   std::vector<float> weightVec;
 
   thot_ms_dec_pars()
@@ -100,8 +103,11 @@ struct thot_ms_dec_pars
       G=PMSTACK_G_DEFAULT;
       heuristic=PMSTACK_H_DEFAULT;
       be=0;
+      swmVocabFilter=false;
       wgPruningThreshold=DISABLE_WORDGRAPH;
       wgPruningThreshold=UNLIMITED_DENSITY;
+      wgBinary=false;
+      wgContainer=false;
       verbosity=0;
     }
 };
@@ -118,6 +124,8 @@ void release_translator_legacy_impl(void);
 void release_translator_feat_impl(void);
 void release_translator(void);
 int translate_corpus(const thot_ms_dec_pars& tdp);
+int obtainTestCorpusVocab(std::string testCorpusFileName,
+                          std::set<std::string>& vocab);
 std::vector<std::string> stringToStringVector(std::string s);
 void version(void);
 int handleParameters(int argc,
@@ -319,6 +327,20 @@ int init_translator_legacy_impl(const thot_ms_dec_pars& tdp)
   if(base_pbswtm_ptr)
   {
     base_pbswtm_ptr->link_swm_info(swModelInfoPtr);
+
+        // Restrict sw model parameters to test corpus vocabulary if
+        // requested
+    if(tdp.swmVocabFilter)
+    {
+      std::set<std::string> testVocab;
+      ret=obtainTestCorpusVocab(tdp.sourceSentencesFile,testVocab);
+      if(ret==THOT_ERROR)
+      {
+        release_translator();
+        return THOT_ERROR;
+      }
+      base_pbswtm_ptr->setSwmSrcVocabFilter(testVocab);
+    }
   }
 
   if(phrbtm_ptr)
@@ -472,6 +494,17 @@ int init_translator_feat_impl(const thot_ms_dec_pars& tdp)
 
       // Set default models for standard feature handler
   set_default_models();
+
+      // Restrict sw model parameters to test corpus vocabulary if
+      // requested
+  if(tdp.swmVocabFilter)
+  {
+    std::set<std::string> testVocab;
+    ret=obtainTestCorpusVocab(tdp.sourceSentencesFile,testVocab);
+    if(ret==THOT_ERROR)
+      return THOT_ERROR;
+    stdFeatureHandler.setSwmSrcVocabFilter(testVocab);
+  }
   
       // Load model features
   ret=load_model_features(tdp);
@@ -631,6 +664,18 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
       outS.open(tdp.outFile.c_str(),std::ios::out);
       if(!outS) std::cerr<<"Error while opening output file."<<std::endl;
     }
+
+        // Open word graph container if required
+    WgContainerWriter wgContainerWriter;
+    if(stackDecoderRecPtr && tdp.wordGraphFileName!="" && tdp.wgContainer)
+    {
+      std::string wgContainerFileName=tdp.wordGraphFileName+".wgc";
+      if(wgContainerWriter.open(wgContainerFileName.c_str())==THOT_ERROR)
+      {
+        testCorpusFile.close();
+        return THOT_ERROR;
+      }
+    }
     
         // Translate corpus sentences
     while(!testCorpusFile.eof())
@@ -676,10 +721,17 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
             // Print wordgraph if the -wg option was given
         if(tdp.wordGraphFileName!="")
         {
-          char wgFileNameForSent[256];
-          sprintf(wgFileNameForSent,"%s_%06d",tdp.wordGraphFileName.c_str(),sentNo);
           stackDecoderRecPtr->pruneWordGraph(tdp.wgPruningThreshold);
-          stackDecoderRecPtr->printWordGraph(wgFileNameForSent);
+          if(tdp.wgContainer)
+          {
+            stackDecoderRecPtr->printWordGraph(wgContainerWriter,sentNo);
+          }
+          else
+          {
+            char wgFileNameForSent[256];
+            sprintf(wgFileNameForSent,"%s_%06d",tdp.wordGraphFileName.c_str(),sentNo);
+            stackDecoderRecPtr->printWordGraph(wgFileNameForSent,tdp.wgBinary);
+          }
         }
       }
 
@@ -704,6 +756,13 @@ int translate_corpus(const thot_ms_dec_pars& tdp)
       outS.close();
     }
 
+        // Close word graph container
+    if(wgContainerWriter.isOpen() && wgContainerWriter.close()==THOT_ERROR)
+    {
+      testCorpusFile.close();
+      return THOT_ERROR;
+    }
+
         // Close test corpus file
     testCorpusFile.close();
   }
@@ -849,6 +908,13 @@ void takeParametersGivenArgcArgv(int argc,
  {
    tdp.be=1;
  }      
+
+       // read -swf option
+ err=readOption(argc,argv,"-swf");
+ if(err!=-1)
+ {
+   tdp.swmVocabFilter=true;
+ }
      
      // Take -tmw parameter
  err=readFloatSeq(argc,argv, "-tmw", tdp.weightVec);
@@ -859,6 +925,16 @@ void takeParametersGivenArgcArgv(int argc,
  {
        // Take -wgp parameter 
    err=readFloat(argc,argv, "-wgp", &tdp.wgPruningThreshold);
+
+       // Take -wgb parameter
+   err=readOption(argc,argv,"-wgb");
+   if(err!=-1)
+     tdp.wgBinary=true;
+
+       // Take -wgc parameter
+   err=readOption(argc,argv,"-wgc");
+   if(err!=-1)
+     tdp.wgContainer=true;
  }
 
      // Take verbosity parameter
@@ -931,6 +1007,7 @@ void printParameters(const thot_ms_dec_pars& tdp)
 #endif
  std::cerr<<"h: "<<tdp.heuristic<<std::endl;
  std::cerr<<"be: "<<tdp.be<<std::endl;
+ std::cerr<<"swf: "<<tdp.swmVocabFilter<<std::endl;
  std::cerr<<"nomon: "<<tdp.nomon<<std::endl;
  std::cerr<<"weight vector:";
  for(unsigned int i=0;i<tdp.weightVec.size();++i)
@@ -946,6 +1023,10 @@ void printParameters(const thot_ms_dec_pars& tdp)
      std::cerr<<"word graph pruning threshold: word graph density unrestricted"<<std::endl;
    else
      std::cerr<<"word graph pruning threshold: "<<tdp.wgPruningThreshold<<std::endl;
+   if(tdp.wgBinary)
+     std::cerr<<"word graphs are printed in binary format"<<std::endl;
+   if(tdp.wgContainer)
+     std::cerr<<"word graphs are stored in container "<<tdp.wordGraphFileName<<".wgc"<<std::endl;
  }
  else
  {
@@ -954,6 +1035,29 @@ void printParameters(const thot_ms_dec_pars& tdp)
  std::cerr<<"verbosity level: "<<tdp.verbosity<<std::endl;
 }
 
+//---------------
+int obtainTestCorpusVocab(std::string testCorpusFileName,
+                          std::set<std::string>& vocab)
+{
+  std::ifstream testCorpusFile;
+  testCorpusFile.open(testCorpusFileName.c_str());
+  if(!testCorpusFile)
+  {
+    std::cerr<<"Test sentences file could not be opened"<<std::endl;
+    return THOT_ERROR;
+  }
+
+  vocab.clear();
+  std::string srcSentenceString;
+  while(getline(testCorpusFile,srcSentenceString))
+  {
+    std::vector<std::string> srcSentStrVec=stringToStringVector(srcSentenceString);
+    vocab.insert(srcSentStrVec.begin(),srcSentStrVec.end());
+  }
+  std::cerr<<"Single word models restricted to a test vocabulary of "<<vocab.size()<<" words"<<std::endl;
+  return THOT_OK;
+}
+
 //---------------
 std::vector<std::string> stringToStringVector(std::string s)
 {
@@ -979,7 +1083,8 @@ void printUsage(void)
   std::cerr << "                 [-W <float>] [-S <int>] [-A <int>]"<<std::endl;
   std::cerr << "                 [-I <int>] [-G <int>] [-h <int>]"<<std::endl;
   std::cerr << "                 [-be] [ -nomon <int>] [-tmw <float> ... <float>]"<<std::endl;
-  std::cerr << "                 [-wg <string> [-wgp <float>] ]"<<std::endl;
+  std::cerr << "                 [-swf]"<<std::endl;
+  std::cerr << "                 [-wg <string> [-wgp <float>] [-wgb] [-wgc] ]"<<std::endl;
   std::cerr << "                 [-v|-v1|-v2]"<<std::endl;
   std::cerr << "                 [--help] [--version]"<<std::endl<<std::endl;
   std::cerr << " -c <string>           : Configuration file (command-line options override"<<std::endl;
@@ -1010,6 +1115,9 @@ void printUsage(void)
   std::cerr << "                         to skip up to <int> words from the last aligned source"<<std::endl;
   std::cerr << "                         words. If <int> is equal to zero, then a monotonic"<<std::endl;
   std::cerr << "                         search is performed ("<<PMSTACK_NOMON_DEFAULT<<" is the default value)."<<std::endl;
+  std::cerr << " -swf                  : Load only the single word model parameters required"<<std::endl;
+  std::cerr << "                         to translate the test sentences (reduces memory"<<std::endl;
+  std::cerr << "                         usage and loading time)."<<std::endl;
   std::cerr << " -tmw <float>...<float>: Set model weights, the number of weights and their"<<std::endl;
   std::cerr << "                         meaning depends on the model type (use --config"<<std::endl;
   std::cerr << "                         option)."<<std::endl;
@@ -1021,6 +1129,12 @@ void printUsage(void)
   std::cerr << "                                       state is retained.\n";
   std::cerr << "                         If not given, the number of arcs is not\n";
   std::cerr << "                         restricted.\n";
+  std::cerr << " -wgb                  : Print word graphs in binary format (smaller and faster\n";
+  std::cerr << "                         to load).\n";
+  std::cerr << " -wgc                  : Store all word graphs in binary format in a single\n";
+  std::cerr << "                         container file (<string>.wgc), written by a\n";
+  std::cerr << "                         background thread. Hypothesis state index files\n";
+  std::cerr << "                         are not generated.\n";
   std::cerr << " -v|-v1|-v2            : verbose modes."<<std::endl;
   std::cerr << " --help                : Display this help and exit."<<std::endl;
   std::cerr << " --version             : Output version information and exit."<<std::endl;
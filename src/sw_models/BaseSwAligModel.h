@@ -36,11 +36,14 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <math.h>
 #include <float.h>
 #include <string>
+#include <vector>
+#include <algorithm>
 #include "AwkInputStream.h"
 #include "SwDefs.h"
 #include <ErrorDefs.h>
 #include <StrProcUtils.h>
 #include <WordAligMatrix.h>
+#include <ThreadPool.h>
 
 //--------------- Constants ------------------------------------------
 
@@ -72,6 +75,11 @@ class BaseSwAligModel
 
     // Thread/Process safety related functions
     virtual bool modelReadsAreProcessSafe(void);
+    virtual bool modelReadsAreThreadSafe(void);
+        // Returns true if the alignment functions can be called by
+        // several threads at the same time. Models whose reads modify
+        // internal state (e.g. caches filled on lookup) must return
+        // false
     
     // Functions to read and add sentence pairs
 	virtual bool readSentencePairs(const char *srcFileName,
@@ -194,6 +202,25 @@ class BaseSwAligModel
         // Obtains the best alignment for the given sentence pair
         // (input parameters are now index vectors) depending on the
         // value of the modelNumber data member.
+    void obtainBestAlignmentBatch(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                  const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                  unsigned int numThreads,
+                                  std::vector<LgProb>& lgProbVec,
+                                  std::vector<WordAligMatrix>& bestWaMatrixVec);
+        // Obtains the best alignments for a batch of sentence pairs
+        // using numThreads threads. Results are returned in the same
+        // order as the given pairs. The model should not be modified
+        // while the batch is being processed. Threads are only used if
+        // modelReadsAreThreadSafe() returns true, otherwise the batch
+        // is processed sequentially
+    void obtainBestAlignmentBatchVecStr(const std::vector<std::vector<std::string> >& srcSentenceVectors,
+                                        const std::vector<std::vector<std::string> >& trgSentenceVectors,
+                                        unsigned int numThreads,
+                                        std::vector<LgProb>& lgProbVec,
+                                        std::vector<WordAligMatrix>& bestWaMatrixVec);
+        // The same as the previous one, but input parameters are
+        // string vectors. Words are converted to indices before
+        // starting the threads
     
     std::ostream& printAligInGizaFormat(const char *sourceSentence,
                                    const char *targetSentence,
@@ -249,6 +276,33 @@ class BaseSwAligModel
     
     // Destructor
 	virtual ~BaseSwAligModel();
+
+ protected:
+
+    virtual void obtainBestAlignmentRange(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                          const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                          unsigned int begin,
+                                          unsigned int end,
+                                          std::vector<LgProb>& lgProbVec,
+                                          std::vector<WordAligMatrix>& bestWaMatrixVec);
+        // Obtains the best alignments for the sentence pairs in the
+        // range [begin,end). Ranges are processed by a single thread,
+        // so derived classes may reuse auxiliary data structures
+        // across the pairs of the range
+
+ private:
+
+    struct AligBatchTask
+    {
+      BaseSwAligModel<PPINFO>* modelPtr;
+      const std::vector<std::vector<WordIndex> >* srcSentIndexVectorsPtr;
+      const std::vector<std::vector<WordIndex> >* trgSentIndexVectorsPtr;
+      unsigned int begin;
+      unsigned int end;
+      std::vector<LgProb>* lgProbVecPtr;
+      std::vector<WordAligMatrix>* bestWaMatrixVecPtr;
+    };
+    static void aligBatchTaskFunc(void* taskData);
 };
 
 //--------------- BaseSwAligModel class method definitions
@@ -269,6 +323,16 @@ bool BaseSwAligModel<PPINFO>::modelReadsAreProcessSafe(void)
   return true;
 }
 
+//-------------------------
+template<class PPINFO>
+bool BaseSwAligModel<PPINFO>::modelReadsAreThreadSafe(void)
+{
+      // By default it will be assumed that model reads are not thread
+      // safe, those safe classes will override this method returning
+      // true instead
+  return false;
+}
+
 //-------------------------
 template<class PPINFO>
 void BaseSwAligModel<PPINFO>::trainSentPairRange(std::pair<unsigned int,unsigned int> /*sentPairRange*/,
@@ -500,6 +564,91 @@ LgProb BaseSwAligModel<PPINFO>::obtainBestAlignmentVecStr(std::vector<std::strin
 
  return lp;
 }
+//-------------------------
+template<class PPINFO>
+void BaseSwAligModel<PPINFO>::obtainBestAlignmentBatch(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                                       const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                                       unsigned int numThreads,
+                                                       std::vector<LgProb>& lgProbVec,
+                                                       std::vector<WordAligMatrix>& bestWaMatrixVec)
+{
+  unsigned int numPairs=std::min(srcSentIndexVectors.size(),trgSentIndexVectors.size());
+  lgProbVec.clear();
+  lgProbVec.resize(numPairs,0);
+  bestWaMatrixVec.clear();
+  bestWaMatrixVec.resize(numPairs);
+
+  if(numThreads<=1 || numPairs<=1 || !modelReadsAreThreadSafe())
+  {
+    obtainBestAlignmentRange(srcSentIndexVectors,trgSentIndexVectors,0,numPairs,lgProbVec,bestWaMatrixVec);
+  }
+  else
+  {
+        // Split the batch into several ranges per thread to balance
+        // the load
+    unsigned int numTasks=std::min(numPairs,4*numThreads);
+    std::vector<AligBatchTask> tasks(numTasks);
+    ThreadPool pool(numThreads);
+    for(unsigned int k=0;k<numTasks;++k)
+    {
+      tasks[k].modelPtr=this;
+      tasks[k].srcSentIndexVectorsPtr=&srcSentIndexVectors;
+      tasks[k].trgSentIndexVectorsPtr=&trgSentIndexVectors;
+      tasks[k].begin=(unsigned int)(((unsigned long long)numPairs*k)/numTasks);
+      tasks[k].end=(unsigned int)(((unsigned long long)numPairs*(k+1))/numTasks);
+      tasks[k].lgProbVecPtr=&lgProbVec;
+      tasks[k].bestWaMatrixVecPtr=&bestWaMatrixVec;
+      pool.addTask(aligBatchTaskFunc,(void*)&tasks[k]);
+    }
+    pool.waitForTasks();
+  }
+}
+
+//-------------------------
+template<class PPINFO>
+void BaseSwAligModel<PPINFO>::obtainBestAlignmentBatchVecStr(const std::vector<std::vector<std::string> >& srcSentenceVectors,
+                                                             const std::vector<std::vector<std::string> >& trgSentenceVectors,
+                                                             unsigned int numThreads,
+                                                             std::vector<LgProb>& lgProbVec,
+                                                             std::vector<WordAligMatrix>& bestWaMatrixVec)
+{
+  std::vector<std::vector<WordIndex> > srcSentIndexVectors;
+  std::vector<std::vector<WordIndex> > trgSentIndexVectors;
+  unsigned int numPairs=std::min(srcSentenceVectors.size(),trgSentenceVectors.size());
+  for(unsigned int n=0;n<numPairs;++n)
+  {
+    srcSentIndexVectors.push_back(strVectorToSrcIndexVector(srcSentenceVectors[n]));
+    trgSentIndexVectors.push_back(strVectorToTrgIndexVector(trgSentenceVectors[n]));
+  }
+  obtainBestAlignmentBatch(srcSentIndexVectors,trgSentIndexVectors,numThreads,lgProbVec,bestWaMatrixVec);
+}
+
+//-------------------------
+template<class PPINFO>
+void BaseSwAligModel<PPINFO>::obtainBestAlignmentRange(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                                       const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                                       unsigned int begin,
+                                                       unsigned int end,
+                                                       std::vector<LgProb>& lgProbVec,
+                                                       std::vector<WordAligMatrix>& bestWaMatrixVec)
+{
+  for(unsigned int n=begin;n<end;++n)
+    lgProbVec[n]=obtainBestAlignment(srcSentIndexVectors[n],trgSentIndexVectors[n],bestWaMatrixVec[n]);
+}
+
+//-------------------------
+template<class PPINFO>
+void BaseSwAligModel<PPINFO>::aligBatchTaskFunc(void* taskData)
+{
+  AligBatchTask* taskPtr=(AligBatchTask*)taskData;
+  taskPtr->modelPtr->obtainBestAlignmentRange(*taskPtr->srcSentIndexVectorsPtr,
+                                              *taskPtr->trgSentIndexVectorsPtr,
+                                              taskPtr->begin,
+                                              taskPtr->end,
+                                              *taskPtr->lgProbVecPtr,
+                                              *taskPtr->bestWaMatrixVecPtr);
+}
+
 //-------------------------
 template<class PPINFO>
 std::ostream& BaseSwAligModel<PPINFO>::printAligInGizaFormat(const char *sourceSentence,
@@ -35,3 +35,12 @@ IncrHmmAligModel::IncrHmmAligModel() : _incrHmmAligModel()
   incrLexTable = new IncrLexTable();
   lexNumDenFileExtension = ".hmm_lexnd";
 }
+
+//-------------------------
+bool IncrHmmAligModel::modelReadsAreThreadSafe(void)
+{
+      // Lexical parameters are stored in memory and batch alignments
+      // use caches local to each range of sentence pairs instead of
+      // the cached log-probs of the model
+  return true;
+}
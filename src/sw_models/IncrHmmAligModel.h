@@ -54,6 +54,9 @@ class IncrHmmAligModel : public _incrHmmAligModel
    // Constructor
    IncrHmmAligModel();
 
+   // Thread safety related functions
+   bool modelReadsAreThreadSafe(void);
+
 };
 
 #endif
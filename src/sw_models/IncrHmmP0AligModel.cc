@@ -35,3 +35,11 @@ IncrHmmP0AligModel::IncrHmmP0AligModel() : _incrHmmP0AligModel()
   incrLexTable = new IncrLexTable();
   lexNumDenFileExtension = ".hmm_lexnd";
 }
+
+//-------------------------
+bool IncrHmmP0AligModel::modelReadsAreThreadSafe(void)
+{
+      // The lexical table is kept in memory and the Viterbi search of
+      // batch alignments does not fill the caches of the model
+  return true;
+}
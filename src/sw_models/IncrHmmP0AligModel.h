@@ -52,6 +52,9 @@ class IncrHmmP0AligModel : public _incrHmmP0AligModel
 
       // Constructor
    IncrHmmP0AligModel();
+
+      // Thread safety related functions
+   bool modelReadsAreThreadSafe(void);
 };
 
 #endif
@@ -36,12 +36,33 @@ IncrIbm1AligModel::IncrIbm1AligModel()
   sentLengthModel.linkSentPairInfo(&sentenceHandler);
 }
 
+//-------------------------
+bool IncrIbm1AligModel::modelReadsAreThreadSafe(void)
+{
+      // Alignments are obtained by looking up the in-memory lexical
+      // and alignment tables and the sentence length model, none of
+      // them is modified by lookups
+  return true;
+}
+
 //-------------------------   
 void IncrIbm1AligModel::set_expval_maxnsize(unsigned int _anji_maxnsize)
 {
   anji.set_maxnsize(_anji_maxnsize);
 }
 
+//-------------------------   
+void IncrIbm1AligModel::set_expval_topk(unsigned int _anji_topk)
+{
+  anji.set_topk(_anji_topk);
+}
+
+//-------------------------
+bool IncrIbm1AligModel::expValsArePruned(void)
+{
+  return anji.get_topk()!=UNRESTRICTED_ANJI_TOPK;
+}
+
 //-------------------------   
 unsigned int IncrIbm1AligModel::numSentPairs(void)
 {
@@ -225,10 +246,16 @@ void IncrIbm1AligModel::calc_anji(unsigned int n,
           // Store num in numVec
       numVec.push_back(d);
     }
+        // Obtain expected values and prune them if required
+    std::vector<float> anjiRow(nsrcSent.size());
+    for(unsigned int i=0;i<nsrcSent.size();++i)
+      anjiRow[i]=numVec[i]/sum_anji_num_forall_s;
+    anji.prune_row(anjiRow);
         // Set value of anji_aux
     for(unsigned int i=0;i<nsrcSent.size();++i)
     {
-      anji_aux.set_fast(mapped_n_aux,j,i,numVec[i]/sum_anji_num_forall_s);
+      if(anjiRow[i]!=INVALID_ANJI_VAL)
+        anji_aux.set_fast(mapped_n_aux,j,i,anjiRow[i]);
     }
   }
 
@@ -242,8 +269,9 @@ void IncrIbm1AligModel::calc_anji(unsigned int n,
             // Fill variables for n_aux,j,i
         fillEmAuxVars(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight);
 
-            // Update anji
-        anji.set_fast(mapped_n,j,i,anji_aux.get_invp(n_aux,j,i));
+            // Update anji (pruned values are kept invalid, they
+            // have no contribution to be subtracted)
+        anji.set_fast(mapped_n,j,i,anji_aux.get_fast(mapped_n_aux,j,i));
       }
     }
         // clear anji_aux data structure
@@ -307,7 +335,11 @@ void IncrIbm1AligModel::fillEmAuxVars(unsigned int mapped_n,
   else
     weighted_curr_lanji=log(weighted_curr_anji);
   
-  float weighted_new_lanji=log(weighted_new_anji);
+  float weighted_new_lanji;
+  if(weighted_new_anji==0 && expValsArePruned())
+    weighted_new_lanji=SMALL_LG_NUM;  // Pruned expected value
+  else
+    weighted_new_lanji=log(weighted_new_anji);
 
       // Store contributions
   while(lexAuxVar.size()<=s)
@@ -357,10 +389,16 @@ void IncrIbm1AligModel::updatePars(void)
       
             // Obtain new sufficient statistics
         float new_numer=obtainLogNewSuffStat(numer,log_suff_stat_curr,log_suff_stat_new);
-        float new_denom=denom;
-        if(numer!=SMALL_LG_NUM)
-          new_denom=MathFuncs::lns_sublog_float(denom,numer);
-        new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+        float new_denom;
+        if(expValsArePruned())
+          new_denom=obtainLogNewSuffStat(denom,numer,new_numer);
+        else
+        {
+          new_denom=denom;
+          if(numer!=SMALL_LG_NUM)
+            new_denom=MathFuncs::lns_sublog_float(denom,numer);
+          new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+        }
         
             // Set lexical numerator and denominator
         incrLexTable.setLexNumDen(s,t,new_numer,new_denom);   
@@ -376,6 +414,12 @@ float IncrIbm1AligModel::obtainLogNewSuffStat(float lcurrSuffStat,
                                               float lLocalSuffStatCurr,
                                               float lLocalSuffStatNew)
 {
+      // When the expected values are pruned, the local statistic may
+      // exceed the global one due to rounding errors if the remaining
+      // mass is negligible
+  if(expValsArePruned() && lLocalSuffStatCurr>=lcurrSuffStat)
+    return lLocalSuffStatNew;
+  
   float lresult=MathFuncs::lns_sublog_float(lcurrSuffStat,lLocalSuffStatCurr);
   lresult=MathFuncs::lns_sumlog_float(lresult,lLocalSuffStatNew);
   return lresult;
@@ -819,6 +863,7 @@ bool IncrIbm1AligModel::load(const char* prefFileName)
         // Load file with lexical nd values
     std::string lexNumDenFile=prefFileName;
     lexNumDenFile=lexNumDenFile+".ibm_lexnd";
+    applyLexLoadFilters(incrLexTable);
     retVal=incrLexTable.load(lexNumDenFile.c_str());
     if(retVal==THOT_ERROR) return THOT_ERROR;
 
@@ -65,9 +65,15 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
    // Constructor
    IncrIbm1AligModel();
 
+   // Thread safety related functions
+   bool modelReadsAreThreadSafe(void);
+
    void set_expval_maxnsize(unsigned int _anji_maxnsize);
        // Function to set a maximum size for the vector of expected
        // values anji (by default the size is not restricted)
+   void set_expval_topk(unsigned int _anji_topk);
+       // Function to keep only the top-k expected values for each
+       // target position (by default no pruning is applied)
 
    // Functions to read and add sentence pairs
    unsigned int numSentPairs(void);
@@ -241,6 +247,9 @@ class IncrIbm1AligModel: public _incrSwAligModel<std::vector<Prob> >
    virtual float obtainLogNewSuffStat(float lcurrSuffStat,
                                       float lLocalSuffStatCurr,
                                       float lLocalSuffStatNew);
+   bool expValsArePruned(void);
+       // Returns true if only the top-k expected values are kept (see
+       // set_expval_topk())
    
    // Functions to update log-likelihood
    void update_loglikelihood(std::pair<unsigned int,unsigned int> sentPairRange,
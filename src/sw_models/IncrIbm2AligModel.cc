@@ -124,7 +124,8 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   }
 
   float weighted_new_anji=(float)weight*anji_aux.get_invp_fast(mapped_n_aux,j,i);
-  if(weighted_new_anji<SMOOTHING_WEIGHTED_ANJI)
+  if((weighted_new_anji!=0 || !expValsArePruned()) &&
+     weighted_new_anji<SMOOTHING_WEIGHTED_ANJI)
     weighted_new_anji=SMOOTHING_WEIGHTED_ANJI;
   
       // Init aSource data structure
@@ -141,7 +142,11 @@ void IncrIbm2AligModel::fillEmAuxVarsAlig(unsigned int mapped_n,
   else
     weighted_curr_lanji=log(weighted_curr_anji);
   
-  float weighted_new_lanji=log(weighted_new_anji);
+  float weighted_new_lanji;
+  if(weighted_new_anji==0 && expValsArePruned())
+    weighted_new_lanji=SMALL_LG_NUM;  // Pruned expected value
+  else
+    weighted_new_lanji=log(weighted_new_anji);
 
       // Store contributions
   AligAuxVar::iterator aligAuxVarIter=aligAuxVar.find(std::make_pair(as,i));
@@ -190,10 +195,16 @@ void IncrIbm2AligModel::updateParsAlig(void)
 
           // Obtain new sufficient statistics
       float new_numer=obtainLogNewSuffStat(numer,log_suff_stat_curr,log_suff_stat_new);
-      float new_denom=denom;
-      if(numer!=SMALL_LG_NUM)
-        new_denom=MathFuncs::lns_sublog_float(denom,numer);
-      new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+      float new_denom;
+      if(expValsArePruned())
+        new_denom=obtainLogNewSuffStat(denom,numer,new_numer);
+      else
+      {
+        new_denom=denom;
+        if(numer!=SMALL_LG_NUM)
+          new_denom=MathFuncs::lns_sublog_float(denom,numer);
+        new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+      }
       
           // Set lexical numerator and denominator
       incrIbm2AligTable.setAligNumDen(as,i,new_numer,new_denom);
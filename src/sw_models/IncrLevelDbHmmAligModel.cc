@@ -50,3 +50,15 @@ bool IncrLevelDbHmmAligModel::init(const char* prefFileName)
 {
   return ((IncrLexLevelDbTable *) incrLexTable)->init(prefFileName);
 }
+
+//-------------------------
+const LevelDbConfig& IncrLevelDbHmmAligModel::getLevelDbConfig(void)const
+{
+  return ((IncrLexLevelDbTable *) incrLexTable)->getConfig();
+}
+
+//-------------------------
+bool IncrLevelDbHmmAligModel::setLevelDbConfig(const LevelDbConfig& config)
+{
+  return ((IncrLexLevelDbTable *) incrLexTable)->setConfig(config);
+}
@@ -50,3 +50,15 @@ bool IncrLevelDbHmmP0AligModel::init(const char* prefFileName)
 {
   return ((IncrLexLevelDbTable *) incrLexTable)->init(prefFileName);
 }
+
+//-------------------------
+const LevelDbConfig& IncrLevelDbHmmP0AligModel::getLevelDbConfig(void)const
+{
+  return ((IncrLexLevelDbTable *) incrLexTable)->getConfig();
+}
+
+//-------------------------
+bool IncrLevelDbHmmP0AligModel::setLevelDbConfig(const LevelDbConfig& config)
+{
+  return ((IncrLexLevelDbTable *) incrLexTable)->setConfig(config);
+}
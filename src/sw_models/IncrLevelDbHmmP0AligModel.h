@@ -61,6 +61,11 @@ class IncrLevelDbHmmP0AligModel : public _incrHmmP0AligModel
    // init function
    bool init(const char* prefFileName);
 
+   // Functions to tune the access to the database storing the
+   // lexical parameters
+   const LevelDbConfig& getLevelDbConfig(void)const;
+   bool setLevelDbConfig(const LevelDbConfig& config);
+
 };
 
 #endif
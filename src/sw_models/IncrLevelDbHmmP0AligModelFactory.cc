@@ -29,9 +29,17 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 //--------------- Function definitions
 
-extern "C" BaseSwAligModel<std::vector<Prob> >* create(const char* /*str*/)
+extern "C" BaseSwAligModel<std::vector<Prob> >* create(const char* str)
 {
-  return new IncrLevelDbHmmP0AligModel;
+  IncrLevelDbHmmP0AligModel* incrLevelDbHmmP0AligModelPtr=new IncrLevelDbHmmP0AligModel;
+
+      // Initialization parameters such as "-ldb-cache-mb 512" tune
+      // the access to the LevelDB database (see LevelDbConfig.h)
+  LevelDbConfig config=incrLevelDbHmmP0AligModelPtr->getLevelDbConfig();
+  if(config.parseInitPars(str)==THOT_OK)
+    incrLevelDbHmmP0AligModelPtr->setLevelDbConfig(config);
+
+  return incrLevelDbHmmP0AligModelPtr;
 }
 
 //---------------
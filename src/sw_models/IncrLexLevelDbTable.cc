@@ -29,16 +29,16 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 //--------------- IncrLexLevelDbTable class function definitions
 
 //-------------------------
-IncrLexLevelDbTable::IncrLexLevelDbTable(void)
+IncrLexLevelDbTable::IncrLexLevelDbTable(void):config(10, 10, 0)
 {
     // Define extensions
     ldbExtension = "_ldb_hmm_lexnd";
     defaultExtension = ".hmm_lexnd";
 
-    // Prepare DB configuration
-    options.create_if_missing = true;
-    options.filter_policy = leveldb::NewBloomFilterPolicy(10);
-    options.block_cache = leveldb::NewLRUCache(10 * 1048576);  // 10 MB for cache
+    // Prepare DB configuration (10 MB for cache)
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
     db = NULL;
     dbName = "";
 }
@@ -55,6 +55,7 @@ bool IncrLexLevelDbTable::init(const char* prefFileName)
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     // Prepare empty DB
     leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
@@ -81,6 +82,7 @@ bool IncrLexLevelDbTable::drop()
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     leveldb::Status status = leveldb::DestroyDB(dbName, options);
 
@@ -96,6 +98,55 @@ bool IncrLexLevelDbTable::drop()
     }
 }
 
+//-------------------------
+bool IncrLexLevelDbTable::setConfig(const LevelDbConfig& _config)
+{
+    // The database uses the filter policy and the block cache of the
+    // current options, so it is closed before they are released
+    bool dbWasOpen = (db != NULL);
+    if(db != NULL)
+    {
+        delete db;
+        db = NULL;
+    }
+
+    config.releaseOptions(options);
+    config = _config;
+    config.setOptions(options);
+    readOptions = config.getReadOptions();
+    valueCache.setCapacity(config.valueCacheSize);
+    valueCache.clear();
+
+    if(!dbWasOpen)
+        return THOT_OK;
+
+    // Reopen database using the new options
+    leveldb::Status status = leveldb::DB::Open(options, dbName, &db);
+
+    if (status.ok())
+    {
+        return THOT_OK;
+    }
+    else
+    {
+        std::cerr << "Cannot open DB: " << status.ToString() << std::endl;
+
+        return THOT_ERROR;
+    }
+}
+
+//-------------------------
+const LevelDbConfig& IncrLexLevelDbTable::getConfig(void)const
+{
+    return config;
+}
+
+//-------------------------
+void IncrLexLevelDbTable::printCacheStats(std::ostream& outS)const
+{
+    valueCache.printStats("LevelDB lexical table", outS);
+}
+
 //-------------------------
 std::string IncrLexLevelDbTable::vectorToString(const std::vector<WordIndex>& vec)const
 {
@@ -181,11 +232,19 @@ bool IncrLexLevelDbTable::retrieveData(const std::vector<WordIndex>& phrase, flo
     value = 0;
     std::string key = vectorToString(phrase);
 
-    leveldb::Status result = db->Get(leveldb::ReadOptions(), key, &value_str);
+    bool found;
+    if(valueCache.lookup(key, value, found))
+        return found;
+
+    leveldb::Status result = db->Get(readOptions, key, &value_str);
 
     if (result.ok()) {
-        return stringToFloat(value_str, value);
+        bool ret = stringToFloat(value_str, value);
+        valueCache.insert(key, value, ret);
+        return ret;
     } else {
+        if(result.IsNotFound())
+            valueCache.insert(key, value, false);
         return false;
     }
 }
@@ -194,13 +253,21 @@ bool IncrLexLevelDbTable::retrieveData(const std::vector<WordIndex>& phrase, flo
 bool IncrLexLevelDbTable::storeData(const std::vector<WordIndex>& phrase, float value)const
 {
     std::string value_str = floatToString(value);
+    std::string key = vectorToString(phrase);
 
     leveldb::WriteBatch batch;
-    batch.Put(vectorToString(phrase), value_str);
+    batch.Put(key, value_str);
     leveldb::Status s = db->Write(leveldb::WriteOptions(), &batch);
 
-    if(!s.ok())
+    if(s.ok())
+    {
+        valueCache.insert(key, value, true);
+    }
+    else
+    {
+        valueCache.erase(key);
         std::cerr << "Storing data status: " << s.ToString() << std::endl;
+    }
 
     return s.ok();
 }
@@ -275,7 +342,7 @@ bool IncrLexLevelDbTable::getTransForTarget(WordIndex t,
     leveldb::Slice start = start_str;
     leveldb::Slice end = end_str;
 
-    leveldb::Iterator* it = db->NewIterator(leveldb::ReadOptions());
+    leveldb::Iterator* it = db->NewIterator(readOptions);
 
     transSet.clear();
 
@@ -377,6 +444,7 @@ bool IncrLexLevelDbTable::loadLevelDb(const char* lexNumDenFile)
         delete db;
         db = NULL;
     }
+    valueCache.clear();
 
     dbName = ((std::string) lexNumDenFile) + ldbExtension;
 
@@ -403,6 +471,8 @@ bool IncrLexLevelDbTable::loadLevelDb(const char* lexNumDenFile)
 //-------------------------
 bool IncrLexLevelDbTable::print(const char* lexNumDenFile)
 {
+    printCacheStats(std::cerr);
+
 #ifdef THOT_ENABLE_LOAD_PRINT_TEXTPARS
     return printPlainText(lexNumDenFile);
 #else
@@ -545,9 +615,5 @@ IncrLexLevelDbTable::~IncrLexLevelDbTable(void)
     if(db != NULL)
         delete db;
 
-    if(options.filter_policy != NULL)
-        delete options.filter_policy;
-
-    if(options.block_cache != NULL)
-        delete options.block_cache;
+    config.releaseOptions(options);
 }
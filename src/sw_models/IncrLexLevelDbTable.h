@@ -39,6 +39,8 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #include <_incrLexTable.h>
 #include <ErrorDefs.h>
 #include <StatModelDefs.h>
+#include <LevelDbConfig.h>
+#include <LevelDbValueCache.h>
 
 #include "leveldb/cache.h"
 #include "leveldb/db.h"
@@ -70,6 +72,9 @@ class IncrLexLevelDbTable : public _incrLexTable
     // DB-related variables
     leveldb::DB* db;
     leveldb::Options options;
+    leveldb::ReadOptions readOptions;
+    LevelDbConfig config;
+    mutable LevelDbValueCache<float> valueCache;
     std::string dbName;
 
         // Converters
@@ -100,6 +105,12 @@ class IncrLexLevelDbTable : public _incrLexTable
         bool init(const char* prefFileName);
         bool drop();
 
+            // Functions to tune database access. The new configuration
+            // reopens the database if it was already loaded
+        bool setConfig(const LevelDbConfig& _config);
+        const LevelDbConfig& getConfig(void)const;
+        void printCacheStats(std::ostream& outS)const;
+
             // Functions to handle lexNumer
         void setLexNumer(WordIndex s,
                          WordIndex t,
@@ -26,11 +26,19 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 
 #include "IncrLexTable.h"
 
+#include <string.h>
+
+//--------------- Constants ------------------------------------------
+
+#define LEXND_RECORDS_PER_READ 4096
+
 //--------------- IncrLexTable class function definitions
 
 //-------------------------
 IncrLexTable::IncrLexTable(void)
 {
+  srcLoadFilterEnabled=false;
+  trgLoadFilterEnabled=false;
 }
 
 //-------------------------   
@@ -145,6 +153,54 @@ bool IncrLexTable::load(const char* lexNumDenFile)
 #endif
 }
 
+//-------------------------
+void IncrLexTable::setSrcLoadFilter(const std::set<WordIndex>& srcWordSet)
+{
+  srcLoadFilterEnabled=true;
+  srcLoadFilter.clear();
+  std::set<WordIndex>::const_iterator setIter;
+  for(setIter=srcWordSet.begin();setIter!=srcWordSet.end();++setIter)
+  {
+    if(srcLoadFilter.size()<=*setIter)
+      srcLoadFilter.resize(*setIter+1,false);
+    srcLoadFilter[*setIter]=true;
+  }
+}
+
+//-------------------------
+void IncrLexTable::setTrgLoadFilter(const std::set<WordIndex>& trgWordSet)
+{
+  trgLoadFilterEnabled=true;
+  trgLoadFilter.clear();
+  std::set<WordIndex>::const_iterator setIter;
+  for(setIter=trgWordSet.begin();setIter!=trgWordSet.end();++setIter)
+  {
+    if(trgLoadFilter.size()<=*setIter)
+      trgLoadFilter.resize(*setIter+1,false);
+    trgLoadFilter[*setIter]=true;
+  }
+}
+
+//-------------------------
+void IncrLexTable::clearLoadFilters(void)
+{
+  srcLoadFilterEnabled=false;
+  srcLoadFilter.clear();
+  trgLoadFilterEnabled=false;
+  trgLoadFilter.clear();
+}
+
+//-------------------------
+bool IncrLexTable::entryPassesLoadFilters(WordIndex s,
+                                          WordIndex t)const
+{
+  if(srcLoadFilterEnabled && (s>=srcLoadFilter.size() || !srcLoadFilter[s]))
+    return false;
+  if(trgLoadFilterEnabled && (t>=trgLoadFilter.size() || !trgLoadFilter[t]))
+    return false;
+  return true;
+}
+
 //-------------------------
 bool IncrLexTable::loadBin(const char* lexNumDenFile)
 {
@@ -162,22 +218,27 @@ bool IncrLexTable::loadBin(const char* lexNumDenFile)
   }
   else
   {
-        // Read register
-    bool end=false;
-    while(!end)
+        // Read registers in blocks
+    const size_t recordSize=2*sizeof(WordIndex)+2*sizeof(float);
+    std::vector<char> buffer(LEXND_RECORDS_PER_READ*recordSize);
+    while(inF)
     {
-      WordIndex s;
-      WordIndex t;
-      float numer;
-      float denom;
-      if(inF.read((char*)&s,sizeof(WordIndex)))
+      inF.read(&buffer[0],buffer.size());
+      size_t numRecords=inF.gcount()/recordSize;
+      for(size_t i=0;i<numRecords;++i)
       {
-        inF.read((char*)&t,sizeof(WordIndex));
-        inF.read((char*)&numer,sizeof(float));
-        inF.read((char*)&denom,sizeof(float));
-        setLexNumDen(s,t,numer,denom);
+        const char* recordPtr=&buffer[i*recordSize];
+        WordIndex s;
+        WordIndex t;
+        float numer;
+        float denom;
+        memcpy(&s,recordPtr,sizeof(WordIndex));
+        memcpy(&t,recordPtr+sizeof(WordIndex),sizeof(WordIndex));
+        memcpy(&numer,recordPtr+2*sizeof(WordIndex),sizeof(float));
+        memcpy(&denom,recordPtr+2*sizeof(WordIndex)+sizeof(float),sizeof(float));
+        if(entryPassesLoadFilters(s,t))
+          setLexNumDen(s,t,numer,denom);
       }
-      else end=true;
     }
     return THOT_OK;
   }
@@ -208,7 +269,8 @@ bool IncrLexTable::loadPlainText(const char* lexNumDenFile)
         WordIndex t=atoi(awk.dollar(2).c_str());
         float numer=atof(awk.dollar(3).c_str());
         float denom=atof(awk.dollar(4).c_str());
-        setLexNumDen(s,t,numer,denom);
+        if(entryPassesLoadFilters(s,t))
+          setLexNumDen(s,t,numer,denom);
       }
     }
     return THOT_OK;
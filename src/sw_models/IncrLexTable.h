@@ -101,6 +101,11 @@ class IncrLexTable : public _incrLexTable
 
        // load function
    bool load(const char* lexNumDenFile);
+
+       // Functions to restrict the entries obtained by load()
+   void setSrcLoadFilter(const std::set<WordIndex>& srcWordSet);
+   void setTrgLoadFilter(const std::set<WordIndex>& trgWordSet);
+   void clearLoadFilters(void);
    
        // print function
    bool print(const char* lexNumDenFile);
@@ -123,6 +128,16 @@ class IncrLexTable : public _incrLexTable
    LexNumer lexNumer;
    LexDenom lexDenom;
 
+       // Load filters (loadFilter[w] is true if entries for word w
+       // are to be loaded)
+   bool srcLoadFilterEnabled;
+   std::vector<bool> srcLoadFilter;
+   bool trgLoadFilterEnabled;
+   std::vector<bool> trgLoadFilter;
+
+   bool entryPassesLoadFilters(WordIndex s,
+                               WordIndex t)const;
+
        // load and print auxiliary functions
    bool loadBin(const char* lexNumDenFile);
    bool loadPlainText(const char* lexNumDenFile);
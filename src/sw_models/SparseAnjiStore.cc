@@ -0,0 +1,613 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SparseAnjiStore.cc
+ *
+ * @brief Definitions file for SparseAnjiStore.h
+ */
+
+//--------------- Include files --------------------------------------
+
+#include "SparseAnjiStore.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <iostream>
+
+//--------------- Global variables -----------------------------------
+
+
+//--------------- Function declarations
+
+namespace
+{
+  struct greaterValue
+  {
+    bool operator()(const std::pair<uint32_t,float>& a,
+                    const std::pair<uint32_t,float>& b)const
+    {
+      return a.second>b.second;
+    }
+  };
+
+  void appendUint32(std::string& str,
+                    uint32_t val)
+  {
+    str.append((const char*)&val,sizeof(uint32_t));
+  }
+
+  bool readUint32(const char*& ptr,
+                  const char* endPtr,
+                  uint32_t& val)
+  {
+    if(ptr+sizeof(uint32_t)>endPtr)
+      return false;
+    memcpy(&val,ptr,sizeof(uint32_t));
+    ptr+=sizeof(uint32_t);
+    return true;
+  }
+}
+
+//--------------- Constants
+
+#define SPARSE_ANJI_HEADER_SIZE (4*sizeof(uint32_t))
+#define SPARSE_ANJI_FOOTER_SIZE (sizeof(uint64_t)+2*sizeof(uint32_t))
+
+//--------------- Classes --------------------------------------------
+
+
+//--------------- SparseAnjiStore class function definitions
+
+//-------------------------
+SparseAnjiStore::SparseAnjiStore(void)
+{
+  topk=UNRESTRICTED_ANJI_TOPK;
+  logValues=false;
+  mapAddr=NULL;
+  mapSize=0;
+  mapIndexOffset=0;
+  mapNumEntries=0;
+  spillFile=NULL;
+  spillFileSize=0;
+  spillLiveBytes=0;
+}
+
+//-------------------------
+SparseAnjiStore::~SparseAnjiStore()
+{
+  clear();
+}
+
+//-------------------------
+void SparseAnjiStore::set_topk(unsigned int _topk)
+{
+  topk=_topk;
+}
+
+//-------------------------
+unsigned int SparseAnjiStore::get_topk(void)const
+{
+  return topk;
+}
+
+//-------------------------
+void SparseAnjiStore::set_log_values(bool _logValues)
+{
+  logValues=_logValues;
+}
+
+//-------------------------
+void SparseAnjiStore::pruneRow(float invalidVal,
+                               std::vector<float>& row)const
+{
+  if(topk==UNRESTRICTED_ANJI_TOPK)
+    return;
+
+      // Collect valid values of row
+  std::vector<std::pair<uint32_t,float> > rowVals;
+  for(unsigned int i=0;i<row.size();++i)
+  {
+    if(row[i]!=invalidVal)
+      rowVals.push_back(std::make_pair(i,row[i]));
+  }
+  if(rowVals.size()<=topk)
+    return;
+
+  std::nth_element(rowVals.begin(),rowVals.begin()+topk,rowVals.end(),greaterValue());
+
+      // Obtain total and kept mass of the row
+  double totalMass=0;
+  double keptMass=0;
+  float maxVal=rowVals[0].second;
+  for(unsigned int k=0;k<topk;++k)
+    maxVal=std::max(maxVal,rowVals[k].second);
+  for(unsigned int k=0;k<rowVals.size();++k)
+  {
+    double mass=logValues?exp(rowVals[k].second-maxVal):rowVals[k].second;
+    totalMass+=mass;
+    if(k<topk)
+      keptMass+=mass;
+  }
+
+      // Invalidate pruned values and scale kept ones
+  for(unsigned int k=topk;k<rowVals.size();++k)
+    row[rowVals[k].first]=invalidVal;
+  if(keptMass>0)
+  {
+    for(unsigned int k=0;k<topk;++k)
+    {
+      if(logValues)
+        row[rowVals[k].first]=rowVals[k].second+log(totalMass/keptMass);
+      else
+        row[rowVals[k].first]=rowVals[k].second*(totalMass/keptMass);
+    }
+  }
+}
+
+//-------------------------
+bool SparseAnjiStore::attach(const char* fileName)
+{
+  detach();
+
+  int fd=::open(fileName,O_RDONLY);
+  if(fd<0)
+    return THOT_ERROR;
+
+  struct stat st;
+  if(fstat(fd,&st)!=0 || (size_t)st.st_size<SPARSE_ANJI_HEADER_SIZE+SPARSE_ANJI_FOOTER_SIZE)
+  {
+    std::cerr<<"Error: file with sparse anji values "<<fileName<<" is corrupted."<<std::endl;
+    ::close(fd);
+    return THOT_ERROR;
+  }
+
+  void* addr=mmap(NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+  ::close(fd);
+  if(addr==MAP_FAILED)
+  {
+    std::cerr<<"Error: file with sparse anji values "<<fileName<<" could not be mapped in memory."<<std::endl;
+    return THOT_ERROR;
+  }
+  mapAddr=(const char*)addr;
+  mapSize=st.st_size;
+
+      // Check header and footer
+  uint32_t magic;
+  uint32_t version;
+  memcpy(&magic,mapAddr,sizeof(uint32_t));
+  memcpy(&version,mapAddr+sizeof(uint32_t),sizeof(uint32_t));
+  const char* footerPtr=mapAddr+mapSize-SPARSE_ANJI_FOOTER_SIZE;
+  uint32_t numEntries;
+  uint32_t footerMagic;
+  memcpy(&mapIndexOffset,footerPtr,sizeof(uint64_t));
+  memcpy(&numEntries,footerPtr+sizeof(uint64_t),sizeof(uint32_t));
+  memcpy(&footerMagic,footerPtr+sizeof(uint64_t)+sizeof(uint32_t),sizeof(uint32_t));
+  mapNumEntries=numEntries;
+  if(magic!=SPARSE_ANJI_MAGIC || footerMagic!=SPARSE_ANJI_MAGIC || version!=SPARSE_ANJI_VERSION ||
+     mapIndexOffset+(uint64_t)(mapNumEntries+1)*sizeof(uint64_t)+SPARSE_ANJI_FOOTER_SIZE!=mapSize)
+  {
+    std::cerr<<"Error: file with sparse anji values "<<fileName<<" is corrupted."<<std::endl;
+    detach();
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool SparseAnjiStore::is_attached(void)const
+{
+  return mapAddr!=NULL;
+}
+
+//-------------------------
+void SparseAnjiStore::detach(void)
+{
+  if(mapAddr!=NULL)
+  {
+    munmap((void*)mapAddr,mapSize);
+    mapAddr=NULL;
+  }
+  mapSize=0;
+  mapIndexOffset=0;
+  mapNumEntries=0;
+}
+
+//-------------------------
+unsigned int SparseAnjiStore::n_size(void)const
+{
+  if(spillIndex.size()>mapNumEntries)
+    return spillIndex.size();
+  else
+    return mapNumEntries;
+}
+
+//-------------------------
+bool SparseAnjiStore::getEntry(unsigned int n,
+                               float invalidVal,
+                               std::vector<unsigned int>& shape,
+                               std::vector<std::vector<float> >& rows)
+{
+  if(n<spillIndex.size() && spillIndex[n].len>0)
+  {
+    std::string encEntry;
+    if(!getEncodedEntry(n,encEntry))
+      return false;
+    return decodeEntry(encEntry.data(),encEntry.size(),invalidVal,shape,rows);
+  }
+  else
+  {
+    const char* entryPtr;
+    size_t entryLen;
+    if(!getMappedEncodedEntry(n,entryPtr,entryLen))
+      return false;
+    return decodeEntry(entryPtr,entryLen,invalidVal,shape,rows);
+  }
+}
+
+//-------------------------
+bool SparseAnjiStore::getEncodedEntry(unsigned int n,
+                                      std::string& encEntry)
+{
+  encEntry.clear();
+
+      // Spilled entries supersede those of the memory-mapped file
+  if(n<spillIndex.size() && spillIndex[n].len>0)
+  {
+    encEntry.resize(spillIndex[n].len);
+    if(fseeko(spillFile,spillIndex[n].offset,SEEK_SET)!=0 ||
+       fread(&encEntry[0],1,encEntry.size(),spillFile)!=encEntry.size())
+    {
+      std::cerr<<"Error while reading anji spill file."<<std::endl;
+      encEntry.clear();
+      return false;
+    }
+    return true;
+  }
+
+  const char* entryPtr;
+  size_t entryLen;
+  if(!getMappedEncodedEntry(n,entryPtr,entryLen))
+    return false;
+  encEntry.assign(entryPtr,entryLen);
+  return true;
+}
+
+//-------------------------
+bool SparseAnjiStore::getMappedEncodedEntry(unsigned int n,
+                                            const char*& entryPtr,
+                                            size_t& entryLen)const
+{
+  if(mapAddr==NULL || n>=mapNumEntries)
+    return false;
+
+  uint64_t begOffset;
+  uint64_t endOffset;
+  const char* indexPtr=mapAddr+mapIndexOffset+(uint64_t)n*sizeof(uint64_t);
+  memcpy(&begOffset,indexPtr,sizeof(uint64_t));
+  memcpy(&endOffset,indexPtr+sizeof(uint64_t),sizeof(uint64_t));
+  if(endOffset<=begOffset || endOffset>mapIndexOffset)
+    return false;
+
+  entryPtr=mapAddr+begOffset;
+  entryLen=endOffset-begOffset;
+  return true;
+}
+
+//-------------------------
+bool SparseAnjiStore::spillEntry(unsigned int n,
+                                 float invalidVal,
+                                 const std::vector<unsigned int>& shape,
+                                 const std::vector<std::vector<float> >& rows)
+{
+  if(spillFile==NULL)
+  {
+    spillFile=tmpfile();
+    if(spillFile==NULL)
+    {
+      std::cerr<<"Error: anji spill file could not be created."<<std::endl;
+      return THOT_ERROR;
+    }
+  }
+
+  std::string encEntry;
+  encodeEntry(invalidVal,shape,rows,encEntry);
+
+  if(spillIndex.size()<=n)
+    spillIndex.resize(n+1);
+  SpillSlot& slot=spillIndex[n];
+
+  if(slot.capacity>=encEntry.size())
+  {
+        // Overwrite previous version of the entry
+    if(fseeko(spillFile,slot.offset,SEEK_SET)!=0 ||
+       fwrite(encEntry.data(),1,encEntry.size(),spillFile)!=encEntry.size())
+    {
+      std::cerr<<"Error while writing anji spill file."<<std::endl;
+      return THOT_ERROR;
+    }
+    slot.len=encEntry.size();
+  }
+  else
+  {
+        // Append entry to spill file, the slot of the previous version
+        // of the entry becomes dead
+    if(fseeko(spillFile,spillFileSize,SEEK_SET)!=0 ||
+       fwrite(encEntry.data(),1,encEntry.size(),spillFile)!=encEntry.size())
+    {
+      std::cerr<<"Error while writing anji spill file."<<std::endl;
+      return THOT_ERROR;
+    }
+    spillLiveBytes-=slot.capacity;
+    slot.offset=spillFileSize;
+    slot.len=encEntry.size();
+    slot.capacity=encEntry.size();
+    spillFileSize+=encEntry.size();
+    spillLiveBytes+=slot.capacity;
+
+        // Reclaim dead space if necessary
+    uint64_t deadBytes=spillFileSize-spillLiveBytes;
+    if(deadBytes>SPARSE_ANJI_MIN_DEAD_SPILL_BYTES && deadBytes>spillLiveBytes)
+      return compactSpillFile();
+  }
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool SparseAnjiStore::compactSpillFile(void)
+{
+  FILE* newSpillFile=tmpfile();
+  if(newSpillFile==NULL)
+  {
+    std::cerr<<"Error: anji spill file could not be created."<<std::endl;
+    return THOT_ERROR;
+  }
+
+      // Copy slots in use to the new file
+  std::vector<SpillSlot> newSpillIndex(spillIndex.size());
+  uint64_t newOffset=0;
+  std::string encEntry;
+  for(unsigned int n=0;n<spillIndex.size();++n)
+  {
+    if(spillIndex[n].len>0)
+    {
+      encEntry.resize(spillIndex[n].len);
+      if(fseeko(spillFile,spillIndex[n].offset,SEEK_SET)!=0 ||
+         fread(&encEntry[0],1,encEntry.size(),spillFile)!=encEntry.size() ||
+         fwrite(encEntry.data(),1,encEntry.size(),newSpillFile)!=encEntry.size())
+      {
+        std::cerr<<"Error while compacting anji spill file."<<std::endl;
+        fclose(newSpillFile);
+        return THOT_ERROR;
+      }
+      newSpillIndex[n].offset=newOffset;
+      newSpillIndex[n].len=spillIndex[n].len;
+      newSpillIndex[n].capacity=spillIndex[n].len;
+      newOffset+=spillIndex[n].len;
+    }
+  }
+
+      // Replace spill file
+  fclose(spillFile);
+  spillFile=newSpillFile;
+  spillIndex.swap(newSpillIndex);
+  spillFileSize=newOffset;
+  spillLiveBytes=newOffset;
+
+  return THOT_OK;
+}
+
+//-------------------------
+void SparseAnjiStore::encodeEntry(float invalidVal,
+                                  const std::vector<unsigned int>& shape,
+                                  const std::vector<std::vector<float> >& rows,
+                                  std::string& encEntry)const
+{
+  encEntry.clear();
+
+  appendUint32(encEntry,shape.size());
+  for(unsigned int s=0;s<shape.size();++s)
+    appendUint32(encEntry,shape[s]);
+
+  appendUint32(encEntry,rows.size());
+  std::vector<std::pair<uint32_t,float> > rowVals;
+  for(unsigned int r=0;r<rows.size();++r)
+  {
+        // Collect valid values of row
+    rowVals.clear();
+    for(unsigned int i=0;i<rows[r].size();++i)
+    {
+      if(rows[r][i]!=invalidVal)
+        rowVals.push_back(std::make_pair(i,rows[r][i]));
+    }
+
+    appendUint32(encEntry,rows[r].size());
+    appendUint32(encEntry,rowVals.size());
+    for(unsigned int k=0;k<rowVals.size();++k)
+    {
+      appendUint32(encEntry,rowVals[k].first);
+      encEntry.append((const char*)&rowVals[k].second,sizeof(float));
+    }
+  }
+}
+
+//-------------------------
+bool SparseAnjiStore::decodeEntry(const char* entryPtr,
+                                  size_t entryLen,
+                                  float invalidVal,
+                                  std::vector<unsigned int>& shape,
+                                  std::vector<std::vector<float> >& rows)const
+{
+  const char* ptr=entryPtr;
+  const char* endPtr=entryPtr+entryLen;
+  uint32_t shapeLen;
+  uint32_t numRows;
+
+  shape.clear();
+  rows.clear();
+
+  if(!readUint32(ptr,endPtr,shapeLen))
+    return false;
+  shape.resize(shapeLen);
+  for(unsigned int s=0;s<shapeLen;++s)
+  {
+    uint32_t val;
+    if(!readUint32(ptr,endPtr,val))
+      return false;
+    shape[s]=val;
+  }
+
+  if(!readUint32(ptr,endPtr,numRows))
+    return false;
+  rows.resize(numRows);
+  for(unsigned int r=0;r<numRows;++r)
+  {
+    uint32_t rowLen;
+    uint32_t k;
+    if(!readUint32(ptr,endPtr,rowLen) || !readUint32(ptr,endPtr,k))
+      return false;
+    rows[r].assign(rowLen,invalidVal);
+    for(unsigned int l=0;l<k;++l)
+    {
+      uint32_t i;
+      float f;
+      if(!readUint32(ptr,endPtr,i) || ptr+sizeof(float)>endPtr)
+        return false;
+      memcpy(&f,ptr,sizeof(float));
+      ptr+=sizeof(float);
+      if(i<rowLen)
+        rows[r][i]=f;
+    }
+  }
+  return true;
+}
+
+//-------------------------
+void SparseAnjiStore::clear(void)
+{
+  detach();
+  if(spillFile!=NULL)
+  {
+    fclose(spillFile);
+    spillFile=NULL;
+  }
+  spillIndex.clear();
+  spillFileSize=0;
+  spillLiveBytes=0;
+}
+
+//--------------- SparseAnjiFileWriter class function definitions
+
+//-------------------------
+SparseAnjiFileWriter::SparseAnjiFileWriter(void)
+{
+  outFile=NULL;
+  currOffset=0;
+}
+
+//-------------------------
+SparseAnjiFileWriter::~SparseAnjiFileWriter()
+{
+  if(outFile!=NULL)
+  {
+        // close() was not called, discard partial file
+    fclose(outFile);
+    remove(tmpFileName.c_str());
+  }
+}
+
+//-------------------------
+bool SparseAnjiFileWriter::open(const char* fileName,
+                                unsigned int topk)
+{
+  finalFileName=fileName;
+  tmpFileName=finalFileName+".tmp";
+  index.clear();
+
+      // The file is written under a temporary name so as to not
+      // disturb memory mappings of the previous version
+  outFile=fopen(tmpFileName.c_str(),"wb");
+  if(outFile==NULL)
+  {
+    std::cerr<<"Error while printing sparse anji file."<<std::endl;
+    return THOT_ERROR;
+  }
+
+  uint32_t header[4]={SPARSE_ANJI_MAGIC,SPARSE_ANJI_VERSION,topk,0};
+  if(fwrite(header,sizeof(uint32_t),4,outFile)!=4)
+    return THOT_ERROR;
+  currOffset=SPARSE_ANJI_HEADER_SIZE;
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool SparseAnjiFileWriter::addEntry(unsigned int n,
+                                    const std::string& encEntry)
+{
+  if(outFile==NULL || n<index.size())
+    return THOT_ERROR;
+
+      // Missing entries are stored with empty ranges
+  while(index.size()<=n)
+    index.push_back(currOffset);
+
+  if(fwrite(encEntry.data(),1,encEntry.size(),outFile)!=encEntry.size())
+  {
+    std::cerr<<"Error while printing sparse anji file."<<std::endl;
+    return THOT_ERROR;
+  }
+  currOffset+=encEntry.size();
+
+  return THOT_OK;
+}
+
+//-------------------------
+bool SparseAnjiFileWriter::close(void)
+{
+  if(outFile==NULL)
+    return THOT_ERROR;
+
+      // Print index and footer
+  uint64_t indexOffset=currOffset;
+  uint32_t numEntries=index.size();
+  index.push_back(currOffset);
+  bool error=(fwrite(&index[0],sizeof(uint64_t),index.size(),outFile)!=index.size());
+  error=error || fwrite(&indexOffset,sizeof(uint64_t),1,outFile)!=1;
+  error=error || fwrite(&numEntries,sizeof(uint32_t),1,outFile)!=1;
+  uint32_t magic=SPARSE_ANJI_MAGIC;
+  error=error || fwrite(&magic,sizeof(uint32_t),1,outFile)!=1;
+  error=(fclose(outFile)!=0) || error;
+  outFile=NULL;
+
+  if(error || rename(tmpFileName.c_str(),finalFileName.c_str())!=0)
+  {
+    std::cerr<<"Error while printing sparse anji file."<<std::endl;
+    remove(tmpFileName.c_str());
+    return THOT_ERROR;
+  }
+
+  return THOT_OK;
+}
@@ -0,0 +1,208 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file SparseAnjiStore.h
+ *
+ * @brief Defines the SparseAnjiStore class.  SparseAnjiStore class
+ * provides pruned, disk-resident storage for the per-sentence
+ * expected values kept by anjiMatrix and anjm1ip_anjiMatrix.
+ * Persistent data is stored in a memory-mapped file that is paged in
+ * lazily, entries evicted from memory during training are spilled to
+ * a temporary file.
+ *
+ * Each entry is composed of a shape vector (interpreted by the
+ * matrix class) and a sequence of rows.  Only valid values are
+ * stored.  Rows are pruned by the training algorithms with
+ * pruneRow() before their contributions are gathered, so pruned values
+ * are invalid and contribute nothing to the sufficient statistics
+ * when the sentence is revisited.
+ *
+ * File layout (all integers in native byte order):
+ *  - header: magic, version, topk, reserved (4 x uint32)
+ *  - data: encoded entries, one after another
+ *  - index: numEntries+1 uint64 offsets, entry n is stored in the
+ *    byte range [index[n],index[n+1])
+ *  - footer: index offset (uint64), numEntries (uint32), magic
+ *    (uint32)
+ *
+ * Encoded entry: shapeLen (uint32), shape values (uint32 each),
+ * numRows (uint32) and, for each row, rowLen (uint32), k (uint32)
+ * and k (index uint32, value float) pairs.
+ *
+ */
+
+#ifndef _SparseAnjiStore_h
+#define _SparseAnjiStore_h
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+#include <string>
+#include <utility>
+#include <limits.h>
+#include <ErrorDefs.h>
+
+//--------------- Constants ------------------------------------------
+
+#define SPARSE_ANJI_MAGIC      0x534a4e41
+#define SPARSE_ANJI_VERSION    1
+#define UNRESTRICTED_ANJI_TOPK 0
+#define SPARSE_ANJI_MIN_DEAD_SPILL_BYTES (64*1024*1024) // The spill
+                                // file is compacted when it contains
+                                // more dead bytes than this value and
+                                // than live bytes
+
+//--------------- typedefs -------------------------------------------
+
+
+//--------------- function declarations ------------------------------
+
+//--------------- Classes --------------------------------------------
+
+//--------------- SparseAnjiStore class
+
+class SparseAnjiStore
+{
+  public:
+
+      // Constructor and destructor
+   SparseAnjiStore(void);
+   ~SparseAnjiStore();
+
+      // Functions to set pruning parameters
+   void set_topk(unsigned int _topk);
+   unsigned int get_topk(void)const;
+   void set_log_values(bool _logValues);
+       // Indicates that the values are logarithms
+   void pruneRow(float invalidVal,
+                 std::vector<float>& row)const;
+       // Keeps the top-k valid values of row, the remaining ones are
+       // set to invalidVal and their mass is distributed among the
+       // kept values in proportion to them
+
+       // Functions to attach and detach memory-mapped files
+   bool attach(const char* fileName);
+   bool is_attached(void)const;
+   void detach(void);
+
+       // Functions to access entries
+   unsigned int n_size(void)const;
+       // Returns one plus the index of the last stored entry
+   bool getEntry(unsigned int n,
+                 float invalidVal,
+                 std::vector<unsigned int>& shape,
+                 std::vector<std::vector<float> >& rows);
+       // Decodes entry n, values not stored are set to invalidVal.
+       // Returns false if entry n is not stored
+   bool getEncodedEntry(unsigned int n,
+                        std::string& encEntry);
+   bool spillEntry(unsigned int n,
+                   float invalidVal,
+                   const std::vector<unsigned int>& shape,
+                   const std::vector<std::vector<float> >& rows);
+       // Stores entry n in the spill file, previous versions of the
+       // entry are superseded. The new version overwrites the previous
+       // one if it fits in its slot, the space of the slots that are
+       // no longer used is reclaimed by compacting the file
+   void encodeEntry(float invalidVal,
+                    const std::vector<unsigned int>& shape,
+                    const std::vector<std::vector<float> >& rows,
+                    std::string& encEntry)const;
+
+       // clear() function
+   void clear(void);
+       // Detaches the memory-mapped file and discards spilled
+       // entries, the top-k value is kept
+
+  protected:
+
+   unsigned int topk;
+   bool logValues;
+
+       // Memory-mapped file data
+   const char* mapAddr;
+   size_t mapSize;
+   uint64_t mapIndexOffset;
+   unsigned int mapNumEntries;
+
+       // Spill file data
+   struct SpillSlot
+   {
+     uint64_t offset;
+     uint32_t len;       // Zero if the entry was not spilled
+     uint32_t capacity;  // Bytes available at offset
+     SpillSlot(void){offset=0;len=0;capacity=0;}
+   };
+   FILE* spillFile;
+   std::vector<SpillSlot> spillIndex;
+       // For each sentence index stores the slot of its entry in the
+       // spill file
+   uint64_t spillFileSize;
+   uint64_t spillLiveBytes;
+       // Bytes of the spill file that belong to slots in use
+
+       // Auxiliary functions
+   bool getMappedEncodedEntry(unsigned int n,
+                              const char*& entryPtr,
+                              size_t& entryLen)const;
+   bool decodeEntry(const char* entryPtr,
+                    size_t entryLen,
+                    float invalidVal,
+                    std::vector<unsigned int>& shape,
+                    std::vector<std::vector<float> >& rows)const;
+   bool compactSpillFile(void);
+       // Copies the slots in use to a new spill file
+};
+
+//--------------- SparseAnjiFileWriter class
+
+class SparseAnjiFileWriter
+{
+  public:
+
+      // Constructor and destructor
+   SparseAnjiFileWriter(void);
+   ~SparseAnjiFileWriter();
+
+       // Opens a temporary file next to fileName, the final file is
+       // created when close() is called
+   bool open(const char* fileName,
+             unsigned int topk);
+   bool addEntry(unsigned int n,
+                 const std::string& encEntry);
+       // Entries should be added in increasing order of n, missing
+       // entries are stored as empty
+   bool close(void);
+
+  protected:
+
+   FILE* outFile;
+   std::string finalFileName;
+   std::string tmpFileName;
+   std::vector<uint64_t> index;
+   uint64_t currOffset;
+};
+
+#endif
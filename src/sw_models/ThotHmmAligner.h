@@ -35,8 +35,9 @@ using namespace casmacat;
 class ThotHmmAligner: public IAlignmentEngine, Loggable {
   IncrHmmAligModel aligModel;
   Logger *_logger;
+  unsigned int numThreads;
 public:
-  ThotHmmAligner(): _logger(0) { }
+  ThotHmmAligner(): _logger(0), numThreads(1) { }
 
   virtual ~ThotHmmAligner() {
     LOG(INFO) << "ThotHmmAligner is now free!" << std::endl;
@@ -47,6 +48,16 @@ public:
                      const vector<string> &target,
                      vector< vector<float> > &alignments); 
 
+  // Aligns a batch of sentence pairs using numThreads threads,
+  // alignments are returned in the same order as the given pairs
+  void alignBatch(const vector< vector<string> > &sources,
+                  const vector< vector<string> > &targets,
+                  vector< vector< vector<float> > > &alignments);
+
+  void setNumThreads(unsigned int _numThreads) {
+    numThreads = (_numThreads > 0) ? _numThreads : 1;
+  }
+
   virtual void update(const std::vector<std::string> &source,
                       const std::vector<std::string> &target) {}
 
@@ -50,6 +50,32 @@ void ThotIbm2Aligner::align(const vector<string> &source,
   }
 }
 
+//-------------------------
+void ThotIbm2Aligner::alignBatch(const vector< vector<string> > &sources,
+                                 const vector< vector<string> > &targets,
+                                 vector< vector< vector<float> > > &alignments)
+{
+  std::vector<LgProb> lgProbVec;
+  std::vector<WordAligMatrix> waMatrixVec;
+  aligModel.obtainBestAlignmentBatchVecStr(sources, targets, numThreads, lgProbVec, waMatrixVec);
+
+  alignments.resize(waMatrixVec.size());
+  for (size_t n=0; n<waMatrixVec.size(); ++n) {
+    if (sources[n].size() == 0 || targets[n].size() == 0) {
+      LOG(INFO) << "WARNING: ThotIbm2Aligner received an empty source or target sentence!!" << std::endl << "WARNING: Returning empty alignment matrix!" << std::endl;
+      alignments[n].resize(0);
+      continue;
+    }
+    alignments[n].resize(sources[n].size());
+    for (size_t s=0; s<sources[n].size(); ++s) {
+      alignments[n][s].resize(targets[n].size());
+      for (size_t t=0; t<targets[n].size(); ++t) {
+        alignments[n][s][t] = waMatrixVec[n].getValue(s,t);
+      }
+    }
+  }
+}
+
 //-------------------------
 int ThotIbm2Aligner::init(char* filesPrefix)
 {
@@ -49,6 +49,19 @@ void _incrHmmAligModel::set_expval_maxnsize(unsigned int _expval_maxnsize)
   lanjm1ip_anji.set_maxnsize(_expval_maxnsize);
 }
 
+//-------------------------
+void _incrHmmAligModel::set_expval_topk(unsigned int _expval_topk)
+{
+  lanji.set_topk(_expval_topk,true);
+  lanjm1ip_anji.set_topk(_expval_topk,true);
+}
+
+//-------------------------
+bool _incrHmmAligModel::expValsArePruned(void)
+{
+  return lanji.get_topk()!=UNRESTRICTED_ANJI_TOPK;
+}
+
 //-------------------------
 unsigned int _incrHmmAligModel::numSentPairs(void)
 {
@@ -519,11 +532,11 @@ void _incrHmmAligModel::initCachedLexicalLps(const std::vector<WordIndex>& nSrcS
                                              const std::vector<WordIndex>& trgSentIndexVector,
                                              std::vector<std::vector<double> >& cachedLps)
 {
-      // Create data structure to cache lexical log-probs
-  std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,SMALL_LG_NUM);
-  cachedLps.clear();
-  cachedLps.insert(cachedLps.begin(),nSrcSentIndexVector.size()+1,dVec);
+      // Create data structure to cache lexical log-probs (row memory
+      // is reused)
+  cachedLps.resize(nSrcSentIndexVector.size()+1);
+  for(unsigned int i=0;i<cachedLps.size();++i)
+    cachedLps[i].assign(trgSentIndexVector.size()+1,SMALL_LG_NUM);
 
       // Cache lexical log-probs
   for(PositionIndex j=1;j<=trgSentIndexVector.size();++j)
@@ -751,7 +764,8 @@ void _incrHmmAligModel::calc_lanji(unsigned int n,
           // Store num in numVec
       numVec[i]=d;
     }
-        // Set value of lanji_aux
+        // Obtain expected values
+    std::vector<float> lanjiRow(nsrcSent.size()+1,INVALID_ANJI_VAL);
     for(unsigned int i=1;i<=nsrcSent.size();++i)
     {
           // Obtain expected value
@@ -759,8 +773,15 @@ void _incrHmmAligModel::calc_lanji(unsigned int n,
           // Smooth expected value
       if(lanji_val>EXP_VAL_LOG_MAX) lanji_val=EXP_VAL_LOG_MAX;
       if(lanji_val<EXP_VAL_LOG_MIN) lanji_val=EXP_VAL_LOG_MIN;
-          // Store expected value
-      lanji_aux.set_fast(mapped_n_aux,j,i,lanji_val);
+      lanjiRow[i]=lanji_val;
+    }
+        // Prune expected values if required
+    lanji.prune_row(lanjiRow);
+        // Set value of lanji_aux
+    for(unsigned int i=1;i<=nsrcSent.size();++i)
+    {
+      if(lanjiRow[i]!=INVALID_ANJI_VAL)
+        lanji_aux.set_fast(mapped_n_aux,j,i,lanjiRow[i]);
     }
   }
       // Gather lexical sufficient statistics
@@ -823,8 +844,9 @@ void _incrHmmAligModel::gatherLexSuffStats(unsigned int mapped_n,
           // Reestimate lexical parameters
       fillEmAuxVarsLex(mapped_n,mapped_n_aux,i,j,nsrcSent,trgSent,weight);
 
-          // Update lanji
-      lanji.set_fast(mapped_n,j,i,lanji_aux.get_invlogp(mapped_n_aux,j,i));
+          // Update lanji (values not set in lanji_aux are kept
+          // invalid, they have no contribution to be subtracted)
+      lanji.set_fast(mapped_n,j,i,lanji_aux.get_fast(mapped_n_aux,j,i));
     }
   }
 }
@@ -968,6 +990,7 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
       }
       else
       {
+        std::vector<float> lanjm1ip_anjiRow(nsrcSent.size()+1,INVALID_ANJM1IP_ANJI_VAL);
         for(unsigned int ip=1;ip<=nsrcSent.size();++ip)
         {
               // Obtain information about alignment
@@ -979,8 +1002,15 @@ void _incrHmmAligModel::calc_lanjm1ip_anji(unsigned int n,
                 // Smooth expected value
             if(lanjm1ip_anji_val>EXP_VAL_LOG_MAX) lanjm1ip_anji_val=EXP_VAL_LOG_MAX;
             if(lanjm1ip_anji_val<EXP_VAL_LOG_MIN) lanjm1ip_anji_val=EXP_VAL_LOG_MIN;
-            lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anji_val);
+            lanjm1ip_anjiRow[ip]=lanjm1ip_anji_val;
           }
+        }
+            // Prune expected values if required
+        lanjm1ip_anji.prune_row(lanjm1ip_anjiRow);
+        for(unsigned int ip=1;ip<=nsrcSent.size();++ip)
+        {
+          if(lanjm1ip_anjiRow[ip]!=INVALID_ANJM1IP_ANJI_VAL)
+            lanjm1ip_anji_aux.set_fast(mapped_n_aux,j,i,ip,lanjm1ip_anjiRow[ip]);
         }
       }
     }
@@ -1079,8 +1109,9 @@ void _incrHmmAligModel::gatherAligSuffStats(unsigned int mapped_n,
           {
                 // Reestimate alignment parameters
             fillEmAuxVarsAlig(mapped_n,mapped_n_aux,slen,ip,i,j,weight);
-                // Update lanjm1ip_anji
-            lanjm1ip_anji.set_fast(mapped_n,j,i,ip,lanjm1ip_anji_aux.get_invlogp_fast(mapped_n_aux,j,i,ip));
+                // Update lanjm1ip_anji (values not set in
+                // lanjm1ip_anji_aux are kept invalid)
+            lanjm1ip_anji.set_fast(mapped_n,j,i,ip,lanjm1ip_anji_aux.get_fast(mapped_n_aux,j,i,ip));
           }
         }
       }
@@ -1301,10 +1332,16 @@ void _incrHmmAligModel::updateParsLex(void)
 
             // Obtain new sufficient statistics
         float new_numer=obtainLogNewSuffStat(numer,log_suff_stat_curr,log_suff_stat_new);
-        float new_denom=denom;
-        if(numer!=SMALL_LG_NUM)
-          new_denom=MathFuncs::lns_sublog_float(denom,numer);
-        new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+        float new_denom;
+        if(expValsArePruned())
+          new_denom=obtainLogNewSuffStat(denom,numer,new_numer);
+        else
+        {
+          new_denom=denom;
+          if(numer!=SMALL_LG_NUM)
+            new_denom=MathFuncs::lns_sublog_float(denom,numer);
+          new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+        }
 
             // Set lexical numerator and denominator
         incrLexTable->setLexNumDen(s,t,new_numer,new_denom);
@@ -1341,8 +1378,14 @@ void _incrHmmAligModel::updateParsAlig(void)
 
           // Obtain new sufficient statistics
       float new_numer=obtainLogNewSuffStat(numer,log_suff_stat_curr,log_suff_stat_new);
-      float new_denom=MathFuncs::lns_sublog_float(denom,numer);
-      new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+      float new_denom;
+      if(expValsArePruned())
+        new_denom=obtainLogNewSuffStat(denom,numer,new_numer);
+      else
+      {
+        new_denom=MathFuncs::lns_sublog_float(denom,numer);
+        new_denom=MathFuncs::lns_sumlog_float(new_denom,new_numer);
+      }
 
           // Set lexical numerator and denominator
       incrHmmAligTable.setAligNumDen(asHmm,i,new_numer,new_denom);
@@ -1357,6 +1400,12 @@ float _incrHmmAligModel::obtainLogNewSuffStat(float lcurrSuffStat,
                                               float lLocalSuffStatCurr,
                                               float lLocalSuffStatNew)
 {
+      // When the expected values are pruned, the local statistic may
+      // exceed the global one due to rounding errors if the remaining
+      // mass is negligible
+  if(expValsArePruned() && lLocalSuffStatCurr>=lcurrSuffStat)
+    return lLocalSuffStatNew;
+  
   float lresult=MathFuncs::lns_sublog_float(lcurrSuffStat,lLocalSuffStatCurr);
   lresult=MathFuncs::lns_sumlog_float(lresult,lLocalSuffStatNew);
   return lresult;
@@ -1406,17 +1455,37 @@ LgProb _incrHmmAligModel::obtainBestAlignmentCached(std::vector<WordIndex> srcSe
                                                     std::vector<WordIndex> trgSentIndexVector,
                                                     CachedHmmAligLgProb& cached_logap,
                                                     WordAligMatrix& bestWaMatrix)
+{
+  std::vector<std::vector<double> > cached_logpts;
+  std::vector<std::vector<double> > vitMatrix;
+  std::vector<std::vector<PositionIndex> > predMatrix;
+  return obtainBestAlignmentScratch(srcSentIndexVector,
+                                    trgSentIndexVector,
+                                    cached_logap,
+                                    cached_logpts,
+                                    vitMatrix,
+                                    predMatrix,
+                                    bestWaMatrix);
+}
+
+//-------------------------
+LgProb _incrHmmAligModel::obtainBestAlignmentScratch(const std::vector<WordIndex>& srcSentIndexVector,
+                                                     const std::vector<WordIndex>& trgSentIndexVector,
+                                                     CachedHmmAligLgProb& cached_logap,
+                                                     std::vector<std::vector<double> >& cached_logpts,
+                                                     std::vector<std::vector<double> >& vitMatrix,
+                                                     std::vector<std::vector<PositionIndex> >& predMatrix,
+                                                     WordAligMatrix& bestWaMatrix)
 {
   if(sentenceLengthIsOk(srcSentIndexVector) && sentenceLengthIsOk(trgSentIndexVector))
   {
         // Obtain extended source vector
     std::vector<WordIndex> nSrcSentIndexVector=extendWithNullWord(srcSentIndexVector);
         // Call function to obtain best lgprob and viterbi alignment
-    std::vector<std::vector<double> > vitMatrix;
-    std::vector<std::vector<PositionIndex> > predMatrix;
     viterbiAlgorithmCached(nSrcSentIndexVector,
                            trgSentIndexVector,
                            cached_logap,
+                           cached_logpts,
                            vitMatrix,
                            predMatrix);
     std::vector<PositionIndex> bestAlig;
@@ -1438,6 +1507,33 @@ LgProb _incrHmmAligModel::obtainBestAlignmentCached(std::vector<WordIndex> srcSe
   }
 }
 
+//-------------------------
+void _incrHmmAligModel::obtainBestAlignmentRange(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                                 const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                                 unsigned int begin,
+                                                 unsigned int end,
+                                                 std::vector<LgProb>& lgProbVec,
+                                                 std::vector<WordAligMatrix>& bestWaMatrixVec)
+{
+      // Auxiliary data structures are shared by the pairs of the
+      // range. Alignment log-probs only depend on the source length,
+      // so they can be reused across sentence pairs
+  CachedHmmAligLgProb cached_logap;
+  std::vector<std::vector<double> > cached_logpts;
+  std::vector<std::vector<double> > vitMatrix;
+  std::vector<std::vector<PositionIndex> > predMatrix;
+  for(unsigned int n=begin;n<end;++n)
+  {
+    lgProbVec[n]=obtainBestAlignmentScratch(srcSentIndexVectors[n],
+                                            trgSentIndexVectors[n],
+                                            cached_logap,
+                                            cached_logpts,
+                                            vitMatrix,
+                                            predMatrix,
+                                            bestWaMatrixVec[n]);
+  }
+}
+
 //-------------------------
 void _incrHmmAligModel::viterbiAlgorithm(const std::vector<WordIndex>& nSrcSentIndexVector,
                                          const std::vector<WordIndex>& trgSentIndexVector,
@@ -1454,25 +1550,32 @@ void _incrHmmAligModel::viterbiAlgorithmCached(const std::vector<WordIndex>& nSr
                                                CachedHmmAligLgProb& cached_logap,
                                                std::vector<std::vector<double> >& vitMatrix,
                                                std::vector<std::vector<PositionIndex> >& predMatrix)
+{
+  std::vector<std::vector<double> > cached_logpts;
+  viterbiAlgorithmCached(nSrcSentIndexVector,trgSentIndexVector,cached_logap,cached_logpts,vitMatrix,predMatrix);
+}
+
+//-------------------------
+void _incrHmmAligModel::viterbiAlgorithmCached(const std::vector<WordIndex>& nSrcSentIndexVector,
+                                               const std::vector<WordIndex>& trgSentIndexVector,
+                                               CachedHmmAligLgProb& cached_logap,
+                                               std::vector<std::vector<double> >& cached_logpts,
+                                               std::vector<std::vector<double> >& vitMatrix,
+                                               std::vector<std::vector<PositionIndex> >& predMatrix)
 {
       // Obtain slen
   PositionIndex slen=getSrcLen(nSrcSentIndexVector);
 
-      // Clear matrices
-  vitMatrix.clear();
-  predMatrix.clear();
-
-      // Make room for matrices
-  std::vector<double> dVec;
-  dVec.insert(dVec.begin(),trgSentIndexVector.size()+1,SMALL_LG_NUM);
-  vitMatrix.insert(vitMatrix.begin(),nSrcSentIndexVector.size()+1,dVec);
-
-  std::vector<PositionIndex> pidxVec;
-  pidxVec.insert(pidxVec.begin(),trgSentIndexVector.size()+1,0);
-  predMatrix.insert(predMatrix.begin(),nSrcSentIndexVector.size()+1,pidxVec);
+      // Make room for matrices (row memory is reused)
+  vitMatrix.resize(nSrcSentIndexVector.size()+1);
+  predMatrix.resize(nSrcSentIndexVector.size()+1);
+  for(unsigned int i=0;i<vitMatrix.size();++i)
+  {
+    vitMatrix[i].assign(trgSentIndexVector.size()+1,SMALL_LG_NUM);
+    predMatrix[i].assign(trgSentIndexVector.size()+1,0);
+  }
 
       // Initialize data structure to cache lexical log-probs
-  std::vector<std::vector<double> > cached_logpts;
   initCachedLexicalLps(nSrcSentIndexVector,trgSentIndexVector,cached_logpts);
 
       // Fill matrices
@@ -1904,6 +2007,7 @@ bool _incrHmmAligModel::load(const char* prefFileName)
         // Load file with lexical nd values
     std::string lexNumDenFile=prefFileName;
     lexNumDenFile=lexNumDenFile+lexNumDenFileExtension;
+    applyLexLoadFilters(*incrLexTable);
     retVal=incrLexTable->load(lexNumDenFile.c_str());
     if(retVal==THOT_ERROR) return THOT_ERROR;
 
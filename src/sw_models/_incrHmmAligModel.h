@@ -84,6 +84,9 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    void set_expval_maxnsize(unsigned int _expval_maxnsize);
        // Function to set a maximum size for the matrices of expected
        // values (by default the size is not restricted)
+   void set_expval_topk(unsigned int _expval_topk);
+       // Function to keep only the top-k expected values for each
+       // target position (by default no pruning is applied)
 
    // Functions to read and add sentence pairs
    unsigned int numSentPairs(void);
@@ -295,6 +298,32 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
                                std::vector<std::vector<double> >& vitMatrix,
                                std::vector<std::vector<PositionIndex> >& predMatrix);
        // Cached version of viterbiAlgorithm()
+   void viterbiAlgorithmCached(const std::vector<WordIndex>& nSrcSentIndexVector,
+                               const std::vector<WordIndex>& trgSentIndexVector,
+                               CachedHmmAligLgProb& cached_logap,
+                               std::vector<std::vector<double> >& cached_logpts,
+                               std::vector<std::vector<double> >& vitMatrix,
+                               std::vector<std::vector<PositionIndex> >& predMatrix);
+       // The same as the previous one, but the matrix used to cache
+       // lexical log-probs is also given. Memory of the given matrices
+       // is reused when possible
+   LgProb obtainBestAlignmentScratch(const std::vector<WordIndex>& srcSentIndexVector,
+                                     const std::vector<WordIndex>& trgSentIndexVector,
+                                     CachedHmmAligLgProb& cached_logap,
+                                     std::vector<std::vector<double> >& cached_logpts,
+                                     std::vector<std::vector<double> >& vitMatrix,
+                                     std::vector<std::vector<PositionIndex> >& predMatrix,
+                                     WordAligMatrix& bestWaMatrix);
+       // Obtains the best alignment using the given auxiliary data
+       // structures
+   void obtainBestAlignmentRange(const std::vector<std::vector<WordIndex> >& srcSentIndexVectors,
+                                 const std::vector<std::vector<WordIndex> >& trgSentIndexVectors,
+                                 unsigned int begin,
+                                 unsigned int end,
+                                 std::vector<LgProb>& lgProbVec,
+                                 std::vector<WordAligMatrix>& bestWaMatrixVec);
+       // Aligns a range of a batch of sentence pairs sharing the
+       // Viterbi matrices and the cached alignment log-probs
 
    double bestAligGivenVitMatricesRaw(const std::vector<std::vector<double> >& vitMatrix,
                                       const std::vector<std::vector<PositionIndex> >& predMatrix,
@@ -424,6 +453,9 @@ class _incrHmmAligModel: public _incrSwAligModel<std::vector<Prob> >
    virtual float obtainLogNewSuffStat(float lcurrSuffStat,
                                       float lLocalSuffStatCurr,
                                       float lLocalSuffStatNew);
+   bool expValsArePruned(void);
+       // Returns true if only the top-k expected values are kept (see
+       // set_expval_topk())
 };
 
 #endif
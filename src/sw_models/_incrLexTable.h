@@ -78,6 +78,13 @@ class _incrLexTable
        // load function
    virtual bool load(const char* lexNumDenFile) = 0;
 
+       // Functions to restrict the entries obtained by the load()
+       // function to those involving the given words (tables that
+       // are not loaded in memory ignore these filters)
+   virtual void setSrcLoadFilter(const std::set<WordIndex>& /*srcWordSet*/) {};
+   virtual void setTrgLoadFilter(const std::set<WordIndex>& /*trgWordSet*/) {};
+   virtual void clearLoadFilters(void) {};
+
        // print function
    virtual bool print(const char* lexNumDenFile) = 0;
 
@@ -35,6 +35,9 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include "_swAligModel.h"
+#include "_incrLexTable.h"
+#include <set>
+#include <string>
 
 //--------------- Constants ------------------------------------------
 
@@ -57,17 +60,53 @@ class _incrSwAligModel: public _swAligModel<PPINFO>
 
   typedef typename _swAligModel<PPINFO>::PpInfo PpInfo;
 
+      // Constructor
+  _incrSwAligModel(void);
+
   virtual void set_expval_maxnsize(unsigned int _anji_maxnsize)=0;
       // Function to set a maximum size for the vector of expected
       // values anji (by default the size is not restricted)
+  virtual void set_expval_topk(unsigned int _anji_topk)=0;
+      // Function to keep only the top-k expected values for each
+      // target position. Pruned values are stored in disk-resident
+      // sparse files (by default no pruning is applied)
 
   virtual void efficientBatchTrainingForRange(std::pair<unsigned int,unsigned int> sentPairRange,
                                               int verbosity=0);
   void efficientBatchTrainingForAllSents(int verbosity=0);
+
+      // Functions to restrict the lexical parameters obtained by
+      // subsequent calls to load() to the entries of the given source
+      // or target words. They are intended for decoding-only
+      // processes, since the filtered models cannot be trained or
+      // printed without losing information
+  void setSrcLexLoadFilter(const std::set<std::string>& srcWordSet);
+  void setTrgLexLoadFilter(const std::set<std::string>& trgWordSet);
+  void clearLexLoadFilters(void);
+
+ protected:
+
+  bool srcLexLoadFilterEnabled;
+  std::set<std::string> srcLexLoadFilter;
+  bool trgLexLoadFilterEnabled;
+  std::set<std::string> trgLexLoadFilter;
+
+  void applyLexLoadFilters(_incrLexTable& lexTable);
+      // Sets the load filters of lexTable given the current
+      // vocabularies (they should be loaded before calling this
+      // function)
 };
 
 //--------------- _incrSwAligModel class method definitions
 
+//-------------------------
+template<class PPINFO>
+_incrSwAligModel<PPINFO>::_incrSwAligModel(void)
+{
+  srcLexLoadFilterEnabled=false;
+  trgLexLoadFilterEnabled=false;
+}
+
 //-------------------------
 template<class PPINFO>
 void _incrSwAligModel<PPINFO>::efficientBatchTrainingForRange(std::pair<unsigned int,unsigned int> /*sentPairRange*/,
@@ -83,6 +122,64 @@ void _incrSwAligModel<PPINFO>::efficientBatchTrainingForAllSents(int verbosity/*
   efficientBatchTrainingForRange(std::make_pair(0,this->numSentPairs()-1),verbosity);
 }
 
+//-------------------------
+template<class PPINFO>
+void _incrSwAligModel<PPINFO>::setSrcLexLoadFilter(const std::set<std::string>& srcWordSet)
+{
+  srcLexLoadFilterEnabled=true;
+  srcLexLoadFilter=srcWordSet;
+}
+
+//-------------------------
+template<class PPINFO>
+void _incrSwAligModel<PPINFO>::setTrgLexLoadFilter(const std::set<std::string>& trgWordSet)
+{
+  trgLexLoadFilterEnabled=true;
+  trgLexLoadFilter=trgWordSet;
+}
+
+//-------------------------
+template<class PPINFO>
+void _incrSwAligModel<PPINFO>::clearLexLoadFilters(void)
+{
+  srcLexLoadFilterEnabled=false;
+  srcLexLoadFilter.clear();
+  trgLexLoadFilterEnabled=false;
+  trgLexLoadFilter.clear();
+}
+
+//-------------------------
+template<class PPINFO>
+void _incrSwAligModel<PPINFO>::applyLexLoadFilters(_incrLexTable& lexTable)
+{
+  lexTable.clearLoadFilters();
+  std::set<std::string>::const_iterator setIter;
+
+  if(srcLexLoadFilterEnabled)
+  {
+        // The entries for the NULL word are always kept
+    std::set<WordIndex> srcWordIdxSet;
+    srcWordIdxSet.insert(NULL_WORD);
+    for(setIter=srcLexLoadFilter.begin();setIter!=srcLexLoadFilter.end();++setIter)
+    {
+      if(this->existSrcSymbol(*setIter))
+        srcWordIdxSet.insert(this->stringToSrcWordIndex(*setIter));
+    }
+    lexTable.setSrcLoadFilter(srcWordIdxSet);
+  }
+
+  if(trgLexLoadFilterEnabled)
+  {
+    std::set<WordIndex> trgWordIdxSet;
+    for(setIter=trgLexLoadFilter.begin();setIter!=trgLexLoadFilter.end();++setIter)
+    {
+      if(this->existTrgSymbol(*setIter))
+        trgWordIdxSet.insert(this->stringToTrgWordIndex(*setIter));
+    }
+    lexTable.setTrgLoadFilter(trgWordIdxSet);
+  }
+}
+
 //-------------------------
 
 #endif
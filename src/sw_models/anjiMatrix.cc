@@ -45,6 +45,7 @@ anjiMatrix::anjiMatrix(void)
 {
   anji_maxnsize=UNRESTRICTED_ANJI_SIZE;
   anji_pointer=0;
+  sparse=false;
 }
 
 //-------------------------
@@ -64,6 +65,10 @@ bool anjiMatrix::init_nth_entry(unsigned int n,
       anji.resize(mapped_n+1);
     }
 
+        // Page in entry from disk if necessary
+    if(sparse && anji[mapped_n].empty())
+      page_in_entry(n,mapped_n);
+
         // Check if entry has enough room
     if(resizeIsRequired(mapped_n,nslen,tlen))
     {
@@ -130,6 +135,28 @@ unsigned int anjiMatrix::get_maxnsize(void)
   return anji_maxnsize;
 }
 
+//-------------------------
+void anjiMatrix::set_topk(unsigned int _anji_topk,
+                          bool logValues/*=false*/)
+{
+  anjiStore.set_topk(_anji_topk);
+  anjiStore.set_log_values(logValues);
+  if(_anji_topk!=UNRESTRICTED_ANJI_TOPK)
+    sparse=true;
+}
+
+//-------------------------
+unsigned int anjiMatrix::get_topk(void)
+{
+  return anjiStore.get_topk();
+}
+
+//-------------------------
+void anjiMatrix::prune_row(std::vector<float>& row)
+{
+  anjiStore.pruneRow(INVALID_ANJI_VAL,row);
+}
+
 //-------------------------
 unsigned int anjiMatrix::n_size(void)
 {
@@ -157,10 +184,21 @@ bool anjiMatrix::load(const char* prefFileName)
 
       // Load information from files
   bool retVal;
-  std::string anjiFile=prefFileName;
-  anjiFile=anjiFile+".anji";
-  retVal=load_anji_values(anjiFile.c_str());
-  if(retVal==THOT_ERROR) return THOT_ERROR;
+  std::string sparseAnjiFile=prefFileName;
+  sparseAnjiFile=sparseAnjiFile+".anjisp";
+  if(anjiStore.attach(sparseAnjiFile.c_str())==THOT_OK)
+  {
+        // Entries will be paged in when required
+    std::cerr<<"Sparse file with anji values "<<sparseAnjiFile<<" mapped in memory"<<std::endl;
+    sparse=true;
+  }
+  else
+  {
+    std::string anjiFile=prefFileName;
+    anjiFile=anjiFile+".anji";
+    retVal=load_anji_values(anjiFile.c_str());
+    if(retVal==THOT_ERROR) return THOT_ERROR;
+  }
 
   std::string maxnsizeDataFile=prefFileName;
   maxnsizeDataFile=maxnsizeDataFile+".msinfo";
@@ -247,9 +285,18 @@ bool anjiMatrix::load_maxnsize_data(const char* maxnsizeDataFile)
 bool anjiMatrix::print(const char* prefFileName)
 {
   bool retVal;
-  std::string anjiFile=prefFileName;
-  anjiFile=anjiFile+".anji";
-  retVal=print_anji_values(anjiFile.c_str());
+  if(sparse)
+  {
+    std::string sparseAnjiFile=prefFileName;
+    sparseAnjiFile=sparseAnjiFile+".anjisp";
+    retVal=print_sparse_anji_values(sparseAnjiFile.c_str());
+  }
+  else
+  {
+    std::string anjiFile=prefFileName;
+    anjiFile=anjiFile+".anji";
+    retVal=print_anji_values(anjiFile.c_str());
+  }
   if(retVal==THOT_ERROR) return THOT_ERROR;
 
   if(anji_maxnsize!=UNRESTRICTED_ANJI_SIZE)
@@ -293,6 +340,46 @@ bool anjiMatrix::print_anji_values(const char* anjiFile)
   }
 }
 
+//-------------------------
+bool anjiMatrix::print_sparse_anji_values(const char* anjiFile)
+{
+  SparseAnjiFileWriter writer;
+  if(writer.open(anjiFile,anjiStore.get_topk())==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Determine number of entries
+  unsigned int numEntries=anjiStore.n_size();
+  if(anji_maxnsize==UNRESTRICTED_ANJI_SIZE)
+    numEntries=std::max(numEntries,(unsigned int)anji.size());
+  else
+    numEntries=std::max(numEntries,(unsigned int)n_to_np_vector.size());
+
+      // Print entries, those mapped in anji take precedence over those
+      // stored on disk
+  std::vector<unsigned int> shape;
+  std::string encEntry;
+  for(unsigned int n=0;n<numEntries;++n)
+  {
+    unsigned int np;
+    bool found;
+    if(n_is_mapped_in_matrix(n,np) && np<anji.size() && !anji[np].empty())
+    {
+      anjiStore.encodeEntry(INVALID_ANJI_VAL,shape,anji[np],encEntry);
+      found=true;
+    }
+    else
+      found=anjiStore.getEncodedEntry(n,encEntry);
+
+    if(found)
+    {
+      if(writer.addEntry(n,encEntry)==THOT_ERROR)
+        return THOT_ERROR;
+    }
+  }
+
+  return writer.close();
+}
+
 //-------------------------   
 bool anjiMatrix::print_maxnsize_data(const char* maxnsizeDataFile)
 {
@@ -487,7 +574,10 @@ void anjiMatrix::map_n_in_matrix(unsigned int n,
             // Update old n to np correspondence
         update_n_to_np_vector(pbui.second,std::make_pair(false,0));
             // Clear anji entry for old index
-        anji[np].clear();
+        if(sparse)
+          spill_entry(pbui.second,np);
+        if(np<anji.size())
+          anji[np].clear();
       }
       
           // Update np to n mapping
@@ -499,6 +589,26 @@ void anjiMatrix::map_n_in_matrix(unsigned int n,
   }
 }
 
+//-------------------------
+void anjiMatrix::spill_entry(unsigned int n,
+                             unsigned int np)
+{
+  if(np<anji.size() && !anji[np].empty())
+  {
+    std::vector<unsigned int> shape;
+    anjiStore.spillEntry(n,INVALID_ANJI_VAL,shape,anji[np]);
+  }
+}
+
+//-------------------------
+void anjiMatrix::page_in_entry(unsigned int n,
+                               unsigned int np)
+{
+  std::vector<unsigned int> shape;
+  if(!anjiStore.getEntry(n,INVALID_ANJI_VAL,shape,anji[np]))
+    anji[np].clear();
+}
+
 //-------------------------
 std::pair<bool,unsigned int> anjiMatrix::read_np_to_n_vector(unsigned int np)
 {
@@ -548,6 +658,7 @@ void anjiMatrix::clear(void)
 {
   anji_pointer=0;
   anji.clear();
+  anjiStore.clear();
   np_to_n_vector.clear();
   n_to_np_vector.clear();
 }
@@ -35,8 +35,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include <AwkInputStream.h>
+#include "SparseAnjiStore.h"
 #include <vector>
 #include <utility>
+#include <algorithm>
 #include <limits.h>
 #include <StatModelDefs.h>
 #include <MathDefs.h>
@@ -72,6 +74,18 @@ class anjiMatrix
       // Functions to handle anji
    void set_maxnsize(unsigned int _anji_maxnsize);
    unsigned int get_maxnsize(void);
+   void set_topk(unsigned int _anji_topk,
+                 bool logValues=false);
+       // Enables sparse storage keeping only the top-k values for
+       // each j.  Entries evicted from memory are spilled to disk and
+       // paged in again when required.  logValues indicates that the
+       // matrix stores logarithms
+   unsigned int get_topk(void);
+   void prune_row(std::vector<float>& row);
+       // Keeps the top-k values of a row of new expected values (for
+       // a given j), the remaining ones are set to INVALID_ANJI_VAL.
+       // It should be applied before the contributions of the row are
+       // gathered, so pruned values contribute nothing
    unsigned int n_size(void);
    unsigned int nj_size(unsigned int n);
    unsigned int nji_size(unsigned int n,
@@ -105,6 +119,8 @@ class anjiMatrix
 
        // load function
    bool load(const char* prefFileName);
+       // If a sparse file (.anjisp) is found it is memory-mapped and
+       // its entries are paged in lazily
    
        // print function
    bool print(const char* prefFileName);
@@ -119,6 +135,9 @@ class anjiMatrix
    std::vector<std::vector<std::vector<float> > > anji;
        // Use simple precission floating-point numbers for expected
        // values
+   bool sparse;
+   SparseAnjiStore anjiStore;
+       // Disk-resident storage for entries not mapped in anji
    std::vector<std::pair<bool,unsigned int> > np_to_n_vector;
        // For each index of anji stores if it is already used and the
        // real index of the sample
@@ -143,9 +162,16 @@ class anjiMatrix
    void update_n_to_np_vector(unsigned int n,
                               std::pair<bool,unsigned int> pbui);
 
+       // Functions to move entries between anji and anjiStore
+   void spill_entry(unsigned int n,
+                    unsigned int np);
+   void page_in_entry(unsigned int n,
+                      unsigned int np);
+
        // Functions to load and print anji matrices
    bool load_anji_values(const char* anjiFile);   
    bool print_anji_values(const char* anjiFile);
+   bool print_sparse_anji_values(const char* anjiFile);
 
        // Functions to load and print maximum size data
    bool load_maxnsize_data(const char* maxnsizeDataFile);
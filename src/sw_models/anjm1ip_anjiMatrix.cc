@@ -42,6 +42,7 @@ anjm1ip_anjiMatrix::anjm1ip_anjiMatrix(void)
 {
   anjm1ip_anji_maxnsize=UNRESTRICTED_ANJM1IP_ANJI_SIZE;
   anjm1ip_anji_pointer=0;
+  sparse=false;
 }
 
 //-------------------------
@@ -60,6 +61,10 @@ bool anjm1ip_anjiMatrix::init_nth_entry(unsigned int n,
     {
       anjm1ip_anji.resize(mapped_n+1);
     }
+
+        // Page in entry from disk if necessary
+    if(sparse && anjm1ip_anji[mapped_n].empty())
+      page_in_entry(n,mapped_n);
     
         // Check if entry has enough room
     if(resizeIsRequired(mapped_n,nslen,tlen))
@@ -134,6 +139,28 @@ unsigned int anjm1ip_anjiMatrix::get_maxnsize(void)
   return anjm1ip_anji_maxnsize;
 }
 
+//-------------------------
+void anjm1ip_anjiMatrix::set_topk(unsigned int _anjm1ip_anji_topk,
+                                  bool logValues/*=false*/)
+{
+  anjm1ip_anjiStore.set_topk(_anjm1ip_anji_topk);
+  anjm1ip_anjiStore.set_log_values(logValues);
+  if(_anjm1ip_anji_topk!=UNRESTRICTED_ANJI_TOPK)
+    sparse=true;
+}
+
+//-------------------------
+unsigned int anjm1ip_anjiMatrix::get_topk(void)
+{
+  return anjm1ip_anjiStore.get_topk();
+}
+
+//-------------------------
+void anjm1ip_anjiMatrix::prune_row(std::vector<float>& row)
+{
+  anjm1ip_anjiStore.pruneRow(INVALID_ANJM1IP_ANJI_VAL,row);
+}
+
 //-------------------------
 unsigned int anjm1ip_anjiMatrix::n_size(void)
 {
@@ -346,7 +373,10 @@ void anjm1ip_anjiMatrix::map_n_in_matrix(unsigned int n,
             // Update old n to np correspondence
         update_n_to_np_vector(pbui.second,std::make_pair(false,0));
             // Clear anji entry for old index
-        anjm1ip_anji[np].clear();
+        if(sparse)
+          spill_entry(pbui.second,np);
+        if(np<anjm1ip_anji.size())
+          anjm1ip_anji[np].clear();
       }
       
           // Update np to n mapping
@@ -358,6 +388,48 @@ void anjm1ip_anjiMatrix::map_n_in_matrix(unsigned int n,
   }
 }
 
+//-------------------------
+void anjm1ip_anjiMatrix::spill_entry(unsigned int n,
+                                     unsigned int np)
+{
+  if(np<anjm1ip_anji.size() && !anjm1ip_anji[np].empty())
+  {
+        // Flatten (j,i) rows, the shape stores the number of rows
+        // for each j
+    std::vector<unsigned int> shape;
+    std::vector<std::vector<float> > rows;
+    for(unsigned int j=0;j<anjm1ip_anji[np].size();++j)
+    {
+      shape.push_back(anjm1ip_anji[np][j].size());
+      rows.insert(rows.end(),anjm1ip_anji[np][j].begin(),anjm1ip_anji[np][j].end());
+    }
+    anjm1ip_anjiStore.spillEntry(n,INVALID_ANJM1IP_ANJI_VAL,shape,rows);
+  }
+}
+
+//-------------------------
+void anjm1ip_anjiMatrix::page_in_entry(unsigned int n,
+                                       unsigned int np)
+{
+  std::vector<unsigned int> shape;
+  std::vector<std::vector<float> > rows;
+  anjm1ip_anji[np].clear();
+  if(anjm1ip_anjiStore.getEntry(n,INVALID_ANJM1IP_ANJI_VAL,shape,rows))
+  {
+        // Rebuild (j,i) structure from flattened rows
+    unsigned int r=0;
+    anjm1ip_anji[np].resize(shape.size());
+    for(unsigned int j=0;j<shape.size();++j)
+    {
+      for(unsigned int i=0;i<shape[j] && r<rows.size();++i,++r)
+      {
+        anjm1ip_anji[np][j].push_back(std::vector<float>());
+        anjm1ip_anji[np][j].back().swap(rows[r]);
+      }
+    }
+  }
+}
+
 //-------------------------
 std::pair<bool,unsigned int> anjm1ip_anjiMatrix::read_np_to_n_vector(unsigned int np)
 {
@@ -410,10 +482,21 @@ bool anjm1ip_anjiMatrix::load(const char* prefFileName)
 
       // Load information from files
   bool retVal;
-  std::string matrixFile=prefFileName;
-  matrixFile=matrixFile+".anjm1ip_anji";
-  retVal=load_matrix_values(matrixFile.c_str());
-  if(retVal==THOT_ERROR) return THOT_ERROR;
+  std::string sparseMatrixFile=prefFileName;
+  sparseMatrixFile=sparseMatrixFile+".anjm1ip_anjisp";
+  if(anjm1ip_anjiStore.attach(sparseMatrixFile.c_str())==THOT_OK)
+  {
+        // Entries will be paged in when required
+    std::cerr<<"Sparse file with anjm1ip_anji values "<<sparseMatrixFile<<" mapped in memory"<<std::endl;
+    sparse=true;
+  }
+  else
+  {
+    std::string matrixFile=prefFileName;
+    matrixFile=matrixFile+".anjm1ip_anji";
+    retVal=load_matrix_values(matrixFile.c_str());
+    if(retVal==THOT_ERROR) return THOT_ERROR;
+  }
 
   std::string maxnsizeDataFile=prefFileName;
   maxnsizeDataFile=maxnsizeDataFile+".msinfo";
@@ -501,9 +584,18 @@ bool anjm1ip_anjiMatrix::load_maxnsize_data(const char* maxnsizeDataFile)
 bool anjm1ip_anjiMatrix::print(const char* prefFileName)
 {
   bool retVal;
-  std::string matrixFile=prefFileName;
-  matrixFile=matrixFile+".anjm1ip_anji";
-  retVal=print_matrix_values(matrixFile.c_str());
+  if(sparse)
+  {
+    std::string sparseMatrixFile=prefFileName;
+    sparseMatrixFile=sparseMatrixFile+".anjm1ip_anjisp";
+    retVal=print_sparse_matrix_values(sparseMatrixFile.c_str());
+  }
+  else
+  {
+    std::string matrixFile=prefFileName;
+    matrixFile=matrixFile+".anjm1ip_anji";
+    retVal=print_matrix_values(matrixFile.c_str());
+  }
   if(retVal==THOT_ERROR) return THOT_ERROR;
 
   if(anjm1ip_anji_maxnsize!=UNRESTRICTED_ANJM1IP_ANJI_SIZE)
@@ -551,6 +643,54 @@ bool anjm1ip_anjiMatrix::print_matrix_values(const char* matrixFile)
   }
 }
 
+//-------------------------
+bool anjm1ip_anjiMatrix::print_sparse_matrix_values(const char* matrixFile)
+{
+  SparseAnjiFileWriter writer;
+  if(writer.open(matrixFile,anjm1ip_anjiStore.get_topk())==THOT_ERROR)
+    return THOT_ERROR;
+
+      // Determine number of entries
+  unsigned int numEntries=anjm1ip_anjiStore.n_size();
+  if(anjm1ip_anji_maxnsize==UNRESTRICTED_ANJM1IP_ANJI_SIZE)
+    numEntries=std::max(numEntries,(unsigned int)anjm1ip_anji.size());
+  else
+    numEntries=std::max(numEntries,(unsigned int)n_to_np_vector.size());
+
+      // Print entries, those mapped in anjm1ip_anji take precedence
+      // over those stored on disk
+  std::vector<unsigned int> shape;
+  std::vector<std::vector<float> > rows;
+  std::string encEntry;
+  for(unsigned int n=0;n<numEntries;++n)
+  {
+    unsigned int np;
+    bool found;
+    if(n_is_mapped_in_matrix(n,np) && np<anjm1ip_anji.size() && !anjm1ip_anji[np].empty())
+    {
+      shape.clear();
+      rows.clear();
+      for(unsigned int j=0;j<anjm1ip_anji[np].size();++j)
+      {
+        shape.push_back(anjm1ip_anji[np][j].size());
+        rows.insert(rows.end(),anjm1ip_anji[np][j].begin(),anjm1ip_anji[np][j].end());
+      }
+      anjm1ip_anjiStore.encodeEntry(INVALID_ANJM1IP_ANJI_VAL,shape,rows,encEntry);
+      found=true;
+    }
+    else
+      found=anjm1ip_anjiStore.getEncodedEntry(n,encEntry);
+
+    if(found)
+    {
+      if(writer.addEntry(n,encEntry)==THOT_ERROR)
+        return THOT_ERROR;
+    }
+  }
+
+  return writer.close();
+}
+
 //-------------------------   
 bool anjm1ip_anjiMatrix::print_maxnsize_data(const char* maxnsizeDataFile)
 {
@@ -582,6 +722,7 @@ void anjm1ip_anjiMatrix::clear(void)
 {
   anjm1ip_anji_pointer=0;
   anjm1ip_anji.clear();
+  anjm1ip_anjiStore.clear();
   np_to_n_vector.clear();
   n_to_np_vector.clear();
 }
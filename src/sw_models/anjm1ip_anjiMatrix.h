@@ -35,8 +35,10 @@ along with this program; If not, see <http://www.gnu.org/licenses/>.
 #endif /* HAVE_CONFIG_H */
 
 #include <AwkInputStream.h>
+#include "SparseAnjiStore.h"
 #include <vector>
 #include <utility>
+#include <algorithm>
 #include <limits.h>
 #include <StatModelDefs.h>
 #include <MathDefs.h>
@@ -72,6 +74,19 @@ class anjm1ip_anjiMatrix
        // Functions to handle anjm1ip_anji
    void set_maxnsize(unsigned int _anjm1ip_anji_maxnsize);
    unsigned int get_maxnsize(void);
+   void set_topk(unsigned int _anjm1ip_anji_topk,
+                 bool logValues=false);
+       // Enables sparse storage keeping only the top-k values for
+       // each (j,i) pair.  Entries evicted from memory are spilled to
+       // disk and paged in again when required.  logValues indicates
+       // that the matrix stores logarithms
+   unsigned int get_topk(void);
+   void prune_row(std::vector<float>& row);
+       // Keeps the top-k values of a row of new expected values (for
+       // a given (j,i) pair), the remaining ones are set to
+       // INVALID_ANJM1IP_ANJI_VAL.  It should be applied before the
+       // contributions of the row are gathered, so pruned values
+       // contribute nothing
    unsigned int n_size(void);
    unsigned int nj_size(unsigned int n);
    unsigned int nji_size(unsigned int n,
@@ -116,6 +131,8 @@ class anjm1ip_anjiMatrix
 
        // load function
    bool load(const char* prefFileName);
+       // If a sparse file (.anjm1ip_anjisp) is found it is
+       // memory-mapped and its entries are paged in lazily
    
        // print function
    bool print(const char* prefFileName);
@@ -130,6 +147,10 @@ class anjm1ip_anjiMatrix
    std::vector<std::vector<std::vector<std::vector<float> > > > anjm1ip_anji;
        // Use simple precission floating-point numbers for expected
        // values
+   bool sparse;
+   SparseAnjiStore anjm1ip_anjiStore;
+       // Disk-resident storage for entries not mapped in
+       // anjm1ip_anji
    std::vector<std::pair<bool,unsigned int> > np_to_n_vector;
        // For each index of anji stores if it is already used and the
        // real index of the sample
@@ -155,9 +176,17 @@ class anjm1ip_anjiMatrix
    void update_n_to_np_vector(unsigned int n,
                               std::pair<bool,unsigned int> pbui);
 
+       // Functions to move entries between anjm1ip_anji and
+       // anjm1ip_anjiStore
+   void spill_entry(unsigned int n,
+                    unsigned int np);
+   void page_in_entry(unsigned int n,
+                      unsigned int np);
+
        // Functions to load and print matrices
    bool load_matrix_values(const char* anjiFile);   
    bool print_matrix_values(const char* anjiFile);
+   bool print_sparse_matrix_values(const char* matrixFile);
 
        // Functions to load and print maximum size data
    bool load_maxnsize_data(const char* maxnsizeDataFile);
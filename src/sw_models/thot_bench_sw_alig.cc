@@ -0,0 +1,235 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_bench_sw_alig.cc
+ *
+ * @brief Measures the alignment speed (in sentence pairs per second)
+ * of the IBM 2 and HMM models wrapped by the casmacat aligner classes,
+ * aligning one pair at a time and in batches.
+ */
+
+//--------------- Include files --------------------------------------
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "options.h"
+#include "ctimer.h"
+#include "SmoothedIncrIbm2AligModel.h"
+#include "IncrHmmAligModel.h"
+#include <StrProcUtils.h>
+
+//--------------- Constants ------------------------------------------
+
+#define DEFAULT_BATCH_SIZE 1000
+
+//--------------- Function Declarations ------------------------------
+
+int readCorpus(void);
+void benchModel(const char* modelName,
+                BaseSwAligModel<std::vector<Prob> >& aligModel);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+void printDesc(void);
+
+//--------------- Global variables -----------------------------------
+
+std::string ibm2Prefix;
+std::string hmmPrefix;
+std::string srcFileName;
+std::string trgFileName;
+unsigned int numThreads;
+unsigned int batchSize;
+std::vector<std::vector<std::string> > srcSentVec;
+std::vector<std::vector<std::string> > trgSentVec;
+
+//--------------- Function Definitions -------------------------------
+
+//--------------- main function
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+    if(readCorpus()==THOT_ERROR)
+      return THOT_ERROR;
+    std::cerr<<"Corpus contains "<<srcSentVec.size()<<" sentence pairs"<<std::endl;
+
+    if(!ibm2Prefix.empty())
+    {
+      SmoothedIncrIbm2AligModel ibm2Model;
+      if(ibm2Model.load(ibm2Prefix.c_str())==THOT_ERROR)
+        return THOT_ERROR;
+      benchModel("IBM2",ibm2Model);
+    }
+
+    if(!hmmPrefix.empty())
+    {
+      IncrHmmAligModel hmmModel;
+      if(hmmModel.load(hmmPrefix.c_str())==THOT_ERROR)
+        return THOT_ERROR;
+      benchModel("HMM",hmmModel);
+    }
+    return THOT_OK;
+  }
+  else return THOT_ERROR;
+}
+
+//--------------- readCorpus() function
+int readCorpus(void)
+{
+  std::ifstream srcF(srcFileName.c_str());
+  if(!srcF)
+  {
+    std::cerr<<"Error while opening file "<<srcFileName<<std::endl;
+    return THOT_ERROR;
+  }
+  std::ifstream trgF(trgFileName.c_str());
+  if(!trgF)
+  {
+    std::cerr<<"Error while opening file "<<trgFileName<<std::endl;
+    return THOT_ERROR;
+  }
+
+  std::string srcLine;
+  std::string trgLine;
+  while(std::getline(srcF,srcLine))
+  {
+    if(!std::getline(trgF,trgLine))
+    {
+      std::cerr<<"Error: source and target files have not the same size"<<std::endl;
+      return THOT_ERROR;
+    }
+    srcSentVec.push_back(StrProcUtils::stringToStringVector(srcLine));
+    trgSentVec.push_back(StrProcUtils::stringToStringVector(trgLine));
+  }
+  return THOT_OK;
+}
+
+//--------------- benchModel() function
+void benchModel(const char* modelName,
+                BaseSwAligModel<std::vector<Prob> >& aligModel)
+{
+  double elapsed_ant,elapsed,ucpu,scpu;
+
+      // Align one sentence pair at a time
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  double lgProbSeq=0;
+  for(unsigned int n=0;n<srcSentVec.size();++n)
+  {
+    WordAligMatrix waMatrix;
+    lgProbSeq+=(double)aligModel.obtainBestAlignmentVecStr(srcSentVec[n],trgSentVec[n],waMatrix);
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double seqTime=elapsed-elapsed_ant;
+
+      // Align batches of sentence pairs
+  ctimer(&elapsed_ant,&ucpu,&scpu);
+  double lgProbBatch=0;
+  for(unsigned int begin=0;begin<srcSentVec.size();begin+=batchSize)
+  {
+    unsigned int end=std::min((size_t)begin+batchSize,srcSentVec.size());
+    std::vector<std::vector<std::string> > srcBatch(srcSentVec.begin()+begin,srcSentVec.begin()+end);
+    std::vector<std::vector<std::string> > trgBatch(trgSentVec.begin()+begin,trgSentVec.begin()+end);
+    std::vector<LgProb> lgProbVec;
+    std::vector<WordAligMatrix> waMatrixVec;
+    aligModel.obtainBestAlignmentBatchVecStr(srcBatch,trgBatch,numThreads,lgProbVec,waMatrixVec);
+    for(unsigned int n=0;n<lgProbVec.size();++n)
+      lgProbBatch+=(double)lgProbVec[n];
+  }
+  ctimer(&elapsed,&ucpu,&scpu);
+  double batchTime=elapsed-elapsed_ant;
+
+  std::cout<<modelName<<" one pair at a time: "<<seqTime<<" s, "<<(seqTime>0 ? srcSentVec.size()/seqTime : 0)<<" pairs/s (total logprob "<<lgProbSeq<<")"<<std::endl;
+  std::cout<<modelName<<" batch ("<<numThreads<<" threads, batch size "<<batchSize<<"): "<<batchTime<<" s, "<<(batchTime>0 ? srcSentVec.size()/batchTime : 0)<<" pairs/s (total logprob "<<lgProbBatch<<")"<<std::endl;
+}
+
+//--------------- TakeParameters function
+int TakeParameters(int argc,char *argv[])
+{
+ int err;
+
+ if(argc==1)
+ {
+   printDesc();
+   return THOT_ERROR;
+ }
+
+     /* Verify --help option */
+ err=readOption(argc,argv,"--help");
+ if(err!=-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take corpus files */
+ if(readSTLstring(argc,argv,"-s",&srcFileName)==-1 ||
+    readSTLstring(argc,argv,"-t",&trgFileName)==-1)
+ {
+   std::cerr<<"Error: parameters -s and -t should be given!"<<std::endl;
+   return THOT_ERROR;
+ }
+
+     /* Take model prefixes */
+ readSTLstring(argc,argv,"-ibm2",&ibm2Prefix);
+ readSTLstring(argc,argv,"-hmm",&hmmPrefix);
+ if(ibm2Prefix.empty() && hmmPrefix.empty())
+ {
+   std::cerr<<"Error: at least one of the -ibm2 or -hmm parameters should be given!"<<std::endl;
+   return THOT_ERROR;
+ }
+
+     /* Take optional parameters */
+ int val;
+ numThreads=1;
+ if(readInt(argc,argv,"-nt",&val)!=-1)
+   numThreads=(val>0 ? val : 1);
+ batchSize=DEFAULT_BATCH_SIZE;
+ if(readInt(argc,argv,"-b",&val)!=-1)
+   batchSize=(val>0 ? val : 1);
+
+ return THOT_OK;
+}
+
+//--------------- printDesc() function
+void printDesc(void)
+{
+  printf("thot_bench_sw_alig written by Daniel Ortiz\n");
+  printf("A tool to measure the alignment speed of single word models\n");
+  printf("type \"thot_bench_sw_alig --help\" to get usage information.\n");
+}
+
+//--------------- printUsage() function
+void printUsage(void)
+{
+  printf("Usage: thot_bench_sw_alig [-ibm2 <string>] [-hmm <string>] -s <string>\n");
+  printf("                          -t <string> [-nt <int>] [-b <int>] [--help]\n\n");
+  printf("-ibm2 <string>             Prefix of the IBM 2 model files.\n");
+  printf("-hmm <string>              Prefix of the HMM model files.\n");
+  printf("-s <string>                File with source sentences.\n");
+  printf("-t <string>                File with target sentences.\n");
+  printf("-nt <int>                  Number of threads used in batch mode (1 by\n");
+  printf("                           default).\n");
+  printf("-b <int>                   Batch size (%d by default).\n",DEFAULT_BATCH_SIZE);
+  printf("--help                     Display this help and exit.\n\n");
+}
+
+//--------------------------------
@@ -173,6 +173,13 @@ int processParameters(thot_gen_sw_model_pars pars)
     if(pars.r_given)
     {
       _incrSwAligModelPtr->set_expval_maxnsize(pars.r);
+    }
+
+        // Set number of expected values kept for each target
+        // position
+    if(pars.tk_given)
+    {
+      _incrSwAligModelPtr->set_expval_topk(pars.tk);
     }
   }
 
@@ -618,6 +625,23 @@ int takeParameters(int argc,
       }
     }
 
+        // -tk parameter
+    if(argv_stl[i]=="-tk" && !matched)
+    {
+      pars.tk_given=true;
+      if(i==argc-1)
+      {
+        std::cerr<<"Error: no value for -tk parameter."<<std::endl;
+        return THOT_ERROR;
+      }
+      else
+      {
+        pars.tk=atoi(argv_stl[i+1].c_str());
+        ++matched;
+        ++i;
+      }
+    }
+
         // -in parameter
     if(argv_stl[i]=="-in" && !matched)
     {
@@ -827,6 +851,12 @@ int checkParameters(thot_gen_sw_model_pars& pars)
     return THOT_ERROR;
   }
 
+  if(pars.tk_given && !pars.i_given)
+  {
+    std::cerr<<"Error: parameter -tk cannot be used without -i parameter"<<std::endl;
+    return THOT_ERROR;
+  }
+
   if(pars.in_given && !pars.i_given)
   {
     std::cerr<<"Error: parameter -in cannot be used without -i parameter"<<std::endl;
@@ -840,10 +870,10 @@ int checkParameters(thot_gen_sw_model_pars& pars)
   _incrSwAligModel<std::vector<Prob> >* _incrSwAligModelPtr=dynamic_cast<_incrSwAligModel<std::vector<Prob> >*>(swAligModelPtr);
   if(!_incrSwAligModelPtr)
   {
-    if(pars.eb_given || pars.i_given || pars.c_given || pars.r_given || pars.mb_given || pars.in_given)
+    if(pars.eb_given || pars.i_given || pars.c_given || pars.r_given || pars.tk_given || pars.mb_given || pars.in_given)
     {
       release_swm(false);
-      std::cerr<<"Error: parameters -eb, -mb, -i, -c, -r and -in cannot be used with non-incremental single word models"<<std::endl;
+      std::cerr<<"Error: parameters -eb, -mb, -i, -c, -r, -tk and -in cannot be used with non-incremental single word models"<<std::endl;
       return THOT_ERROR;
     }
   }
@@ -869,6 +899,7 @@ void printParameters(thot_gen_sw_model_pars pars)
   std::cerr<<"-i: "<<pars.i_given<<std::endl;
   std::cerr<<"-c: "<<pars.c_given<<std::endl;
   if(pars.r_given) std::cerr<<"-r: "<<pars.r<<std::endl;
+  if(pars.tk_given) std::cerr<<"-tk: "<<pars.tk<<std::endl;
   if(pars.mb_given) std::cerr<<"-mb: "<<pars.mb<<std::endl;
   if(pars.lr_given)
   {
@@ -894,7 +925,7 @@ void printUsage(void)
   std::cerr<<"Usage: thot_gen_sw_model {[-s <string> -t <string>] [-l <string>]}\n";
   std::cerr<<"                      -n <int> [-nl]\n";
   std::cerr<<"                      [-eb | -mb <int> [-lr <int> [<float1>...<floatn>] ] \n";
-  std::cerr<<"                      | -i [-c] [-r <int> [-in]] ]\n";
+  std::cerr<<"                      | -i [-c] [-r <int> [-in]] [-tk <int>] ]\n";
   std::cerr<<"                      [-np <float>] [-lf <float>] [-af <float>]\n";
   std::cerr<<"                      -o <string>\n";
   std::cerr<<"                      [-v|-v1] [--help] [--version]\n\n";
@@ -911,6 +942,11 @@ void printUsage(void)
   std::cerr<<"                      EM iteration.\n";
   std::cerr<<"-r <int>              Restrict maximum size of matrix of\n";
   std::cerr<<"                      expected values in the dimension of n.\n";
+  std::cerr<<"-tk <int>             Keep only the <int> highest expected values for\n";
+  std::cerr<<"                      each target position. Pruned values are stored\n";
+  std::cerr<<"                      in memory-mapped sparse files, entries evicted\n";
+  std::cerr<<"                      due to -r are spilled to disk instead of being\n";
+  std::cerr<<"                      discarded.\n";
   std::cerr<<"-mb <int>             Execute mini-batches of length <int>.\n";
   std::cerr<<"-lr <int> <f1...n>    Set learning-rate type. Depending on the lr\n";
   std::cerr<<"                      type, additional parameters are required.\n";
@@ -45,6 +45,8 @@ struct thot_gen_sw_model_pars
   bool c_given;
   bool r_given;
   unsigned int r;
+  bool tk_given;
+  unsigned int tk;
   bool mb_given;
   unsigned int mb;
   bool lr_given;
@@ -78,6 +80,7 @@ struct thot_gen_sw_model_pars
       i_given=false;
       c_given=false;
       r_given=false;
+      tk_given=false;
       mb_given=false;
       lr_given=false;
       in_given=false;
@@ -0,0 +1,791 @@
+/*
+thot package for statistical machine translation
+Copyright (C) 2013 Daniel Ortiz-Mart\'inez
+
+This library is free software; you can redistribute it and/or
+modify it under the terms of the GNU Lesser General Public License
+as published by the Free Software Foundation; either version 3
+of the License, or (at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU Lesser General Public License for more details.
+
+You should have received a copy of the GNU Lesser General Public License
+along with this program; If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/**
+ * @file thot_merge_bin_swtables.cc
+ *
+ * @brief Sorts and merges the counts given in a set of binary
+ * incremental lexical, IBM 2 alignment or HMM alignment tables. Input
+ * tables do not need to be sorted. Sorted runs are generated in
+ * parallel using a bounded amount of memory and then k-way merged,
+ * the result is written in the format loaded by the incremental
+ * table classes.
+ */
+
+//--------------- Include files --------------------------------------
+
+#if HAVE_CONFIG_H
+#  include <thot_config.h>
+#endif /* HAVE_CONFIG_H */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include "options.h"
+#include "SwDefs.h"
+#include "ThreadPool.h"
+#include "SortedRunUtils.h"
+#include <MathFuncs.h>
+
+//--------------- Constants ------------------------------------------
+
+#define LEX_TABLE          0
+#define IBM2_ALIG_TABLE    1
+#define HMM_ALIG_TABLE     2
+
+#define MAX_KEY_LEN        4
+#define DEFAULT_MEM_MB     512
+#define DEFAULT_MAX_FANIN  256
+#define MIN_READ_BUFF_RECS 1024
+#define OUT_BUFF_SIZE      (1<<20)
+
+//--------------- Type definitions -----------------------------------
+
+struct Record
+{
+  unsigned int key[MAX_KEY_LEN];
+      // Source fields followed by the target field
+  float numer;
+  float denom;
+  unsigned int id;
+      // Index of the input table the record comes from
+};
+
+struct SortByKey
+{
+  bool operator() (const Record& a,
+                   const Record& b)const
+    {
+      for(unsigned int k=0;k<MAX_KEY_LEN;++k)
+      {
+        if(a.key[k]<b.key[k]) return true;
+        if(b.key[k]<a.key[k]) return false;
+      }
+      return false;
+    }
+};
+
+//--------------- RecordSource class
+
+/**
+ * @brief Buffered reader of records stored either in an input table
+ * or in a temporary run file.
+ */
+
+class RecordSource: public SortedRunSource<Record>
+{
+ public:
+
+  RecordSource(FILE* _file,
+               bool _runFormat,
+               unsigned int _id,
+               unsigned int buffRecs);
+  ~RecordSource();
+
+  bool next(Record& rec);
+  bool readError(void)const;
+
+ private:
+
+  FILE* file;
+  bool runFormat;
+  unsigned int id;
+  std::vector<char> buff;
+  size_t buffLen;
+  size_t buffPos;
+  bool error;
+
+  bool fillBuffer(void);
+};
+
+typedef SortedRunMerger<Record,SortByKey> RecordMerger;
+
+struct SortRunTask
+{
+  std::vector<Record> records;
+  FILE* runFile;
+  bool error;
+};
+
+struct MergeRunsTask
+{
+  std::vector<FILE*> inRuns;
+  unsigned int buffRecs;
+  FILE* outRun;
+  bool error;
+};
+
+//--------------- Function Declarations ------------------------------
+
+int generateRuns(ThreadPool& pool,
+                 std::vector<FILE*>& runFiles);
+int reduceRuns(ThreadPool& pool,
+               std::vector<FILE*>& runFiles);
+int mergeAndPrint(std::vector<SortedRunSource<Record>*>& sources,
+                  FILE* outFile);
+void sortRunTask(void* taskData);
+void mergeRunsTask(void* taskData);
+unsigned int keyLength(void);
+size_t tableFieldSize(void);
+size_t tableRecordSize(void);
+bool writeRecordFields(FILE* outFile,
+                       const Record& rec,
+                       float denom);
+int TakeParameters(int argc,char *argv[]);
+void printUsage(void);
+void printDesc(void);
+
+//--------------- Global variables -----------------------------------
+
+int tableType;
+unsigned int numThreads;
+unsigned int memMb;
+unsigned int maxFanIn;
+bool inputsSorted;
+std::string tmpDir;
+std::string outFileName;
+std::vector<std::string> fileNameVec;
+
+//--------------- Function Definitions -------------------------------
+
+//--------------- main function
+int main(int argc,char *argv[])
+{
+  if(TakeParameters(argc,argv)==THOT_OK)
+  {
+    ThreadPool pool(numThreads);
+    std::vector<SortedRunSource<Record>*> sources;
+    int ret=THOT_OK;
+
+    if(inputsSorted && fileNameVec.size()<=maxFanIn)
+    {
+          // Input tables are used as runs
+      unsigned int buffRecs=std::max((size_t)MIN_READ_BUFF_RECS,((size_t)memMb<<20)/(fileNameVec.size()*tableRecordSize()));
+      for(unsigned int i=0;i<fileNameVec.size();++i)
+      {
+        FILE* file=fopen(fileNameVec[i].c_str(),"rb");
+        if(file==NULL)
+        {
+          std::cerr<<"Error in file with incremental table, file "<<fileNameVec[i]<<" does not exist.\n";
+          ret=THOT_ERROR;
+          break;
+        }
+        sources.push_back(new RecordSource(file,false,i,buffRecs));
+      }
+    }
+    else
+    {
+          // Generate sorted runs
+      std::vector<FILE*> runFiles;
+      ret=generateRuns(pool,runFiles);
+
+          // Reduce number of runs if necessary
+      if(ret==THOT_OK)
+        ret=reduceRuns(pool,runFiles);
+
+      unsigned int buffRecs=std::max((size_t)MIN_READ_BUFF_RECS,((size_t)memMb<<20)/(std::max((size_t)1,runFiles.size())*sizeof(Record)));
+      for(unsigned int i=0;i<runFiles.size();++i)
+      {
+        rewind(runFiles[i]);
+        sources.push_back(new RecordSource(runFiles[i],true,i,buffRecs));
+      }
+    }
+
+    if(ret==THOT_OK)
+    {
+          // Open output file
+      FILE* outFile=stdout;
+      if(!outFileName.empty())
+      {
+        outFile=fopen(outFileName.c_str(),"wb");
+        if(outFile==NULL)
+        {
+          std::cerr<<"Error while opening output file "<<outFileName<<std::endl;
+          ret=THOT_ERROR;
+        }
+      }
+      if(outFile!=NULL)
+      {
+        static char outBuff[OUT_BUFF_SIZE];
+        setvbuf(outFile,outBuff,_IOFBF,OUT_BUFF_SIZE);
+
+            // Merge sorted runs
+        ret=mergeAndPrint(sources,outFile);
+
+        if(fflush(outFile)!=0)
+        {
+          std::cerr<<"Error while writing output"<<std::endl;
+          ret=THOT_ERROR;
+        }
+        if(outFile!=stdout)
+          fclose(outFile);
+      }
+    }
+
+        // Release sources
+    for(unsigned int i=0;i<sources.size();++i)
+      delete sources[i];
+
+    return ret;
+  }
+  else return THOT_ERROR;
+}
+
+//--------------- generateRuns() function
+int generateRuns(ThreadPool& pool,
+                 std::vector<FILE*>& runFiles)
+{
+      // Memory is split among the runs being sorted at the same time
+  size_t blockRecs=((size_t)memMb<<20)/(pool.getNumThreads()*sizeof(Record));
+  if(blockRecs<MIN_READ_BUFF_RECS)
+    blockRecs=MIN_READ_BUFF_RECS;
+
+  std::vector<SortRunTask*> tasks;
+  SortRunTask* currTask=NULL;
+  int ret=THOT_OK;
+
+  for(unsigned int i=0;i<fileNameVec.size() && ret==THOT_OK;++i)
+  {
+    FILE* file=fopen(fileNameVec[i].c_str(),"rb");
+    if(file==NULL)
+    {
+      std::cerr<<"Error in file with incremental table, file "<<fileNameVec[i]<<" does not exist.\n";
+      ret=THOT_ERROR;
+      break;
+    }
+
+    RecordSource source(file,false,i,MIN_READ_BUFF_RECS*64);
+    Record rec;
+    while(source.next(rec))
+    {
+      if(currTask==NULL)
+      {
+        currTask=new SortRunTask;
+        currTask->records.reserve(blockRecs);
+        currTask->runFile=NULL;
+        currTask->error=false;
+      }
+      currTask->records.push_back(rec);
+
+          // Sort block when full
+      if(currTask->records.size()==blockRecs)
+      {
+        tasks.push_back(currTask);
+        pool.addTask(sortRunTask,(void*)currTask);
+        currTask=NULL;
+
+            // Bound number of blocks kept in memory
+        if(tasks.size()%pool.getNumThreads()==0)
+          pool.waitForTasks();
+      }
+    }
+    if(source.readError())
+    {
+      std::cerr<<"Error while reading file "<<fileNameVec[i]<<std::endl;
+      ret=THOT_ERROR;
+    }
+  }
+      // Sort last block
+  if(currTask!=NULL)
+  {
+    tasks.push_back(currTask);
+    pool.addTask(sortRunTask,(void*)currTask);
+  }
+  pool.waitForTasks();
+
+      // Collect runs
+  for(unsigned int i=0;i<tasks.size();++i)
+  {
+    if(tasks[i]->error)
+      ret=THOT_ERROR;
+    if(tasks[i]->runFile!=NULL)
+      runFiles.push_back(tasks[i]->runFile);
+    delete tasks[i];
+  }
+  return ret;
+}
+
+//--------------- reduceRuns() function
+int reduceRuns(ThreadPool& pool,
+               std::vector<FILE*>& runFiles)
+{
+  int ret=THOT_OK;
+  while(runFiles.size()>maxFanIn && ret==THOT_OK)
+  {
+        // Merge groups of runs in parallel
+    std::vector<MergeRunsTask*> tasks;
+    unsigned int numGroups=(runFiles.size()+maxFanIn-1)/maxFanIn;
+    unsigned int groupsInMem=std::min(numGroups,pool.getNumThreads());
+    unsigned int buffRecs=std::max((size_t)MIN_READ_BUFF_RECS,((size_t)memMb<<20)/((size_t)groupsInMem*maxFanIn*sizeof(Record)));
+    for(unsigned int i=0;i<runFiles.size();i+=maxFanIn)
+    {
+      MergeRunsTask* task=new MergeRunsTask;
+      for(unsigned int j=i;j<runFiles.size() && j<i+maxFanIn;++j)
+        task->inRuns.push_back(runFiles[j]);
+      task->buffRecs=buffRecs;
+      task->outRun=NULL;
+      task->error=false;
+      tasks.push_back(task);
+      pool.addTask(mergeRunsTask,(void*)task);
+    }
+    pool.waitForTasks();
+
+        // Replace runs by merged ones
+    runFiles.clear();
+    for(unsigned int i=0;i<tasks.size();++i)
+    {
+      if(tasks[i]->error)
+        ret=THOT_ERROR;
+      if(tasks[i]->outRun!=NULL)
+        runFiles.push_back(tasks[i]->outRun);
+      delete tasks[i];
+    }
+  }
+  return ret;
+}
+
+//--------------- mergeAndPrint() function
+int mergeAndPrint(std::vector<SortedRunSource<Record>*>& sources,
+                  FILE* outFile)
+{
+  unsigned int srcLen=keyLength()-1;
+  RecordMerger merger(sources);
+
+      // Process groups of records sharing the same source fields. The
+      // numerators of identical keys are added, the denominator is
+      // added once per input table
+  std::vector<Record> group;
+  std::vector<unsigned int> chunkStamp(fileNameVec.size(),0);
+  unsigned int groupNum=0;
+  float lcSrc=SMALL_LG_NUM;
+  bool end=false;
+  bool ok=true;
+  while(!end)
+  {
+    Record rec;
+    unsigned int srcIdx;
+    bool recordRead=merger.next(rec,srcIdx);
+
+        // Check if current group has finished
+    bool newGroup=true;
+    if(recordRead && !group.empty())
+      newGroup=(memcmp(rec.key,group[0].key,srcLen*sizeof(unsigned int))!=0);
+    if(newGroup && !group.empty())
+    {
+          // Print counts
+      Record merged=group[0];
+      for(unsigned int n=1;n<group.size();++n)
+      {
+        if(merged.key[srcLen]==group[n].key[srcLen])
+        {
+              // Accumulate count of target for additional chunk
+          merged.numer=MathFuncs::lns_sumlog(merged.numer,group[n].numer);
+        }
+        else
+        {
+          ok=ok && writeRecordFields(outFile,merged,lcSrc);
+          merged=group[n];
+        }
+      }
+      ok=ok && writeRecordFields(outFile,merged,lcSrc);
+
+          // Reset variables
+      group.clear();
+      lcSrc=SMALL_LG_NUM;
+      ++groupNum;
+    }
+
+    if(recordRead)
+    {
+      group.push_back(rec);
+      if(chunkStamp[rec.id]!=groupNum+1)
+      {
+        chunkStamp[rec.id]=groupNum+1;
+        lcSrc=MathFuncs::lns_sumlog(lcSrc,rec.denom);
+      }
+    }
+    else end=true;
+  }
+
+      // Check read errors
+  if(merger.readError())
+  {
+    std::cerr<<"Error while reading input records"<<std::endl;
+    ok=false;
+  }
+
+  if(ok)
+    return THOT_OK;
+  else
+    return THOT_ERROR;
+}
+
+//--------------- sortRunTask() function
+void sortRunTask(void* taskData)
+{
+  SortRunTask* task=(SortRunTask*)taskData;
+
+      // Sort records
+  std::sort(task->records.begin(),task->records.end(),SortByKey());
+
+      // Write run
+  task->runFile=SortedRunUtils::createTmpFile(tmpDir,"thot_merge_bin_swtables");
+  if(task->runFile==NULL)
+    task->error=true;
+  else
+  {
+    if(fwrite(&task->records[0],sizeof(Record),task->records.size(),task->runFile)!=task->records.size()
+       || fflush(task->runFile)!=0)
+    {
+      std::cerr<<"Error while writing temporary run file"<<std::endl;
+      task->error=true;
+    }
+  }
+
+      // Release memory
+  std::vector<Record>().swap(task->records);
+}
+
+//--------------- mergeRunsTask() function
+void mergeRunsTask(void* taskData)
+{
+  MergeRunsTask* task=(MergeRunsTask*)taskData;
+
+      // Create output run
+  task->outRun=SortedRunUtils::createTmpFile(tmpDir,"thot_merge_bin_swtables");
+  if(task->outRun==NULL)
+  {
+    task->error=true;
+    return;
+  }
+
+      // Create sources for input runs
+  std::vector<SortedRunSource<Record>*> runSources;
+  for(unsigned int i=0;i<task->inRuns.size();++i)
+  {
+    rewind(task->inRuns[i]);
+    runSources.push_back(new RecordSource(task->inRuns[i],true,i,task->buffRecs));
+  }
+
+      // Merge records, table ids are kept so that the final merge
+      // can combine the denominators
+  RecordMerger merger(runSources);
+  std::vector<Record> outBuff;
+  outBuff.reserve(task->buffRecs);
+  Record rec;
+  unsigned int srcIdx;
+  bool recordRead=merger.next(rec,srcIdx);
+  while(recordRead && !task->error)
+  {
+    outBuff.push_back(rec);
+    recordRead=merger.next(rec,srcIdx);
+
+    if(outBuff.size()==task->buffRecs || !recordRead)
+    {
+      if(fwrite(&outBuff[0],sizeof(Record),outBuff.size(),task->outRun)!=outBuff.size())
+      {
+        std::cerr<<"Error while writing temporary run file"<<std::endl;
+        task->error=true;
+      }
+      outBuff.clear();
+    }
+  }
+  if(fflush(task->outRun)!=0)
+    task->error=true;
+  if(merger.readError())
+    task->error=true;
+
+      // Release input runs
+  for(unsigned int i=0;i<runSources.size();++i)
+    delete runSources[i];
+}
+
+//--------------- keyLength() function
+unsigned int keyLength(void)
+{
+  switch(tableType)
+  {
+    case IBM2_ALIG_TABLE: return 4;
+    case HMM_ALIG_TABLE: return 3;
+    default: return 2;
+  }
+}
+
+//--------------- tableFieldSize() function
+size_t tableFieldSize(void)
+{
+  if(tableType==LEX_TABLE)
+    return sizeof(WordIndex);
+  else
+    return sizeof(PositionIndex);
+}
+
+//--------------- tableRecordSize() function
+size_t tableRecordSize(void)
+{
+  return keyLength()*tableFieldSize()+2*sizeof(float);
+}
+
+//--------------- writeRecordFields() function
+bool writeRecordFields(FILE* outFile,
+                       const Record& rec,
+                       float denom)
+{
+  unsigned int keyLen=keyLength();
+  bool ok=true;
+  for(unsigned int k=0;k<keyLen;++k)
+  {
+    if(tableType==LEX_TABLE)
+    {
+      WordIndex w=rec.key[k];
+      ok=ok && fwrite(&w,sizeof(WordIndex),1,outFile)==1;
+    }
+    else
+    {
+      PositionIndex p=rec.key[k];
+      ok=ok && fwrite(&p,sizeof(PositionIndex),1,outFile)==1;
+    }
+  }
+  ok=ok && fwrite(&rec.numer,sizeof(float),1,outFile)==1;
+  ok=ok && fwrite(&denom,sizeof(float),1,outFile)==1;
+  return ok;
+}
+
+//--------------- RecordSource class function definitions
+
+//-------------------------
+RecordSource::RecordSource(FILE* _file,
+                           bool _runFormat,
+                           unsigned int _id,
+                           unsigned int buffRecs)
+{
+  file=_file;
+  runFormat=_runFormat;
+  id=_id;
+  if(runFormat)
+    buff.resize((size_t)buffRecs*sizeof(Record));
+  else
+    buff.resize((size_t)buffRecs*tableRecordSize());
+  buffLen=0;
+  buffPos=0;
+  error=false;
+}
+
+//-------------------------
+RecordSource::~RecordSource()
+{
+  if(file!=NULL)
+    fclose(file);
+}
+
+//-------------------------
+bool RecordSource::next(Record& rec)
+{
+  size_t recSize=(runFormat ? sizeof(Record) : tableRecordSize());
+  if(buffPos+recSize>buffLen)
+  {
+    if(!fillBuffer())
+      return false;
+  }
+
+  const char* ptr=&buff[buffPos];
+  buffPos+=recSize;
+  if(runFormat)
+  {
+    memcpy(&rec,ptr,sizeof(Record));
+  }
+  else
+  {
+        // Decode fields of table record
+    unsigned int keyLen=keyLength();
+    for(unsigned int k=0;k<MAX_KEY_LEN;++k)
+    {
+      rec.key[k]=0;
+      if(k<keyLen)
+      {
+        if(tableType==LEX_TABLE)
+        {
+          WordIndex w;
+          memcpy(&w,ptr,sizeof(WordIndex));
+          ptr+=sizeof(WordIndex);
+          rec.key[k]=w;
+        }
+        else
+        {
+          PositionIndex p;
+          memcpy(&p,ptr,sizeof(PositionIndex));
+          ptr+=sizeof(PositionIndex);
+          rec.key[k]=p;
+        }
+      }
+    }
+    memcpy(&rec.numer,ptr,sizeof(float));
+    ptr+=sizeof(float);
+    memcpy(&rec.denom,ptr,sizeof(float));
+    rec.id=id;
+  }
+  return true;
+}
+
+//-------------------------
+bool RecordSource::readError(void)const
+{
+  return error;
+}
+
+//-------------------------
+bool RecordSource::fillBuffer(void)
+{
+  size_t recSize=(runFormat ? sizeof(Record) : tableRecordSize());
+
+      // Move incomplete record to the beginning of the buffer
+  size_t remaining=buffLen-buffPos;
+  if(remaining>0)
+    memmove(&buff[0],&buff[buffPos],remaining);
+  buffLen=remaining;
+  buffPos=0;
+
+  size_t nread=fread(&buff[buffLen],1,buff.size()-buffLen,file);
+  buffLen+=nread;
+  if(buffLen<recSize)
+  {
+    if(ferror(file) || buffLen>0)
+    {
+          // Truncated record or I/O error
+      error=true;
+    }
+    return false;
+  }
+  return true;
+}
+
+//--------------- TakeParameters function
+int TakeParameters(int argc,char *argv[])
+{
+ int err;
+
+ if(argc==1)
+ {
+   printDesc();
+   return THOT_ERROR;
+ }
+
+     /* Verify --help option */
+ err=readOption(argc,argv,"--help");
+ if(err!=-1)
+ {
+   printUsage();
+   return THOT_ERROR;
+ }
+
+     /* Take table type */
+ std::string typeStr;
+ if(readSTLstring(argc,argv,"-t",&typeStr)==-1)
+ {
+   std::cerr<<"Error: parameter -t not given!"<<std::endl;
+   printUsage();
+   return THOT_ERROR;
+ }
+ if(typeStr=="lex")
+   tableType=LEX_TABLE;
+ else if(typeStr=="ibm2")
+   tableType=IBM2_ALIG_TABLE;
+ else if(typeStr=="hmm")
+   tableType=HMM_ALIG_TABLE;
+ else
+ {
+   std::cerr<<"Error: unknown table type "<<typeStr<<std::endl;
+   return THOT_ERROR;
+ }
+
+     /* Take optional parameters */
+ int val;
+ numThreads=1;
+ if(readInt(argc,argv,"-nt",&val)!=-1)
+   numThreads=(val>0 ? val : 1);
+ memMb=DEFAULT_MEM_MB;
+ if(readInt(argc,argv,"-S",&val)!=-1)
+   memMb=(val>0 ? val : 1);
+ maxFanIn=DEFAULT_MAX_FANIN;
+ if(readInt(argc,argv,"-k",&val)!=-1)
+   maxFanIn=(val>1 ? val : 2);
+ inputsSorted=(readOption(argc,argv,"-s")!=-1);
+ if(readSTLstring(argc,argv,"-T",&tmpDir)==-1)
+ {
+   const char* envTmpDir=getenv("TMPDIR");
+   if(envTmpDir!=NULL)
+     tmpDir=envTmpDir;
+   else
+     tmpDir="/tmp";
+ }
+ if(readSTLstring(argc,argv,"-o",&outFileName)==-1)
+   outFileName.clear();
+
+     /* Take the table file names (arguments not belonging to
+        options) */
+ for(int i=1;i<argc;++i)
+ {
+   std::string arg=argv[i];
+   if(arg=="-t" || arg=="-nt" || arg=="-S" || arg=="-k" || arg=="-T" || arg=="-o")
+     ++i;
+   else if(arg!="-s")
+     fileNameVec.push_back(arg);
+ }
+ if(fileNameVec.empty())
+ {
+   std::cerr<<"Error: no input tables were given!"<<std::endl;
+   return THOT_ERROR;
+ }
+
+ return THOT_OK;
+}
+
+//--------------- printDesc() function
+void printDesc(void)
+{
+  printf("thot_merge_bin_swtables written by Daniel Ortiz\n");
+  printf("A tool to sort and merge the counts of a set of binary single word tables\n");
+  printf("type \"thot_merge_bin_swtables --help\" to get usage information.\n");
+}
+
+//--------------- printUsage() function
+void printUsage(void)
+{
+  printf("Usage: thot_merge_bin_swtables -t <string> [-nt <int>] [-S <int>] [-k <int>]\n");
+  printf("                               [-s] [-T <string>] [-o <string>]\n");
+  printf("                               <table_1> [<table_2> ...] [--help]\n\n");
+  printf("-t <string>                Table type: lex, ibm2 or hmm.\n");
+  printf("-nt <int>                  Number of threads used to sort and merge runs\n");
+  printf("                           (%d by default).\n",1);
+  printf("-S <int>                   Memory budget in megabytes (%d by default).\n",DEFAULT_MEM_MB);
+  printf("-k <int>                   Maximum number of runs merged at once\n");
+  printf("                           (%d by default).\n",DEFAULT_MAX_FANIN);
+  printf("-s                         Input tables are already sorted, runs are not\n");
+  printf("                           generated unless the number of tables exceeds\n");
+  printf("                           the maximum fan-in.\n");
+  printf("-T <string>                Directory for temporary files ($TMPDIR or /tmp by\n");
+  printf("                           default).\n");
+  printf("-o <string>                Output file (standard output by default).\n");
+  printf("--help                     Display this help and exit.\n\n");
+}
+
+//--------------------------------
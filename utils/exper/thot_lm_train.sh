@@ -200,14 +200,15 @@ estimate_thotlm()
     # Obtain number of lines for input file
     nl=`$WC -l $corpus | $AWK '{printf"%s",$1}'`
 
-    # Estimate n-gram model parameters
-    if [ $nl -gt 0 ]; then
+    # Estimate n-gram model parameters (n-grams are counted natively
+    # unless the counting is distributed using qsub)
+    if [ $nl -gt 0 -a ${qs_given} -eq 1 ]; then
         ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
                  -c $corpus -o $prefix -n ${n_val} -f ${fragm_size} ${unk_opt} \
                  ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
     else
-        ${bindir}/thot_get_ngram_counts -c $corpus \
-                 -n ${n_val} > $prefix || return 1
+        ${bindir}/thot_count_ngrams -c $corpus -n ${n_val} ${unk_opt} \
+                 -nt ${pr_val} -T $tdir -o $prefix 2> ${prefix}.getng_log || return 1
     fi
 }
 
@@ -241,28 +242,29 @@ estimate_ldb()
     # Obtain number of lines for input file
     nl=`$WC -l $corpus | $AWK '{printf"%s",$1}'`
 
-    # Estimate n-gram model parameters
-    if [ $nl -gt 0 ]; then
-        ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
-                 -c $corpus -o ${thotlm_prefix} -n ${n_val} -f ${fragm_size} ${unk_opt} \
-                 ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
-    else
-        ${bindir}/thot_get_ngram_counts -c $corpus \
-                 -n ${n_val} > ${thotlm_prefix} || return 1
-    fi
-
     # Determine output directory information
     prefix=$outd/${outsubdir}/trg.lm
     relative_prefix=${outsubdir}/trg.lm
 
     # Remove previously existing ldb files
     remove_prev_ldb_files
-    
-    # Create leveldb model
-    cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -o $prefix 2> ${prefix}.ldb_err || return 1
 
-    # Remove native thot language model files
-    rm ${thotlm_prefix}*
+    if [ $nl -gt 0 -a ${qs_given} -eq 1 ]; then
+        # Estimate n-gram model parameters
+        ${bindir}/thot_pbs_get_ngram_counts -pr ${pr_val} \
+                 -c $corpus -o ${thotlm_prefix} -n ${n_val} -f ${fragm_size} ${unk_opt} \
+                 ${qs_opt} "${qs_par}" -tdir $tdir -sdir $sdir ${debug_opt} || return 1
+
+        # Create leveldb model
+        cat ${thotlm_prefix} | ${bindir}/thot_ngram_to_leveldb -o $prefix 2> ${prefix}.ldb_err || return 1
+
+        # Remove native thot language model files
+        rm ${thotlm_prefix}*
+    else
+        # Count n-grams directly into the leveldb model
+        ${bindir}/thot_count_ngrams -c $corpus -n ${n_val} ${unk_opt} \
+                 -nt ${pr_val} -T $tdir -ldb -o $prefix 2> ${prefix}.ldb_err || return 1
+    fi
 }
 
 ########
@@ -82,13 +82,15 @@ obtain_nblists()
         -o ${outd}/wg/inputsent -wg ${outd}/wg/devtrans \
         -sdir $sdir ${qs_opt} "${qs_par}" -v || { trap - EXIT ; return 1; }
 
-    # Obtain n-best lists from word graphs
+    # Obtain n-best lists from word graphs (word graphs are processed
+    # in parallel by thot_wg_nblists)
     for wgfile in ${outd}/wg/devtrans*.wg; do
         basewgfile=`$BASENAME $wgfile`
         sentid=`get_sentid ${basewgfile}`
-        ${bindir}/thot_wg_proc -w $wgfile -n ${n_val} \
-            -o ${outd}/nblist/inputsent_${sentid} 2>> ${outd}/nblist/thot_wg_proc.log || return 1
-    done
+        echo "$wgfile ${outd}/nblist/inputsent_${sentid}"
+    done > ${outd}/nblist/wg_list
+    ${bindir}/thot_wg_nblists -l ${outd}/nblist/wg_list -n ${n_val} \
+        -pr ${pr_val} 2>> ${outd}/nblist/thot_wg_nblists.log || return 1
 
     # Save disk space (compress files)
     for file in ${outd}/wg/devtrans*; do
@@ -162,7 +162,13 @@ gen_nbest_lists_iter()
     for wgfile in ${TDIR_LLWU}/wg/${niter}*.wg; do
         basewgfile=`$BASENAME $wgfile`
         sentid=`get_sentid ${basewgfile}`
-        ${bindir}/thot_wg_proc -w $wgfile -n ${n_val} -o ${TDIR_LLWU}/nblist/${niter}_${sentid} 2>> ${TDIR_LLWU}/nblist/thot_wg_proc.log || return 1
+        echo "$wgfile ${TDIR_LLWU}/nblist/${niter}_${sentid}"
+    done > ${TDIR_LLWU}/nblist/${niter}_wg_list
+    ${bindir}/thot_wg_nblists -l ${TDIR_LLWU}/nblist/${niter}_wg_list -n ${n_val} -pr ${nprocs} 2>> ${TDIR_LLWU}/nblist/thot_wg_nblists.log || return 1
+
+    for wgfile in ${TDIR_LLWU}/wg/${niter}*.wg; do
+        basewgfile=`$BASENAME $wgfile`
+        sentid=`get_sentid ${basewgfile}`
 
         # Filter n-best lists violating translation constraints (under
         # specific circumstances, a certain translation may violate
@@ -252,15 +252,15 @@ sort_counts_text()
 
 sort_counts_bin()
 {
-    ${bindir}/thot_sort_bin_ilextable -l ${models_per_chunk_dir}/${out_chunk}/model.${lex_ext} > ${curr_tables_dir}/lex_counts_${out_chunk}
+    ${bindir}/thot_merge_bin_swtables -t lex -T $TMP ${models_per_chunk_dir}/${out_chunk}/model.${lex_ext} > ${curr_tables_dir}/lex_counts_${out_chunk}
 
     if [ ${alig_ext} != "none" ]; then 
         case ${alig_ext} in
-            "hmm_alignd") ${bindir}/thot_sort_bin_ihmmatable \
-                -a ${models_per_chunk_dir}/${out_chunk}/model.${alig_ext} > ${curr_tables_dir}/alig_counts_${out_chunk}
+            "hmm_alignd") ${bindir}/thot_merge_bin_swtables -t hmm -T $TMP \
+                ${models_per_chunk_dir}/${out_chunk}/model.${alig_ext} > ${curr_tables_dir}/alig_counts_${out_chunk}
                 ;;
-            "ibm2_alignd") ${bindir}/thot_sort_bin_iibm2atable \
-                -a ${models_per_chunk_dir}/${out_chunk}/model.${alig_ext} > ${curr_tables_dir}/alig_counts_${out_chunk}
+            "ibm2_alignd") ${bindir}/thot_merge_bin_swtables -t ibm2 -T $TMP \
+                ${models_per_chunk_dir}/${out_chunk}/model.${alig_ext} > ${curr_tables_dir}/alig_counts_${out_chunk}
                 ;;
         esac
     fi
@@ -381,7 +381,7 @@ merge_lex_counts_text()
 merge_lex_counts_bin()
 {
     # Merge lex sorted counts
-    ${bindir}/thot_merge_bin_ilextable ${curr_tables_dir}/lex_counts_* \
+    ${bindir}/thot_merge_bin_swtables -t lex -s -T $TMP ${curr_tables_dir}/lex_counts_* \
         > ${curr_tables_dir}/merged_lex_counts ; ${PIPE_FAIL} || return 1
 
     # Delete lex sorted counts
@@ -426,10 +426,10 @@ merge_alig_counts_bin()
 {
     # Merge alig sorted counts
     case ${alig_ext} in
-        "hmm_alignd") ${bindir}/thot_merge_bin_ihmmatable ${curr_tables_dir}/alig_counts_* \
+        "hmm_alignd") ${bindir}/thot_merge_bin_swtables -t hmm -s -T $TMP ${curr_tables_dir}/alig_counts_* \
             > ${curr_tables_dir}/merged_alig_counts ; ${PIPE_FAIL} || return 1
             ;;
-        "ibm2_alignd") ${bindir}/thot_merge_bin_iibm2atable ${curr_tables_dir}/alig_counts_* \
+        "ibm2_alignd") ${bindir}/thot_merge_bin_swtables -t ibm2 -s -T $TMP ${curr_tables_dir}/alig_counts_* \
             > ${curr_tables_dir}/merged_alig_counts ; ${PIPE_FAIL} || return 1
             ;;
     esac